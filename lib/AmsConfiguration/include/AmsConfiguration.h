@@ -30,6 +30,7 @@
 #define CONFIG_HA_START 1552
 #define CONFIG_UI_START 1720
 #define CONFIG_CLOUD_START 1742
+#define CONFIG_SUBMETER_START 1832
 
 #define CONFIG_METER_START_103 32
 #define CONFIG_UPGRADE_INFO_START_103 216
@@ -45,6 +46,13 @@
 #define CONFIG_MQTT_START_103 1004
 #define CONFIG_HA_START_103 1680
 
+// Channel 0 is the main meter, the rest are sub-meters on their own UART
+#if defined(CONFIG_IDF_TARGET_ESP32)
+#define METER_CHANNELS 2
+#else
+#define METER_CHANNELS 1
+#endif
+
 #define LED_BEHAVIOUR_DEFAULT 0
 #define LED_BEHAVIOUR_BOOT 1
 #define LED_BEHAVIOUR_ERROR_ONLY 3
@@ -285,6 +293,9 @@ public:
 	bool isMeterChanged();
 	void ackMeterChanged();
 
+	bool getSubMeterConfig(uint8_t channel, MeterConfig&);
+	bool setSubMeterConfig(uint8_t channel, MeterConfig&);
+
 	bool getDebugConfig(DebugConfig&);
 	bool setDebugConfig(DebugConfig&);
 	void clearDebug(DebugConfig&);
@@ -15,7 +15,10 @@
 
 #define FILE_DAYPLOT "/dayplot.bin"
 #define FILE_MONTHPLOT "/monthplot.bin"
+#define FILE_QUARTERPLOT "/quarterplot.bin"
+#define FILE_HISTORY "/history.bin"
 #define FILE_ENERGYACCOUNTING "/energyaccounting.bin"
+#define FILE_TIMESERIES "/ts%02d.bin"
 
 #define FILE_CFG "/configfile.cfg"
 #define FILE_PRICE_CONF "/priceconf.bin"
@@ -304,6 +304,41 @@ bool AmsConfiguration::setMeterConfig(MeterConfig& config) {
 	return ret;
 }
 
+bool AmsConfiguration::getSubMeterConfig(uint8_t channel, MeterConfig& config) {
+	if(channel < 1 || channel >= METER_CHANNELS || !hasConfig()) {
+		clearMeter(config);
+		return false;
+	}
+	EEPROM.begin(EEPROM_SIZE);
+	EEPROM.get(CONFIG_SUBMETER_START + ((channel-1) * sizeof(MeterConfig)), config);
+	EEPROM.end();
+	// Area was never written by older firmware, treat anything that does not look like a meter as disabled
+	if(config.baud == 0 || config.baud > 115200 || config.rxPin == 0xFF || config.source != 1) {
+		clearMeter(config);
+		return false;
+	}
+	if(config.bufferSize < 1 || config.bufferSize > 64) {
+		config.bufferSize = 2;
+	}
+	return true;
+}
+
+bool AmsConfiguration::setSubMeterConfig(uint8_t channel, MeterConfig& config) {
+	if(channel < 1 || channel >= METER_CHANNELS) return false;
+	if(config.bufferSize < 1) config.bufferSize = 1;
+	if(config.bufferSize > 64) config.bufferSize = 64;
+
+	MeterConfig existing;
+	getSubMeterConfig(channel, existing);
+	meterChanged |= memcmp(&config, &existing, sizeof(MeterConfig)) != 0;
+
+	EEPROM.begin(EEPROM_SIZE);
+	EEPROM.put(CONFIG_SUBMETER_START + ((channel-1) * sizeof(MeterConfig)), config);
+	bool ret = EEPROM.commit();
+	EEPROM.end();
+	return ret;
+}
+
 void AmsConfiguration::clearMeter(MeterConfig& config) {
 	config.rxPin = 0xFF;
 	config.txPin = 0xFF;
@@ -929,6 +964,10 @@ void AmsConfiguration::clear() {
 	clearCloudConfig(cloud);
 	EEPROM.put(CONFIG_CLOUD_START, cloud);
 
+	for(uint8_t i = 1; i < METER_CHANNELS; i++) {
+		EEPROM.put(CONFIG_SUBMETER_START + ((i-1) * sizeof(MeterConfig)), meter);
+	}
+
 	EEPROM.put(EEPROM_CONFIG_ADDRESS, EEPROM_CLEARED_INDICATOR);
 	EEPROM.commit();
 	EEPROM.end();
@@ -23,23 +23,69 @@ enum AmsType {
     AmsTypeUnknown = 0xFF
 };
 
+// Bit positions in the bitmap of fields changed by apply()
+enum AmsDataField {
+    AmsDataFieldListId = 0,
+    AmsDataFieldMeterId,
+    AmsDataFieldMeterType,
+    AmsDataFieldMeterModel,
+    AmsDataFieldMeterTimestamp,
+    AmsDataFieldActiveImportPower,
+    AmsDataFieldReactiveImportPower,
+    AmsDataFieldActiveExportPower,
+    AmsDataFieldReactiveExportPower,
+    AmsDataFieldL1Voltage,
+    AmsDataFieldL2Voltage,
+    AmsDataFieldL3Voltage,
+    AmsDataFieldL1Current,
+    AmsDataFieldL2Current,
+    AmsDataFieldL3Current,
+    AmsDataFieldPowerFactor,
+    AmsDataFieldL1PowerFactor,
+    AmsDataFieldL2PowerFactor,
+    AmsDataFieldL3PowerFactor,
+    AmsDataFieldL1ActiveImportPower,
+    AmsDataFieldL2ActiveImportPower,
+    AmsDataFieldL3ActiveImportPower,
+    AmsDataFieldL1ActiveExportPower,
+    AmsDataFieldL2ActiveExportPower,
+    AmsDataFieldL3ActiveExportPower,
+    AmsDataFieldL1ActiveImportCounter,
+    AmsDataFieldL2ActiveImportCounter,
+    AmsDataFieldL3ActiveImportCounter,
+    AmsDataFieldL1ActiveExportCounter,
+    AmsDataFieldL2ActiveExportCounter,
+    AmsDataFieldL3ActiveExportCounter,
+    AmsDataFieldActiveImportCounter,
+    AmsDataFieldReactiveImportCounter,
+    AmsDataFieldActiveExportCounter,
+    AmsDataFieldReactiveExportCounter,
+    AmsDataFieldCount
+};
+
+// Every field, and every field but the meter clock, which moves on with each frame
+#define AMS_DATA_ALL_FIELDS ((1ULL << AmsDataFieldCount) - 1)
+#define AMS_DATA_VALUE_FIELDS (AMS_DATA_ALL_FIELDS & ~(1ULL << AmsDataFieldMeterTimestamp))
+
 class AmsData {
 public:
     AmsData();
 
+    void reset();
     void apply(AmsData& other);
     void apply(const OBIS_code_t obis, double value);
 
     uint64_t getLastUpdateMillis();
+    void setLastUpdateMillis(uint64_t millis);
 
     time_t getPackageTimestamp();
 
     uint8_t getListType();
 
-    String getListId();
-    String getMeterId();
+    const String& getListId();
+    const String& getMeterId();
     uint8_t getMeterType();
-    String getMeterModel();
+    const String& getMeterModel();
 
     time_t getMeterTimestamp();
 
@@ -90,6 +136,10 @@ public:
     int8_t getLastError();
     void setLastError(int8_t);
 
+    uint64_t getChanges();
+    bool isChanged(uint8_t field);
+    void clearChanges();
+
 protected:
     uint64_t lastUpdateMillis = 0;
     uint64_t lastList2 = 0;
@@ -98,18 +148,37 @@ protected:
     String listId = "", meterId = "", meterModel = "";
     time_t meterTimestamp = 0;
     uint32_t activeImportPower = 0, reactiveImportPower = 0, activeExportPower = 0, reactiveExportPower = 0;
-    float l1voltage = 0, l2voltage = 0, l3voltage = 0, l1current = 0, l2current = 0, l3current = 0;
+    // Fixed point, so that applying and estimating does not need floating point: mV, mA,
+    // power factor x 1000 and mWh (kWh x 1000000). The getters convert to SI units.
+    uint32_t l1voltage = 0, l2voltage = 0, l3voltage = 0;
+    int32_t l1current = 0, l2current = 0, l3current = 0;
     uint32_t l1activeImportPower = 0, l2activeImportPower = 0, l3activeImportPower = 0;
     uint32_t l1activeExportPower = 0, l2activeExportPower = 0, l3activeExportPower = 0;
-    double l1activeImportCounter = 0, l2activeImportCounter = 0, l3activeImportCounter = 0;
-    double l1activeExportCounter = 0, l2activeExportCounter = 0, l3activeExportCounter = 0;
-    float powerFactor = 0, l1PowerFactor = 0, l2PowerFactor = 0, l3PowerFactor = 0;
-    double activeImportCounter = 0, reactiveImportCounter = 0, activeExportCounter = 0, reactiveExportCounter = 0;
-    double lastKnownCounter = 0;
+    uint64_t l1activeImportCounter = 0, l2activeImportCounter = 0, l3activeImportCounter = 0;
+    uint64_t l1activeExportCounter = 0, l2activeExportCounter = 0, l3activeExportCounter = 0;
+    int32_t powerFactor = 0, l1PowerFactor = 0, l2PowerFactor = 0, l3PowerFactor = 0;
+    uint64_t activeImportCounter = 0, reactiveImportCounter = 0, activeExportCounter = 0, reactiveExportCounter = 0;
+    int64_t lastKnownCounter = 0;
     bool threePhase = false, twoPhase = false, counterEstimated = false, l2currentMissing = false;;
 
     int8_t lastError = 0x00;
     uint8_t lastErrorCount = 0;
+    uint64_t changes = 0; // One bit per AmsDataField, set when apply() gives the field a new value
+
+    template<typename T> void setField(T& target, const T& value, uint8_t field) {
+        if(target != value) {
+            target = value;
+            changes |= 1ULL << field;
+        }
+    };
+
+    // Used by the decoders to go from decoded SI values to the fixed point fields
+    static int32_t toMilli(double value) {
+        return value < 0 ? value * 1000 - 0.5 : value * 1000 + 0.5;
+    };
+    static uint64_t toMilliWh(double kwh) {
+        return kwh > 0 ? kwh * 1000000 + 0.5 : 0;
+    };
 };
 
 #endif
@@ -0,0 +1,33 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#ifndef _AMSDATASNAPSHOT_H
+#define _AMSDATASNAPSHOT_H
+
+#include "AmsData.h"
+
+// Hands a consistent copy of the meter state to readers outside the task that owns it,
+// without a mutex. There is a single writer, which copies into the slot not currently
+// published and then flips to it. Each slot has its own sequence counter, odd while the
+// slot is being written, and a count of readers copying it. AmsData holds Strings, so a
+// slot is never written while it is read: the writer leaves a slot that still has a
+// reader from before the last flip, and publishes on a later call.
+class AmsDataSnapshot {
+public:
+    bool publish(AmsData& state);
+    bool read(AmsData& target);
+    bool isBehind(AmsData& state);
+    uint32_t getSequence();
+
+private:
+    AmsData slots[2];
+    uint32_t sequence[2] = { 0, 0 };
+    uint32_t readers[2] = { 0, 0 };
+    uint8_t active = 0;
+    uint32_t published = 0;
+};
+
+#endif
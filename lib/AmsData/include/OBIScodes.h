@@ -7,7 +7,11 @@
 #ifndef _OBISCODES_H
 #define _OBISCODES_H
 
+#if defined(ESP8266) || defined(ESP32)
 #include "lwip/def.h"
+#else
+#include <arpa/inet.h>
+#endif
 
 #define OBIS_MEDIUM_ABSTRACT 0
 #define OBIS_MEDIUM_ELECTRICITY 1
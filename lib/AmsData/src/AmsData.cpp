@@ -8,6 +8,33 @@
 
 AmsData::AmsData() {}
 
+// Puts the object back to its initial state. String members are cleared rather than
+// replaced, so buffers already allocated for them are kept for the next frame
+void AmsData::reset() {
+    lastUpdateMillis = 0;
+    lastList2 = 0;
+    listType = 0;
+    meterType = AmsTypeUnknown;
+    packageTimestamp = 0;
+    listId = "";
+    meterId = "";
+    meterModel = "";
+    meterTimestamp = 0;
+    activeImportPower = reactiveImportPower = activeExportPower = reactiveExportPower = 0;
+    l1voltage = l2voltage = l3voltage = l1current = l2current = l3current = 0;
+    l1activeImportPower = l2activeImportPower = l3activeImportPower = 0;
+    l1activeExportPower = l2activeExportPower = l3activeExportPower = 0;
+    l1activeImportCounter = l2activeImportCounter = l3activeImportCounter = 0;
+    l1activeExportCounter = l2activeExportCounter = l3activeExportCounter = 0;
+    powerFactor = l1PowerFactor = l2PowerFactor = l3PowerFactor = 0;
+    activeImportCounter = reactiveImportCounter = activeExportCounter = reactiveExportCounter = 0;
+    lastKnownCounter = 0;
+    threePhase = twoPhase = counterEstimated = l2currentMissing = false;
+    lastError = 0x00;
+    lastErrorCount = 0;
+    changes = 0;
+}
+
 void AmsData::apply(AmsData& other) {
     if(other.getListType() < 3) {
         unsigned long ms = this->lastUpdateMillis > other.getLastUpdateMillis() ? 0 : other.getLastUpdateMillis() - this->lastUpdateMillis;
@@ -15,27 +42,26 @@ void AmsData::apply(AmsData& other) {
         if(ms > 0) {
             if(other.getActiveImportPower() > 0) {
                 uint32_t power = (activeImportPower + other.getActiveImportPower()) / 2;
-                float add = power * (((float) ms) / 3600000.0);
-                activeImportCounter += add / 1000.0;
-                //Serial.printf("%dW, %dms, %.6fkWh added\n", other.getActiveImportPower(), ms, add);
+                activeImportCounter += ((uint64_t) power * ms + 1800) / 3600; // W x ms to mWh, rounded
+                changes |= 1ULL << AmsDataFieldActiveImportCounter;
             }
 
             if(other.getListType() > 1) {
                 ms = this->lastList2 > other.getLastUpdateMillis() ? 0 : other.getLastUpdateMillis() - this->lastList2;
                 if(other.getActiveExportPower() > 0) {
                     uint32_t power = (activeExportPower + other.getActiveExportPower()) / 2;
-                    float add = power * (((float) ms) / 3600000.0);
-                    activeExportCounter += add / 1000.0;
+                    activeExportCounter += ((uint64_t) power * ms + 1800) / 3600;
+                    changes |= 1ULL << AmsDataFieldActiveExportCounter;
                 }
                 if(other.getReactiveImportPower() > 0) {
                     uint32_t power = (reactiveImportPower + other.getReactiveImportPower()) / 2;
-                    float add = power * (((float) ms) / 3600000.0);
-                    reactiveImportCounter += add / 1000.0;
+                    reactiveImportCounter += ((uint64_t) power * ms + 1800) / 3600;
+                    changes |= 1ULL << AmsDataFieldReactiveImportCounter;
                 }
                 if(other.getReactiveExportPower() > 0) {
                     uint32_t power = (reactiveExportPower + other.getReactiveExportPower()) / 2;
-                    float add = power * (((float) ms) / 3600000.0);
-                    reactiveExportCounter += add / 1000.0;
+                    reactiveExportCounter += ((uint64_t) power * ms + 1800) / 3600;
+                    changes |= 1ULL << AmsDataFieldReactiveExportCounter;
                 }
             }
             counterEstimated = true;
@@ -51,75 +77,77 @@ void AmsData::apply(AmsData& other) {
         this->listType = other.getListType();
     switch(other.getListType()) {
         case 4:
-            this->powerFactor = other.getPowerFactor();
-            this->l1PowerFactor = other.getL1PowerFactor();
-            this->l2PowerFactor = other.getL2PowerFactor();
-            this->l3PowerFactor = other.getL3PowerFactor();
-            this->l1activeImportPower = other.getL1ActiveImportPower();
-            this->l2activeImportPower = other.getL2ActiveImportPower();
-            this->l3activeImportPower = other.getL3ActiveImportPower();
-            this->l1activeExportPower = other.getL1ActiveExportPower();
-            this->l2activeExportPower = other.getL2ActiveExportPower();
-            this->l3activeExportPower = other.getL3ActiveExportPower();
-            this->l1activeImportCounter = other.getL1ActiveImportCounter();
-            this->l2activeImportCounter = other.getL2ActiveImportCounter();
-            this->l3activeImportCounter = other.getL3ActiveImportCounter();
-            this->l1activeExportCounter = other.getL1ActiveExportCounter();
-            this->l2activeExportCounter = other.getL2ActiveExportCounter();
-            this->l3activeExportCounter = other.getL3ActiveExportCounter();
+            setField(this->powerFactor, other.powerFactor, AmsDataFieldPowerFactor);
+            setField(this->l1PowerFactor, other.l1PowerFactor, AmsDataFieldL1PowerFactor);
+            setField(this->l2PowerFactor, other.l2PowerFactor, AmsDataFieldL2PowerFactor);
+            setField(this->l3PowerFactor, other.l3PowerFactor, AmsDataFieldL3PowerFactor);
+            setField(this->l1activeImportPower, other.getL1ActiveImportPower(), AmsDataFieldL1ActiveImportPower);
+            setField(this->l2activeImportPower, other.getL2ActiveImportPower(), AmsDataFieldL2ActiveImportPower);
+            setField(this->l3activeImportPower, other.getL3ActiveImportPower(), AmsDataFieldL3ActiveImportPower);
+            setField(this->l1activeExportPower, other.getL1ActiveExportPower(), AmsDataFieldL1ActiveExportPower);
+            setField(this->l2activeExportPower, other.getL2ActiveExportPower(), AmsDataFieldL2ActiveExportPower);
+            setField(this->l3activeExportPower, other.getL3ActiveExportPower(), AmsDataFieldL3ActiveExportPower);
+            setField(this->l1activeImportCounter, other.l1activeImportCounter, AmsDataFieldL1ActiveImportCounter);
+            setField(this->l2activeImportCounter, other.l2activeImportCounter, AmsDataFieldL2ActiveImportCounter);
+            setField(this->l3activeImportCounter, other.l3activeImportCounter, AmsDataFieldL3ActiveImportCounter);
+            setField(this->l1activeExportCounter, other.l1activeExportCounter, AmsDataFieldL1ActiveExportCounter);
+            setField(this->l2activeExportCounter, other.l2activeExportCounter, AmsDataFieldL2ActiveExportCounter);
+            setField(this->l3activeExportCounter, other.l3activeExportCounter, AmsDataFieldL3ActiveExportCounter);
         case 3:
-            this->meterTimestamp = other.getMeterTimestamp();
+            setField(this->meterTimestamp, other.getMeterTimestamp(), AmsDataFieldMeterTimestamp);
             // Aidon tends to sometime send the same counter as last hour by accident
-            if(meterType == AmsTypeAidon && counterEstimated && lastKnownCounter == other.getActiveImportCounter()-other.getActiveExportCounter()) {
-                double diff = activeImportCounter - activeExportCounter - lastKnownCounter;
-                if(diff < 1.0) { // In case a very low value have been calculated, use the new values
-                    this->activeImportCounter = other.getActiveImportCounter();
-                    this->activeExportCounter = other.getActiveExportCounter();
-                    this->reactiveImportCounter = other.getReactiveImportCounter();
-                    this->reactiveExportCounter = other.getReactiveExportCounter();
-                    this->lastKnownCounter = activeImportCounter - activeExportCounter;
+            if(meterType == AmsTypeAidon && counterEstimated && lastKnownCounter == (int64_t) other.activeImportCounter - (int64_t) other.activeExportCounter) {
+                int64_t diff = (int64_t) activeImportCounter - (int64_t) activeExportCounter - lastKnownCounter;
+                if(diff < 1000000) { // In case a very low value have been calculated, use the new values
+                    setField(this->activeImportCounter, other.activeImportCounter, AmsDataFieldActiveImportCounter);
+                    setField(this->activeExportCounter, other.activeExportCounter, AmsDataFieldActiveExportCounter);
+                    setField(this->reactiveImportCounter, other.reactiveImportCounter, AmsDataFieldReactiveImportCounter);
+                    setField(this->reactiveExportCounter, other.reactiveExportCounter, AmsDataFieldReactiveExportCounter);
+                    this->lastKnownCounter = (int64_t) activeImportCounter - (int64_t) activeExportCounter;
                 }
             } else {
-                this->activeImportCounter = other.getActiveImportCounter();
-                this->activeExportCounter = other.getActiveExportCounter();
-                this->reactiveImportCounter = other.getReactiveImportCounter();
-                this->reactiveExportCounter = other.getReactiveExportCounter();
-                this->lastKnownCounter = activeImportCounter - activeExportCounter;
+                setField(this->activeImportCounter, other.activeImportCounter, AmsDataFieldActiveImportCounter);
+                setField(this->activeExportCounter, other.activeExportCounter, AmsDataFieldActiveExportCounter);
+                setField(this->reactiveImportCounter, other.reactiveImportCounter, AmsDataFieldReactiveImportCounter);
+                setField(this->reactiveExportCounter, other.reactiveExportCounter, AmsDataFieldReactiveExportCounter);
+                this->lastKnownCounter = (int64_t) activeImportCounter - (int64_t) activeExportCounter;
             }
             this->counterEstimated = false;
         case 2:
-            this->listId = other.getListId();
-            this->meterId = other.getMeterId();
-            this->meterType = other.getMeterType();
-            this->meterModel = other.getMeterModel();
-            this->reactiveImportPower = other.getReactiveImportPower();
-            this->reactiveExportPower = other.getReactiveExportPower();
-            this->l1current = other.getL1Current();
-            this->l2current = other.getL2Current();
+            setField(this->listId, other.getListId(), AmsDataFieldListId);
+            setField(this->meterId, other.getMeterId(), AmsDataFieldMeterId);
+            setField(this->meterType, other.getMeterType(), AmsDataFieldMeterType);
+            setField(this->meterModel, other.getMeterModel(), AmsDataFieldMeterModel);
+            setField(this->reactiveImportPower, other.getReactiveImportPower(), AmsDataFieldReactiveImportPower);
+            setField(this->reactiveExportPower, other.getReactiveExportPower(), AmsDataFieldReactiveExportPower);
+            setField(this->l1current, other.l1current, AmsDataFieldL1Current);
+            setField(this->l2current, other.l2current, AmsDataFieldL2Current);
             this->l2currentMissing = other.isL2currentMissing();
-            this->l3current = other.getL3Current();
-            this->l1voltage = other.getL1Voltage();
-            this->l2voltage = other.getL2Voltage();
-            this->l3voltage = other.getL3Voltage();
+            setField(this->l3current, other.l3current, AmsDataFieldL3Current);
+            setField(this->l1voltage, other.l1voltage, AmsDataFieldL1Voltage);
+            setField(this->l2voltage, other.l2voltage, AmsDataFieldL2Voltage);
+            setField(this->l3voltage, other.l3voltage, AmsDataFieldL3Voltage);
             this->threePhase = other.isThreePhase();
             this->twoPhase = other.isTwoPhase();
     }
 
     // Moved outside switch to handle meters alternating between sending active and accumulated values
     if(other.getListType() == 1 || (other.getActiveImportPower() > 0 || other.getActiveExportPower() > 0))
-        this->activeImportPower = other.getActiveImportPower();
+        setField(this->activeImportPower, other.getActiveImportPower(), AmsDataFieldActiveImportPower);
     if(other.getListType() == 2 || (other.getActiveImportPower() > 0 || other.getActiveExportPower() > 0))
-        this->activeExportPower = other.getActiveExportPower();
+        setField(this->activeExportPower, other.getActiveExportPower(), AmsDataFieldActiveExportPower);
 }
 
 void AmsData::apply(OBIS_code_t obis, double value) {
     if(obis.sensor == 0 && obis.gr == 0 && obis.tariff == 0) {
         meterType = value;
+        changes |= 1ULL << AmsDataFieldMeterType;
     }
     if(obis.gr == 1) {
         if(obis.sensor == 96) {
             if(obis.tariff == 0) {
                 meterId = String((long) value, 10);
+                changes |= 1ULL << AmsDataFieldMeterId;
                 return;
             } else if(obis.tariff == 1) {
                 return;
@@ -134,125 +162,155 @@ void AmsData::apply(OBIS_code_t obis, double value) {
         switch(obis.sensor) {
             case 1:
                 activeImportPower = value;
+                changes |= 1ULL << AmsDataFieldActiveImportPower;
                 listType = max(listType, (uint8_t) 2);
                 break;
             case 2:
                 activeExportPower = value;
+                changes |= 1ULL << AmsDataFieldActiveExportPower;
                 listType = max(listType, (uint8_t) 2);
                 break;
             case 3:
                 reactiveImportPower = value;
+                changes |= 1ULL << AmsDataFieldReactiveImportPower;
                 listType = max(listType, (uint8_t) 2);
                 break;
             case 4:
                 reactiveExportPower = value;
+                changes |= 1ULL << AmsDataFieldReactiveExportPower;
                 listType = max(listType, (uint8_t) 2);
                 break;
             case 13:
-                powerFactor = value;
+                powerFactor = toMilli(value);
+                changes |= 1ULL << AmsDataFieldPowerFactor;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 21:
                 l1activeImportPower = value;
+                changes |= 1ULL << AmsDataFieldL1ActiveImportPower;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 22:
                 l1activeExportPower = value;
+                changes |= 1ULL << AmsDataFieldL1ActiveExportPower;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 31:
-                l1current = value;
+                l1current = toMilli(value);
+                changes |= 1ULL << AmsDataFieldL1Current;
                 listType = max(listType, (uint8_t) 2);
                 break;
             case 32:
-                l1voltage = value;
+                l1voltage = toMilli(value);
+                changes |= 1ULL << AmsDataFieldL1Voltage;
                 listType = max(listType, (uint8_t) 2);
                 break;
             case 33:
-                l1PowerFactor = value;
+                l1PowerFactor = toMilli(value);
+                changes |= 1ULL << AmsDataFieldL1PowerFactor;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 41:
                 l2activeImportPower = value;
+                changes |= 1ULL << AmsDataFieldL2ActiveImportPower;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 42:
                 l2activeExportPower = value;
+                changes |= 1ULL << AmsDataFieldL2ActiveExportPower;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 51:
-                l2current = value;
+                l2current = toMilli(value);
+                changes |= 1ULL << AmsDataFieldL2Current;
                 listType = max(listType, (uint8_t) 2);
                 break;
             case 52:
-                l2voltage = value;
+                l2voltage = toMilli(value);
+                changes |= 1ULL << AmsDataFieldL2Voltage;
                 listType = max(listType, (uint8_t) 2);
                 break;
             case 53:
-                l2PowerFactor = value;
+                l2PowerFactor = toMilli(value);
+                changes |= 1ULL << AmsDataFieldL2PowerFactor;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 61:
                 l3activeImportPower = value;
+                changes |= 1ULL << AmsDataFieldL3ActiveImportPower;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 62:
                 l3activeExportPower = value;
+                changes |= 1ULL << AmsDataFieldL3ActiveExportPower;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 71:
-                l3current = value;
+                l3current = toMilli(value);
+                changes |= 1ULL << AmsDataFieldL3Current;
                 listType = max(listType, (uint8_t) 2);
                 break;
             case 72:
-                l3voltage = value;
+                l3voltage = toMilli(value);
+                changes |= 1ULL << AmsDataFieldL3Voltage;
                 listType = max(listType, (uint8_t) 2);
                 break;
             case 73:
-                l3PowerFactor = value;
+                l3PowerFactor = toMilli(value);
+                changes |= 1ULL << AmsDataFieldL3PowerFactor;
                 listType = max(listType, (uint8_t) 4);
                 break;
         }
     } else if(obis.gr == 8) { // Accumulated values
         switch(obis.sensor) {
             case 1:
-                activeImportCounter = value;
+                activeImportCounter = toMilliWh(value);
+                changes |= 1ULL << AmsDataFieldActiveImportCounter;
                 listType = max(listType, (uint8_t) 3);
                 break;
             case 2:
-                activeExportCounter = value;
+                activeExportCounter = toMilliWh(value);
+                changes |= 1ULL << AmsDataFieldActiveExportCounter;
                 listType = max(listType, (uint8_t) 3);
                 break;
             case 3:
-                reactiveImportCounter = value;
+                reactiveImportCounter = toMilliWh(value);
+                changes |= 1ULL << AmsDataFieldReactiveImportCounter;
                 listType = max(listType, (uint8_t) 3);
                 break;
             case 4:
-                reactiveExportCounter = value;
+                reactiveExportCounter = toMilliWh(value);
+                changes |= 1ULL << AmsDataFieldReactiveExportCounter;
                 listType = max(listType, (uint8_t) 3);
                 break;
             case 21:
-                l1activeImportCounter = value;
+                l1activeImportCounter = toMilliWh(value);
+                changes |= 1ULL << AmsDataFieldL1ActiveImportCounter;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 22:
-                l1activeExportCounter = value;
+                l1activeExportCounter = toMilliWh(value);
+                changes |= 1ULL << AmsDataFieldL1ActiveExportCounter;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 41:
-                l2activeImportCounter = value;
+                l2activeImportCounter = toMilliWh(value);
+                changes |= 1ULL << AmsDataFieldL2ActiveImportCounter;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 42:
-                l2activeExportCounter = value;
+                l2activeExportCounter = toMilliWh(value);
+                changes |= 1ULL << AmsDataFieldL2ActiveExportCounter;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 61:
-                l3activeImportCounter = value;
+                l3activeImportCounter = toMilliWh(value);
+                changes |= 1ULL << AmsDataFieldL3ActiveImportCounter;
                 listType = max(listType, (uint8_t) 4);
                 break;
             case 62:
-                l3activeExportCounter = value;
+                l3activeExportCounter = toMilliWh(value);
+                changes |= 1ULL << AmsDataFieldL3ActiveExportCounter;
                 listType = max(listType, (uint8_t) 4);
                 break;
         }
@@ -269,6 +327,10 @@ uint64_t AmsData::getLastUpdateMillis() {
     return this->lastUpdateMillis;
 }
 
+void AmsData::setLastUpdateMillis(uint64_t millis) {
+    this->lastUpdateMillis = millis;
+}
+
 time_t AmsData::getPackageTimestamp() {
     return this->packageTimestamp;
 }
@@ -277,11 +339,11 @@ uint8_t AmsData::getListType() {
     return this->listType;
 }
 
-String AmsData::getListId() {
+const String& AmsData::getListId() {
     return this->listId;
 }
 
-String AmsData::getMeterId() {
+const String& AmsData::getMeterId() {
     return this->meterId;
 }
 
@@ -289,7 +351,7 @@ uint8_t AmsData::getMeterType() {
     return this->meterType;
 }
 
-String AmsData::getMeterModel() {
+const String& AmsData::getMeterModel() {
     return this->meterModel;
 }
 
@@ -314,43 +376,43 @@ uint32_t AmsData::getReactiveExportPower() {
 }
 
 float AmsData::getL1Voltage() {
-    return this->l1voltage;
+    return this->l1voltage / 1000.0;
 }
 
 float AmsData::getL2Voltage() {
-    return this->l2voltage;
+    return this->l2voltage / 1000.0;
 }
 
 float AmsData::getL3Voltage() {
-    return this->l3voltage;
+    return this->l3voltage / 1000.0;
 }
 
 float AmsData::getL1Current() {
-    return this->l1current;
+    return this->l1current / 1000.0;
 }
 
 float AmsData::getL2Current() {
-    return this->l2current;
+    return this->l2current / 1000.0;
 }
 
 float AmsData::getL3Current() {
-    return this->l3current;
+    return this->l3current / 1000.0;
 }
 
 float AmsData::getPowerFactor() {
-    return this->powerFactor;
+    return this->powerFactor / 1000.0;
 }
 
 float AmsData::getL1PowerFactor() {
-    return this->l1PowerFactor;
+    return this->l1PowerFactor / 1000.0;
 }
 
 float AmsData::getL2PowerFactor() {
-    return this->l2PowerFactor;
+    return this->l2PowerFactor / 1000.0;
 }
 
 float AmsData::getL3PowerFactor() {
-    return this->l3PowerFactor;
+    return this->l3PowerFactor / 1000.0;
 }
 
 uint32_t AmsData::getL1ActiveImportPower() {
@@ -378,43 +440,43 @@ uint32_t AmsData::getL3ActiveExportPower() {
 }
 
 double AmsData::getL1ActiveImportCounter() {
-    return this->l1activeImportCounter;
+    return this->l1activeImportCounter / 1000000.0;
 }
 
 double AmsData::getL2ActiveImportCounter() {
-    return this->l2activeImportCounter;
+    return this->l2activeImportCounter / 1000000.0;
 }
 
 double AmsData::getL3ActiveImportCounter() {
-    return this->l3activeImportCounter;
+    return this->l3activeImportCounter / 1000000.0;
 }
 
 double AmsData::getL1ActiveExportCounter() {
-    return this->l1activeExportCounter;
+    return this->l1activeExportCounter / 1000000.0;
 }
 
 double AmsData::getL2ActiveExportCounter() {
-    return this->l2activeExportCounter;
+    return this->l2activeExportCounter / 1000000.0;
 }
 
 double AmsData::getL3ActiveExportCounter() {
-    return this->l3activeExportCounter;
+    return this->l3activeExportCounter / 1000000.0;
 }
 
 double AmsData::getActiveImportCounter() {
-    return this->activeImportCounter;
+    return this->activeImportCounter / 1000000.0;
 }
 
 double AmsData::getReactiveImportCounter() {
-    return this->reactiveImportCounter;
+    return this->reactiveImportCounter / 1000000.0;
 }
 
 double AmsData::getActiveExportCounter() {
-    return this->activeExportCounter;
+    return this->activeExportCounter / 1000000.0;
 }
 
 double AmsData::getReactiveExportCounter() {
-    return this->reactiveExportCounter;
+    return this->reactiveExportCounter / 1000000.0;
 }
 
 bool AmsData::isThreePhase() {
@@ -444,4 +506,16 @@ void AmsData::setLastError(int8_t lastError) {
     } else {
         lastErrorCount++;
     }
-}
\ No newline at end of file
+}
+
+uint64_t AmsData::getChanges() {
+    return this->changes;
+}
+
+bool AmsData::isChanged(uint8_t field) {
+    return (this->changes >> field) & 1;
+}
+
+void AmsData::clearChanges() {
+    this->changes = 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#include "AmsDataSnapshot.h"
+
+// Writer side, only ever called from one task. Returns false when a reader was still
+// copying the slot, isBehind() then stays true so the caller tries again.
+bool AmsDataSnapshot::publish(AmsData& state) {
+    uint8_t next = active ^ 1;
+    // Marking the slot and then looking for readers pairs with the reader registering and then
+    // looking at the mark, so at least one of the two sees the other
+    __atomic_store_n(&sequence[next], sequence[next] + 1, __ATOMIC_SEQ_CST);
+    if(__atomic_load_n(&readers[next], __ATOMIC_SEQ_CST) != 0) {
+        __atomic_store_n(&sequence[next], sequence[next] + 1, __ATOMIC_RELEASE);
+        return false;
+    }
+    slots[next] = state;
+    __atomic_store_n(&sequence[next], sequence[next] + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&active, next, __ATOMIC_RELEASE);
+    __atomic_store_n(&published, published + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Returns false if nothing has been published yet. Only retries when the slot is being
+// written, which needs the writer to have published twice since the active slot was read.
+bool AmsDataSnapshot::read(AmsData& target) {
+    if(__atomic_load_n(&published, __ATOMIC_ACQUIRE) == 0) return false;
+    while(true) {
+        uint8_t idx = __atomic_load_n(&active, __ATOMIC_ACQUIRE);
+        __atomic_add_fetch(&readers[idx], 1, __ATOMIC_SEQ_CST);
+        if(__atomic_load_n(&sequence[idx], __ATOMIC_SEQ_CST) & 1) {
+            __atomic_sub_fetch(&readers[idx], 1, __ATOMIC_RELEASE);
+            continue;
+        }
+        target = slots[idx];
+        __atomic_sub_fetch(&readers[idx], 1, __ATOMIC_RELEASE);
+        return true;
+    }
+}
+
+// Writer side, true if state has been updated or got a new error since it was last published
+bool AmsDataSnapshot::isBehind(AmsData& state) {
+    if(published == 0) return true;
+    AmsData& last = slots[active];
+    return last.getLastUpdateMillis() != state.getLastUpdateMillis() || last.getLastError() != state.getLastError();
+}
+
+uint32_t AmsDataSnapshot::getSequence() {
+    return __atomic_load_n(&published, __ATOMIC_ACQUIRE);
+}
@@ -8,6 +8,8 @@
 #define _AMSDATASTORAGE_H
 #include "Arduino.h"
 #include "AmsData.h"
+#include "AmsRollup.h"
+#include "AmsFile.h"
 #if defined(AMS_REMOTE_DEBUG)
 #include "RemoteDebug.h"
 #endif
@@ -53,6 +55,18 @@ struct MonthDataPoints {
     uint8_t accuracy;
 };
 
+// A 25 hour day in quarter hours, counted from local midnight
+#define QUARTER_SLOTS 100
+
+struct QuarterDataPoints {
+    uint8_t version;
+    time_t dayStart;
+    uint16_t qImport[QUARTER_SLOTS];
+    uint16_t qExport[QUARTER_SLOTS];
+    uint32_t filled[(QUARTER_SLOTS + 31) / 32];
+    uint8_t accuracy;
+};
+
 class AmsDataStorage {
 public:
     #if defined(AMS_REMOTE_DEBUG)
@@ -61,6 +75,7 @@ public:
     AmsDataStorage(Stream*);
     #endif
     void setTimezone(Timezone*);
+    // Fills the day and month plots from the meter counters, for what the rollup missed
     bool update(AmsData*);
     uint32_t getHourImport(uint8_t);
     uint32_t getHourExport(uint8_t);
@@ -68,6 +83,8 @@ public:
     uint32_t getDayExport(uint8_t);
     bool load();
     bool save();
+    void requestSave();
+    bool loop();
 
     DayDataPoints getDayData();
     bool setDayData(DayDataPoints&);
@@ -90,6 +107,15 @@ public:
     void setDayImport(uint8_t, uint32_t);
     void setDayExport(uint8_t, uint32_t);
 
+    bool updateHour(AmsRollup&);
+    bool updateDay(AmsRollup&);
+    bool updateQuarter(AmsRollup&);
+    time_t getQuarterDayStart();
+    uint8_t getQuarterCount();
+    bool hasQuarter(uint8_t);
+    uint32_t getQuarterImport(uint8_t);
+    uint32_t getQuarterExport(uint8_t);
+
 private:
     Timezone* tz;
     DayDataPoints day = {
@@ -106,11 +132,18 @@ private:
         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
         10
     };
+    QuarterDataPoints quarter = { 1 };
+    AmsFile dayFile, monthFile, quarterFile;
+    unsigned long saveRequested = 0;
+    bool savePending = false;
     #if defined(AMS_REMOTE_DEBUG)
     RemoteDebug* debugger;
     #else
     Stream* debugger;
     #endif
+
+    time_t getLocalMidnight(time_t now, int8_t days);
+    void setQuarter(uint8_t slot, uint32_t importWh, uint32_t exportWh);
 };
 
 #endif
@@ -0,0 +1,37 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#ifndef _AMSFILE_H
+#define _AMSFILE_H
+#include "Arduino.h"
+
+#define AMSFILE_MAGIC 0xA5F1
+#define AMSFILE_SAVE_DELAY 5000 // Saves requested within this many ms are written once
+
+struct AmsFileTrailer {
+    uint16_t magic;
+    uint16_t crc;
+};
+
+// One record in a file, followed by a trailer with a CRC of the record. It is written to a
+// temporary file which is renamed over the old one, so that a power loss while writing
+// leaves either the old or the new record on flash, never a mix.
+class AmsFile {
+public:
+    AmsFile(const char* path);
+    int16_t read(uint8_t* buf, uint16_t size);
+    bool write(const uint8_t* buf, uint16_t len);
+
+private:
+    const char* path;
+    uint16_t crc = 0;       // Of the record on flash, to skip writing the same again
+    bool stored = false;
+
+    int16_t readFile(const char* path, uint8_t* buf, uint16_t size, bool& checked);
+    void getTempPath(char* buf, uint8_t size);
+};
+
+#endif
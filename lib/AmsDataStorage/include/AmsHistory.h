@@ -0,0 +1,102 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#ifndef _AMSHISTORY_H
+#define _AMSHISTORY_H
+#include "Arduino.h"
+#include "AmsRollup.h"
+#if defined(AMS_REMOTE_DEBUG)
+#include "RemoteDebug.h"
+#endif
+
+#define HISTORY_BLOCK_SIZE 256
+#define HISTORY_BLOCKS 128
+
+struct HistoryBlockHeader {
+    uint32_t start;     // UTC, first hour in the block
+    uint16_t count;     // Hours in the block
+    uint16_t used;      // Bytes of data
+};
+
+// Each hour is the change in the import and export positions from the hour before, which is
+// the energy of that hour. They are zig-zag encoded so that a counter that went back still
+// fits. The lowest bit of the import value flags hours left out before this one, with the
+// number in a varint after it. The first hour of a block has the positions themselves.
+struct HistoryBlock {
+    HistoryBlockHeader header;
+    uint8_t data[HISTORY_BLOCK_SIZE - sizeof(HistoryBlockHeader)];
+};
+
+// Import and export counter positions at the end of the hour. The energy of an hour is the
+// difference to the hour before it.
+struct HistoryPoint {
+    time_t timestamp;
+    uint32_t importWh;
+    uint32_t exportWh;
+};
+
+class AmsHistory;
+
+// Decodes one block at a time, so any range can be streamed with a single block of RAM
+class AmsHistoryCursor {
+public:
+    AmsHistoryCursor(AmsHistory* history);
+    bool seek(time_t from);
+    bool next(HistoryPoint& point);
+
+private:
+    AmsHistory* history;
+    HistoryBlock block;
+    time_t from = 0;
+    uint16_t blockIdx = 0;
+    uint16_t entry = 0;
+    uint16_t pos = 0;
+    time_t timestamp = 0;
+    uint32_t importWh = 0;
+    uint32_t exportWh = 0;
+
+    bool loadBlock(uint16_t idx);
+
+    friend class AmsHistory;
+};
+
+class AmsHistory {
+public:
+    #if defined(AMS_REMOTE_DEBUG)
+    AmsHistory(RemoteDebug*);
+    #else
+    AmsHistory(Stream*);
+    #endif
+    bool load();
+    bool update(AmsRollup& rollup);
+    bool append(time_t hour, uint32_t importWh, uint32_t exportWh);
+    uint16_t getBlockCount();
+
+    static uint8_t putVarint(uint8_t* buf, uint32_t val);
+    static uint8_t getVarint(const uint8_t* buf, uint16_t len, uint32_t& val);
+
+private:
+    HistoryBlock current;
+    uint16_t currentSlot = 0;
+    uint16_t blocks = 0;        // Blocks in the file
+    uint32_t lastHour = 0;
+    uint32_t lastImport = 0;
+    uint32_t lastExport = 0;
+
+    #if defined(AMS_REMOTE_DEBUG)
+    RemoteDebug* debugger;
+    #else
+    Stream* debugger;
+    #endif
+
+    uint16_t getOldestSlot();
+    bool readBlock(uint16_t slot, HistoryBlock& block);
+    bool writeBlock();
+
+    friend class AmsHistoryCursor;
+};
+
+#endif
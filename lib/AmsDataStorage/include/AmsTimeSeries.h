@@ -0,0 +1,72 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#ifndef _AMSTIMESERIES_H
+#define _AMSTIMESERIES_H
+#include "Arduino.h"
+#include "AmsRollup.h"
+#include "FS.h"
+#if defined(AMS_REMOTE_DEBUG)
+#include "RemoteDebug.h"
+#endif
+
+#define TIMESERIES_VERSION 1
+#define TIMESERIES_INTERVAL 60
+#define TIMESERIES_SEGMENT_SECONDS 86400
+#define TIMESERIES_BUFFER 15
+
+// One file per UTC day, reused round robin. The firmware upload is staged in the same
+// filesystem, so this has to stay well below what is left after that.
+#if defined(ESP32)
+#define TIMESERIES_SEGMENTS 14
+#else
+#define TIMESERIES_SEGMENTS 3
+#endif
+
+struct TimeSeriesRecord {
+    uint32_t timestamp;     // Start of the interval, UTC
+    uint32_t activeImport;  // Counter at the end of the interval, Wh
+    uint32_t activeExport;
+    uint16_t importPower;   // Average over the interval, W
+    uint16_t exportPower;
+};
+
+struct TimeSeriesSegmentHeader {
+    uint8_t version;
+    uint8_t interval;
+    uint16_t recordSize;
+    uint32_t day;           // Days since epoch, UTC
+};
+
+class AmsTimeSeries {
+public:
+    #if defined(AMS_REMOTE_DEBUG)
+    AmsTimeSeries(RemoteDebug*);
+    #else
+    AmsTimeSeries(Stream*);
+    #endif
+    bool update(AmsRollup& rollup);
+    bool load();
+    bool flush();
+    uint16_t query(time_t from, time_t to, TimeSeriesRecord* target, uint16_t size);
+
+private:
+    TimeSeriesRecord buffer[TIMESERIES_BUFFER];
+    uint8_t buffered = 0;
+    uint32_t lastTimestamp = 0;
+
+    #if defined(AMS_REMOTE_DEBUG)
+    RemoteDebug* debugger;
+    #else
+    Stream* debugger;
+    #endif
+
+    void getSegmentPath(uint32_t day, char* path);
+    bool readHeader(File& file, uint32_t day);
+    uint16_t findFirst(File& file, uint16_t count, uint32_t timestamp);
+};
+
+#endif
@@ -11,9 +11,9 @@
 #include "FirmwareVersion.h"
 
 #if defined(AMS_REMOTE_DEBUG)
-AmsDataStorage::AmsDataStorage(RemoteDebug* debugger) {
+AmsDataStorage::AmsDataStorage(RemoteDebug* debugger) : dayFile(FILE_DAYPLOT), monthFile(FILE_MONTHPLOT), quarterFile(FILE_QUARTERPLOT) {
 #else
-AmsDataStorage::AmsDataStorage(Stream* debugger) {
+AmsDataStorage::AmsDataStorage(Stream* debugger) : dayFile(FILE_DAYPLOT), monthFile(FILE_MONTHPLOT), quarterFile(FILE_QUARTERPLOT) {
 #endif
     day.version = 6;
     day.accuracy = 1;
@@ -374,16 +374,139 @@ uint32_t AmsDataStorage::getDayExport(uint8_t day) {
     return (month.dExport[day-1] * pow(10, month.accuracy));
 }
 
+// Called for every frame, stores the quarter hour from the rollup once it closes
+// The hour that just closed in the rollup goes into the day plot. The first hour after boot
+// is not complete and is left to update(), which fills it from the meter counters.
+bool AmsDataStorage::updateHour(AmsRollup& rollup) {
+    if(tz == NULL || !rollup.isClosed(RollupTierHour)) {
+        return false;
+    }
+    RollupAggregate* h = rollup.getLast(RollupTierHour);
+    if(h == NULL || !h->complete || h->start < FirmwareVersion::BuildEpoch) {
+        return false;
+    }
+
+    tmElements_t tm;
+    breakTime(h->start, tm);
+    setHourImport(tm.Hour, AmsRollup::getImportWh(h));
+    setHourExport(tm.Hour, AmsRollup::getExportWh(h));
+
+    // Where update() carries on from if the rollup has a gap
+    day.lastMeterReadTime = rollup.getCurrent(RollupTierHour)->start;
+    if(rollup.hasCounters()) {
+        day.activeImport = h->importEnd / 1000;
+        day.activeExport = h->exportEnd / 1000;
+    }
+    return true;
+}
+
+// As updateHour(), for the day that just closed and the month plot
+bool AmsDataStorage::updateDay(AmsRollup& rollup) {
+    if(tz == NULL || !rollup.isClosed(RollupTierDay)) {
+        return false;
+    }
+    RollupAggregate* d = rollup.getLast(RollupTierDay);
+    if(d == NULL || !d->complete || d->start < FirmwareVersion::BuildEpoch) {
+        return false;
+    }
+
+    tmElements_t tm;
+    breakTime(tz->toLocal(d->start), tm);
+    setDayImport(tm.Day, AmsRollup::getImportWh(d));
+    setDayExport(tm.Day, AmsRollup::getExportWh(d));
+
+    month.lastMeterReadTime = rollup.getCurrent(RollupTierDay)->start;
+    if(rollup.hasCounters()) {
+        month.activeImport = d->importEnd / 1000;
+        month.activeExport = d->exportEnd / 1000;
+    }
+    return true;
+}
+
+bool AmsDataStorage::updateQuarter(AmsRollup& rollup) {
+    if(tz == NULL || !rollup.isClosed(RollupTierQuarter)) {
+        return false;
+    }
+    RollupAggregate* q = rollup.getLast(RollupTierQuarter);
+    if(q == NULL || !q->complete || q->start < FirmwareVersion::BuildEpoch) {
+        return false;
+    }
+
+    time_t dayStart = getLocalMidnight(q->start, 0);
+    if(dayStart != quarter.dayStart) {
+        memset(quarter.qImport, 0, sizeof(quarter.qImport));
+        memset(quarter.qExport, 0, sizeof(quarter.qExport));
+        memset(quarter.filled, 0, sizeof(quarter.filled));
+        quarter.accuracy = 0;
+        quarter.dayStart = dayStart;
+    }
+    uint32_t slot = (q->start - dayStart) / 900;
+    if(slot >= QUARTER_SLOTS) {
+        return false;
+    }
+    setQuarter(slot, AmsRollup::getImportWh(q), AmsRollup::getExportWh(q));
+    return true;
+}
+
+void AmsDataStorage::setQuarter(uint8_t slot, uint32_t importWh, uint32_t exportWh) {
+    uint8_t accuracy = quarter.accuracy;
+    while(max(importWh, exportWh) / pow(10, accuracy) > UINT16_MAX) {
+        accuracy++;
+    }
+    if(accuracy != quarter.accuracy) {
+        double multiplier = pow(10, quarter.accuracy)/pow(10, accuracy);
+        for(uint8_t i = 0; i < QUARTER_SLOTS; i++) {
+            quarter.qImport[i] = quarter.qImport[i] * multiplier;
+            quarter.qExport[i] = quarter.qExport[i] * multiplier;
+        }
+        quarter.accuracy = accuracy;
+    }
+    quarter.qImport[slot] = importWh / pow(10, accuracy);
+    quarter.qExport[slot] = exportWh / pow(10, accuracy);
+    quarter.filled[slot / 32] |= 1UL << (slot % 32);
+}
+
+time_t AmsDataStorage::getQuarterDayStart() {
+    return quarter.dayStart;
+}
+
+// 92 on the day DST starts, 100 on the day it ends
+uint8_t AmsDataStorage::getQuarterCount() {
+    if(quarter.dayStart == 0) return 0;
+    return (getLocalMidnight(quarter.dayStart, 1) - quarter.dayStart) / 900;
+}
+
+bool AmsDataStorage::hasQuarter(uint8_t slot) {
+    if(slot >= QUARTER_SLOTS) return false;
+    return (quarter.filled[slot / 32] & (1UL << (slot % 32))) != 0;
+}
+
+uint32_t AmsDataStorage::getQuarterImport(uint8_t slot) {
+    if(!hasQuarter(slot)) return 0;
+    return quarter.qImport[slot] * pow(10, quarter.accuracy);
+}
+
+uint32_t AmsDataStorage::getQuarterExport(uint8_t slot) {
+    if(!hasQuarter(slot)) return 0;
+    return quarter.qExport[slot] * pow(10, quarter.accuracy);
+}
+
+// UTC time of local midnight, days from the one now is in
+time_t AmsDataStorage::getLocalMidnight(time_t now, int8_t days) {
+    tmElements_t tm;
+    time_t local = tz->toLocal(now);
+    breakTime(local, tm);
+    return tz->toUTC(local - (tm.Hour * 3600) - (tm.Minute * 60) - tm.Second + (days * 86400));
+}
+
 bool AmsDataStorage::load() {
     if(!LittleFS.begin()) {
         return false;
     }
 
     bool ret = false;
-    if(LittleFS.exists(FILE_DAYPLOT)) {
-        File file = LittleFS.open(FILE_DAYPLOT, "r");
-        char buf[file.size()];
-        file.readBytes(buf, file.size());
+    uint8_t buf[sizeof(QuarterDataPoints) + sizeof(AmsFileTrailer)];
+    if(dayFile.read(buf, sizeof(DayDataPoints) + sizeof(AmsFileTrailer)) > 0) {
         if(buf[0] > 5) {
             DayDataPoints* day = (DayDataPoints*) buf;
             ret = setDayData(*day);
@@ -401,13 +524,9 @@ bool AmsDataStorage::load() {
 
             ret = setDayData(day);
         }
-        file.close();
     }
 
-    if(LittleFS.exists(FILE_MONTHPLOT)) {
-        File file = LittleFS.open(FILE_MONTHPLOT, "r");
-        char buf[file.size()];
-        file.readBytes(buf, file.size());
+    if(monthFile.read(buf, sizeof(MonthDataPoints) + sizeof(AmsFileTrailer)) > 0) {
         if(buf[0] > 6) {
             MonthDataPoints* month = (MonthDataPoints*) buf;
             ret &= setMonthData(*month);
@@ -425,7 +544,10 @@ bool AmsDataStorage::load() {
 
             ret &= setMonthData(month);
         }
-        file.close();
+    }
+
+    if(quarterFile.read(buf, sizeof(buf)) == sizeof(QuarterDataPoints) && buf[0] == quarter.version) {
+        memcpy(&quarter, buf, sizeof(quarter));
     }
 
     return ret;
@@ -435,25 +557,32 @@ bool AmsDataStorage::save() {
     if(!LittleFS.begin()) {
         return false;
     }
-    {
-        File file = LittleFS.open(FILE_DAYPLOT, "w");
-        char buf[sizeof(day)];
-        memcpy(buf, &day, sizeof(day));
-        for(unsigned long i = 0; i < sizeof(day); i++) {
-            file.write(buf[i]);
-        }
-        file.close();
-    }
-    {
-        File file = LittleFS.open(FILE_MONTHPLOT, "w");
-        char buf[sizeof(month)];
-        memcpy(buf, &month, sizeof(month));
-        for(unsigned long i = 0; i < sizeof(month); i++) {
-            file.write(buf[i]);
-        }
-        file.close();
+    savePending = false;
+    bool ret = dayFile.write((uint8_t*) &day, sizeof(day));
+    ret &= monthFile.write((uint8_t*) &month, sizeof(month));
+    ret &= quarterFile.write((uint8_t*) &quarter, sizeof(quarter));
+    if(!ret) {
+#if defined(AMS_REMOTE_DEBUG)
+if (debugger->isActive(RemoteDebug::ERROR))
+#endif
+debugger->printf_P(PSTR("(AmsDataStorage) Unable to save data\n"));
     }
-    return true;
+    return ret;
+}
+
+// Saves requested close together are written once, when the first one is old enough
+void AmsDataStorage::requestSave() {
+    if(!savePending) {
+        saveRequested = millis();
+        savePending = true;
+    }
+}
+
+bool AmsDataStorage::loop() {
+    if(savePending && millis() - saveRequested >= AMSFILE_SAVE_DELAY) {
+        return save();
+    }
+    return false;
 }
 
 DayDataPoints AmsDataStorage::getDayData() {
@@ -0,0 +1,91 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#include "AmsFile.h"
+#include "LittleFS.h"
+#include "crc.h"
+
+AmsFile::AmsFile(const char* path) {
+    this->path = path;
+}
+
+// Returns the length of the record, or -1 if there is none or it fails the CRC check. Files
+// written before the trailer was added are returned as they are.
+int16_t AmsFile::read(uint8_t* buf, uint16_t size) {
+    bool checked = false;
+    int16_t len = readFile(path, buf, size, checked);
+    if(len < 0) {
+        // Power lost after the temporary file was complete, but before it was renamed. It was
+        // written with a trailer, so one without is cut short and not a file from old firmware.
+        char tmp[32];
+        getTempPath(tmp, sizeof(tmp));
+        len = readFile(tmp, buf, size, checked);
+        if(len < 0 || !checked || !LittleFS.rename(tmp, path)) {
+            return -1;
+        }
+    }
+    // Without a trailer on flash, the next write has to add one even if the record is the same
+    crc = crc16_x25(buf, len);
+    stored = checked;
+    return len;
+}
+
+bool AmsFile::write(const uint8_t* buf, uint16_t len) {
+    AmsFileTrailer trailer = { AMSFILE_MAGIC, crc16_x25(buf, len) };
+    if(stored && trailer.crc == crc) {
+        return true;
+    }
+
+    char tmp[32];
+    getTempPath(tmp, sizeof(tmp));
+    File file = LittleFS.open(tmp, "w");
+    if(!file) {
+        return false;
+    }
+    bool ret = file.write(buf, len) == len;
+    ret &= file.write((uint8_t*) &trailer, sizeof(trailer)) == sizeof(trailer);
+    file.close();
+    if(!ret || !LittleFS.rename(tmp, path)) {
+        LittleFS.remove(tmp);
+        return false;
+    }
+    crc = trailer.crc;
+    stored = true;
+    return true;
+}
+
+int16_t AmsFile::readFile(const char* path, uint8_t* buf, uint16_t size, bool& checked) {
+    if(!LittleFS.exists(path)) {
+        return -1;
+    }
+    File file = LittleFS.open(path, "r");
+    size_t len = file.size();
+    if(len == 0 || len > size || file.read(buf, len) != len) {
+        file.close();
+        return -1;
+    }
+    file.close();
+
+    checked = false;
+    if(len <= sizeof(AmsFileTrailer)) {
+        return len;
+    }
+    AmsFileTrailer trailer;
+    memcpy(&trailer, buf + len - sizeof(trailer), sizeof(trailer));
+    if(trailer.magic != AMSFILE_MAGIC) {
+        return len;
+    }
+    len -= sizeof(trailer);
+    if(crc16_x25(buf, len) != trailer.crc) {
+        return -1;
+    }
+    checked = true;
+    return len;
+}
+
+void AmsFile::getTempPath(char* buf, uint8_t size) {
+    snprintf_P(buf, size, PSTR("%s.tmp"), path);
+}
@@ -0,0 +1,266 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#include "AmsHistory.h"
+#include "LittleFS.h"
+#include "AmsStorage.h"
+#include "FirmwareVersion.h"
+
+static uint32_t zigzag(int32_t val) {
+    return ((uint32_t) val << 1) ^ (uint32_t) (val >> 31);
+}
+
+static int32_t unzigzag(uint32_t val) {
+    return (int32_t) (val >> 1) ^ -(int32_t) (val & 1);
+}
+
+#if defined(AMS_REMOTE_DEBUG)
+AmsHistory::AmsHistory(RemoteDebug* debugger) {
+#else
+AmsHistory::AmsHistory(Stream* debugger) {
+#endif
+    this->debugger = debugger;
+    memset(&current, 0, sizeof(current));
+}
+
+uint8_t AmsHistory::putVarint(uint8_t* buf, uint32_t val) {
+    uint8_t len = 0;
+    while(val >= 0x80) {
+        buf[len++] = (val & 0x7F) | 0x80;
+        val >>= 7;
+    }
+    buf[len++] = val;
+    return len;
+}
+
+// Returns the number of bytes used, 0 if the varint runs past len
+uint8_t AmsHistory::getVarint(const uint8_t* buf, uint16_t len, uint32_t& val) {
+    val = 0;
+    for(uint8_t i = 0; i < 5 && i < len; i++) {
+        val |= (uint32_t) (buf[i] & 0x7F) << (7 * i);
+        if((buf[i] & 0x80) == 0) return i + 1;
+    }
+    return 0;
+}
+
+// Called for every frame, appends the hour from the rollup once it closes. The position is the
+// meter counter when there is one. Otherwise the energy of the hour is added to the last position,
+// as the integrated energy in the rollup starts from zero again after a reboot.
+bool AmsHistory::update(AmsRollup& rollup) {
+    if(!rollup.isClosed(RollupTierHour)) {
+        return false;
+    }
+    RollupAggregate* hour = rollup.getLast(RollupTierHour);
+    if(hour == NULL || !hour->complete || hour->start < FirmwareVersion::BuildEpoch) {
+        return false;
+    }
+    if(rollup.hasCounters()) {
+        return append(hour->start, hour->importEnd / 1000, hour->exportEnd / 1000);
+    }
+    return append(hour->start, lastImport + AmsRollup::getImportWh(hour), lastExport + AmsRollup::getExportWh(hour));
+}
+
+// Takes the import and export positions at the end of the hour, not the energy in it
+bool AmsHistory::append(time_t hour, uint32_t importWh, uint32_t exportWh) {
+    hour -= hour % 3600;
+    if(current.header.count > 0 && (uint32_t) hour <= lastHour) {
+        return false;
+    }
+
+    uint8_t entry[15];
+    uint8_t len = 0;
+    uint32_t skip = current.header.count > 0 ? ((hour - lastHour) / 3600) - 1 : 0;
+    uint32_t imp = zigzag((int32_t) (importWh - lastImport)) << 1;
+    len += putVarint(entry, skip > 0 ? imp | 1 : imp);
+    if(skip > 0) len += putVarint(entry + len, skip);
+    len += putVarint(entry + len, zigzag((int32_t) (exportWh - lastExport)));
+
+    // Start the next block, which begins from zero again so it can be decoded on its own
+    if(current.header.used + len > sizeof(current.data)) {
+        currentSlot = (currentSlot + 1) % HISTORY_BLOCKS;
+        memset(&current, 0, sizeof(current));
+        lastImport = lastExport = 0;
+
+        len = putVarint(entry, zigzag((int32_t) importWh) << 1);
+        len += putVarint(entry + len, zigzag((int32_t) exportWh));
+    }
+    if(current.header.count == 0) {
+        current.header.start = hour;
+    }
+
+    memcpy(current.data + current.header.used, entry, len);
+    current.header.used += len;
+    current.header.count++;
+    lastHour = hour;
+    lastImport = importWh;
+    lastExport = exportWh;
+    return writeBlock();
+}
+
+// Finds the newest block and carries on from its last hour
+bool AmsHistory::load() {
+    if(!LittleFS.begin()) {
+        return false;
+    }
+    if(!LittleFS.exists(FILE_HISTORY)) {
+        return true;
+    }
+
+    File file = LittleFS.open(FILE_HISTORY, "r");
+    blocks = min((uint16_t) (file.size() / HISTORY_BLOCK_SIZE), (uint16_t) HISTORY_BLOCKS);
+    uint32_t newest = 0;
+    for(uint16_t i = 0; i < blocks; i++) {
+        HistoryBlockHeader header;
+        file.seek(i * HISTORY_BLOCK_SIZE);
+        if(file.read((uint8_t*) &header, sizeof(header)) != sizeof(header)) break;
+        if(header.count > 0 && header.start > newest) {
+            newest = header.start;
+            currentSlot = i;
+        }
+    }
+    file.close();
+
+    if(newest == 0 || !readBlock(currentSlot, current)) {
+        memset(&current, 0, sizeof(current));
+        return true;
+    }
+
+    // The newest block is always the last one seen from the cursor
+    AmsHistoryCursor cursor(this);
+    HistoryPoint point;
+    if(cursor.loadBlock(blocks - 1)) {
+        while(cursor.next(point)) {
+            lastHour = point.timestamp;
+            lastImport = point.importWh;
+            lastExport = point.exportWh;
+        }
+    }
+    return true;
+}
+
+uint16_t AmsHistory::getBlockCount() {
+    return blocks;
+}
+
+uint16_t AmsHistory::getOldestSlot() {
+    return blocks < HISTORY_BLOCKS ? 0 : (currentSlot + 1) % HISTORY_BLOCKS;
+}
+
+bool AmsHistory::readBlock(uint16_t slot, HistoryBlock& block) {
+    if(slot >= blocks || !LittleFS.begin()) {
+        return false;
+    }
+    File file = LittleFS.open(FILE_HISTORY, "r");
+    file.seek(slot * HISTORY_BLOCK_SIZE);
+    bool ret = file.read((uint8_t*) &block, sizeof(block)) == sizeof(block) && block.header.used <= sizeof(block.data);
+    file.close();
+    return ret;
+}
+
+// Rewrites the block in place, the file only grows until it has all blocks
+bool AmsHistory::writeBlock() {
+    if(!LittleFS.begin()) {
+        return false;
+    }
+    uint32_t offset = currentSlot * HISTORY_BLOCK_SIZE;
+    File file;
+    if(LittleFS.exists(FILE_HISTORY)) {
+        file = LittleFS.open(FILE_HISTORY, "r+");
+        if(file.size() < offset) {
+            file.close();
+            return false;
+        }
+        file.seek(offset);
+    } else {
+        file = LittleFS.open(FILE_HISTORY, "w");
+    }
+    size_t written = file.write((uint8_t*) &current, sizeof(current));
+    file.close();
+    if(written != sizeof(current)) {
+#if defined(AMS_REMOTE_DEBUG)
+if (debugger->isActive(RemoteDebug::WARNING))
+#endif
+debugger->printf_P(PSTR("(AmsHistory) Only wrote %lu of %lu bytes\n"), (unsigned long) written, (unsigned long) sizeof(current));
+        return false;
+    }
+    if(currentSlot >= blocks) {
+        blocks = currentSlot + 1;
+    }
+    return true;
+}
+
+AmsHistoryCursor::AmsHistoryCursor(AmsHistory* history) {
+    this->history = history;
+    memset(&block, 0, sizeof(block));
+}
+
+// Binary search on the block headers for the last block starting at or before from
+bool AmsHistoryCursor::seek(time_t from) {
+    uint16_t lo = 0, hi = history->blocks;
+    if(hi == 0) return false;
+    while(hi - lo > 1) {
+        uint16_t mid = (lo + hi) / 2;
+        if(!loadBlock(mid)) return false;
+        if(block.header.start <= (uint32_t) from) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    if(!loadBlock(lo)) return false;
+    this->from = from;
+    return true;
+}
+
+bool AmsHistoryCursor::next(HistoryPoint& point) {
+    while(true) {
+        if(entry >= block.header.count) {
+            if(!loadBlock(blockIdx + 1)) return false;
+            continue;
+        }
+
+        uint32_t imp, exp, skip = 0;
+        uint8_t len = AmsHistory::getVarint(block.data + pos, block.header.used - pos, imp);
+        if(len == 0) return false;
+        pos += len;
+        if(imp & 1) {
+            len = AmsHistory::getVarint(block.data + pos, block.header.used - pos, skip);
+            if(len == 0) return false;
+            pos += len;
+        }
+        len = AmsHistory::getVarint(block.data + pos, block.header.used - pos, exp);
+        if(len == 0) return false;
+        pos += len;
+
+        timestamp = entry == 0 ? block.header.start : timestamp + ((1 + skip) * 3600);
+        importWh += unzigzag(imp >> 1);
+        exportWh += unzigzag(exp);
+        entry++;
+
+        if(timestamp < from) continue;
+        point.timestamp = timestamp;
+        point.importWh = importWh;
+        point.exportWh = exportWh;
+        return true;
+    }
+}
+
+// Index is the age of the block, 0 is the oldest
+bool AmsHistoryCursor::loadBlock(uint16_t idx) {
+    if(idx >= history->blocks) return false;
+    uint16_t slot = (history->getOldestSlot() + idx) % history->blocks;
+    if(slot == history->currentSlot) {
+        memcpy(&block, &history->current, sizeof(block));
+    } else if(!history->readBlock(slot, block)) {
+        return false;
+    }
+    blockIdx = idx;
+    entry = 0;
+    pos = 0;
+    importWh = 0;
+    exportWh = 0;
+    return true;
+}
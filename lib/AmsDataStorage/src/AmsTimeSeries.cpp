@@ -0,0 +1,224 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#include "AmsTimeSeries.h"
+#include "LittleFS.h"
+#include "AmsStorage.h"
+#include "FirmwareVersion.h"
+
+#if defined(AMS_REMOTE_DEBUG)
+AmsTimeSeries::AmsTimeSeries(RemoteDebug* debugger) {
+#else
+AmsTimeSeries::AmsTimeSeries(Stream* debugger) {
+#endif
+    this->debugger = debugger;
+}
+
+// Called for every frame, appends the minute from the rollup once it closes. Returns true
+// when a record was added.
+bool AmsTimeSeries::update(AmsRollup& rollup) {
+    if(!rollup.isClosed(RollupTierMinute)) {
+        return false;
+    }
+
+    // The first minute after boot or a gap does not span the whole interval
+    RollupAggregate* minute = rollup.getLast(RollupTierMinute);
+    if(minute == NULL || !minute->complete) {
+        return false;
+    }
+    if(minute->start < FirmwareVersion::BuildEpoch || (uint32_t) minute->start <= lastTimestamp) {
+        // Clock went backwards, the segments must stay sorted so drop it
+        return false;
+    }
+
+    // mWh over the interval to average W
+    uint32_t importPower = (uint64_t) (minute->importEnd - minute->importStart) * 3600 / (TIMESERIES_INTERVAL * 1000);
+    uint32_t exportPower = (uint64_t) (minute->exportEnd - minute->exportStart) * 3600 / (TIMESERIES_INTERVAL * 1000);
+    if(minute->importEnd < minute->importStart) importPower = 0;
+    if(minute->exportEnd < minute->exportStart) exportPower = 0;
+
+    if(buffered == TIMESERIES_BUFFER && !flush()) {
+        // The flash keeps failing, the oldest record makes room
+        memmove(buffer, buffer + 1, (TIMESERIES_BUFFER - 1) * sizeof(TimeSeriesRecord));
+        buffered--;
+    }
+
+    TimeSeriesRecord& record = buffer[buffered++];
+    record.timestamp = minute->start;
+    record.activeImport = rollup.hasCounters() ? minute->importEnd / 1000 : 0;
+    record.activeExport = rollup.hasCounters() ? minute->exportEnd / 1000 : 0;
+    record.importPower = min(importPower, (uint32_t) UINT16_MAX);
+    record.exportPower = min(exportPower, (uint32_t) UINT16_MAX);
+    lastTimestamp = record.timestamp;
+
+    if(buffered == TIMESERIES_BUFFER) {
+        flush();
+    }
+    return true;
+}
+
+// Finds the newest record on flash, so that appends after a reboot stay in order
+bool AmsTimeSeries::load() {
+    if(!LittleFS.begin()) {
+        return false;
+    }
+
+    char path[16];
+    for(uint8_t i = 0; i < TIMESERIES_SEGMENTS; i++) {
+        getSegmentPath(i, path);
+        if(!LittleFS.exists(path)) continue;
+
+        File file = LittleFS.open(path, "r");
+        TimeSeriesSegmentHeader header;
+        if(file.read((uint8_t*) &header, sizeof(header)) == sizeof(header) && header.version == TIMESERIES_VERSION && header.recordSize == sizeof(TimeSeriesRecord)) {
+            uint16_t count = (file.size() - sizeof(header)) / sizeof(TimeSeriesRecord);
+            if(count > 0) {
+                TimeSeriesRecord last;
+                file.seek(sizeof(header) + (count - 1) * sizeof(TimeSeriesRecord));
+                if(file.read((uint8_t*) &last, sizeof(last)) == sizeof(last) && last.timestamp > lastTimestamp) {
+                    lastTimestamp = last.timestamp;
+                }
+            }
+        }
+        file.close();
+    }
+    return true;
+}
+
+// Appends the buffered records to their segments, one write per segment. A segment that
+// still holds an older day is truncated, which is how the oldest day rotates out. Returns
+// false if a write came up short, the records that did not make it stay buffered.
+bool AmsTimeSeries::flush() {
+    if(buffered == 0) {
+        return true;
+    }
+    if(!LittleFS.begin()) {
+        return false;
+    }
+
+    char path[16];
+    uint8_t i = 0;
+    while(i < buffered) {
+        uint32_t day = buffer[i].timestamp / TIMESERIES_SEGMENT_SECONDS;
+        uint8_t n = 1;
+        while(i + n < buffered && buffer[i + n].timestamp / TIMESERIES_SEGMENT_SECONDS == day) n++;
+
+        getSegmentPath(day, path);
+        bool append = false;
+        size_t end = 0;
+        if(LittleFS.exists(path)) {
+            File file = LittleFS.open(path, "r");
+            if(readHeader(file, day)) {
+                append = true;
+                // A partial record from an earlier short write would misalign everything after it,
+                // so it is written over
+                end = file.size() - (file.size() - sizeof(TimeSeriesSegmentHeader)) % sizeof(TimeSeriesRecord);
+                if(end == file.size()) end = 0;
+            }
+            file.close();
+        }
+
+        File file = LittleFS.open(path, !append ? "w" : end > 0 ? "r+" : "a");
+        size_t written = 0;
+        if(!append) {
+            TimeSeriesSegmentHeader header = { TIMESERIES_VERSION, TIMESERIES_INTERVAL, sizeof(TimeSeriesRecord), day };
+            if(file.write((uint8_t*) &header, sizeof(header)) == sizeof(header)) {
+                written = file.write((uint8_t*) &buffer[i], n * sizeof(TimeSeriesRecord));
+            }
+        } else {
+            if(end > 0) file.seek(end);
+            written = file.write((uint8_t*) &buffer[i], n * sizeof(TimeSeriesRecord));
+        }
+        file.close();
+
+        size_t len = n * sizeof(TimeSeriesRecord);
+        if(written != len) {
+#if defined(AMS_REMOTE_DEBUG)
+if (debugger->isActive(RemoteDebug::WARNING))
+#endif
+debugger->printf_P(PSTR("(AmsTimeSeries) Only wrote %d of %d bytes to %s\n"), written, len, path);
+            // Whole records that made it are on flash, the rest is tried again on the next flush
+            uint8_t done = i + written / sizeof(TimeSeriesRecord);
+            memmove(buffer, buffer + done, (buffered - done) * sizeof(TimeSeriesRecord));
+            buffered -= done;
+            return false;
+        }
+        i += n;
+    }
+    buffered = 0;
+    return true;
+}
+
+// Fills target with up to max records in [from, to], oldest first. The segment is found
+// from the day, and the first record within it by binary search, so callers can page
+// through a long range by moving from past the last record returned.
+uint16_t AmsTimeSeries::query(time_t from, time_t to, TimeSeriesRecord* target, uint16_t size) {
+    uint16_t count = 0;
+    if(to < from || size == 0) {
+        return 0;
+    }
+
+    uint32_t newest = lastTimestamp / TIMESERIES_SEGMENT_SECONDS;
+    uint32_t oldest = newest >= TIMESERIES_SEGMENTS ? newest - TIMESERIES_SEGMENTS + 1 : 0;
+    uint32_t firstDay = max((uint32_t) (from / TIMESERIES_SEGMENT_SECONDS), oldest);
+    uint32_t lastDay = min((uint32_t) (to / TIMESERIES_SEGMENT_SECONDS), newest);
+
+    if(lastTimestamp > 0 && LittleFS.begin()) {
+        char path[16];
+        for(uint32_t day = firstDay; day <= lastDay && count < size; day++) {
+            getSegmentPath(day, path);
+            if(!LittleFS.exists(path)) continue;
+
+            File file = LittleFS.open(path, "r");
+            if(readHeader(file, day)) {
+                uint16_t records = (file.size() - sizeof(TimeSeriesSegmentHeader)) / sizeof(TimeSeriesRecord);
+                uint16_t idx = findFirst(file, records, from);
+                file.seek(sizeof(TimeSeriesSegmentHeader) + idx * sizeof(TimeSeriesRecord));
+                for(; idx < records && count < size; idx++) {
+                    if(file.read((uint8_t*) &target[count], sizeof(TimeSeriesRecord)) != sizeof(TimeSeriesRecord)) break;
+                    if(target[count].timestamp > to) break;
+                    count++;
+                }
+            }
+            file.close();
+        }
+    }
+
+    // Not yet flushed, always newer than anything on flash
+    for(uint8_t i = 0; i < buffered && count < size; i++) {
+        if(buffer[i].timestamp >= from && buffer[i].timestamp <= to) {
+            target[count++] = buffer[i];
+        }
+    }
+    return count;
+}
+
+void AmsTimeSeries::getSegmentPath(uint32_t day, char* path) {
+    snprintf_P(path, 16, PSTR(FILE_TIMESERIES), day % TIMESERIES_SEGMENTS);
+}
+
+bool AmsTimeSeries::readHeader(File& file, uint32_t day) {
+    TimeSeriesSegmentHeader header;
+    if(file.read((uint8_t*) &header, sizeof(header)) != sizeof(header)) return false;
+    return header.version == TIMESERIES_VERSION && header.interval == TIMESERIES_INTERVAL && header.recordSize == sizeof(TimeSeriesRecord) && header.day == day;
+}
+
+// Index of the first record at or after timestamp, count if there is none
+uint16_t AmsTimeSeries::findFirst(File& file, uint16_t count, uint32_t timestamp) {
+    uint16_t lo = 0, hi = count;
+    while(lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        uint32_t ts = 0;
+        file.seek(sizeof(TimeSeriesSegmentHeader) + mid * sizeof(TimeSeriesRecord));
+        if(file.read((uint8_t*) &ts, sizeof(ts)) != sizeof(ts)) return count;
+        if(ts < timestamp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
@@ -0,0 +1,66 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _COSEMINDEX_H
+#define _COSEMINDEX_H
+
+#include "Arduino.h"
+#include "Cosem.h"
+
+#define COSEM_INDEX_SIZE 255
+#define COSEM_OBIS_MAP_SIZE 64
+#define COSEM_MAX_SCAN 900
+// Room for the list layouts of each meter sharing the cache
+#if defined(CONFIG_IDF_TARGET_ESP32)
+#define COSEM_LAYOUT_CACHE_SIZE 6
+#else
+#define COSEM_LAYOUT_CACHE_SIZE 3
+#endif
+
+// Walks a COSEM structure once and remembers where each item starts, so that items can be
+// looked up by position or by the OBIS code preceding them without rescanning the payload.
+class CosemIndex {
+public:
+    void build(const char* ptr, uint16_t length);
+    bool matches(const char* ptr, uint16_t length);
+    CosemData* getAt(uint8_t index);
+    CosemData* find(const uint8_t* obis);
+    uint8_t getCount();
+    bool isObisMapFull();
+
+    static uint16_t itemSize(CosemData* item);
+
+private:
+    const char* ptr = NULL;
+    uint16_t limit = 0; // Bytes of the payload that may be read, never more than COSEM_MAX_SCAN
+    uint16_t offsets[COSEM_INDEX_SIZE];
+    uint8_t count = 0;
+    uint16_t end = 0;
+    uint32_t signature = 0; // Hash of type tags and lengths, the layout of the list
+    uint8_t obisMap[COSEM_OBIS_MAP_SIZE]; // Position of OBIS octet string + 1, 0 is empty slot
+    bool obisMapFull = false; // Some OBIS codes did not fit in the map, find() has to scan for them
+
+    uint8_t obisHash(const uint8_t* obis);
+    uint32_t signatureAdd(uint32_t hash, CosemData* item);
+    bool obisMatch(uint16_t offset, const uint8_t* obis);
+    uint16_t itemSizeAt(uint16_t pos);
+};
+
+// Meters send the same few list layouts over and over. Keeps the index of the last seen
+// layouts so a frame with a known layout only needs to be verified, not indexed again.
+class CosemLayoutCache {
+public:
+    CosemIndex* get(const char* ptr, uint16_t length);
+    uint32_t getHits();
+    uint32_t getMisses();
+
+private:
+    CosemIndex slots[COSEM_LAYOUT_CACHE_SIZE];
+    uint8_t next = 0;
+    uint32_t hits = 0, misses = 0;
+};
+
+#endif
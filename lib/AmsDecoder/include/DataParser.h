@@ -31,11 +31,14 @@
 #define DATA_PARSE_FINAL_SEGMENT -7
 #define DATA_PARSE_UNKNOWN_DATA -9
 
+class DataSegments;
+
 struct DataParserContext {
     uint8_t type;
     uint16_t length;
     time_t timestamp;
     uint8_t system_title[8];
+    DataSegments* segments; // Where segmented frames record their payloads, NULL if not supported
 };
 
 #endif
@@ -14,6 +14,9 @@
 #include "GbtParser.h"
 #include "GcmParser.h"
 #include "LlcParser.h"
+#include "FrameAssembler.h"
+#include "CosemIndex.h"
+#include "FrameDigest.h"
 
 #endif
 
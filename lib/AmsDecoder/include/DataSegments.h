@@ -0,0 +1,43 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _DATASEGMENTS_H
+#define _DATASEGMENTS_H
+
+#include "Arduino.h"
+
+#define DATA_SEGMENTS_MAX 16
+
+// Scatter list for a segmented APDU. Each frame stays in the receive buffer where it arrived
+// and the segment parsers only record where its payload is, as an (offset, length) view. The
+// views are gathered into one contiguous APDU once, when the final segment is in, as the
+// decoders need it in one piece.
+class DataSegments {
+public:
+    void setBuffer(uint8_t* buf, uint16_t size);
+    void begin();
+    bool add(const uint8_t* payload, uint16_t length);
+    uint8_t getCount();
+    uint16_t getLength();
+
+    // Moves the payloads together at the start of the buffer and leaves one view covering
+    // them. Returns the APDU length, or 0 if there was nothing to gather.
+    uint16_t gather();
+
+private:
+    struct View {
+        uint16_t offset;
+        uint16_t length;
+    };
+
+    uint8_t* buf = NULL;
+    uint16_t size = 0;
+    View views[DATA_SEGMENTS_MAX];
+    uint8_t count = 0;
+    uint16_t length = 0;
+};
+
+#endif
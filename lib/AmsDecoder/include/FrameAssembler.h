@@ -0,0 +1,31 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _FRAMEASSEMBLER_H
+#define _FRAMEASSEMBLER_H
+
+#include "Arduino.h"
+#include "DataParser.h"
+
+// Keeps track of how far into the outer frame (HDLC, M-Bus or DSMR) we are, so that the
+// layer parsers only have to run once the whole frame has been received.
+class FrameAssembler {
+public:
+    void reset();
+    int8_t append(const uint8_t *buf, uint16_t length);
+    // True when the frame just completed is HDLC and its FCS has been checked
+    bool isVerified() { return verified; }
+
+private:
+    uint8_t tag = DATA_TAG_NONE;
+    uint16_t expected = 0;
+    uint8_t lastByte = 0x00;
+    bool endSeen = false;
+    bool verified = false;
+    uint16_t crc = 0;
+};
+
+#endif
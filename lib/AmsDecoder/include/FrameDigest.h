@@ -0,0 +1,31 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _FRAMEDIGEST_H
+#define _FRAMEDIGEST_H
+
+#include "Arduino.h"
+#include "DataParser.h"
+
+// Remembers a hash of the last application payload, so that a frame identical to the previous
+// one can be recognized without decoding it again.
+class FrameDigest {
+public:
+    bool matches(const uint8_t* payload, DataParserContext &ctx);
+    void invalidate();
+    uint32_t getHits();
+    uint32_t getMisses();
+
+private:
+    bool valid = false;
+    uint8_t type = DATA_TAG_NONE;
+    uint16_t length = 0;
+    time_t timestamp = 0;
+    uint32_t hash = 0;
+    uint32_t hits = 0, misses = 0;
+};
+
+#endif
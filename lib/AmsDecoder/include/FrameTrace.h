@@ -0,0 +1,60 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _FRAMETRACE_H
+#define _FRAMETRACE_H
+
+#include "Arduino.h"
+
+// Size must be a power of two, positions are kept as free running counters
+#if defined(ESP32)
+#define FRAME_TRACE_SIZE 4096
+#define FRAME_TRACE_MAX_DATA 1024
+#else
+#define FRAME_TRACE_SIZE 1024
+#define FRAME_TRACE_MAX_DATA 512
+#endif
+
+enum FrameTraceKind {
+    FrameTraceLayer = 1, // A layer that was unwrapped
+    FrameTracePayload = 2, // Application data handed to the decoders
+    FrameTraceError = 3 // Bytes received when unwrapping failed
+};
+
+struct FrameTraceHeader {
+    uint32_t millis;
+    uint16_t length; // Length of the data when recorded
+    uint16_t stored; // Bytes following the header
+    uint8_t kind;
+    uint8_t tag;
+    int8_t result;
+} __attribute__((packed));
+
+// Position of a reader in the trace. Starts at the oldest record still in the buffer.
+struct FrameTraceCursor {
+    uint32_t pos = 0;
+    uint16_t offset = 0;
+};
+
+// Fixed size ring of raw frames and parse results. Recording is a copy of the header and the
+// data, all formatting is left to whoever reads the trace. The oldest records are overwritten.
+class FrameTrace {
+public:
+    void record(uint8_t kind, uint8_t tag, int8_t result, const uint8_t* data, uint16_t length);
+    uint16_t format(char* out, uint16_t size, FrameTraceCursor& cursor);
+    uint32_t getRecords();
+
+private:
+    uint8_t buf[FRAME_TRACE_SIZE];
+    uint32_t head = 0; // Total number of bytes written
+    uint32_t tail = 0; // Where the oldest record starts, on the same scale as head
+    uint32_t records = 0;
+
+    void put(uint32_t pos, const void* src, uint16_t length);
+    void get(uint32_t pos, void* dst, uint16_t length);
+};
+
+#endif
@@ -9,6 +9,7 @@
 
 #include "Arduino.h"
 #include "DataParser.h"
+#include "DataSegments.h"
 
 #define GBT_TAG 0xE0
 
@@ -25,8 +26,6 @@ public:
     int8_t parse(uint8_t *buf, DataParserContext &ctx);
 private:
     uint8_t lastSequenceNumber = 0;
-    uint16_t pos = 0;
-    uint8_t *buf  = NULL;
 };
 
 #endif
@@ -9,6 +9,13 @@
 
 #include "Arduino.h"
 #include "DataParser.h"
+#if defined(ESP8266)
+#include "bearssl/bearssl.h"
+#elif defined(ESP32) || defined(AMS_NATIVE_MBEDTLS)
+// The host build uses the system mbedtls when it has one
+#define GCM_MBEDTLS
+#include "mbedtls/gcm.h"
+#endif
 
 #define GCM_TAG 0xDB
 #define GCM_AUTH_FAILED -51
@@ -18,10 +25,25 @@
 class GCMParser {
 public:
     GCMParser(uint8_t *encryption_key, uint8_t *authentication_key);
+    ~GCMParser();
+    void setKeys(uint8_t *encryption_key, uint8_t *authentication_key);
     int8_t parse(uint8_t *buf, DataParserContext &ctx);
 private:
     uint8_t encryption_key[16];
     uint8_t authentication_key[16];
+    bool hasAuthenticationKey = false;
+
+    // Key schedule is expanded once and kept until the keys change
+    bool keyReady = false;
+    #if defined(ESP8266)
+    br_aes_ct_ctr_keys bc;
+    br_gcm_context gcmCtx;
+    #elif defined(GCM_MBEDTLS)
+    mbedtls_gcm_context m_ctx;
+    #endif
+
+    bool setupKey();
+    void freeKey();
 };
 
 #endif
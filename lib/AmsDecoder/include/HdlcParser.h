@@ -9,6 +9,7 @@
 
 #include "Arduino.h"
 #include "DataParser.h"
+#include "DataSegments.h"
 
 #define HDLC_FLAG 0x7E
 
@@ -29,12 +30,10 @@ typedef struct HDLC3CtrlHcs {
 
 class HDLCParser {
 public:
-    int8_t parse(uint8_t *buf, DataParserContext &ctx);
+    int8_t parse(uint8_t *buf, DataParserContext &ctx, bool verified);
 
 private:
     uint8_t lastSequenceNumber = 0;
-    uint16_t pos = 0;
-    uint8_t *buf  = NULL;
 };
 
 #endif
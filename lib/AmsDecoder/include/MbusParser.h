@@ -9,6 +9,7 @@
 
 #include "Arduino.h"
 #include "DataParser.h"
+#include "DataSegments.h"
 
 #define MBUS_START 0x68
 #define MBUS_END 0x16
@@ -29,11 +30,8 @@ typedef struct MbusFooter {
 class MBUSParser {
 public:
     int8_t parse(uint8_t *buf, DataParserContext &ctx);
-	uint16_t write(const uint8_t* d, DataParserContext &ctx);
 private:
     uint8_t lastSequenceNumber = 0;
-    uint16_t pos = 0;
-    uint8_t *buf  = NULL;
     uint8_t checksum(const uint8_t* p, int len);
 };
 
@@ -0,0 +1,46 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#ifndef _SERIALAUTODETECT_H
+#define _SERIALAUTODETECT_H
+
+#include "Arduino.h"
+
+// Parity ordinals, as used by MeterConfig.parity, tried for every baud rate
+const uint8_t AUTODETECT_PARITIES[] = { 11, 3, 10 }; // 8E1, 8N1, 7E1
+
+struct SerialAutodetectScore {
+    uint32_t baud;
+    uint8_t parity;
+    bool invert;
+    int32_t score;
+    uint16_t bytes;
+    uint16_t framingErrors;
+    uint16_t parityErrors;
+    uint8_t tagHits;
+    uint8_t checksumPasses;
+};
+
+// Captured RX line: the duration in microseconds of each level the line had, starting with
+// startLevel and alternating from there. Runs longer than 65535us are stored as 65535.
+struct SerialLineCapture {
+    const uint16_t* runs;
+    uint16_t count;
+    bool startLevel;
+};
+
+// Decodes the captured line with the serial parameters given in score and fills in the score.
+// work is scratch space for the decoded bytes.
+void serialAutodetectScore(const SerialLineCapture& line, SerialAutodetectScore& score, uint8_t* work, uint16_t workSize);
+
+// Scores every combination of the given baud rates, AUTODETECT_PARITIES and inversion.
+// Returns false if no combination looked like meter data.
+bool serialAutodetectBest(const SerialLineCapture& line, const uint32_t* bauds, uint8_t baudCount, SerialAutodetectScore& best, uint8_t* work, uint16_t workSize);
+
+// Looks for HDLC, M-Bus and DSMR frames in a decoded byte window
+void serialAutodetectTags(const uint8_t* buf, uint16_t length, uint8_t& tagHits, uint8_t& checksumPasses);
+
+#endif
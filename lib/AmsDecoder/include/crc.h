@@ -14,4 +14,17 @@ uint16_t crc16(const uint8_t* p, int len);
 uint16_t crc16_x25(const uint8_t* p, int len);
 uint16_t crc16_1021(const uint8_t* p, int len);
 
+// Streaming variants, for checksums calculated while data is still arriving
+uint16_t crc16_init();
+uint16_t crc16_update(uint16_t crc, const uint8_t* p, int len);
+uint16_t crc16_final(uint16_t crc);
+
+uint16_t crc16_x25_init();
+uint16_t crc16_x25_update(uint16_t crc, const uint8_t* p, int len);
+uint16_t crc16_x25_final(uint16_t crc);
+
+uint16_t crc16_1021_init();
+uint16_t crc16_1021_update(uint16_t crc, const uint8_t* p, int len);
+uint16_t crc16_1021_final(uint16_t crc);
+
 #endif
@@ -7,7 +7,12 @@
 #ifndef _NTOHLL_H
 #define _NTOHLL_H
 
+#if defined(ESP8266) || defined(ESP32)
 #include "lwip/def.h"
+#else
+// Byte order helpers for building the decoders off-device
+#include <arpa/inet.h>
+#endif
 
 uint64_t ntohll(uint64_t x);
 
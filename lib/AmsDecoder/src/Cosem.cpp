@@ -5,7 +5,7 @@
  */
 
 #include "Cosem.h"
-#include "lwip/def.h"
+#include "ntohll.h"
 #include <TimeLib.h>
 
 time_t decodeCosemDateTime(CosemDateTime timestamp) {
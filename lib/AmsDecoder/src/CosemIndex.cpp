@@ -0,0 +1,193 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "CosemIndex.h"
+
+void CosemIndex::build(const char* ptr, uint16_t length) {
+    this->ptr = ptr;
+    limit = min(length, (uint16_t) COSEM_MAX_SCAN);
+    count = 0;
+    signature = 2166136261UL;
+    memset(obisMap, 0, sizeof(obisMap));
+    obisMapFull = false;
+
+    uint16_t pos = 0;
+    while(count < COSEM_INDEX_SIZE) {
+        uint16_t size = itemSizeAt(pos);
+        if(size == 0) break;
+        CosemData* item = (CosemData*) (ptr + pos);
+        offsets[count] = pos;
+
+        // Only the first occurrence of an OBIS code is used, same as a scan from the start would
+        if(item->base.type == CosemTypeOctetString && item->base.length == 6 && count < COSEM_INDEX_SIZE - 1) {
+            const uint8_t* obis = item->oct.data + 2;
+            uint8_t slot = obisHash(obis);
+            bool placed = false;
+            for(uint8_t i = 0; i < COSEM_OBIS_MAP_SIZE && !placed; i++) {
+                uint8_t s = (slot + i) % COSEM_OBIS_MAP_SIZE;
+                if(obisMap[s] == 0) {
+                    obisMap[s] = count + 1;
+                    placed = true;
+                } else if(obisMatch(offsets[obisMap[s]-1], obis)) {
+                    placed = true;
+                }
+            }
+            if(!placed) obisMapFull = true;
+        }
+
+        signature = signatureAdd(signature, item);
+        pos += size;
+        count++;
+    }
+    end = pos;
+}
+
+// Checks that the payload has the same layout as the one indexed, and if so uses the index for it
+bool CosemIndex::matches(const char* ptr, uint16_t length) {
+    if(count == 0 || length < end) return false;
+    uint32_t hash = 2166136261UL;
+    for(uint8_t i = 0; i < count; i++) {
+        hash = signatureAdd(hash, (CosemData*) (ptr + offsets[i]));
+    }
+    if(hash != signature) return false;
+    this->ptr = ptr;
+    limit = min(length, (uint16_t) COSEM_MAX_SCAN);
+    return true;
+}
+
+CosemData* CosemIndex::getAt(uint8_t index) {
+    if(ptr == NULL) return NULL;
+    if(index < count) return (CosemData*) (ptr + offsets[index]);
+
+    // Outside of what was indexed, continue scanning from where the index stopped
+    uint16_t pos = end;
+    uint16_t i = count;
+    uint16_t size;
+    while((size = itemSizeAt(pos)) > 0) {
+        if(i == index) return (CosemData*) (ptr + pos);
+        pos += size;
+        i++;
+    }
+    return NULL;
+}
+
+CosemData* CosemIndex::find(const uint8_t* obis) {
+    if(ptr == NULL) return NULL;
+    uint8_t slot = obisHash(obis);
+    for(uint8_t i = 0; i < COSEM_OBIS_MAP_SIZE; i++) {
+        uint8_t s = (slot + i) % COSEM_OBIS_MAP_SIZE;
+        if(obisMap[s] == 0) break;
+        uint8_t idx = obisMap[s]-1;
+        if(obisMatch(offsets[idx], obis)) {
+            return getAt(idx+1);
+        }
+    }
+
+    // Not in the map, look through whatever is left of the payload. If the map ran full,
+    // codes may also be missing from the indexed part, so then look from the start.
+    uint16_t pos = obisMapFull ? 0 : end;
+    uint16_t size;
+    while((size = itemSizeAt(pos)) > 0) {
+        CosemData* item = (CosemData*) (ptr + pos);
+        if(item->base.type == CosemTypeOctetString && item->base.length == 6 && obisMatch(pos, obis)) {
+            return itemSizeAt(pos + size) > 0 ? (CosemData*) (ptr + pos + size) : NULL;
+        }
+        pos += size;
+    }
+    return NULL;
+}
+
+uint8_t CosemIndex::getCount() {
+    return count;
+}
+
+bool CosemIndex::isObisMapFull() {
+    return obisMapFull;
+}
+
+uint16_t CosemIndex::itemSize(CosemData* item) {
+    switch(item->base.type) {
+        case CosemTypeArray:
+        case CosemTypeStructure:
+            return 2;
+        case CosemTypeOctetString:
+        case CosemTypeString:
+            return 2 + item->base.length;
+        case CosemTypeLongSigned:
+        case CosemTypeLongUnsigned:
+            return 3;
+        case CosemTypeDLongSigned:
+        case CosemTypeDLongUnsigned:
+            return 5;
+        case CosemTypeLong64Signed:
+        case CosemTypeLong64Unsigned:
+            return 9;
+        case CosemTypeNull:
+            return 1;
+        default:
+            return 2;
+    }
+}
+
+// Size of the item at pos, or 0 if the item does not fit in what is left of the payload
+uint16_t CosemIndex::itemSizeAt(uint16_t pos) {
+    if(pos >= limit) return 0;
+    CosemData* item = (CosemData*) (ptr + pos);
+    if(item->base.type != CosemTypeNull && pos + 2 > limit) return 0;
+    uint16_t size = itemSize(item);
+    return pos + size <= limit ? size : 0;
+}
+
+// FNV-1a over the type of each item, the length for those where the length moves the items after it
+// and the OBIS codes, as the OBIS map is part of what is reused
+uint32_t CosemIndex::signatureAdd(uint32_t hash, CosemData* item) {
+    hash = (hash ^ item->base.type) * 16777619UL;
+    switch(item->base.type) {
+        case CosemTypeOctetString:
+            if(item->base.length == 6) {
+                for(uint8_t i = 0; i < 6; i++) {
+                    hash = (hash ^ item->oct.data[i]) * 16777619UL;
+                }
+            }
+            // Fallthrough
+        case CosemTypeArray:
+        case CosemTypeStructure:
+        case CosemTypeString:
+            hash = (hash ^ item->base.length) * 16777619UL;
+            break;
+    }
+    return hash;
+}
+
+uint8_t CosemIndex::obisHash(const uint8_t* obis) {
+    return (obis[0] + obis[1] * 13 + obis[2] * 5) % COSEM_OBIS_MAP_SIZE;
+}
+
+bool CosemIndex::obisMatch(uint16_t offset, const uint8_t* obis) {
+    return memcmp(ptr + offset + 4, obis, 4) == 0;
+}
+
+CosemIndex* CosemLayoutCache::get(const char* ptr, uint16_t length) {
+    for(uint8_t i = 0; i < COSEM_LAYOUT_CACHE_SIZE; i++) {
+        if(slots[i].matches(ptr, length)) {
+            hits++;
+            return &slots[i];
+        }
+    }
+    misses++;
+    CosemIndex* index = &slots[next];
+    next = (next + 1) % COSEM_LAYOUT_CACHE_SIZE;
+    index->build(ptr, length);
+    return index;
+}
+
+uint32_t CosemLayoutCache::getHits() {
+    return hits;
+}
+
+uint32_t CosemLayoutCache::getMisses() {
+    return misses;
+}
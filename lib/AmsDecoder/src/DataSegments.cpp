@@ -0,0 +1,58 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "DataSegments.h"
+
+void DataSegments::setBuffer(uint8_t* buf, uint16_t size) {
+    if(buf != this->buf) begin();
+    this->buf = buf;
+    this->size = size;
+}
+
+void DataSegments::begin() {
+    count = 0;
+    length = 0;
+}
+
+// Views have to be inside the buffer and come after each other, like the frames they are in
+bool DataSegments::add(const uint8_t* payload, uint16_t length) {
+    if(buf == NULL || count == DATA_SEGMENTS_MAX || payload < buf || payload + length > buf + size) {
+        begin();
+        return false;
+    }
+    uint16_t offset = payload - buf;
+    if(count > 0 && offset < views[count-1].offset + views[count-1].length) {
+        begin();
+        return false;
+    }
+    views[count].offset = offset;
+    views[count].length = length;
+    count++;
+    this->length += length;
+    return true;
+}
+
+uint8_t DataSegments::getCount() {
+    return count;
+}
+
+uint16_t DataSegments::getLength() {
+    return length;
+}
+
+uint16_t DataSegments::gather() {
+    if(count == 0) return 0;
+    // Views are in order and the destination never passes the source, so each payload moves once
+    uint16_t pos = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        if(views[i].offset != pos) memmove(buf + pos, buf + views[i].offset, views[i].length);
+        pos += views[i].length;
+    }
+    views[0].offset = 0;
+    views[0].length = pos;
+    count = 1;
+    return pos;
+}
@@ -7,7 +7,7 @@
 #include "DsmrParser.h"
 #include "crc.h"
 #include "hexutils.h"
-#include "lwip/def.h"
+#include "ntohll.h"
 
 int8_t DSMRParser::parse(uint8_t *buf, DataParserContext &ctx, bool verified) {
     uint16_t crcPos = 0;
@@ -0,0 +1,74 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "FrameAssembler.h"
+#include "HdlcParser.h"
+#include "MbusParser.h"
+#include "crc.h"
+
+void FrameAssembler::reset() {
+    tag = DATA_TAG_NONE;
+    expected = 0;
+    lastByte = 0x00;
+    endSeen = false;
+    verified = false;
+    crc = crc16_x25_init();
+}
+
+// Called once for each byte appended to buf. Returns DATA_PARSE_INCOMPLETE as long as we
+// know the outer frame is not complete yet, DATA_PARSE_OK when the layer parsers should run.
+// A complete HDLC frame with a bad FCS is rejected here, without running the parsers.
+int8_t FrameAssembler::append(const uint8_t *buf, uint16_t length) {
+    if(length == 0) {
+        reset();
+        return DATA_PARSE_INCOMPLETE;
+    }
+    if(length == 1) {
+        reset();
+        tag = buf[0];
+    }
+    uint8_t b = buf[length-1];
+
+    switch(tag) {
+        case DATA_TAG_HDLC:
+            // Fold everything between start flag and FCS into the checksum as it arrives
+            if(length > 1 && (expected == 0 || length <= expected - 3)) {
+                crc = crc16_x25_update(crc, &b, 1);
+            }
+            if(expected == 0) {
+                if(length < 3) return DATA_PARSE_INCOMPLETE;
+                // Only frame format type 3 carries a length, let the parser handle anything else
+                if((buf[1] & 0xF0) != 0xA0) return DATA_PARSE_OK;
+                expected = (((buf[1] << 8) | buf[2]) & 0x7FF) + 2;
+                if(expected < 6) return DATA_PARSE_OK;
+            }
+            if(length < expected) return DATA_PARSE_INCOMPLETE;
+            if(buf[expected-1] != HDLC_FLAG) return DATA_PARSE_BOUNDRY_FLAG_MISSING;
+            if(((buf[expected-3] << 8) | buf[expected-2]) != crc16_x25_final(crc)) return DATA_PARSE_FOOTER_CHECKSUM_ERROR;
+            verified = true;
+            return DATA_PARSE_OK;
+        case DATA_TAG_MBUS:
+            if(expected == 0) {
+                if(length < 4) return DATA_PARSE_INCOMPLETE;
+                // Zero length or malformed header, fall back to letting the parser decide on every byte
+                if(buf[1] == 0x00 || buf[1] != buf[2] || buf[3] != MBUS_START) return DATA_PARSE_OK;
+                uint16_t len = buf[1];
+                if(len < 4) len += 256; // Same assumption as in MBUSParser for austrian meters
+                expected = len + 6;
+            }
+            return length < expected ? DATA_PARSE_INCOMPLETE : DATA_PARSE_OK;
+        case DATA_TAG_DSMR: {
+            bool done = false;
+            if(length > 1 && b == '!' && lastByte == '\n') endSeen = true;
+            else if(endSeen && b == '\n') done = true;
+            lastByte = b;
+            return done ? DATA_PARSE_OK : DATA_PARSE_INCOMPLETE;
+        }
+        default:
+            // No outer framing we can measure, parse on every byte
+            return DATA_PARSE_OK;
+    }
+}
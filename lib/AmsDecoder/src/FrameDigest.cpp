@@ -0,0 +1,42 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "FrameDigest.h"
+
+// Checks the payload against the previous one and remembers it for the next call. The package
+// timestamp is compared too, a frame sent at a new time is not a repetition even if the values are.
+bool FrameDigest::matches(const uint8_t* payload, DataParserContext &ctx) {
+    // FNV-1a, cheap enough to run on every frame
+    uint32_t h = 2166136261UL;
+    for(uint16_t i = 0; i < ctx.length; i++) {
+        h = (h ^ payload[i]) * 16777619UL;
+    }
+
+    bool match = valid && type == ctx.type && length == ctx.length && timestamp == ctx.timestamp && hash == h;
+    if(match) {
+        hits++;
+    } else {
+        misses++;
+        type = ctx.type;
+        length = ctx.length;
+        timestamp = ctx.timestamp;
+        hash = h;
+        valid = true;
+    }
+    return match;
+}
+
+void FrameDigest::invalidate() {
+    valid = false;
+}
+
+uint32_t FrameDigest::getHits() {
+    return hits;
+}
+
+uint32_t FrameDigest::getMisses() {
+    return misses;
+}
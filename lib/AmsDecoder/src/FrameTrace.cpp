@@ -0,0 +1,86 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "FrameTrace.h"
+
+void FrameTrace::record(uint8_t kind, uint8_t tag, int8_t result, const uint8_t* data, uint16_t length) {
+    FrameTraceHeader h;
+    h.millis = millis();
+    h.length = length;
+    h.stored = data == NULL ? 0 : min(length, (uint16_t) FRAME_TRACE_MAX_DATA);
+    h.kind = kind;
+    h.tag = tag;
+    h.result = result;
+
+    // Drop the oldest records until the new one fits
+    uint32_t size = sizeof(h) + h.stored;
+    while(head + size - tail > FRAME_TRACE_SIZE) {
+        FrameTraceHeader old;
+        get(tail, &old, sizeof(old));
+        tail += sizeof(old) + old.stored;
+    }
+
+    put(head, &h, sizeof(h));
+    put(head + sizeof(h), data, h.stored);
+    head += size;
+    records++;
+}
+
+// Formats records from the cursor as text, one header line followed by the data in hex with 32
+// bytes on each line. Only whole lines are written, returns the number of characters in out.
+uint16_t FrameTrace::format(char* out, uint16_t size, FrameTraceCursor& cursor) {
+    if((int32_t) (cursor.pos - tail) < 0) {
+        // Records the reader had not got to yet have been overwritten
+        cursor.pos = tail;
+        cursor.offset = 0;
+    }
+
+    uint16_t len = 0;
+    while(cursor.pos != head) {
+        FrameTraceHeader h;
+        get(cursor.pos, &h, sizeof(h));
+        if(cursor.offset == 0) {
+            if(size - len < 64) break;
+            len += snprintf_P(out + len, size - len, PSTR("%lu kind=%d tag=%02X result=%d length=%d\n"), h.millis, h.kind, h.tag, h.result, h.length);
+        }
+        while(cursor.offset < h.stored) {
+            if(size - len < 3 * 32 + 2) return len;
+            uint8_t line[32];
+            uint16_t count = min((uint16_t) (h.stored - cursor.offset), (uint16_t) sizeof(line));
+            get(cursor.pos + sizeof(h) + cursor.offset, line, count);
+            for(uint16_t i = 0; i < count; i++) {
+                len += snprintf_P(out + len, size - len, PSTR("%02X "), line[i]);
+            }
+            out[len-1] = '\n';
+            cursor.offset += count;
+        }
+        cursor.pos += sizeof(h) + h.stored;
+        cursor.offset = 0;
+    }
+    return len;
+}
+
+uint32_t FrameTrace::getRecords() {
+    return records;
+}
+
+void FrameTrace::put(uint32_t pos, const void* src, uint16_t length) {
+    uint16_t start = pos & (FRAME_TRACE_SIZE - 1);
+    uint16_t first = min(length, (uint16_t) (FRAME_TRACE_SIZE - start));
+    memcpy(buf + start, src, first);
+    if(first < length) {
+        memcpy(buf, ((const uint8_t*) src) + first, length - first);
+    }
+}
+
+void FrameTrace::get(uint32_t pos, void* dst, uint16_t length) {
+    uint16_t start = pos & (FRAME_TRACE_SIZE - 1);
+    uint16_t first = min(length, (uint16_t) (FRAME_TRACE_SIZE - start));
+    memcpy(dst, buf + start, first);
+    if(first < length) {
+        memcpy(((uint8_t*) dst) + first, buf, length - first);
+    }
+}
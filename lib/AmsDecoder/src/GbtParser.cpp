@@ -5,7 +5,7 @@
  */
 
 #include "GbtParser.h"
-#include "lwip/def.h"
+#include "ntohll.h"
 
 int8_t GBTParser::parse(uint8_t *d, DataParserContext &ctx) {
     GBTHeader* h = (GBTHeader*) (d);
@@ -13,26 +13,20 @@ int8_t GBTParser::parse(uint8_t *d, DataParserContext &ctx) {
 
     if(h->flag != GBT_TAG) return DATA_PARSE_BOUNDRY_FLAG_MISSING;
 
+    if(ctx.segments == NULL) return DATA_PARSE_FAIL;
     if(sequence == 1) {
-        if(buf == NULL) buf = (uint8_t *)malloc((size_t)1024); // TODO find out from first package ?
-        pos = 0;
+        ctx.segments->begin();
     } else if(lastSequenceNumber != sequence-1) {
         return DATA_PARSE_FAIL;
     }
 
-    if(buf == NULL) return DATA_PARSE_FAIL;
-
     uint8_t* ptr = (uint8_t*) &h[1];
-    memcpy(buf + pos, ptr, h->size);
-    pos += h->size;
+    if(!ctx.segments->add(ptr, h->size)) return DATA_PARSE_FAIL;
     lastSequenceNumber = sequence;
 
     if((h->control & 0x80) == 0x00) {
         return DATA_PARSE_INTERMEDIATE_SEGMENT;
-    } else {
-        memcpy((uint8_t *) d, buf, pos);
     }
-    ctx.length = pos;
-    return DATA_PARSE_OK;
+    return DATA_PARSE_FINAL_SEGMENT;
 
 }
@@ -5,16 +5,55 @@
  */
 
 #include "GcmParser.h"
-#include "lwip/def.h"
-#if defined(ESP8266)
-#include "bearssl/bearssl.h"
-#elif defined(ESP32)
-#include "mbedtls/gcm.h"
-#endif
+#include "ntohll.h"
 
 GCMParser::GCMParser(uint8_t *encryption_key, uint8_t *authentication_key) {
+    #if defined(GCM_MBEDTLS)
+    mbedtls_gcm_init(&m_ctx);
+    #endif
+    setKeys(encryption_key, authentication_key);
+}
+
+GCMParser::~GCMParser() {
+    #if defined(GCM_MBEDTLS)
+    mbedtls_gcm_free(&m_ctx);
+    #endif
+}
+
+void GCMParser::setKeys(uint8_t *encryption_key, uint8_t *authentication_key) {
+    if(keyReady && memcmp(this->encryption_key, encryption_key, 16) == 0 && memcmp(this->authentication_key, authentication_key, 16) == 0) {
+        return;
+    }
+    freeKey();
     memcpy(this->encryption_key, encryption_key, 16);
     memcpy(this->authentication_key, authentication_key, 16);
+
+    hasAuthenticationKey = false;
+    for(uint8_t i = 0; i < 16; i++) hasAuthenticationKey |= authentication_key[i] > 0;
+}
+
+bool GCMParser::setupKey() {
+    if(keyReady) return true;
+    #if defined(ESP8266)
+        br_aes_ct_ctr_init(&bc, encryption_key, 16);
+        br_gcm_init(&gcmCtx, &bc.vtable, br_ghash_ctmul32);
+    #elif defined(GCM_MBEDTLS)
+        if(mbedtls_gcm_setkey(&m_ctx, MBEDTLS_CIPHER_ID_AES, encryption_key, 128) != 0) {
+            return false;
+        }
+    #endif
+    keyReady = true;
+    return true;
+}
+
+void GCMParser::freeKey() {
+    #if defined(GCM_MBEDTLS)
+        if(keyReady) {
+            mbedtls_gcm_free(&m_ctx);
+            mbedtls_gcm_init(&m_ctx);
+        }
+    #endif
+    keyReady = false;
 }
 
 int8_t GCMParser::parse(uint8_t *d, DataParserContext &ctx) {
@@ -87,14 +126,14 @@ int8_t GCMParser::parse(uint8_t *d, DataParserContext &ctx) {
         footersize += authkeylen;
         memcpy(additional_authenticated_data + 1, authentication_key, 16);
         memcpy(authentication_tag, ptr + len - footersize - 5, authkeylen);
-        for(uint8_t i; i < 16; i++) authenticate |= authentication_key[i] > 0;
+        authenticate = hasAuthenticationKey;
+    }
+
+    if(!setupKey()) {
+        return GCM_ENCRYPTION_KEY_FAILED;
     }
 
     #if defined(ESP8266)
-        br_gcm_context gcmCtx;
-        br_aes_ct_ctr_keys bc;
-        br_aes_ct_ctr_init(&bc, encryption_key, 16);
-        br_gcm_init(&gcmCtx, &bc.vtable, br_ghash_ctmul32);
         br_gcm_reset(&gcmCtx, initialization_vector, sizeof(initialization_vector));
         if(authenticate) {
             br_gcm_aad_inject(&gcmCtx, additional_authenticated_data, aadlen);
@@ -104,40 +143,32 @@ int8_t GCMParser::parse(uint8_t *d, DataParserContext &ctx) {
         if(authkeylen > 0 && br_gcm_check_tag_trunc(&gcmCtx, authentication_tag, authkeylen) != 1) {
             return GCM_AUTH_FAILED;
         }
-    #elif defined(ESP32)
-        uint8_t cipher_text[len - authkeylen - 5];
-        memcpy(cipher_text, ptr, len - authkeylen - 5);
-
-        mbedtls_gcm_context m_ctx;
-        mbedtls_gcm_init(&m_ctx);
-        int success = mbedtls_gcm_setkey(&m_ctx, MBEDTLS_CIPHER_ID_AES, encryption_key, 128);
-        if (0 != success) {
-            return GCM_ENCRYPTION_KEY_FAILED;
-        }
+    #elif defined(GCM_MBEDTLS)
+        // Decrypted in place, mbedtls allows input and output to be the same buffer
+        size_t cipherLength = len - authkeylen - 5; // 5 == security tag and frame counter
+        int success;
         if (authenticate) {
-            success = mbedtls_gcm_auth_decrypt(&m_ctx, sizeof(cipher_text), initialization_vector, sizeof(initialization_vector),
+            success = mbedtls_gcm_auth_decrypt(&m_ctx, cipherLength, initialization_vector, sizeof(initialization_vector),
                 additional_authenticated_data, aadlen, authentication_tag, authkeylen,
-                cipher_text, (unsigned char*)(ptr));
+                ptr, ptr);
             if (authkeylen > 0 && success == MBEDTLS_ERR_GCM_AUTH_FAILED) {
-                mbedtls_gcm_free(&m_ctx);
                 return GCM_AUTH_FAILED;
             } else if(success == MBEDTLS_ERR_GCM_BAD_INPUT) {
-                mbedtls_gcm_free(&m_ctx);
                 return GCM_DECRYPT_FAILED;
             }
         } else {
             success = mbedtls_gcm_starts(&m_ctx, MBEDTLS_GCM_DECRYPT, initialization_vector, sizeof(initialization_vector),NULL, 0);
             if (0 != success) {
-                mbedtls_gcm_free(&m_ctx);
                 return GCM_DECRYPT_FAILED;
             }
-            success = mbedtls_gcm_update(&m_ctx, sizeof(cipher_text), cipher_text, (unsigned char*)(ptr));
+            success = mbedtls_gcm_update(&m_ctx, cipherLength, ptr, ptr);
             if (0 != success) {
-                mbedtls_gcm_free(&m_ctx);
                 return GCM_DECRYPT_FAILED;
             }
         }
-        mbedtls_gcm_free(&m_ctx);
+    #else
+        // No cipher implementation available, never hand the ciphertext on as plaintext
+        return GCM_DECRYPT_FAILED;
     #endif
 
     ctx.length -= footersize + headersize;
@@ -5,10 +5,10 @@
  */
 
 #include "HdlcParser.h"
-#include "lwip/def.h"
+#include "ntohll.h"
 #include "crc.h"
 
-int8_t HDLCParser::parse(uint8_t *d, DataParserContext &ctx) {
+int8_t HDLCParser::parse(uint8_t *d, DataParserContext &ctx, bool verified) {
     int len;
 
     uint8_t* ptr;
@@ -31,8 +31,8 @@ int8_t HDLCParser::parse(uint8_t *d, DataParserContext &ctx) {
         if(h->flag != HDLC_FLAG || f->flag != HDLC_FLAG)
             return DATA_PARSE_BOUNDRY_FLAG_MISSING;
 
-        // Verify FCS
-        if(ntohs(f->fcs) != crc16_x25(d + 1, len - sizeof *f - 1))
+        // Verify FCS, unless FrameAssembler already did while the frame was received
+        if(!verified && ntohs(f->fcs) != crc16_x25(d + 1, len - sizeof *f - 1))
             return DATA_PARSE_FOOTER_CHECKSUM_ERROR;
 
         // Skip destination address, LSB marks last byte
@@ -60,33 +60,29 @@ int8_t HDLCParser::parse(uint8_t *d, DataParserContext &ctx) {
             ctx.length -= 3;
         }
 
-        // Payload incomplete
-        if((h->format & 0x08) == 0x08) {
+        // Segmented APDU. The LLC header is only in front of the first segment, and the
+        // segments are left where they are, only their place is recorded
+        if((h->format & 0x08) == 0x08 || lastSequenceNumber > 0) {
+            uint8_t* payload = ptr;
+            uint16_t payloadLength = ctx.length;
+            if(lastSequenceNumber == 0 && payloadLength >= 3 && payload[0] == DATA_TAG_LLC) {
+                payload += 3;
+                payloadLength -= 3;
+            }
+            if(ctx.segments == NULL) return DATA_PARSE_FAIL;
             if(lastSequenceNumber == 0) {
-                if(buf == NULL) buf = (uint8_t *)malloc((size_t)1024);
-                pos = 0;
+                ctx.segments->begin();
+            }
+            if(!ctx.segments->add(payload, payloadLength)) {
+                lastSequenceNumber = 0;
+                return DATA_PARSE_FAIL;
+            }
+            if((h->format & 0x08) == 0x08) {
+                lastSequenceNumber++;
+                return DATA_PARSE_INTERMEDIATE_SEGMENT;
             }
-
-            if(buf == NULL) return DATA_PARSE_FAIL;
-
-            memcpy(buf + pos, ptr+3, ctx.length); // +3 to skip LLC
-            pos += ctx.length;
-
-            lastSequenceNumber++;
-            return DATA_PARSE_INTERMEDIATE_SEGMENT;
-        } else if(lastSequenceNumber > 0) {
             lastSequenceNumber = 0;
-            if(buf == NULL) return DATA_PARSE_FAIL;
-
-            memcpy(buf + pos, ptr+3, ctx.length); // +3 to skip LLC
-            pos += ctx.length;
-
-            memcpy((uint8_t *) d, buf, pos);
-            free(buf);
-            buf = NULL;
-            ctx.length = pos;
-            pos = 0;
-            return DATA_PARSE_OK;
+            return DATA_PARSE_FINAL_SEGMENT;
         } else {
             return ptr-d;
         }
@@ -0,0 +1,162 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#include "SerialAutodetect.h"
+#include "HdlcParser.h"
+#include "MbusParser.h"
+#include "crc.h"
+
+struct LineCursor {
+    const SerialLineCapture* line;
+    uint16_t idx;
+    uint32_t start; // Time the current run started
+};
+
+static bool lineLevel(const LineCursor& c) {
+    return c.line->startLevel ^ (c.idx & 1);
+}
+
+// Level of the line at time t, t must never go backwards
+static bool levelAt(LineCursor& c, uint32_t t) {
+    while(c.idx < c.line->count - 1 && t >= c.start + c.line->runs[c.idx]) {
+        c.start += c.line->runs[c.idx];
+        c.idx++;
+    }
+    return lineLevel(c);
+}
+
+void serialAutodetectScore(const SerialLineCapture& line, SerialAutodetectScore& score, uint8_t* work, uint16_t workSize) {
+    score.score = INT32_MIN;
+    score.bytes = score.framingErrors = score.parityErrors = 0;
+    score.tagHits = score.checksumPasses = 0;
+    if(line.count < 2 || score.baud == 0) return;
+
+    uint32_t end = 0;
+    for(uint16_t i = 0; i < line.count; i++) end += line.runs[i];
+
+    uint8_t dataBits = (score.parity & 0x01) ? 8 : 7;
+    bool parity = (score.parity & 0x08) == 0x08;
+    bool idle = !score.invert;
+    float bitTime = 1000000.0 / score.baud;
+
+    LineCursor c = { &line, 0, 0 };
+    uint32_t t = 0;
+    while(true) {
+        // Find the next start bit, the line leaving idle at or after t
+        while(c.idx < line.count && (lineLevel(c) == idle || c.start < t)) {
+            c.start += line.runs[c.idx];
+            c.idx++;
+        }
+        if(c.idx >= line.count) break;
+
+        uint32_t t0 = c.start;
+        uint8_t bits = 1 + dataBits + (parity ? 1 : 0);
+        uint32_t stopAt = t0 + (uint32_t) ((bits + 0.5) * bitTime);
+        if(stopAt >= end) break;
+
+        if(levelAt(c, t0 + (uint32_t) (0.5 * bitTime)) == idle) {
+            // Glitch shorter than half a bit
+            t = t0 + 1;
+            continue;
+        }
+
+        uint8_t val = 0, ones = 0;
+        for(uint8_t b = 0; b < dataBits; b++) {
+            if(levelAt(c, t0 + (uint32_t) ((1 + b + 0.5) * bitTime)) == idle) {
+                val |= 1 << b;
+                ones++;
+            }
+        }
+        if(parity) {
+            if(levelAt(c, t0 + (uint32_t) ((1 + dataBits + 0.5) * bitTime)) == idle) ones++;
+            if(ones % 2 != 0) score.parityErrors++;
+        }
+        if(levelAt(c, stopAt) != idle) score.framingErrors++;
+
+        if(score.bytes < workSize) work[score.bytes] = val;
+        score.bytes++;
+        t = stopAt;
+    }
+
+    serialAutodetectTags(work, min(score.bytes, workSize), score.tagHits, score.checksumPasses);
+    score.score = (int32_t) score.bytes - 8 * (score.framingErrors + score.parityErrors) + 20 * score.tagHits + 200 * score.checksumPasses;
+}
+
+bool serialAutodetectBest(const SerialLineCapture& line, const uint32_t* bauds, uint8_t baudCount, SerialAutodetectScore& best, uint8_t* work, uint16_t workSize) {
+    best.score = INT32_MIN;
+    for(uint8_t b = 0; b < baudCount; b++) {
+        for(uint8_t p = 0; p < sizeof(AUTODETECT_PARITIES); p++) {
+            for(uint8_t i = 0; i < 2; i++) {
+                SerialAutodetectScore candidate;
+                candidate.baud = bauds[b];
+                candidate.parity = AUTODETECT_PARITIES[p];
+                candidate.invert = i == 1;
+                serialAutodetectScore(line, candidate, work, workSize);
+                if(candidate.score > best.score) best = candidate;
+            }
+        }
+    }
+    // Require a recognized frame, or at least a clean stream of bytes
+    return best.score > 0 && (best.tagHits > 0 || best.checksumPasses > 0 || (best.bytes >= 16 && best.framingErrors == 0 && best.parityErrors == 0));
+}
+
+static bool isHex(uint8_t c) {
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
+}
+
+static uint8_t hexValue(uint8_t c) {
+    if(c >= 'a') return c - 'a' + 10;
+    if(c >= 'A') return c - 'A' + 10;
+    return c - '0';
+}
+
+void serialAutodetectTags(const uint8_t* buf, uint16_t length, uint8_t& tagHits, uint8_t& checksumPasses) {
+    int dsmrStart = -1;
+    for(uint16_t i = 0; i < length; i++) {
+        uint16_t left = length - i;
+        uint8_t b = buf[i];
+        if(b == HDLC_FLAG && left > 3 && (buf[i+1] & 0xF0) == 0xA0) {
+            // Frame format type 3, length is everything between the flags
+            uint16_t len = ((buf[i+1] & 0x07) << 8) | buf[i+2];
+            if(len > 5 && len + 2 <= left && buf[i+len+1] == HDLC_FLAG) {
+                uint16_t fcs = (buf[i+len-1] << 8) | buf[i+len];
+                if(fcs == crc16_x25(buf+i+1, len-2)) {
+                    if(checksumPasses < 255) checksumPasses++;
+                    i += len;
+                    continue;
+                }
+            }
+            if(tagHits < 255) tagHits++;
+        } else if(b == MBUS_START && left > 4 && buf[i+1] == buf[i+2] && buf[i+3] == MBUS_START && buf[i+1] > 0) {
+            uint8_t len = buf[i+1];
+            if(len + 6 <= left && buf[i+len+5] == MBUS_END) {
+                uint8_t sum = 0;
+                for(uint16_t j = 0; j < len; j++) sum += buf[i+4+j];
+                if(sum == buf[i+len+4]) {
+                    if(checksumPasses < 255) checksumPasses++;
+                    i += len + 5;
+                    continue;
+                }
+            }
+            if(tagHits < 255) tagHits++;
+        } else if(b == '/' && left > 4 && isupper(buf[i+1]) && isalpha(buf[i+2]) && isalpha(buf[i+3])) {
+            // DSMR identification line, e.g. "/KFM5"
+            dsmrStart = i;
+            if(tagHits < 255) tagHits++;
+        } else if(b == '!' && dsmrStart >= 0 && left > 4 && i > 0 && buf[i-1] == '\n') {
+            if(isHex(buf[i+1]) && isHex(buf[i+2]) && isHex(buf[i+3]) && isHex(buf[i+4])) {
+                uint16_t crc = (hexValue(buf[i+1]) << 12) | (hexValue(buf[i+2]) << 8) | (hexValue(buf[i+3]) << 4) | hexValue(buf[i+4]);
+                if(crc == crc16(buf+dsmrStart, i-dsmrStart+1)) {
+                    if(checksumPasses < 255) checksumPasses++;
+                }
+            }
+            dsmrStart = -1;
+        } else if(b == '\n' && left > 4 && isdigit(buf[i+1]) && buf[i+2] == '-' && isdigit(buf[i+3]) && buf[i+4] == ':') {
+            // DSMR data line, e.g. "1-0:1.8.0(...)"
+            if(tagHits < 255) tagHits++;
+        }
+    }
+}
@@ -19,10 +19,13 @@
 #include <esp_task_wdt.h>
 #endif
 
+// How often all fields are sent, even those that have not changed
+#define MQTT_FULL_REFRESH_INTERVAL 300000
+
 class AmsMqttHandler {
 public:
     #if defined(AMS_REMOTE_DEBUG)
-    AmsMqttHandler(MqttConfig& mqttConfig, RemoteDebug* debugger, char* buf) {
+    AmsMqttHandler(MqttConfig& mqttConfig, RemoteDebug* debugger, char* buf, uint16_t mqttBufferSize = 256) : mqtt(mqttBufferSize) {
         this->mqttConfig = mqttConfig;
     	this->mqttConfigChanged = true;
         this->debugger = debugger;
@@ -30,7 +33,7 @@ public:
         mqtt.dropOverflow(true);
     };
     #else
-    AmsMqttHandler(MqttConfig& mqttConfig, Stream* debugger, char* buf) {
+    AmsMqttHandler(MqttConfig& mqttConfig, Stream* debugger, char* buf, uint16_t mqttBufferSize = 256) : mqtt(mqttBufferSize) {
         this->mqttConfig = mqttConfig;
     	this->mqttConfigChanged = true;
         this->debugger = debugger;
@@ -50,11 +53,12 @@ public:
 
     virtual uint8_t getFormat() { return 0; };
 
-    virtual bool publish(AmsData* data, AmsData* previousState, EnergyAccounting* ea, PriceService* ps) { return false; };
+    virtual bool publish(AmsData* data, AmsData* meterState, EnergyAccounting* ea, PriceService* ps) { return false; };
     virtual bool publishTemperatures(AmsConfiguration*, HwTools*) { return false; };
     virtual bool publishPrices(PriceService* ps) { return false; };
     virtual bool publishSystem(HwTools*, PriceService*, EnergyAccounting*) { return false; };
     virtual bool publishRaw(String data) { return false; };
+    virtual bool publishChannel(uint8_t channel, AmsData* data);
     virtual void onMessage(String &topic, String &payload) {};
 
     virtual ~AmsMqttHandler() {
@@ -72,7 +76,7 @@ protected:
     #endif
     MqttConfig mqttConfig;
     bool mqttConfigChanged = true;
-    MQTTClient mqtt = MQTTClient(256);
+    MQTTClient mqtt;
     unsigned long lastMqttRetry = -10000;
     bool caVerification = true;
     WiFiClient *mqttClient = NULL;
@@ -80,6 +84,11 @@ protected:
     char* json;
     uint16_t BufferSize = 2048;
     uint64_t lastStateUpdate = 0;
+    uint64_t pendingChanges = AMS_DATA_ALL_FIELDS;
+    uint64_t lastFullRefresh = 0;
+
+    void collectChanges(AmsData* meterState);
+    bool isChanged(uint8_t field);
 };
 
 #endif
@@ -8,6 +8,7 @@
 #include "FirmwareVersion.h"
 #include "AmsStorage.h"
 #include "LittleFS.h"
+#include "Uptime.h"
 
 void AmsMqttHandler::setCaVerification(bool caVerification) {
 	this->caVerification = caVerification;
@@ -176,4 +177,50 @@ bool AmsMqttHandler::loop() {
 		ESP.wdtFeed();
 	#endif
     return ret;
-}
\ No newline at end of file
+}
+
+// Changes are kept until a publish clears them, so a skipped state update interval or a lost
+// connection does not drop any. Now and then every field is marked, for receivers that only
+// keep the last value to get back in sync.
+void AmsMqttHandler::collectChanges(AmsData* meterState) {
+    pendingChanges |= meterState->getChanges();
+    uint64_t now = millis64();
+    if(now - lastFullRefresh >= MQTT_FULL_REFRESH_INTERVAL) {
+        pendingChanges = AMS_DATA_ALL_FIELDS;
+        lastFullRefresh = now;
+    }
+}
+
+bool AmsMqttHandler::isChanged(uint8_t field) {
+    return (pendingChanges >> field) & 1;
+}
+
+// Sub-meters are published in the same flat format regardless of payload format, below the main topic
+bool AmsMqttHandler::publishChannel(uint8_t channel, AmsData* data) {
+    if(strlen(mqttConfig.publishTopic) == 0 || !mqtt.connected()) {
+        return false;
+    }
+
+    snprintf_P(json, BufferSize, PSTR("{\"ch\":%d,\"id\":\"%s\",\"lt\":%d,\"P\":%lu,\"PO\":%lu,\"Q\":%lu,\"QO\":%lu,\"U1\":%.2f,\"U2\":%.2f,\"U3\":%.2f,\"I1\":%.2f,\"I2\":%.2f,\"I3\":%.2f,\"tPI\":%.3f,\"tPO\":%.3f}"),
+        channel,
+        data->getMeterId().c_str(),
+        data->getListType(),
+        data->getActiveImportPower(),
+        data->getActiveExportPower(),
+        data->getReactiveImportPower(),
+        data->getReactiveExportPower(),
+        data->getL1Voltage(),
+        data->getL2Voltage(),
+        data->getL3Voltage(),
+        data->getL1Current(),
+        data->getL2Current(),
+        data->getL3Current(),
+        data->getActiveImportCounter(),
+        data->getActiveExportCounter()
+    );
+    char topic[192];
+    snprintf_P(topic, 192, PSTR("%s/meter/%d"), mqttConfig.publishTopic, channel);
+    bool ret = mqtt.publish(topic, json);
+    loop();
+    return ret;
+}
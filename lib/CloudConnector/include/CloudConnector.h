@@ -38,6 +38,8 @@
 #endif
 
 #define CC_BUF_SIZE 2048
+// While the meter sends nothing new, the cloud still hears from the device this often
+#define CC_IDLE_INTERVAL 300000
 
 static const char CC_JSON_POWER[] PROGMEM = ",\"%s\":{\"P\":%lu,\"Q\":%lu}";
 static const char CC_JSON_POWER_LIST3[] PROGMEM = ",\"%s\":{\"P\":%lu,\"Q\":%lu,\"tP\":%.3f,\"tQ\":%.3f}";
@@ -61,6 +63,7 @@ public:
     bool setup(CloudConfig& config, MeterConfig& meter, SystemConfig& system, NtpConfig& ntp, HwTools* hw, ResetDataContainer* rdc);
     void setMqttHandler(AmsMqttHandler* mqttHandler);
     void update(AmsData& data, EnergyAccounting& ea);
+    void dataChanged(uint64_t changes);
     void setPriceConfig(PriceServiceConfig&);
     void setEnergyAccountingConfig(EnergyAccountingConfig&);
     void forceUpdate();
@@ -93,6 +96,7 @@ private:
     String uuid;
     bool initialized = false;
     unsigned long lastUpdate = 0;
+    uint64_t pendingChanges = 0;
     char mac[18];
     char apmac[18];
 
@@ -106,7 +110,6 @@ private:
     char* pers = "amsreader";
 
     bool init();
-    void debugPrint(byte *buffer, int start, int length);
 
     String meterManufacturer(uint8_t type) {
         switch(type) {
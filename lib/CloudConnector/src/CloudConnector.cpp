@@ -178,6 +178,8 @@ debugger->printf_P(PSTR("(CloudConnector) Client ID is not valid\n"));
         return;
     }
     if(data.getListType() < 2) return;
+    // Nothing but the meter clock has changed since the last upload
+    if(lastUpdate != 0 && (pendingChanges & AMS_DATA_VALUE_FIELDS) == 0 && now-lastUpdate < CC_IDLE_INTERVAL) return;
 
     if(!initialized && !init()) {
         #if defined(AMS_REMOTE_DEBUG)
@@ -439,6 +441,12 @@ debugger->printf_P(PSTR("%s\n"), clearBuffer);
     udp.endPacket();
 
     lastUpdate = now;
+    pendingChanges = 0;
+}
+
+// Called with the fields each frame changed, update() is called on its own schedule and would miss them
+void CloudConnector::dataChanged(uint64_t changes) {
+    pendingChanges |= changes;
 }
 
 void CloudConnector::forceUpdate() {
@@ -461,22 +469,6 @@ void CloudConnector::setEnergyAccountingConfig(EnergyAccountingConfig& eac) {
     this->lastEac = 0;
 }
 
-void CloudConnector::debugPrint(byte *buffer, int start, int length) {
-	for (int i = start; i < start + length; i++) {
-		if (buffer[i] < 0x10)
-			debugger->print(F("0"));
-		debugger->print(buffer[i], HEX);
-		debugger->print(F(" "));
-		if ((i - start + 1) % 16 == 0)
-			debugger->println(F(""));
-		else if ((i - start + 1) % 4 == 0)
-			debugger->print(F(" "));
-
-		yield(); // Let other get some resources too
-	}
-	debugger->println(F(""));
-}
-
 String CloudConnector::generateSeed() {
     uint8_t key[16];
     ESPRandom::uuid4(key);
@@ -8,27 +8,30 @@
 #include "json/domoticz_json.h"
 #include "Uptime.h"
 
-bool DomoticzMqttHandler::publish(AmsData* update, AmsData* previousState, EnergyAccounting* ea, PriceService* ps) {
+bool DomoticzMqttHandler::publish(AmsData* update, AmsData* meterState, EnergyAccounting* ea, PriceService* ps) {
     bool ret = false;
 
-    AmsData data;
+    // Voltage and current devices are only updated when the value has changed, and at every full refresh
+    collectChanges(meterState);
+    if(!mqtt.connected())
+        return false;
+
+    // The frame is already applied to meterState
+    AmsData* data = update;
     if(mqttConfig.stateUpdate) {
         uint64_t now = millis64();
         if(now-lastStateUpdate < mqttConfig.stateUpdateInterval * 1000) return false;
-        data.apply(*previousState);
-        data.apply(*update);
+        data = meterState;
         lastStateUpdate = now;
-    } else {
-        data = *update;
     }
 
     if (config.elidx > 0) {
-        if(data.getActiveImportCounter() > 1.0 && !data.isCounterEstimated()) {
-            energy = data.getActiveImportCounter();
+        if(data->getActiveImportCounter() > 1.0 && !data->isCounterEstimated()) {
+            energy = data->getActiveImportCounter();
         }
         if(energy > 0.0) {
             char val[16];
-            snprintf_P(val, 16, PSTR("%.1f;%.1f"), (data.getActiveImportPower()/1.0), energy*1000.0);
+            snprintf_P(val, 16, PSTR("%.1f;%.1f"), (data->getActiveImportPower()/1.0), energy*1000.0);
             snprintf_P(json, BufferSize, DOMOTICZ_JSON,
                 config.elidx,
                 val
@@ -38,12 +41,12 @@ bool DomoticzMqttHandler::publish(AmsData* update, AmsData* previousState, Energ
         }
     }
 
-    if(data.getListType() == 1)
+    if(data->getListType() == 1)
         return ret;
 
-    if (config.vl1idx > 0){				
+    if (config.vl1idx > 0 && isChanged(AmsDataFieldL1Voltage)){				
         char val[16];
-        snprintf_P(val, 16, PSTR("%.2f"), data.getL1Voltage());
+        snprintf_P(val, 16, PSTR("%.2f"), data->getL1Voltage());
         snprintf_P(json, BufferSize, DOMOTICZ_JSON,
             config.vl1idx,
             val
@@ -52,9 +55,9 @@ bool DomoticzMqttHandler::publish(AmsData* update, AmsData* previousState, Energ
         mqtt.loop();
     }
 
-    if (config.vl2idx > 0){				
+    if (config.vl2idx > 0 && isChanged(AmsDataFieldL2Voltage)){				
         char val[16];
-        snprintf_P(val, 16, PSTR("%.2f"), data.getL2Voltage());
+        snprintf_P(val, 16, PSTR("%.2f"), data->getL2Voltage());
         snprintf_P(json, BufferSize, DOMOTICZ_JSON,
             config.vl2idx,
             val
@@ -63,9 +66,9 @@ bool DomoticzMqttHandler::publish(AmsData* update, AmsData* previousState, Energ
         mqtt.loop();
     }
 
-    if (config.vl3idx > 0){				
+    if (config.vl3idx > 0 && isChanged(AmsDataFieldL3Voltage)){				
         char val[16];
-        snprintf(val, 16, "%.2f", data.getL3Voltage());
+        snprintf(val, 16, "%.2f", data->getL3Voltage());
         snprintf_P(json, BufferSize, DOMOTICZ_JSON,
             config.vl3idx,
             val
@@ -74,9 +77,9 @@ bool DomoticzMqttHandler::publish(AmsData* update, AmsData* previousState, Energ
         mqtt.loop();
     }
 
-    if (config.cl1idx > 0){				
+    if (config.cl1idx > 0 && (isChanged(AmsDataFieldL1Current) || isChanged(AmsDataFieldL2Current) || isChanged(AmsDataFieldL3Current))){				
         char val[16];
-        snprintf(val, 16, "%.1f;%.1f;%.1f", data.getL1Current(), data.getL2Current(), data.getL3Current());
+        snprintf(val, 16, "%.1f;%.1f;%.1f", data->getL1Current(), data->getL2Current(), data->getL3Current());
         snprintf_P(json, BufferSize, DOMOTICZ_JSON,
             config.cl1idx,
             val
@@ -84,6 +87,7 @@ bool DomoticzMqttHandler::publish(AmsData* update, AmsData* previousState, Energ
         ret |= mqtt.publish(F("domoticz/in"), json);
         mqtt.loop();
     }			
+    pendingChanges = 0;
     return ret;
 }
 
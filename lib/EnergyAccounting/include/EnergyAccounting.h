@@ -10,6 +10,8 @@
 #include "Arduino.h"
 #include "AmsData.h"
 #include "AmsDataStorage.h"
+#include "AmsFile.h"
+#include "AmsRollup.h"
 #include "PriceService.h"
 
 struct EnergyAccountingPeak {
@@ -87,11 +89,14 @@ public:
     #endif
     void setup(AmsDataStorage *ds, EnergyAccountingConfig *config);
     void setPriceService(PriceService *ps);
+    void setRollup(AmsRollup *rollup);
     void setTimezone(Timezone*);
     EnergyAccountingConfig* getConfig();
     bool update(AmsData* amsData);
     bool load();
     bool save();
+    void requestSave();
+    bool loop();
     bool isInitialized();
 
     float getUseThisHour();
@@ -125,6 +130,7 @@ public:
 
     void setCurrency(String currency);
     float getPriceForHour(uint8_t d, uint8_t h);
+    float getCurrentPrice(uint8_t d);
 
 private:
     #if defined(AMS_REMOTE_DEBUG)
@@ -135,14 +141,19 @@ private:
     bool init = false, initPrice = false;
     AmsDataStorage *ds = NULL;
     PriceService *ps = NULL;
+    AmsRollup *rollup = NULL;
     EnergyAccountingConfig *config = NULL;
     Timezone *tz = NULL;
     EnergyAccountingData data = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
     EnergyAccountingRealtimeData* realtimeData = NULL;
     String currency = "";
+    AmsFile file;
+    unsigned long saveRequested = 0;
+    bool savePending = false;
 
     void calcDayCost();
     bool updateMax(uint16_t val, uint8_t day);
+    bool addQuarterCost(time_t hourStart);
 };
 
 #endif
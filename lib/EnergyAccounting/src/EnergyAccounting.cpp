@@ -10,9 +10,9 @@
 #include "FirmwareVersion.h"
 
 #if defined(AMS_REMOTE_DEBUG)
-EnergyAccounting::EnergyAccounting(RemoteDebug* debugger, EnergyAccountingRealtimeData* rtd) {
+EnergyAccounting::EnergyAccounting(RemoteDebug* debugger, EnergyAccountingRealtimeData* rtd) : file(FILE_ENERGYACCOUNTING) {
 #else
-EnergyAccounting::EnergyAccounting(Stream* Stream, EnergyAccountingRealtimeData* rtd) {
+EnergyAccounting::EnergyAccounting(Stream* Stream, EnergyAccountingRealtimeData* rtd) : file(FILE_ENERGYACCOUNTING) {
 #endif
     data.version = 1;
     this->debugger = debugger;
@@ -42,6 +42,10 @@ void EnergyAccounting::setPriceService(PriceService *ps) {
     this->ps = ps;
 }
 
+void EnergyAccounting::setRollup(AmsRollup *rollup) {
+    this->rollup = rollup;
+}
+
 EnergyAccountingConfig* EnergyAccounting::getConfig() {
     return config;
 }
@@ -86,16 +90,24 @@ bool EnergyAccounting::update(AmsData* amsData) {
         init = true;
     }
 
-    float importPrice = getPriceForHour(PRICE_DIRECTION_IMPORT, 0);
+    float importPrice = getCurrentPrice(PRICE_DIRECTION_IMPORT);
     if(!initPrice && importPrice != PRICE_NO_VALUE) {
         calcDayCost();
     }
 
     if(local.Hour != this->realtimeData->currentHour && (amsData->getListType() >= 3 || local.Minute == 1)) {
-        tmElements_t oneHrAgo, oneHrAgoLocal;
-        breakTime(now-3600, oneHrAgo);
-        uint16_t val = round(ds->getHourImport(oneHrAgo.Hour) / 10.0);
+        // The rollup only has the whole hour if we were running when it started
+        uint16_t val;
+        RollupAggregate* hour = rollup == NULL ? NULL : rollup->getLast(RollupTierHour);
+        if(hour != NULL && hour->complete && now - hour->start <= 7200) {
+            val = round(AmsRollup::getImportWh(hour) / 10.0);
+        } else {
+            tmElements_t oneHrAgo;
+            breakTime(now-3600, oneHrAgo);
+            val = round(ds->getHourImport(oneHrAgo.Hour) / 10.0);
+        }
 
+        tmElements_t oneHrAgoLocal;
         breakTime(tz->toLocal(now-3600), oneHrAgoLocal);
         ret |= updateMax(val, oneHrAgoLocal.Day);
 
@@ -156,8 +168,10 @@ bool EnergyAccounting::update(AmsData* amsData) {
 
     if(this->realtimeData->lastImportUpdateMillis < amsData->getLastUpdateMillis()) {
         unsigned long ms = amsData->getLastUpdateMillis() - this->realtimeData->lastImportUpdateMillis;
-        float kwhi = (amsData->getActiveImportPower() * (((float) ms) / 3600000.0)) / 1000.0;
-        if(kwhi > 0) {
+        // W x ms to mWh in integer math, only converted when there is something to add
+        uint32_t mwhi = ((uint64_t) amsData->getActiveImportPower() * ms + 1800) / 3600;
+        if(mwhi > 0) {
+            float kwhi = mwhi / 1000000.0;
             this->realtimeData->use += kwhi;
             if(importPrice != PRICE_NO_VALUE) {
                 float cost = importPrice * kwhi;
@@ -170,10 +184,11 @@ bool EnergyAccounting::update(AmsData* amsData) {
 
     if(amsData->getListType() > 1 && this->realtimeData->lastExportUpdateMillis < amsData->getLastUpdateMillis()) {
         unsigned long ms = amsData->getLastUpdateMillis() - this->realtimeData->lastExportUpdateMillis;
-        float kwhe = (amsData->getActiveExportPower() * (((float) ms) / 3600000.0)) / 1000.0;
-        if(kwhe > 0) {
+        uint32_t mwhe = ((uint64_t) amsData->getActiveExportPower() * ms + 1800) / 3600;
+        if(mwhe > 0) {
+            float kwhe = mwhe / 1000000.0;
             this->realtimeData->produce += kwhe;
-            float exportPrice = getPriceForHour(PRICE_DIRECTION_EXPORT, 0);
+            float exportPrice = getCurrentPrice(PRICE_DIRECTION_EXPORT);
             if(exportPrice != PRICE_NO_VALUE) {
                 float income = exportPrice * kwhe;
                 this->realtimeData->incomeHour += income;
@@ -194,23 +209,29 @@ void EnergyAccounting::calcDayCost() {
     time_t now = time(nullptr);
     tmElements_t local, utc;
     if(tz == NULL) return;
-    breakTime(tz->toLocal(now), local);
+    time_t localNow = tz->toLocal(now);
+    breakTime(localNow, local);
 
     if(getPriceForHour(PRICE_DIRECTION_IMPORT, 0) != PRICE_NO_VALUE) {
         if(initPrice) {
             this->realtimeData->costDay = 0;
             this->realtimeData->incomeDay = 0;
         }
-        for(uint8_t i = 0; i < this->realtimeData->currentHour; i++) {
-            breakTime(now - ((local.Hour - i) * 3600), utc);
-
-            float priceIn = getPriceForHour(PRICE_DIRECTION_IMPORT, i - local.Hour);
+        // Walks the hours since local midnight by UTC time, there are 23 or 25 of them on DST days
+        time_t thisHour = now - (local.Minute * 60) - local.Second;
+        time_t dayStart = tz->toUTC(localNow - (local.Hour * 3600) - (local.Minute * 60) - local.Second);
+        for(time_t hourStart = dayStart; hourStart < thisHour; hourStart += 3600) {
+            if(addQuarterCost(hourStart)) continue;
+
+            breakTime(hourStart, utc);
+            int8_t i = (hourStart - thisHour) / 3600;
+            float priceIn = getPriceForHour(PRICE_DIRECTION_IMPORT, i);
             if(priceIn != PRICE_NO_VALUE) {
                 int16_t wh = ds->getHourImport(utc.Hour);
                 this->realtimeData->costDay += priceIn * (wh / 1000.0);
             }
 
-            float priceOut = getPriceForHour(PRICE_DIRECTION_EXPORT, i - local.Hour);
+            float priceOut = getPriceForHour(PRICE_DIRECTION_EXPORT, i);
             if(priceOut != PRICE_NO_VALUE) {
                 int16_t wh = ds->getHourExport(utc.Hour);
                 this->realtimeData->incomeDay += priceOut * (wh / 1000.0);
@@ -220,6 +241,32 @@ void EnergyAccounting::calcDayCost() {
     }
 }
 
+// Prices the hour by its quarters when we have all four, as the price can change within
+// the hour with 15 minute settlement
+bool EnergyAccounting::addQuarterCost(time_t hourStart) {
+    if(ps == NULL) return false;
+    time_t dayStart = ds->getQuarterDayStart();
+    if(dayStart == 0 || hourStart < dayStart) return false;
+    uint32_t slot = (hourStart - dayStart) / 900;
+    if(slot + 4 > ds->getQuarterCount()) return false;
+    for(uint8_t q = 0; q < 4; q++) {
+        if(!ds->hasQuarter(slot + q)) return false;
+    }
+
+    for(uint8_t q = 0; q < 4; q++) {
+        time_t t = hourStart + (q * 900);
+        float priceIn = ps->getValue(PRICE_DIRECTION_IMPORT, t);
+        if(priceIn != PRICE_NO_VALUE) {
+            this->realtimeData->costDay += priceIn * (ds->getQuarterImport(slot + q) / 1000.0);
+        }
+        float priceOut = ps->getValue(PRICE_DIRECTION_EXPORT, t);
+        if(priceOut != PRICE_NO_VALUE) {
+            this->realtimeData->incomeDay += priceOut * (ds->getQuarterExport(slot + q) / 1000.0);
+        }
+    }
+    return true;
+}
+
 float EnergyAccounting::getUseThisHour() {
     return this->realtimeData->use;
 }
@@ -402,11 +449,9 @@ bool EnergyAccounting::load() {
     }
 
     bool ret = false;
-    if(LittleFS.exists(FILE_ENERGYACCOUNTING)) {
-        File file = LittleFS.open(FILE_ENERGYACCOUNTING, "r");
-        char buf[file.size()];
-        file.readBytes(buf, file.size());
-
+    uint8_t buf[sizeof(EnergyAccountingData) + sizeof(AmsFileTrailer)];
+    int16_t len = file.read(buf, sizeof(buf));
+    if(len > 0) {
         if(buf[0] == 6) {
             EnergyAccountingData* data = (EnergyAccountingData*) buf;
             memcpy(&this->data, data, sizeof(this->data));
@@ -476,7 +521,7 @@ bool EnergyAccounting::load() {
                 this->data.costThisMonth = data->costThisMonth;
                 this->data.costLastMonth = data->costLastMonth;
                 uint8_t b = 0;
-                for(uint8_t i = sizeof(this->data); i < file.size(); i+=2) {
+                for(uint8_t i = sizeof(this->data); i < len; i+=2) {
                     this->data.peaks[b].day = b;
                     memcpy(&this->data.peaks[b].value, buf+i, 2);
                     b++;
@@ -487,8 +532,6 @@ bool EnergyAccounting::load() {
                 ret = false;
             }
         }
-
-        file.close();
     }
 
     return ret;
@@ -498,16 +541,23 @@ bool EnergyAccounting::save() {
     if(!LittleFS.begin()) {
         return false;
     }
-    {
-        File file = LittleFS.open(FILE_ENERGYACCOUNTING, "w");
-        char buf[sizeof(data)];
-        memcpy(buf, &data, sizeof(data));
-        for(uint8_t i = 0; i < sizeof(buf); i++) {
-            file.write(buf[i]);
-        }
-        file.close();
+    savePending = false;
+    return file.write((uint8_t*) &data, sizeof(data));
+}
+
+// Saves requested close together are written once, when the first one is old enough
+void EnergyAccounting::requestSave() {
+    if(!savePending) {
+        saveRequested = millis();
+        savePending = true;
     }
-    return true;
+}
+
+bool EnergyAccounting::loop() {
+    if(savePending && millis() - saveRequested >= AMSFILE_SAVE_DELAY) {
+        return save();
+    }
+    return false;
 }
 
 EnergyAccountingData EnergyAccounting::getData() {
@@ -554,4 +604,10 @@ void EnergyAccounting::setCurrency(String currency) {
 float EnergyAccounting::getPriceForHour(uint8_t d, uint8_t h) {
     if(ps == NULL) return PRICE_NO_VALUE;
     return ps->getValueForHour(d, h);
+}
+
+// The price right now, which can change every 15 minutes
+float EnergyAccounting::getCurrentPrice(uint8_t d) {
+    if(ps == NULL) return PRICE_NO_VALUE;
+    return ps->getValue(d, time(nullptr));
 }
\ No newline at end of file
@@ -71,7 +71,7 @@ public:
         }
         strcpy(this->mqttConfig.subscribeTopic, statusTopic.c_str());
     };
-    bool publish(AmsData* data, AmsData* previousState, EnergyAccounting* ea, PriceService* ps);
+    bool publish(AmsData* data, AmsData* meterState, EnergyAccounting* ea, PriceService* ps);
     bool publishTemperatures(AmsConfiguration*, HwTools*);
     bool publishPrices(PriceService*);
     bool publishSystem(HwTools* hw, PriceService* ps, EnergyAccounting* ea);
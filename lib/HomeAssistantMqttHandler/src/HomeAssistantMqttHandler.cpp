@@ -19,42 +19,46 @@
 #include <esp_task_wdt.h>
 #endif
 
-bool HomeAssistantMqttHandler::publish(AmsData* update, AmsData* previousState, EnergyAccounting* ea, PriceService* ps) {
+bool HomeAssistantMqttHandler::publish(AmsData* update, AmsData* meterState, EnergyAccounting* ea, PriceService* ps) {
+    collectChanges(meterState);
 	if(topic.isEmpty() || !mqtt.connected())
 		return false;
 
     if(time(nullptr) < FirmwareVersion::BuildEpoch)
         return false;
 
-    AmsData data;
+    // The frame is already applied to meterState
+    AmsData* data = update;
     if(mqttConfig.stateUpdate) {
         uint64_t now = millis64();
         if(now-lastStateUpdate < mqttConfig.stateUpdateInterval * 1000) return false;
-        data.apply(*previousState);
-        data.apply(*update);
+        data = meterState;
         lastStateUpdate = now;
-    } else {
-        data = *update;
     }
 
-    if(data.getListType() >= 3 && !data.isCounterEstimated()) { // publish energy counts
-        publishList3(&data, ea);
+    // Home Assistant keeps the last value of each sensor, so a topic is only sent again when something in it changed
+    uint64_t counters = (1ULL << AmsDataFieldActiveImportCounter) | (1ULL << AmsDataFieldActiveExportCounter) | (1ULL << AmsDataFieldReactiveImportCounter) | (1ULL << AmsDataFieldReactiveExportCounter);
+    if(data->getListType() >= 3 && !data->isCounterEstimated() && (pendingChanges & counters)) { // publish energy counts
+        publishList3(data, ea);
         mqtt.loop();
     }
 
-    if(data.getListType() == 1) { // publish power counts
-        publishList1(&data, ea);
-        mqtt.loop();
-    } else if(data.getListType() <= 3) { // publish power counts and volts/amps
-        publishList2(&data, ea);
-        mqtt.loop();
-    } else if(data.getListType() == 4) { // publish power counts and volts/amps/phase power and PF
-        publishList4(&data, ea);
-        mqtt.loop();
+    if(pendingChanges & AMS_DATA_VALUE_FIELDS & ~counters) {
+        if(data->getListType() == 1) { // publish power counts
+            publishList1(data, ea);
+            mqtt.loop();
+        } else if(data->getListType() <= 3) { // publish power counts and volts/amps
+            publishList2(data, ea);
+            mqtt.loop();
+        } else if(data->getListType() == 4) { // publish power counts and volts/amps/phase power and PF
+            publishList4(data, ea);
+            mqtt.loop();
+        }
     }
+    pendingChanges = 0;
 
     if(ea->isInitialized()) {
-        publishRealtime(&data, ea, ps);
+        publishRealtime(data, ea, ps);
         mqtt.loop();
     }
     loop();
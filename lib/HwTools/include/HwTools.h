@@ -16,6 +16,8 @@
 #include <driver/adc.h>
 #include <esp_adc_cal.h>
 #include <soc/adc_channel.h>
+#elif defined(AMS_NATIVE)
+#include <WiFi.h> // From the host shims in test/native
 #endif
 
 #include <DallasTemperature.h>
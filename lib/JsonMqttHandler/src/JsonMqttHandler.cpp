@@ -9,7 +9,8 @@
 #include "hexutils.h"
 #include "Uptime.h"
 
-bool JsonMqttHandler::publish(AmsData* update, AmsData* previousState, EnergyAccounting* ea, PriceService* ps) {
+bool JsonMqttHandler::publish(AmsData* update, AmsData* meterState, EnergyAccounting* ea, PriceService* ps) {
+    collectChanges(meterState);
     if(strlen(mqttConfig.publishTopic) == 0) {
         return false;
     }
@@ -17,33 +18,37 @@ bool JsonMqttHandler::publish(AmsData* update, AmsData* previousState, EnergyAcc
 		return false;
     }
 
-    bool ret = false;
-    memset(json, 0, BufferSize);
+    // A frame that only moved the meter clock forward is not worth a new document, the full refresh still comes
+    if((pendingChanges & AMS_DATA_VALUE_FIELDS) == 0) {
+        return false;
+    }
 
-    AmsData data;
+    // The frame is already applied to meterState
+    AmsData* data = update;
     if(mqttConfig.stateUpdate) {
         uint64_t now = millis64();
         if(now-lastStateUpdate < mqttConfig.stateUpdateInterval * 1000) return false;
-        data.apply(*previousState);
-        data.apply(*update);
+        data = meterState;
         lastStateUpdate = now;
-    } else {
-        data = *update;
     }
 
-    if(data.getListType() == 1) {
-        ret = publishList1(&data, ea);
+    bool ret = false;
+    memset(json, 0, BufferSize);
+
+    if(data->getListType() == 1) {
+        ret = publishList1(data, ea);
         mqtt.loop();
-    } else if(data.getListType() == 2) {
-        ret = publishList2(&data, ea);
+    } else if(data->getListType() == 2) {
+        ret = publishList2(data, ea);
         mqtt.loop();
-    } else if(data.getListType() == 3) {
-        ret = publishList3(&data, ea);
+    } else if(data->getListType() == 3) {
+        ret = publishList3(data, ea);
         mqtt.loop();
-    } else if(data.getListType() == 4) {
-        ret = publishList4(&data, ea);
+    } else if(data->getListType() == 4) {
+        ret = publishList4(data, ea);
         mqtt.loop();
     }
+    if(ret) pendingChanges = 0;
     loop();
     return ret;
 }
@@ -15,6 +15,7 @@
 #define DOCPOS_MEASUREMENTUNIT 2
 #define DOCPOS_POSITION 3
 #define DOCPOS_AMOUNT 4
+#define DOCPOS_RESOLUTION 5
 
 class EntsoeA44Parser: public Stream {
 public:
@@ -24,6 +25,7 @@ public:
     char* getCurrency();
     char* getMeasurementUnit();
     float getPoint(uint8_t position);
+    uint8_t getResolution();
     
     int available();
     int read();
@@ -31,12 +33,14 @@ public:
     void flush();
     size_t write(const uint8_t *buffer, size_t size);
     size_t write(uint8_t);
-    void get(PricesContainer*);
+    void get(PricesContainer*, uint8_t hours);
 
 private:
     char currency[4];
     char measurementUnit[4];
-    float points[25];
+    float points[PRICE_MAX_POINTS];
+    uint8_t resolution = 0;
+    bool skipPeriod = false;
 
     char buf[64];
     uint8_t pos = 0;
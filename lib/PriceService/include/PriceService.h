@@ -21,6 +21,8 @@
 	#include <ESP8266HTTPClient.h>
 #elif defined(ESP32) // ARDUINO_ARCH_ESP32
 	#include <HTTPClient.h>
+#elif defined(AMS_NATIVE)
+	#include <HTTPClient.h> // From the host shims in test/native
 #else
 	#warning "Unsupported board type"
 #endif
@@ -82,6 +84,9 @@ public:
 
     float getEnergyPriceForHour(uint8_t direction, time_t ts, int8_t hour);
 
+    float getValue(uint8_t direction, time_t ts);
+    float getEnergyPrice(uint8_t direction, time_t ts);
+
     std::vector<PriceConfig>& getPriceConfig();
     void setPriceConfig(uint8_t index, PriceConfig &priceConfig);
     void cropPriceConfig(uint8_t size);
@@ -127,9 +132,10 @@ private:
     int16_t lastError = 0;
 
     PricesContainer* fetchPrices(time_t);
+    float getFixedPrice(uint8_t direction, time_t ts);
+    float addTariffs(float value, uint8_t direction, time_t ts);
+    float getPointValue(PricesContainer* container, uint8_t position);
     bool retrieve(const char* url, Stream* doc);
     float getCurrencyMultiplier(const char* from, const char* to, time_t t);
-
-    void debugPrint(byte *buffer, int start, int length);
 };
 #endif
@@ -7,12 +7,36 @@
 #ifndef _PRICESCONTAINER_H
 #define _PRICESCONTAINER_H
 
+#include <stdint.h>
+
 #define PRICE_NO_VALUE -127
 
-struct PricesContainer {
+// A 25 hour day in quarter hours
+#define PRICE_MAX_POINTS 100
+#define PRICE_POINT_NONE 0xFFFF
+
+// Hourly layout, still what the price hub sends
+struct PricesContainer25 {
     char currency[4];
     char measurementUnit[4];
     int32_t points[25];
     char source[4];
 };
+
+// One day of prices, one point per resolution minutes from local midnight. Points are kept
+// as offsets from the lowest price, in 10^accuracy of the price x 10000, so four times as
+// many points take about the same space as the hourly int32_t points did.
+struct PricesContainer {
+    char currency[4];
+    char measurementUnit[4];
+    char source[4];
+    uint8_t resolution;
+    uint8_t numberOfPoints;
+    uint8_t accuracy;
+    int32_t base;
+    uint16_t points[PRICE_MAX_POINTS];
+
+    void setPoints(const int32_t* values, uint8_t count, uint8_t resolution);
+    int32_t getPoint(uint8_t position);
+};
 #endif
@@ -8,7 +8,7 @@
 #include "HardwareSerial.h"
 
 EntsoeA44Parser::EntsoeA44Parser() {
-    for(int i = 0; i < 25; i++) points[i] = PRICE_NO_VALUE;
+    for(int i = 0; i < PRICE_MAX_POINTS; i++) points[i] = PRICE_NO_VALUE;
 }
 
 EntsoeA44Parser::~EntsoeA44Parser() {
@@ -24,10 +24,15 @@ char* EntsoeA44Parser::getMeasurementUnit() {
 }
 
 float EntsoeA44Parser::getPoint(uint8_t position) {
-    if(position >= 25) return PRICE_NO_VALUE;
+    if(position >= PRICE_MAX_POINTS) return PRICE_NO_VALUE;
     return points[position];
 }
 
+// Minutes per point, 60 before the move to 15 minute settlement
+uint8_t EntsoeA44Parser::getResolution() {
+    return resolution == 0 ? 60 : resolution;
+}
+
 int EntsoeA44Parser::available() {
     return 0;
 }
@@ -78,10 +83,35 @@ size_t EntsoeA44Parser::write(uint8_t byte) {
         } else {
             buf[pos++] = byte;
         }
+    } else if(docPos == DOCPOS_RESOLUTION) {
+        if(byte == '<') {
+            buf[pos] = '\0';
+            // ISO 8601 duration, PT15M or PT60M. A document can carry the same day in
+            // more than one resolution, we keep the finest.
+            uint8_t res = 0;
+            if(strncmp(buf, "PT", 2) == 0 && buf[pos-1] == 'M') {
+                res = String(buf+2).toInt();
+            } else if(strcmp(buf, "PT1H") == 0) {
+                res = 60;
+            }
+            if(res > 0) {
+                skipPeriod = resolution != 0 && res > resolution;
+                if(resolution != 0 && res < resolution) {
+                    for(int i = 0; i < PRICE_MAX_POINTS; i++) points[i] = PRICE_NO_VALUE;
+                }
+                if(!skipPeriod) resolution = res;
+            }
+            docPos = DOCPOS_SEEK;
+            pos = 0;
+        } else {
+            buf[pos++] = byte;
+        }
     } else if(docPos == DOCPOS_AMOUNT) {
         if(byte == '<') {
             buf[pos] = '\0';
-            points[pointNum] = String(buf).toFloat();
+            if(!skipPeriod && pointNum < PRICE_MAX_POINTS) {
+                points[pointNum] = String(buf).toFloat();
+            }
             docPos = DOCPOS_SEEK;
             pos = 0;
         } else {
@@ -102,6 +132,8 @@ size_t EntsoeA44Parser::write(uint8_t byte) {
             } else if(strcmp(buf, "<position>") == 0) {
                 docPos = DOCPOS_POSITION;
                 pointNum = 0xFF;
+            } else if(strcmp(buf, "<resolution>") == 0) {
+                docPos = DOCPOS_RESOLUTION;
             } else if(strcmp(buf, "<price.amount>") == 0) {
                 docPos = DOCPOS_AMOUNT;
             }
@@ -113,14 +145,24 @@ size_t EntsoeA44Parser::write(uint8_t byte) {
     return 1;
 }
 
-void EntsoeA44Parser::get(PricesContainer* container) {
+// Hours is the length of the local day, 23 to 25. A curve of type A03 leaves out positions
+// that have the same price as the one before, so gaps are filled from the previous point.
+void EntsoeA44Parser::get(PricesContainer* container, uint8_t hours) {
     memset(container, 0, sizeof(*container));
 
     strcpy(container->currency, currency);
     strcpy(container->measurementUnit, measurementUnit);
     strcpy(container->source, "EOE");
 
-    for(uint8_t i = 0; i < 25; i++) {
-        container->points[i] = points[i] == PRICE_NO_VALUE ? PRICE_NO_VALUE : points[i] * 10000;
+    uint8_t res = getResolution();
+    uint8_t count = min(hours * 60 / res, PRICE_MAX_POINTS);
+    int32_t values[PRICE_MAX_POINTS];
+    for(uint8_t i = 0; i < count; i++) {
+        if(points[i] != PRICE_NO_VALUE) {
+            values[i] = points[i] * 10000;
+        } else {
+            values[i] = i == 0 ? PRICE_NO_VALUE : values[i-1];
+        }
     }
+    container->setPoints(values, count, res);
 }
\ No newline at end of file
@@ -105,12 +105,21 @@ float PriceService::getValueForHour(uint8_t direction, int8_t hour) {
 }
 
 float PriceService::getValueForHour(uint8_t direction, time_t ts, int8_t hour) {
-    float ret = getEnergyPriceForHour(direction, ts, hour);
-    if(ret == PRICE_NO_VALUE)
-        return ret;
+    return addTariffs(getEnergyPriceForHour(direction, ts, hour), direction, ts + (hour * SECS_PER_HOUR));
+}
+
+// Price for the point covering ts, which is a quarter of an hour once the area has moved to
+// 15 minute settlement
+float PriceService::getValue(uint8_t direction, time_t ts) {
+    return addTariffs(getEnergyPrice(direction, ts), direction, ts);
+}
+
+float PriceService::addTariffs(float value, uint8_t direction, time_t ts) {
+    if(value == PRICE_NO_VALUE)
+        return value;
 
     tmElements_t tm;
-    breakTime(tz->toLocal(ts + (hour * SECS_PER_HOUR)), tm);
+    breakTime(tz->toLocal(ts), tm);
     uint8_t day = 0x01 << ((tm.Wday+5)%7);
     uint32_t hrs = 0x01 << tm.Hour;
 
@@ -125,23 +134,23 @@ float PriceService::getValueForHour(uint8_t direction, time_t ts, int8_t hour) {
         if((pc.direction & direction) == direction && (pc.days & day) == day && (pc.hours & hrs) == hrs && tm.Month >= start_month && tm.Day >= start_dayofmonth && tm.Month <= end_month && tm.Day <= end_dayofmonth) {
             switch(pc.type) {
                 case PRICE_TYPE_ADD:
-                    ret += pc.value / 10000.0;
+                    value += pc.value / 10000.0;
                     break;
                 case PRICE_TYPE_SUBTRACT:
-                    ret -= pc.value / 10000.0;
+                    value -= pc.value / 10000.0;
                     break;
                 case PRICE_TYPE_PCT:
-                    ret += ((pc.value / 10000.0) * ret) / 100.0;
+                    value += ((pc.value / 10000.0) * value) / 100.0;
                     break;
             }
         }
     }
-    return ret;
+    return value;
 }
 
-float PriceService::getEnergyPriceForHour(uint8_t direction, time_t ts, int8_t hour) {
+float PriceService::getFixedPrice(uint8_t direction, time_t ts) {
     tmElements_t tm;
-    breakTime(tz->toLocal(ts + (hour * SECS_PER_HOUR)), tm);
+    breakTime(tz->toLocal(ts), tm);
     uint8_t day = 0x01 << ((tm.Wday+5)%7);
     uint32_t hrs = 0x01 << tm.Hour;
 
@@ -162,61 +171,72 @@ float PriceService::getEnergyPriceForHour(uint8_t direction, time_t ts, int8_t h
             }
         }
     }
-    if(value != PRICE_NO_VALUE) return value;
+    return value;
+}
 
-    int8_t pos = hour;
+// Average of the points within the hour, so hourly consumers see the same as before on
+// days with hourly prices
+float PriceService::getEnergyPriceForHour(uint8_t direction, time_t ts, int8_t hour) {
+    time_t start = ts + (hour * SECS_PER_HOUR);
+    start -= start % SECS_PER_HOUR;
 
-    breakTime(tz->toLocal(ts), tm);
-    while(tm.Hour > 0) {
-        ts -= 3600;
-        breakTime(tz->toLocal(ts), tm);
-        pos++;
+    float sum = 0;
+    for(uint8_t i = 0; i < 4; i++) {
+        float value = getEnergyPrice(direction, start + (i * 900));
+        if(value == PRICE_NO_VALUE)
+            return PRICE_NO_VALUE;
+        sum += value;
     }
-    uint8_t hoursToday = 0;
-    uint8_t todayDate = tm.Day;
-    while(tm.Day == todayDate) {
-        ts += 3600;
-        breakTime(tz->toLocal(ts), tm);
-        hoursToday++;
+    return sum / 4;
+}
+
+float PriceService::getEnergyPrice(uint8_t direction, time_t ts) {
+    float value = getFixedPrice(direction, ts);
+    if(value != PRICE_NO_VALUE) return value;
+
+    // Points count from local midnight, which is 23 or 25 hours from the next one on DST days
+    tmElements_t tm;
+    time_t local = tz->toLocal(ts);
+    breakTime(local, tm);
+    time_t localMidnight = local - (tm.Hour * SECS_PER_HOUR) - (tm.Minute * 60) - tm.Second;
+    time_t midnight = tz->toUTC(localMidnight);
+    time_t nextMidnight = tz->toUTC(localMidnight + SECS_PER_DAY);
+
+    PricesContainer* container;
+    time_t elapsed;
+    if(ts < nextMidnight) {
+        container = today;
+        elapsed = ts - midnight;
+    } else {
+        container = tomorrow;
+        elapsed = ts - nextMidnight;
     }
-    if(pos > 49)
+    if(container == NULL || elapsed < 0 || container->resolution == 0)
+        return PRICE_NO_VALUE;
+
+    uint32_t position = elapsed / (container->resolution * 60);
+    if(position >= container->numberOfPoints)
+        return PRICE_NO_VALUE;
+    return getPointValue(container, position);
+}
+
+float PriceService::getPointValue(PricesContainer* container, uint8_t position) {
+    int32_t point = container->getPoint(position);
+    if(point == PRICE_NO_VALUE)
         return PRICE_NO_VALUE;
 
     float multiplier = 1.0;
-    if(pos >= hoursToday) {
-        if(tomorrow == NULL)
-            return PRICE_NO_VALUE;
-        if(tomorrow->points[pos-hoursToday] == PRICE_NO_VALUE)
-            return PRICE_NO_VALUE;
-        value = tomorrow->points[pos-hoursToday] / 10000.0;
-        if(strcmp(tomorrow->measurementUnit, "KWH") == 0) {
-            // Multiplier is 1
-        } else if(strcmp(tomorrow->measurementUnit, "MWH") == 0) {
-            multiplier *= 0.001;
-        } else {
-            return PRICE_NO_VALUE;
-        }
-        float mult = getCurrencyMultiplier(tomorrow->currency, config->currency, time(nullptr));
-        if(mult == 0) return PRICE_NO_VALUE;
-        multiplier *= mult;
-    } else if(pos >= 0) {
-        if(today == NULL)
-            return PRICE_NO_VALUE;
-        if(today->points[pos] == PRICE_NO_VALUE)
-            return PRICE_NO_VALUE;
-        value = today->points[pos] / 10000.0;
-        if(strcmp(today->measurementUnit, "KWH") == 0) {
-            // Multiplier is 1
-        } else if(strcmp(today->measurementUnit, "MWH") == 0) {
-            multiplier *= 0.001;
-        } else {
-            return PRICE_NO_VALUE;
-        }
-        float mult = getCurrencyMultiplier(today->currency, config->currency, time(nullptr));
-        if(mult == 0) return PRICE_NO_VALUE;
-        multiplier *= mult;
+    if(strcmp(container->measurementUnit, "KWH") == 0) {
+        // Multiplier is 1
+    } else if(strcmp(container->measurementUnit, "MWH") == 0) {
+        multiplier *= 0.001;
+    } else {
+        return PRICE_NO_VALUE;
     }
-    return value * multiplier;
+    float mult = getCurrencyMultiplier(container->currency, config->currency, time(nullptr));
+    if(mult == 0) return PRICE_NO_VALUE;
+    multiplier *= mult;
+    return (point / 10000.0) * multiplier;
 }
 
 bool PriceService::loop() {
@@ -408,8 +428,9 @@ PricesContainer* PriceService::fetchPrices(time_t t) {
     if(strlen(getToken()) > 0) {
         tmElements_t tm;
         breakTime(tz->toLocal(t), tm);
-        time_t e1 = t - (tm.Hour * 3600) - (tm.Minute * 60) - tm.Second; // Local midnight
-        time_t e2 = e1 + SECS_PER_DAY;
+        time_t localMidnight = tz->toLocal(t) - (tm.Hour * 3600) - (tm.Minute * 60) - tm.Second;
+        time_t e1 = tz->toUTC(localMidnight);
+        time_t e2 = tz->toUTC(localMidnight + SECS_PER_DAY); // 23 or 25 hours later on DST days
         tmElements_t d1, d2;
         breakTime(e1, d1);
         breakTime(e2, d2);
@@ -437,7 +458,7 @@ debugger->printf_P(PSTR("(PriceService)  url: %s\n"), buf);
         EntsoeA44Parser a44;
         if(retrieve(buf, &a44) && a44.getPoint(0) != PRICE_NO_VALUE) {
             PricesContainer* ret = new PricesContainer();
-            a44.get(ret);
+            a44.get(ret, (e2 - e1) / SECS_PER_HOUR);
             return ret;
         } else {
             return NULL;
@@ -483,19 +504,22 @@ debugger->printf_P(PSTR("(PriceService)  url: %s\n"), buf);
                 
                 uint8_t* content = (uint8_t*) (data.c_str());
 
-                DataParserContext ctx = {0,0,0,0};
+                DataParserContext ctx = {};
                 ctx.length = data.length();
                 GCMParser gcm(key, auth);
                 int8_t gcmRet = gcm.parse(content, ctx);
                 if(gcmRet > 0) {
-                    PricesContainer* ret = new PricesContainer();
+                    PricesContainer25 hourly;
+                    memcpy(&hourly, content+gcmRet, sizeof(hourly));
                     for(uint8_t i = 0; i < 25; i++) {
-                        ret->points[i] = PRICE_NO_VALUE;
-                    }
-                    memcpy(ret, content+gcmRet, sizeof(*ret));
-                    for(uint8_t i = 0; i < 25; i++) {
-                        ret->points[i] = ntohl(ret->points[i]);
+                        hourly.points[i] = ntohl(hourly.points[i]);
                     }
+                    PricesContainer* ret = new PricesContainer();
+                    memset(ret, 0, sizeof(*ret));
+                    memcpy(ret->currency, hourly.currency, sizeof(ret->currency));
+                    memcpy(ret->measurementUnit, hourly.measurementUnit, sizeof(ret->measurementUnit));
+                    memcpy(ret->source, hourly.source, sizeof(ret->source));
+                    ret->setPoints(hourly.points, 25, 60);
                     lastError = 0;
                     nextFetchDelayMinutes = 1;
                     return ret;
@@ -539,22 +563,6 @@ debugger->printf(http->getString().c_str());
     return NULL;
 }
 
-void PriceService::debugPrint(byte *buffer, int start, int length) {
-	for (int i = start; i < start + length; i++) {
-		if (buffer[i] < 0x10)
-			debugger->print(F("0"));
-		debugger->print(buffer[i], HEX);
-		debugger->print(F(" "));
-		if ((i - start + 1) % 16 == 0)
-			debugger->println(F(""));
-		else if ((i - start + 1) % 4 == 0)
-			debugger->print(F(" "));
-
-		yield(); // Let other get some resources too
-	}
-	debugger->println(F(""));
-}
-
 int16_t PriceService::getLastError() {
     return lastError;
 }
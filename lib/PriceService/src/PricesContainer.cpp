@@ -0,0 +1,44 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#include "PricesContainer.h"
+#include <math.h>
+
+// Values are price x 10000, PRICE_NO_VALUE where there is no price
+void PricesContainer::setPoints(const int32_t* values, uint8_t count, uint8_t resolution) {
+    if(count > PRICE_MAX_POINTS) count = PRICE_MAX_POINTS;
+    this->resolution = resolution;
+    this->numberOfPoints = count;
+
+    int32_t min = INT32_MAX, max = INT32_MIN;
+    for(uint8_t i = 0; i < count; i++) {
+        if(values[i] == PRICE_NO_VALUE) continue;
+        if(values[i] < min) min = values[i];
+        if(values[i] > max) max = values[i];
+    }
+    base = min == INT32_MAX ? 0 : min;
+
+    // Reduce accuracy until the spread fits, keeping one value free for PRICE_POINT_NONE
+    accuracy = 0;
+    uint32_t range = max > min ? (uint32_t) ((int64_t) max - min) : 0;
+    while((range + (uint32_t) pow(10, accuracy) / 2) / (uint32_t) pow(10, accuracy) >= PRICE_POINT_NONE) {
+        accuracy++;
+    }
+
+    uint32_t divisor = pow(10, accuracy);
+    for(uint8_t i = 0; i < PRICE_MAX_POINTS; i++) {
+        if(i >= count || values[i] == PRICE_NO_VALUE) {
+            points[i] = PRICE_POINT_NONE;
+        } else {
+            points[i] = ((uint32_t) ((int64_t) values[i] - base) + divisor / 2) / divisor;
+        }
+    }
+}
+
+int32_t PricesContainer::getPoint(uint8_t position) {
+    if(position >= numberOfPoints || points[position] == PRICE_POINT_NONE) return PRICE_NO_VALUE;
+    return base + (int32_t) (points[position] * (uint32_t) pow(10, accuracy));
+}
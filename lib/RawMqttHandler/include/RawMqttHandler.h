@@ -22,7 +22,7 @@ public:
         topic = String(mqttConfig.publishTopic);
     };
     #endif
-    bool publish(AmsData* data, AmsData* previousState, EnergyAccounting* ea, PriceService* ps);
+    bool publish(AmsData* data, AmsData* meterState, EnergyAccounting* ea, PriceService* ps);
     bool publishTemperatures(AmsConfiguration*, HwTools*);
     bool publishPrices(PriceService*);
     bool publishSystem(HwTools* hw, PriceService* ps, EnergyAccounting* ea);
@@ -36,11 +36,10 @@ private:
     bool full;
     String topic;
     uint32_t lastThresholdPublish = 0;
-
-    bool publishList1(AmsData* data, AmsData* meterState);
-    bool publishList2(AmsData* data, AmsData* meterState);
-    bool publishList3(AmsData* data, AmsData* meterState);
-    bool publishList4(AmsData* data, AmsData* meterState);
+    bool publishList1(AmsData* data);
+    bool publishList2(AmsData* data);
+    bool publishList3(AmsData* data);
+    bool publishList4(AmsData* data);
     bool publishRealtime(EnergyAccounting* ea);
 };
 #endif
@@ -8,38 +8,39 @@
 #include "hexutils.h"
 #include "Uptime.h"
 
-bool RawMqttHandler::publish(AmsData* update, AmsData* previousState, EnergyAccounting* ea, PriceService* ps) {
+bool RawMqttHandler::publish(AmsData* update, AmsData* meterState, EnergyAccounting* ea, PriceService* ps) {
+    collectChanges(meterState);
+    if(full) pendingChanges = AMS_DATA_ALL_FIELDS;
 	if(topic.isEmpty() || !mqtt.connected())
 		return false;
 
-    AmsData data;
+    // The frame is already applied to meterState
+    AmsData* data = update;
     if(mqttConfig.stateUpdate) {
         uint64_t now = millis64();
         if(now-lastStateUpdate < mqttConfig.stateUpdateInterval * 1000) return false;
-        data.apply(*previousState);
-        data.apply(*update);
+        data = meterState;
         lastStateUpdate = now;
-    } else {
-        data = *update;
     }
         
-    if(data.getPackageTimestamp() > 0) {
-        mqtt.publish(topic + "/meter/dlms/timestamp", String(data.getPackageTimestamp()));
+    if(data->getPackageTimestamp() > 0) {
+        mqtt.publish(topic + "/meter/dlms/timestamp", String(data->getPackageTimestamp()));
     }
-    switch(data.getListType()) {
+    switch(data->getListType()) {
         case 4:
-            publishList4(&data, previousState);
+            publishList4(data);
             loop();
         case 3:
-            publishList3(&data, previousState);
+            publishList3(data);
             loop();
         case 2:
-            publishList2(&data, previousState);
+            publishList2(data);
             loop();
         case 1:
-            publishList1(&data, previousState);
+            publishList1(data);
             loop();
     }
+    pendingChanges = 0;
     if(ea->isInitialized()) {
         publishRealtime(ea);
         loop();
@@ -47,56 +48,56 @@ bool RawMqttHandler::publish(AmsData* update, AmsData* previousState, EnergyAcco
     return true;
 }
 
-bool RawMqttHandler::publishList1(AmsData* data, AmsData* meterState) {
-    if(full || meterState->getActiveImportPower() != data->getActiveImportPower()) {
+bool RawMqttHandler::publishList1(AmsData* data) {
+    if(isChanged(AmsDataFieldActiveImportPower)) {
         mqtt.publish(topic + "/meter/import/active", String(data->getActiveImportPower()));
     }
     return true;
 }
 
-bool RawMqttHandler::publishList2(AmsData* data, AmsData* meterState) {
+bool RawMqttHandler::publishList2(AmsData* data) {
     // Only send data if changed. ID and Type is sent on the 10s interval only if changed
-    if(full || meterState->getMeterId() != data->getMeterId()) {
+    if(isChanged(AmsDataFieldMeterId)) {
         mqtt.publish(topic + "/meter/id", data->getMeterId());
     }
-    if(full || meterState->getMeterModel() != data->getMeterModel()) {
+    if(isChanged(AmsDataFieldMeterModel)) {
         mqtt.publish(topic + "/meter/type", data->getMeterModel());
     }
     loop();
-    if(full || meterState->getL1Current() != data->getL1Current()) {
+    if(isChanged(AmsDataFieldL1Current)) {
         mqtt.publish(topic + "/meter/l1/current", String(data->getL1Current(), 2));
     }
-    if(full || meterState->getL1Voltage() != data->getL1Voltage()) {
+    if(isChanged(AmsDataFieldL1Voltage)) {
         mqtt.publish(topic + "/meter/l1/voltage", String(data->getL1Voltage(), 2));
     }
     loop();
-    if(full || meterState->getL2Current() != data->getL2Current()) {
+    if(isChanged(AmsDataFieldL2Current)) {
         mqtt.publish(topic + "/meter/l2/current", String(data->getL2Current(), 2));
     }
-    if(full || meterState->getL2Voltage() != data->getL2Voltage()) {
+    if(isChanged(AmsDataFieldL2Voltage)) {
         mqtt.publish(topic + "/meter/l2/voltage", String(data->getL2Voltage(), 2));
     }
     loop();
-    if(full || meterState->getL3Current() != data->getL3Current()) {
+    if(isChanged(AmsDataFieldL3Current)) {
         mqtt.publish(topic + "/meter/l3/current", String(data->getL3Current(), 2));
     }
-    if(full || meterState->getL3Voltage() != data->getL3Voltage()) {
+    if(isChanged(AmsDataFieldL3Voltage)) {
         mqtt.publish(topic + "/meter/l3/voltage", String(data->getL3Voltage(), 2));
     }
     loop();
-    if(full || meterState->getReactiveExportPower() != data->getReactiveExportPower()) {
+    if(isChanged(AmsDataFieldReactiveExportPower)) {
         mqtt.publish(topic + "/meter/export/reactive", String(data->getReactiveExportPower()));
     }
-    if(full || meterState->getActiveExportPower() != data->getActiveExportPower()) {
+    if(isChanged(AmsDataFieldActiveExportPower)) {
         mqtt.publish(topic + "/meter/export/active", String(data->getActiveExportPower()));
     }
-    if(full || meterState->getReactiveImportPower() != data->getReactiveImportPower()) {
+    if(isChanged(AmsDataFieldReactiveImportPower)) {
         mqtt.publish(topic + "/meter/import/reactive", String(data->getReactiveImportPower()));
     }
     return true;
 }
 
-bool RawMqttHandler::publishList3(AmsData* data, AmsData* meterState) {
+bool RawMqttHandler::publishList3(AmsData* data) {
     // ID and type belongs to List 2, but I see no need to send that every 10s
     mqtt.publish(topic + "/meter/id", data->getMeterId(), true, 0);
     mqtt.publish(topic + "/meter/type", data->getMeterModel(), true, 0);
@@ -108,68 +109,68 @@ bool RawMqttHandler::publishList3(AmsData* data, AmsData* meterState) {
     return true;
 }
 
-bool RawMqttHandler::publishList4(AmsData* data, AmsData* meterState) {
-        if(full || meterState->getL1ActiveImportPower() != data->getL1ActiveImportPower()) {
+bool RawMqttHandler::publishList4(AmsData* data) {
+        if(isChanged(AmsDataFieldL1ActiveImportPower)) {
             mqtt.publish(topic + "/meter/import/l1", String(data->getL1ActiveImportPower()));
             mqtt.loop();
         }
-        if(full || meterState->getL2ActiveImportPower() != data->getL2ActiveImportPower()) {
+        if(isChanged(AmsDataFieldL2ActiveImportPower)) {
             mqtt.publish(topic + "/meter/import/l2", String(data->getL2ActiveImportPower()));
             mqtt.loop();
         }
-        if(full || meterState->getL3ActiveImportPower() != data->getL3ActiveImportPower()) {
+        if(isChanged(AmsDataFieldL3ActiveImportPower)) {
             mqtt.publish(topic + "/meter/import/l3", String(data->getL3ActiveImportPower()));
             mqtt.loop();
         }
-        if(full || meterState->getL1ActiveExportPower() != data->getL1ActiveExportPower()) {
+        if(isChanged(AmsDataFieldL1ActiveExportPower)) {
             mqtt.publish(topic + "/meter/export/l1", String(data->getL1ActiveExportPower()));
             mqtt.loop();
         }
-        if(full || meterState->getL2ActiveExportPower() != data->getL2ActiveExportPower()) {
+        if(isChanged(AmsDataFieldL2ActiveExportPower)) {
             mqtt.publish(topic + "/meter/export/l2", String(data->getL2ActiveExportPower()));
             mqtt.loop();
         }
-        if(full || meterState->getL3ActiveExportPower() != data->getL3ActiveExportPower()) {
+        if(isChanged(AmsDataFieldL3ActiveExportPower)) {
             mqtt.publish(topic + "/meter/export/l3", String(data->getL3ActiveExportPower()));
             mqtt.loop();
         }
-        if(full || meterState->getL1ActiveImportCounter() != data->getL1ActiveImportCounter()) {
+        if(isChanged(AmsDataFieldL1ActiveImportCounter)) {
             mqtt.publish(topic + "/meter/import/l1/accumulated", String(data->getL1ActiveImportCounter(), 2));
             mqtt.loop();
         }
-        if(full || meterState->getL2ActiveImportCounter() != data->getL2ActiveImportCounter()) {
+        if(isChanged(AmsDataFieldL2ActiveImportCounter)) {
             mqtt.publish(topic + "/meter/import/l2/accumulated", String(data->getL2ActiveImportCounter(), 2));
             mqtt.loop();
         }
-        if(full || meterState->getL3ActiveImportCounter() != data->getL3ActiveImportCounter()) {
+        if(isChanged(AmsDataFieldL3ActiveImportCounter)) {
             mqtt.publish(topic + "/meter/import/l3/accumulated", String(data->getL3ActiveImportCounter(), 2));
             mqtt.loop();
         }
-        if(full || meterState->getL1ActiveExportCounter() != data->getL1ActiveExportCounter()) {
+        if(isChanged(AmsDataFieldL1ActiveExportCounter)) {
             mqtt.publish(topic + "/meter/export/l1/accumulated", String(data->getL1ActiveExportCounter(), 2));
             mqtt.loop();
         }
-        if(full || meterState->getL2ActiveExportCounter() != data->getL2ActiveExportCounter()) {
+        if(isChanged(AmsDataFieldL2ActiveExportCounter)) {
             mqtt.publish(topic + "/meter/export/l2/accumulated", String(data->getL2ActiveExportCounter(), 2));
             mqtt.loop();
         }
-        if(full || meterState->getL3ActiveExportCounter() != data->getL3ActiveExportCounter()) {
+        if(isChanged(AmsDataFieldL3ActiveExportCounter)) {
             mqtt.publish(topic + "/meter/export/l3/accumulated", String(data->getL3ActiveExportCounter(), 2));
             mqtt.loop();
         }
-        if(full || meterState->getPowerFactor() != data->getPowerFactor()) {
+        if(isChanged(AmsDataFieldPowerFactor)) {
             mqtt.publish(topic + "/meter/powerfactor", String(data->getPowerFactor(), 2));
             mqtt.loop();
         }
-        if(full || meterState->getL1PowerFactor() != data->getL1PowerFactor()) {
+        if(isChanged(AmsDataFieldL1PowerFactor)) {
             mqtt.publish(topic + "/meter/l1/powerfactor", String(data->getL1PowerFactor(), 2));
             mqtt.loop();
         }
-        if(full || meterState->getL2PowerFactor() != data->getL2PowerFactor()) {
+        if(isChanged(AmsDataFieldL2PowerFactor)) {
             mqtt.publish(topic + "/meter/l2/powerfactor", String(data->getL2PowerFactor(), 2));
             mqtt.loop();
         }
-        if(full || meterState->getL3PowerFactor() != data->getL3PowerFactor()) {
+        if(isChanged(AmsDataFieldL3PowerFactor)) {
             mqtt.publish(topic + "/meter/l3/powerfactor", String(data->getL3PowerFactor(), 2));
             mqtt.loop();
         }
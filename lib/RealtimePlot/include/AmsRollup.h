@@ -0,0 +1,68 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#ifndef _AMSROLLUP_H
+#define _AMSROLLUP_H
+
+#include <stdint.h>
+#include "AmsData.h"
+#include "Timezone.h"
+
+enum RollupTier {
+    RollupTier10s = 0,
+    RollupTierMinute,
+    RollupTierQuarter,
+    RollupTierHour,
+    RollupTierDay,
+    RollupTierMonth,
+    RollupTierCount
+};
+
+struct RollupAggregate {
+    time_t start;           // UTC, start of the bucket in local time
+    uint32_t samples;
+    int32_t minPower;       // W, import minus export
+    int32_t maxPower;
+    int64_t powerSum;
+    uint64_t importStart;   // mWh, energy position when the bucket opened
+    uint64_t importEnd;     // mWh, energy position at the last sample
+    uint64_t exportStart;
+    uint64_t exportEnd;
+    bool complete;          // Opened when the previous bucket closed, not part way through
+};
+
+// Keeps min/max/avg power and energy for the running and the last closed bucket at each
+// resolution, with constant work per frame. Energy follows the meter counters when there
+// are any, otherwise the integrated power.
+class AmsRollup {
+public:
+    void setTimezone(Timezone* tz);
+    uint8_t update(AmsData& data, time_t now);
+    bool isClosed(uint8_t tier);
+    bool hasCounters();
+    RollupAggregate* getCurrent(uint8_t tier);
+    RollupAggregate* getLast(uint8_t tier);
+
+    static int32_t getAveragePower(RollupAggregate* agg);
+    static uint32_t getImportWh(RollupAggregate* agg);
+    static uint32_t getExportWh(RollupAggregate* agg);
+
+private:
+    Timezone* tz = NULL;
+    RollupAggregate current[RollupTierCount] = {};
+    RollupAggregate last[RollupTierCount] = {};
+    uint32_t keys[RollupTierCount] = { 0 };
+    uint8_t closed = 0;
+
+    bool started = false;
+    bool counters = false;
+    uint64_t lastUpdateMillis = 0;
+    uint64_t importPosition = 0;
+    uint64_t exportPosition = 0;
+
+    void open(uint8_t tier, uint32_t key, time_t start, bool complete);
+};
+#endif
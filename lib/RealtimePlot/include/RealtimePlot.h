@@ -8,7 +8,7 @@
 #define _REALTIMEPLOT_H
 
 #include <stdint.h>
-#include "AmsData.h"
+#include "AmsRollup.h"
 
 #define REALTIME_SAMPLE 10000
 #define REALTIME_SIZE 360
@@ -16,7 +16,7 @@
 class RealtimePlot {
 public:
     RealtimePlot();
-    void update(AmsData& data);
+    void update(AmsRollup& rollup);
     int32_t getValue(uint16_t req);
     int16_t getSize();
 
@@ -25,7 +25,6 @@ private:
     uint8_t* scaling;
 
     unsigned long lastMillis = 0;
-    double lastReading = 0;
     uint16_t lastPos = 0;
 };
 #endif
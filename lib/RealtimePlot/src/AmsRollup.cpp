@@ -0,0 +1,137 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#include "AmsRollup.h"
+#include <math.h>
+
+static const uint16_t RollupWidth[RollupTierMonth] = { 10, 60, 900, 3600, 0 }; // Day and month are by calendar
+
+void AmsRollup::setTimezone(Timezone* tz) {
+    this->tz = tz;
+}
+
+// Called once per frame. Returns a bitmap of the tiers that closed a bucket with this frame,
+// the closed bucket is then available from getLast().
+uint8_t AmsRollup::update(AmsData& data, time_t now) {
+    closed = 0;
+
+    uint64_t millis = data.getLastUpdateMillis();
+    uint32_t importPower = data.getActiveImportPower();
+    uint32_t exportPower = data.getActiveExportPower();
+    int32_t power = (int32_t) importPower - (int32_t) exportPower;
+
+    // W x ms to mWh, same as in AmsData::apply()
+    if(started && millis > lastUpdateMillis) {
+        uint64_t ms = millis - lastUpdateMillis;
+        importPosition += ((uint64_t) importPower * ms + 1800) / 3600;
+        exportPosition += ((uint64_t) exportPower * ms + 1800) / 3600;
+    }
+    lastUpdateMillis = millis;
+
+    if(data.getActiveImportCounter() > 0) {
+        uint64_t importCounter = llround(data.getActiveImportCounter() * 1000000);
+        uint64_t exportCounter = llround(data.getActiveExportCounter() * 1000000);
+        if(!counters && started) {
+            // Move the open buckets along, so the switch from integrated power does not show as usage
+            for(uint8_t i = 0; i < RollupTierCount; i++) {
+                current[i].importStart += importCounter - importPosition;
+                current[i].exportStart += exportCounter - exportPosition;
+            }
+        }
+        counters = true;
+        // A counter going far backwards is a meter swap, not negative energy. Small steps back
+        // are the meter correcting our estimate.
+        if(importCounter + 1000000 < importPosition || exportCounter + 1000000 < exportPosition) {
+            for(uint8_t i = 0; i < RollupTierCount; i++) {
+                current[i].importStart = importCounter;
+                current[i].exportStart = exportCounter;
+            }
+        }
+        importPosition = importCounter;
+        exportPosition = exportCounter;
+    }
+
+    time_t local = tz == NULL ? now : tz->toLocal(now);
+    tmElements_t tm;
+    breakTime(local, tm);
+    for(uint8_t i = 0; i < RollupTierCount; i++) {
+        uint32_t key;
+        time_t start;
+        if(i < RollupTierDay) {
+            key = local / RollupWidth[i];
+            start = key * RollupWidth[i];
+        } else if(i == RollupTierDay) {
+            key = local / 86400;
+            start = key * 86400;
+        } else {
+            key = tm.Year * 12 + tm.Month;
+            start = local - ((tm.Day - 1) * 86400) - (tm.Hour * 3600) - (tm.Minute * 60) - tm.Second;
+        }
+        start -= local - now;
+
+        if(!started) {
+            open(i, key, start, false);
+        } else if(key != keys[i]) {
+            // Local time jumps at DST changes, so fixed width buckets follow on by UTC time
+            bool follows = i < RollupTierDay ? start == current[i].start + RollupWidth[i] : key == keys[i] + 1;
+            last[i] = current[i];
+            closed |= 1 << i;
+            open(i, key, start, follows);
+        }
+
+        RollupAggregate& agg = current[i];
+        if(agg.samples == 0 || power < agg.minPower) agg.minPower = power;
+        if(agg.samples == 0 || power > agg.maxPower) agg.maxPower = power;
+        agg.powerSum += power;
+        agg.samples++;
+        agg.importEnd = importPosition;
+        agg.exportEnd = exportPosition;
+    }
+    started = true;
+    return closed;
+}
+
+// A new bucket carries on from where the previous one ended, so the energy between the
+// last frame of one bucket and the first of the next is not lost
+void AmsRollup::open(uint8_t tier, uint32_t key, time_t start, bool complete) {
+    uint64_t importStart = started ? current[tier].importEnd : importPosition;
+    uint64_t exportStart = started ? current[tier].exportEnd : exportPosition;
+    keys[tier] = key;
+    current[tier] = { start, 0, 0, 0, 0, importStart, importStart, exportStart, exportStart, complete };
+}
+
+bool AmsRollup::isClosed(uint8_t tier) {
+    return tier < RollupTierCount && (closed & (1 << tier)) != 0;
+}
+
+bool AmsRollup::hasCounters() {
+    return counters;
+}
+
+RollupAggregate* AmsRollup::getCurrent(uint8_t tier) {
+    if(!started || tier >= RollupTierCount) return NULL;
+    return &current[tier];
+}
+
+RollupAggregate* AmsRollup::getLast(uint8_t tier) {
+    if(tier >= RollupTierCount || last[tier].samples == 0) return NULL;
+    return &last[tier];
+}
+
+int32_t AmsRollup::getAveragePower(RollupAggregate* agg) {
+    if(agg == NULL || agg->samples == 0) return 0;
+    return agg->powerSum / (int64_t) agg->samples;
+}
+
+uint32_t AmsRollup::getImportWh(RollupAggregate* agg) {
+    if(agg == NULL || agg->importEnd < agg->importStart) return 0;
+    return (agg->importEnd - agg->importStart + 500) / 1000;
+}
+
+uint32_t AmsRollup::getExportWh(RollupAggregate* agg) {
+    if(agg == NULL || agg->exportEnd < agg->exportStart) return 0;
+    return (agg->exportEnd - agg->exportStart + 500) / 1000;
+}
@@ -14,30 +14,27 @@ RealtimePlot::RealtimePlot() {
     memset(scaling, 0, REALTIME_SIZE);
 }
 
-void RealtimePlot::update(AmsData& data) {
+// Takes the average of each closed 10 second bucket, and repeats it over any slots we
+// did not get a bucket for
+void RealtimePlot::update(AmsRollup& rollup) {
+    if(!rollup.isClosed(RollupTier10s)) return;
+
     unsigned long now = millis();
     uint16_t pos = (now / REALTIME_SAMPLE) % REALTIME_SIZE;
     if(lastMillis == 0) {
-        lastMillis = now;
-        lastReading = data.getActiveImportCounter() - data.getActiveExportCounter();
-        lastPos = pos;
-        return;
+        lastPos = pos == 0 ? REALTIME_SIZE - 1 : pos - 1;
     }
-    if(pos == lastPos && data.isCounterEstimated()) return;
 
-    unsigned long ms = now - lastMillis;
-    int32_t val; // A bit hacky this one, but just to avoid spikes at end of hour. Will mostly be correct
-    if(data.isCounterEstimated()) {
-        val = ((data.getActiveImportCounter() - data.getActiveExportCounter() - lastReading) * 1000) / (((float) ms) / 3600000.0);
-    } else {
-        val = data.getActiveImportPower() - data.getActiveExportPower();
-    }
+    int32_t val = AmsRollup::getAveragePower(rollup.getLast(RollupTier10s));
     uint8_t scale = 0;
     int32_t update = val / pow(10, scale);
     while(update > INT8_MAX || update < INT8_MIN) {
         update = val / pow(10, ++scale);
     }
-    if(pos < lastPos) {
+    if(pos == lastPos) {
+        values[pos] = update;
+        scaling[pos] = scale;
+    } else if(pos < lastPos) {
         for(uint16_t i = lastPos+1; i < REALTIME_SIZE; i++) {
             values[i] = update;
             scaling[i] = scale;
@@ -54,7 +51,6 @@ void RealtimePlot::update(AmsData& data) {
     }
 
     lastMillis = now;
-    lastReading = data.getActiveImportCounter() - data.getActiveExportCounter();
     lastPos = pos;
 }
 
@@ -11,8 +11,11 @@ static const char HEADER_EXPIRES[] PROGMEM = "Expires";
 static const char HEADER_AUTHENTICATE[] PROGMEM = "WWW-Authenticate";
 static const char HEADER_LOCATION[] PROGMEM = "Location";
 static const char HEADER_ACCESS_CONTROL_ALLOW_ORIGIN[] PROGMEM = "Access-Control-Allow-Origin";
+static const char HEADER_ETAG[] PROGMEM = "ETag";
+static const char HEADER_IF_NONE_MATCH[] PROGMEM = "If-None-Match";
 
 static const char CACHE_CONTROL_NO_CACHE[] PROGMEM = "no-cache, no-store, must-revalidate";
+static const char CACHE_CONTROL_REVALIDATE[] PROGMEM = "no-cache";
 static const char CONTENT_ENCODING_GZIP[] PROGMEM = "gzip";
 static const char CACHE_1DA[] PROGMEM = "public, max-age=86400";
 static const char CACHE_1MO[] PROGMEM = "public, max-age=2630000";
@@ -12,8 +12,11 @@
 #include "AmsConfiguration.h"
 #include "HwTools.h"
 #include "AmsData.h"
+#include "AmsDataSnapshot.h"
 #include "AmsStorage.h"
 #include "AmsDataStorage.h"
+#include "AmsTimeSeries.h"
+#include "AmsHistory.h"
 #include "EnergyAccounting.h"
 #include "Uptime.h"
 #if defined(AMS_REMOTE_DEBUG)
@@ -22,6 +25,10 @@
 #include "PriceService.h"
 #include "RealtimePlot.h"
 #include "ConnectionHandler.h"
+#include "FrameTrace.h"
+
+// How long data.json may be answered with 304 Not Modified while the meter data is unchanged
+#define DATA_JSON_REVALIDATE_INTERVAL 10000
 
 #if defined(ESP8266)
 	#include <ESP8266WiFi.h>
@@ -65,6 +72,13 @@ public:
 	void setMeterConfig(uint8_t distributionSystem, uint16_t mainFuse, uint16_t productionCapacity);
 	void setMqttHandler(AmsMqttHandler* mqttHandler);
 	void setConnectionHandler(ConnectionHandler* ch);
+	void setFrameTrace(FrameTrace* trace);
+	void setChannelState(uint8_t channel, AmsData* state);
+	void dataChanged(uint8_t channel, uint64_t changes);
+	void setMeterSnapshot(AmsDataSnapshot* snapshot);
+	void setTimeSeries(AmsTimeSeries* ts);
+	void setHistory(AmsHistory* hist);
+	void setRollup(AmsRollup* rollup);
 
 private:
     #if defined(AMS_REMOTE_DEBUG)
@@ -85,11 +99,18 @@ private:
 	GpioConfig* gpioConfig;
 	WebConfig webConfig;
 	AmsData* meterState;
+	AmsData* channelStates[METER_CHANNELS] = { NULL }; // By channel, the main meter is meterState
+	uint32_t dataVersion[METER_CHANNELS] = { 0 }; // Frames that changed something, by channel, for the data.json ETag
+	AmsDataSnapshot* meterSnapshot = NULL;
+	AmsTimeSeries* ts = NULL;
+	AmsHistory* hist = NULL;
+	AmsRollup* rollup = NULL;
 	AmsDataStorage* ds;
     EnergyAccounting* ea = NULL;
 	RealtimePlot* rtp = NULL;
 	AmsMqttHandler* mqttHandler = NULL;
 	ConnectionHandler* ch = NULL;
+	FrameTrace* trace = NULL;
 	#if defined(_CLOUDCONNECTOR_H)
 	CloudConnector* cloud = NULL;
 	#endif
@@ -126,6 +147,10 @@ private:
     void sysinfoJson();
     void dataJson();
 	void dayplotJson();
+	void quarterplotJson();
+	void timeseriesJson();
+	void historyJson();
+	void rollupJson();
 	void monthplotJson();
 	void energyPriceJson();
 	void temperatureJson();
@@ -155,6 +180,7 @@ private:
 	void deleteFile(const char* path);
 
 	void configFileDownload();
+	void traceTxt();
 	void configFileUpload();
 	void configFilePost();
 	void factoryResetPost();
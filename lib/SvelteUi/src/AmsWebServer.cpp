@@ -124,6 +124,10 @@ debugger->printf_P(PSTR("Using context path: '%s'\n"), context.c_str());
 	server.on(context + F("/data.json"), HTTP_GET, std::bind(&AmsWebServer::dataJson, this));
 	server.on(context + F("/dayplot.json"), HTTP_GET, std::bind(&AmsWebServer::dayplotJson, this));
 	server.on(context + F("/monthplot.json"), HTTP_GET, std::bind(&AmsWebServer::monthplotJson, this));
+	server.on(context + F("/quarterplot.json"), HTTP_GET, std::bind(&AmsWebServer::quarterplotJson, this));
+	server.on(context + F("/timeseries.json"), HTTP_GET, std::bind(&AmsWebServer::timeseriesJson, this));
+	server.on(context + F("/history.json"), HTTP_GET, std::bind(&AmsWebServer::historyJson, this));
+	server.on(context + F("/rollup.json"), HTTP_GET, std::bind(&AmsWebServer::rollupJson, this));
 	server.on(context + F("/energyprice.json"), HTTP_GET, std::bind(&AmsWebServer::energyPriceJson, this));
 	server.on(context + F("/temperature.json"), HTTP_GET, std::bind(&AmsWebServer::temperatureJson, this));
 	server.on(context + F("/tariff.json"), HTTP_GET, std::bind(&AmsWebServer::tariffJson, this));
@@ -150,6 +154,7 @@ debugger->printf_P(PSTR("Using context path: '%s'\n"), context.c_str());
 
 	server.on(context + F("/configfile"), HTTP_POST, std::bind(&AmsWebServer::configFilePost, this), std::bind(&AmsWebServer::configFileUpload, this));
 	server.on(context + F("/configfile.cfg"), HTTP_GET, std::bind(&AmsWebServer::configFileDownload, this));
+	server.on(context + F("/trace.txt"), HTTP_GET, std::bind(&AmsWebServer::traceTxt, this));
 
 	server.on(context + F("/dayplot"), HTTP_POST, std::bind(&AmsWebServer::modifyDayPlot, this));
 	server.on(context + F("/monthplot"), HTTP_POST, std::bind(&AmsWebServer::modifyMonthPlot, this));
@@ -165,6 +170,9 @@ debugger->printf_P(PSTR("Using context path: '%s'\n"), context.c_str());
 	server.on("/ssdp/schema.xml", HTTP_GET, std::bind(&AmsWebServer::ssdpSchema, this));
 
 	server.onNotFound(std::bind(&AmsWebServer::notFound, this));
+
+	const char* headers[] = { "If-None-Match" };
+	server.collectHeaders(headers, 1);
 	
 	server.begin(); // Web server start
 
@@ -194,6 +202,37 @@ void AmsWebServer::setConnectionHandler(ConnectionHandler* ch) {
 	this->ch = ch;
 }
 
+void AmsWebServer::setFrameTrace(FrameTrace* trace) {
+	this->trace = trace;
+}
+
+void AmsWebServer::setChannelState(uint8_t channel, AmsData* state) {
+	if(channel < 1 || channel >= METER_CHANNELS) return;
+	channelStates[channel] = state;
+}
+
+// Called with the fields each frame changed, so data.json can tell a browser that nothing is new
+void AmsWebServer::dataChanged(uint8_t channel, uint64_t changes) {
+	if(channel >= METER_CHANNELS || changes == 0) return;
+	dataVersion[channel]++;
+}
+
+void AmsWebServer::setMeterSnapshot(AmsDataSnapshot* snapshot) {
+	this->meterSnapshot = snapshot;
+}
+
+void AmsWebServer::setTimeSeries(AmsTimeSeries* ts) {
+	this->ts = ts;
+}
+
+void AmsWebServer::setHistory(AmsHistory* hist) {
+	this->hist = hist;
+}
+
+void AmsWebServer::setRollup(AmsRollup* rollup) {
+	this->rollup = rollup;
+}
+
 void AmsWebServer::setPriceService(PriceService* ps) {
 	this->ps = ps;
 }
@@ -466,6 +505,12 @@ void AmsWebServer::sysinfoJson() {
 		if(ds != NULL) {
 			ds->save();
 		}
+		if(ea != NULL) {
+			ea->save();
+		}
+		if(ts != NULL) {
+			ts->flush();
+		}
 		#if defined(AMS_REMOTE_DEBUG)
 if (debugger->isActive(RemoteDebug::INFO))
 #endif
@@ -484,6 +529,42 @@ void AmsWebServer::dataJson() {
 	if(!checkSecurity(2, true))
 		return;
 
+	// Sub-meters are selected with ?ch=, everything not tied to the meter itself is the same for all
+	AmsData* state = meterState;
+	AmsData snapshot;
+	if(meterSnapshot != NULL && meterSnapshot->read(snapshot)) {
+		state = &snapshot;
+	}
+	int channel = 0;
+	if(server.hasArg(F("ch"))) {
+		String arg = server.arg(F("ch"));
+		channel = arg.toInt();
+		// ch=0 is the main meter, anything else has to be a channel with a configured sub-meter
+		if(channel < 0 || channel >= METER_CHANNELS || (channel == 0 && arg != F("0"))) {
+			notFound();
+			return;
+		}
+		if(channel > 0) {
+			if(channelStates[channel] == NULL) {
+				notFound();
+				return;
+			}
+			state = channelStates[channel];
+		}
+	}
+
+	// The document is the same as last time when no frame changed anything on the channel. Values not
+	// from the meter, like uptime and signal strength, are let through at least every DATA_JSON_REVALIDATE_INTERVAL.
+	char etag[48];
+	snprintf_P(etag, sizeof(etag), PSTR("\"%d-%lu-%d-%lu\""), channel, dataVersion[channel], state->getLastError(), (uint32_t) (millis / DATA_JSON_REVALIDATE_INTERVAL));
+	server.sendHeader(HEADER_ACCESS_CONTROL_ALLOW_ORIGIN, ORIGIN_AMSLESER_CLOUD);
+	server.sendHeader(HEADER_CACHE_CONTROL, CACHE_CONTROL_REVALIDATE);
+	server.sendHeader(HEADER_ETAG, etag);
+	if(server.header(HEADER_IF_NONE_MATCH) == etag) {
+		server.send(304);
+		return;
+	}
+
 	float vcc = hw->getVcc();
 	int rssi = hw->getWifiRssi();
 
@@ -511,13 +592,13 @@ void AmsWebServer::dataJson() {
 	#endif
 
 	uint8_t hanStatus;
-	if(meterState->getLastError() != 0) {
+	if(state->getLastError() != 0) {
 		hanStatus = 3;
-	} else if(meterState->getLastUpdateMillis() == 0 && millis < 30000) {
+	} else if(state->getLastUpdateMillis() == 0 && millis < 30000) {
 		hanStatus = 0;
-	} else if(millis - meterState->getLastUpdateMillis() < 15000) {
+	} else if(millis - state->getLastUpdateMillis() < 15000) {
 		hanStatus = 1;
-	} else if(millis - meterState->getLastUpdateMillis() < 30000) {
+	} else if(millis - state->getLastUpdateMillis() < 30000) {
 		hanStatus = 2;
 	} else {
 		hanStatus = 3;
@@ -543,8 +624,8 @@ void AmsWebServer::dataJson() {
 		mqttStatus = 3;
 	}
 
-	float price = ea->getPriceForHour(PRICE_DIRECTION_IMPORT, 0);
-	float exportPrice = ea->getPriceForHour(PRICE_DIRECTION_EXPORT, 0);
+	float price = ea->getCurrentPrice(PRICE_DIRECTION_IMPORT);
+	float exportPrice = ea->getCurrentPrice(PRICE_DIRECTION_EXPORT);
 
 	String peaks = "";
 	for(uint8_t i = 1; i <= ea->getConfig()->hours; i++) {
@@ -555,38 +636,38 @@ void AmsWebServer::dataJson() {
 	time_t now = time(nullptr);
 
 	snprintf_P(buf, BufferSize, DATA_JSON,
-		maxPwr == 0 ? meterState->isThreePhase() ? 20000 : 10000 : maxPwr,
+		maxPwr == 0 ? state->isThreePhase() ? 20000 : 10000 : maxPwr,
 		productionCapacity,
 		mainFuse == 0 ? 40 : mainFuse,
-		meterState->getActiveImportPower(),
-		meterState->getActiveExportPower(),
-		((int32_t) meterState->getActiveImportPower()) - meterState->getActiveExportPower(),
-		meterState->getReactiveImportPower(),
-		meterState->getReactiveExportPower(),
-		meterState->getActiveImportCounter(),
-		meterState->getActiveExportCounter(),
-		meterState->getReactiveImportCounter(),
-		meterState->getReactiveExportCounter(),
-		meterState->getPowerFactor(),
-
-		meterState->getL1Voltage(),
-		meterState->getL1Current(),
-		meterState->getL1ActiveImportPower(),
-		meterState->getL1ActiveExportPower(),
-		meterState->getL1PowerFactor(),
-
-		meterState->getL2Voltage(),
-		meterState->getL2Current(),
-		meterState->getL2ActiveImportPower(),
-		meterState->getL2ActiveExportPower(),
-		meterState->getL2PowerFactor(),
-		meterState->isL2currentMissing() ? "true" : "false",
-
-		meterState->getL3Voltage(),
-		meterState->getL3Current(),
-		meterState->getL3ActiveImportPower(),
-		meterState->getL3ActiveExportPower(),
-		meterState->getL3PowerFactor(),
+		state->getActiveImportPower(),
+		state->getActiveExportPower(),
+		((int32_t) state->getActiveImportPower()) - state->getActiveExportPower(),
+		state->getReactiveImportPower(),
+		state->getReactiveExportPower(),
+		state->getActiveImportCounter(),
+		state->getActiveExportCounter(),
+		state->getReactiveImportCounter(),
+		state->getReactiveExportCounter(),
+		state->getPowerFactor(),
+
+		state->getL1Voltage(),
+		state->getL1Current(),
+		state->getL1ActiveImportPower(),
+		state->getL1ActiveExportPower(),
+		state->getL1PowerFactor(),
+
+		state->getL2Voltage(),
+		state->getL2Current(),
+		state->getL2ActiveImportPower(),
+		state->getL2ActiveExportPower(),
+		state->getL2PowerFactor(),
+		state->isL2currentMissing() ? "true" : "false",
+
+		state->getL3Voltage(),
+		state->getL3Current(),
+		state->getL3ActiveImportPower(),
+		state->getL3ActiveExportPower(),
+		state->getL3PowerFactor(),
 
 		vcc,
 		rssi,
@@ -600,7 +681,7 @@ void AmsWebServer::dataJson() {
 		mqttHandler == NULL ? 0 : (int) mqttHandler->lastError(),
 		price == PRICE_NO_VALUE ? "null" : String(price, 2).c_str(),
 		exportPrice == PRICE_NO_VALUE ? "null" : String(exportPrice, 2).c_str(),
-		meterState->getMeterType(),
+		state->getMeterType(),
 		distributionSystem,
 		ea->getMonthMax(),
 		peaks.c_str(),
@@ -620,17 +701,12 @@ void AmsWebServer::dataJson() {
 		price == PRICE_NO_VALUE ? "false" : "true",
 		priceRegion.c_str(),
 		priceCurrency.c_str(),
-		meterState->getLastError(),
+		state->getLastError(),
 		ps == NULL ? 0 : ps->getLastError(),
 		(uint32_t) now,
 		checkSecurity(1, false) ? "true" : "false"
 	);
 
-	server.sendHeader(HEADER_ACCESS_CONTROL_ALLOW_ORIGIN, ORIGIN_AMSLESER_CLOUD);
-	server.sendHeader(HEADER_CACHE_CONTROL, CACHE_CONTROL_NO_CACHE);
-	server.sendHeader(HEADER_PRAGMA, PRAGMA_NO_CACHE);
-	server.sendHeader(HEADER_EXPIRES, EXPIRES_OFF);
-
 	server.setContentLength(strlen(buf));
 	server.send(200, MIME_JSON, buf);
 }
@@ -658,6 +734,35 @@ void AmsWebServer::dayplotJson() {
 	}
 }
 
+// Today in quarter hours from local midnight, 92 to 100 of them
+void AmsWebServer::quarterplotJson() {
+	if(!checkSecurity(2))
+		return;
+
+	if(ds == NULL) {
+		notFound();
+	} else {
+		uint8_t count = ds->getQuarterCount();
+		uint16_t pos = snprintf_P(buf, BufferSize, PSTR("{\"unit\":\"kwh\",\"start\":%lu,\"q\":["), (unsigned long) ds->getQuarterDayStart());
+		for(uint8_t i = 0; i < count; i++) {
+			if(ds->hasQuarter(i)) {
+				pos += snprintf_P(buf+pos, BufferSize-pos, PSTR("%s[%.3f,%.3f]"), i == 0 ? "" : ",", ds->getQuarterImport(i) / 1000.0, ds->getQuarterExport(i) / 1000.0);
+			} else {
+				pos += snprintf_P(buf+pos, BufferSize-pos, PSTR("%snull"), i == 0 ? "" : ",");
+			}
+		}
+		snprintf_P(buf+pos, BufferSize-pos, PSTR("]}"));
+
+		server.sendHeader(HEADER_ACCESS_CONTROL_ALLOW_ORIGIN, ORIGIN_AMSLESER_CLOUD);
+		server.sendHeader(HEADER_CACHE_CONTROL, CACHE_CONTROL_NO_CACHE);
+		server.sendHeader(HEADER_PRAGMA, PRAGMA_NO_CACHE);
+		server.sendHeader(HEADER_EXPIRES, EXPIRES_OFF);
+
+		server.setContentLength(strlen(buf));
+		server.send(200, MIME_JSON, buf);
+	}
+}
+
 void AmsWebServer::monthplotJson() {
 	if(!checkSecurity(2))
 		return;
@@ -681,21 +786,174 @@ void AmsWebServer::monthplotJson() {
 	}
 }
 
+// Records from the time series store as [timestamp,import Wh,export Wh,import W,export W].
+// A response holds at most a day, page with from set past the last timestamp returned.
+void AmsWebServer::timeseriesJson() {
+	if(!checkSecurity(2))
+		return;
+
+	if(ts == NULL || !server.hasArg(F("from"))) {
+		notFound();
+		return;
+	}
+
+	time_t from = server.arg(F("from")).toInt();
+	time_t to = server.hasArg(F("to")) ? server.arg(F("to")).toInt() : time(nullptr);
+
+	server.sendHeader(HEADER_ACCESS_CONTROL_ALLOW_ORIGIN, ORIGIN_AMSLESER_CLOUD);
+	server.sendHeader(HEADER_CACHE_CONTROL, CACHE_CONTROL_NO_CACHE);
+	server.sendHeader(HEADER_PRAGMA, PRAGMA_NO_CACHE);
+	server.sendHeader(HEADER_EXPIRES, EXPIRES_OFF);
+
+	server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+	server.send_P(200, MIME_JSON, PSTR("{\"interval\":60,\"r\":["));
+
+	TimeSeriesRecord records[16];
+	uint16_t total = 0;
+	bool first = true;
+	while(total < TIMESERIES_SEGMENT_SECONDS / TIMESERIES_INTERVAL && from <= to) {
+		uint16_t count = ts->query(from, to, records, 16);
+		if(count == 0) break;
+
+		uint16_t pos = 0;
+		for(uint8_t i = 0; i < count; i++) {
+			pos += snprintf_P(buf+pos, BufferSize-pos, PSTR("%s[%lu,%lu,%lu,%u,%u]"),
+				first ? "" : ",",
+				(unsigned long) records[i].timestamp,
+				(unsigned long) records[i].activeImport,
+				(unsigned long) records[i].activeExport,
+				records[i].importPower,
+				records[i].exportPower
+			);
+			first = false;
+		}
+		server.sendContent(buf);
+		total += count;
+		from = records[count-1].timestamp + 1;
+	}
+	server.sendContent_P(PSTR("]}"));
+}
+
+// Hourly history as [timestamp,import Wh,export Wh]. The energy is the counter position at the
+// end of the hour, so the consumption in an hour is the difference to the hour before it.
+void AmsWebServer::historyJson() {
+	if(!checkSecurity(2))
+		return;
+
+	if(hist == NULL) {
+		notFound();
+		return;
+	}
+
+	time_t from = server.hasArg(F("from")) ? server.arg(F("from")).toInt() : 0;
+	time_t to = server.hasArg(F("to")) ? server.arg(F("to")).toInt() : time(nullptr);
+
+	server.sendHeader(HEADER_ACCESS_CONTROL_ALLOW_ORIGIN, ORIGIN_AMSLESER_CLOUD);
+	server.sendHeader(HEADER_CACHE_CONTROL, CACHE_CONTROL_NO_CACHE);
+	server.sendHeader(HEADER_PRAGMA, PRAGMA_NO_CACHE);
+	server.sendHeader(HEADER_EXPIRES, EXPIRES_OFF);
+
+	server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+	server.send_P(200, MIME_JSON, PSTR("{\"interval\":3600,\"r\":["));
+
+	AmsHistoryCursor cursor(hist);
+	HistoryPoint point;
+	uint16_t pos = 0;
+	uint8_t count = 0;
+	bool first = true;
+	if(cursor.seek(from)) {
+		while(cursor.next(point) && point.timestamp <= to) {
+			pos += snprintf_P(buf+pos, BufferSize-pos, PSTR("%s[%lu,%lu,%lu]"),
+				first ? "" : ",",
+				(unsigned long) point.timestamp,
+				(unsigned long) point.importWh,
+				(unsigned long) point.exportWh
+			);
+			first = false;
+			if(++count == 32) {
+				server.sendContent(buf);
+				pos = 0;
+				count = 0;
+			}
+		}
+	}
+	if(count > 0) {
+		server.sendContent(buf);
+	}
+	server.sendContent_P(PSTR("]}"));
+}
+
+// Running and last closed bucket for each rollup tier, power in W and energy in Wh
+void AmsWebServer::rollupJson() {
+	if(!checkSecurity(2))
+		return;
+
+	if(rollup == NULL) {
+		notFound();
+		return;
+	}
+
+	uint16_t pos = snprintf_P(buf, BufferSize, PSTR("{"));
+	for(uint8_t i = 0; i < RollupTierCount; i++) {
+		pos += snprintf_P(buf+pos, BufferSize-pos, PSTR("%s\"%d\":["), i == 0 ? "" : ",", i);
+		for(uint8_t j = 0; j < 2; j++) {
+			RollupAggregate* agg = j == 0 ? rollup->getCurrent(i) : rollup->getLast(i);
+			if(agg == NULL) {
+				pos += snprintf_P(buf+pos, BufferSize-pos, PSTR("%snull"), j == 0 ? "" : ",");
+				continue;
+			}
+			pos += snprintf_P(buf+pos, BufferSize-pos, PSTR("%s{\"t\":%lu,\"a\":%ld,\"n\":%ld,\"x\":%ld,\"i\":%lu,\"e\":%lu,\"c\":%s}"),
+				j == 0 ? "" : ",",
+				(unsigned long) agg->start,
+				(long) AmsRollup::getAveragePower(agg),
+				(long) agg->minPower,
+				(long) agg->maxPower,
+				(unsigned long) AmsRollup::getImportWh(agg),
+				(unsigned long) AmsRollup::getExportWh(agg),
+				agg->complete ? "true" : "false"
+			);
+		}
+		pos += snprintf_P(buf+pos, BufferSize-pos, PSTR("]"));
+	}
+	snprintf_P(buf+pos, BufferSize-pos, PSTR("}"));
+
+	server.sendHeader(HEADER_ACCESS_CONTROL_ALLOW_ORIGIN, ORIGIN_AMSLESER_CLOUD);
+	server.sendHeader(HEADER_CACHE_CONTROL, CACHE_CONTROL_NO_CACHE);
+	server.sendHeader(HEADER_PRAGMA, PRAGMA_NO_CACHE);
+	server.sendHeader(HEADER_EXPIRES, EXPIRES_OFF);
+
+	server.setContentLength(strlen(buf));
+	server.send(200, MIME_JSON, buf);
+}
+
 void AmsWebServer::energyPriceJson() {
 	if(!checkSecurity(2))
 		return;
 
-	float prices[36];
-	for(int i = 0; i < 36; i++) {
-		prices[i] = ps == NULL ? PRICE_NO_VALUE : ps->getValueForHour(PRICE_DIRECTION_IMPORT, i);
+	// Hourly by default, ?res=15 gives the next 24 hours in quarter hours instead
+	uint8_t res = server.hasArg(F("res")) && server.arg(F("res")).toInt() == 15 ? 15 : 60;
+	uint8_t count = res == 15 ? 96 : 36;
+	time_t now = time(nullptr);
+	now -= now % (res * 60);
+
+	float prices[96];
+	for(int i = 0; i < count; i++) {
+		if(ps == NULL) {
+			prices[i] = PRICE_NO_VALUE;
+		} else if(res == 15) {
+			prices[i] = ps->getValue(PRICE_DIRECTION_IMPORT, now + (i * 900));
+		} else {
+			prices[i] = ps->getValueForHour(PRICE_DIRECTION_IMPORT, i);
+		}
 	}
 
-	uint16_t pos = snprintf_P(buf, BufferSize, PSTR("{\"currency\":\"%s\",\"source\":\"%s\""),
+	uint16_t pos = snprintf_P(buf, BufferSize, PSTR("{\"currency\":\"%s\",\"source\":\"%s\",\"res\":%d"),
 		ps == NULL ? "" : ps->getCurrency(),
-		ps == NULL ? "" : ps->getSource()
+		ps == NULL ? "" : ps->getSource(),
+		res
 	);
 
-    for(uint8_t i = 0;i < 36; i++) {
+    for(uint8_t i = 0;i < count; i++) {
         if(prices[i] == PRICE_NO_VALUE) {
             pos += snprintf_P(buf+pos, BufferSize-pos, PSTR(",\"%02d\":null"), i);
         } else {
@@ -1643,6 +1901,12 @@ debugger->printf_P(PSTR("Successfully saved.\n"));
 		if(ds != NULL) {
 			ds->save();
 		}
+		if(ea != NULL) {
+			ea->save();
+		}
+		if(ts != NULL) {
+			ts->flush();
+		}
 		#if defined(AMS_REMOTE_DEBUG)
 if (debugger->isActive(RemoteDebug::INFO))
 #endif
@@ -1668,6 +1932,9 @@ void AmsWebServer::reboot() {
 if (debugger->isActive(RemoteDebug::INFO))
 #endif
 debugger->printf_P(PSTR("Rebooting\n"));
+	if(ts != NULL) {
+		ts->flush();
+	}
 	debugger->flush();
 	delay(1000);	rdc->cause = 3;
 
@@ -1759,6 +2026,9 @@ void AmsWebServer::upgradeFromUrl(String url, String nextVersion) {
 			break;
 		case HTTP_UPDATE_OK:
 			debugger->printf_P(PSTR("Update OK\n"));
+			if(ts != NULL) {
+				ts->flush();
+			}
 			debugger->flush();
 			rdc->cause = 4;
 			ESP.restart();
@@ -1941,6 +2211,9 @@ void AmsWebServer::factoryResetPost() {
 if (debugger->isActive(RemoteDebug::INFO))
 #endif
 debugger->printf_P(PSTR("Rebooting\n"));
+	if(ts != NULL) {
+		ts->flush();
+	}
 	debugger->flush();
 	delay(1000);
 	rdc->cause = 5;
@@ -2263,6 +2536,38 @@ void AmsWebServer::configFileDownload() {
 		}
 	}
 
+	// Settings of sub-meters are prefixed with their channel, subMeter1Baud and so on
+	for(uint8_t ch = 1; includeMeter && ch < METER_CHANNELS; ch++) {
+		MeterConfig subMeter;
+		if(!config->getSubMeterConfig(ch, subMeter)) continue;
+		server.sendContent(buf, snprintf_P(buf, BufferSize, PSTR("subMeter%dHanPin %d\n"), ch, subMeter.rxPin));
+		server.sendContent(buf, snprintf_P(buf, BufferSize, PSTR("subMeter%dBaud %d\n"), ch, subMeter.baud));
+		char parity[4] = "";
+		switch(subMeter.parity) {
+			case 2:
+				strcpy_P(parity, PSTR("7N1"));
+				break;
+			case 3:
+				strcpy_P(parity, PSTR("8N1"));
+				break;
+			case 7:
+				strcpy_P(parity, PSTR("8N2"));
+				break;
+			case 10:
+				strcpy_P(parity, PSTR("7E1"));
+				break;
+			case 11:
+				strcpy_P(parity, PSTR("8E1"));
+				break;
+		}
+		if(strlen(parity) > 0) server.sendContent(buf, snprintf_P(buf, BufferSize, PSTR("subMeter%dParity %s\n"), ch, parity));
+		server.sendContent(buf, snprintf_P(buf, BufferSize, PSTR("subMeter%dInvert %d\n"), ch, subMeter.invert ? 1 : 0));
+		if(includeSecrets) {
+			if(subMeter.encryptionKey[0] != 0x00) server.sendContent(buf, snprintf_P(buf, BufferSize, PSTR("subMeter%dEncryptionKey %s\n"), ch, toHex(subMeter.encryptionKey, 16).c_str()));
+			if(subMeter.authenticationKey[0] != 0x00) server.sendContent(buf, snprintf_P(buf, BufferSize, PSTR("subMeter%dAuthenticationKey %s\n"), ch, toHex(subMeter.authenticationKey, 16).c_str()));
+		}
+	}
+
 	if(includeGpio) {
 		MeterConfig meter;
 		config->getMeterConfig(meter);
@@ -2507,6 +2812,29 @@ void AmsWebServer::configFilePost() {
 	server.send(200, MIME_JSON, buf);
 }
 
+void AmsWebServer::traceTxt() {
+	if(!checkSecurity(1))
+		return;
+
+	if(trace == NULL) {
+		server.send_P(404, MIME_PLAIN, PSTR("No frame trace available"));
+		return;
+	}
+
+	server.sendHeader(HEADER_CACHE_CONTROL, CACHE_CONTROL_NO_CACHE);
+	server.sendHeader(HEADER_PRAGMA, PRAGMA_NO_CACHE);
+	server.sendHeader(HEADER_EXPIRES, EXPIRES_OFF);
+	server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+	server.send_P(200, MIME_PLAIN, PSTR(""));
+
+	// Records are formatted here, a buffer at a time, recording the frames only copied the bytes
+	FrameTraceCursor cursor;
+	uint16_t len;
+	while((len = trace->format(buf, BufferSize, cursor)) > 0) {
+		server.sendContent(buf, len);
+	}
+}
+
 void AmsWebServer::configFileUpload() {
 	if(!checkSecurity(1))
 		return;
@@ -2529,6 +2857,12 @@ void AmsWebServer::configFileUpload() {
 			if(ds != NULL) {
 				ds->save();
 			}
+			if(ea != NULL) {
+				ea->save();
+			}
+			if(ts != NULL) {
+				ts->flush();
+			}
 			#if defined(AMS_REMOTE_DEBUG)
 if (debugger->isActive(RemoteDebug::INFO))
 #endif
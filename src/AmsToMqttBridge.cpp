@@ -56,6 +56,9 @@ ADC_MODE(ADC_VCC);
 #include "FirmwareVersion.h"
 #include "AmsStorage.h"
 #include "AmsDataStorage.h"
+#include "AmsTimeSeries.h"
+#include "AmsHistory.h"
+#include "AmsDataSnapshot.h"
 #include "EnergyAccounting.h"
 #include <MQTT.h>
 #include <DNSServer.h>
@@ -69,6 +72,7 @@ ADC_MODE(ADC_VCC);
 #include "WiFiAccessPointConnectionHandler.h"
 #include "EthernetConnectionHandler.h"
 #include "PriceService.h"
+#include "AmsRollup.h"
 #include "RealtimePlot.h"
 #include "AmsWebServer.h"
 #include "AmsConfiguration.h"
@@ -136,6 +140,7 @@ AmsWebServer ws(commonBuffer, &Debug, &hw, &rdc);
 
 bool mqttEnabled = false;
 AmsMqttHandler* mqttHandler = NULL;
+PassthroughMqttHandler* passthroughMqtt = NULL;
 
 #if defined(ESP32) && defined(ENERGY_SPEEDOMETER_PASS)
 JsonMqttHandler* energySpeedometer = NULL;
@@ -169,11 +174,14 @@ GpioConfig gpioConfig;
 
 MeterConfig meterConfig;
 AmsData meterState;
+AmsDataSnapshot meterSnapshot; // What readers outside of loop() should look at
 bool ntpEnabled = false;
 
 bool mdnsEnabled = false;
 
 AmsDataStorage ds(&Debug);
+AmsTimeSeries ts(&Debug);
+AmsHistory hist(&Debug);
 #if defined(_CLOUDCONNECTOR_H)
 CloudConnector *cloud = NULL;
 __NOINIT_ATTR EnergyAccountingRealtimeData rtd;
@@ -182,6 +190,7 @@ EnergyAccountingRealtimeData rtd;
 #endif
 EnergyAccounting ea(&Debug, &rtd);
 
+AmsRollup rollup;
 RealtimePlot rtp;
 
 MeterCommunicator* mc = NULL;
@@ -191,6 +200,15 @@ KmpCommunicator* kmpMc = NULL;
 #endif
 PulseMeterCommunicator* pulseMc = NULL;
 
+#if METER_CHANNELS > 1
+// Sub-meters, each on its own UART with its own state, decoded and published alongside the main meter
+struct MeterChannel {
+	PassiveMeterCommunicator* mc = NULL;
+	AmsData state;
+};
+MeterChannel subMeters[METER_CHANNELS-1];
+#endif
+
 bool networkConnected = false;
 bool setupMode = false;
 
@@ -210,6 +228,8 @@ void handleUiLanguage();
 void handleEnergyAccountingChanged();
 bool handleVoltageCheck();
 bool readHanPort();
+void configureSubMeters();
+void readSubMeters();
 void errorBlink();
 
 uint8_t pulses = 0;
@@ -497,6 +517,9 @@ void setup() {
 		}
 		if(flashed) {
 			debugI_P(PSTR("Firmware update complete, restarting"));
+			// Data storage and accounting are not loaded yet, saving them here would write
+			// empty plots over the files. The restarts after loading save them as well.
+			ts.flush();
 			Debug.flush();
 			delay(250);
 			ESP.restart();
@@ -510,6 +533,8 @@ void setup() {
 		connectToNetwork();
 		handleNtpChange();
 		ds.load();
+		ts.load();
+		hist.load();
 	} else {
 		debugI_P(PSTR("No configuration, booting AP"));
 		toggleSetupMode();
@@ -524,7 +549,12 @@ void setup() {
 	ea.setup(&ds, eac);
 	ea.load();
 	ea.setPriceService(ps);
+	ea.setRollup(&rollup);
 	ws.setup(&config, &gpioConfig, &meterState, &ds, &ea, &rtp);
+	ws.setMeterSnapshot(&meterSnapshot);
+	ws.setTimeSeries(&ts);
+	ws.setHistory(&hist);
+	ws.setRollup(&rollup);
 
 	UiConfig ui;
 	if(config.getUiConfig(ui)) {
@@ -740,6 +770,9 @@ void loop() {
 			config.setSystemConfig(sys);
 			config.save();
 
+			ds.save();
+			ea.save();
+			ts.flush();
 			ESP.restart();
 		}
 		if(dnsServer != NULL) {
@@ -768,6 +801,8 @@ void loop() {
 					}
 					passiveMc->configure(meterConfig, tz);
 					hwSerial = passiveMc->getHwSerial();
+					ws.setFrameTrace(passiveMc->getTrace());
+					passiveMc->setPassthroughMqttHandler(passthroughMqtt);
 					mc = passiveMc;
 					break;
 				case METER_PARSER_KAMSTRUP:
@@ -776,6 +811,7 @@ void loop() {
 						pulseMc = NULL;
 					}
 					if(passiveMc != NULL) {
+						ws.setFrameTrace(NULL);
 						delete(passiveMc);
 						passiveMc = NULL;
 					}
@@ -796,6 +832,7 @@ void loop() {
 					}
 					#endif
 					if(passiveMc != NULL) {
+						ws.setFrameTrace(NULL);
 						delete(passiveMc);
 						passiveMc = NULL;
 					}
@@ -819,6 +856,7 @@ void loop() {
 			debugE_P(PSTR("Unknown meter source selected: %d"), meterConfig.source);
 		}
 		ws.setMeterConfig(meterConfig.distributionSystem, meterConfig.mainFuse, meterConfig.productionCapacity);
+		configureSubMeters();
 		config.ackMeterChanged();
 	}
 
@@ -844,6 +882,12 @@ void loop() {
 		if(millis() - meterState.getLastUpdateMillis() > 1800000 && !ds.isHappy()) {
 			handleClear(now);
 		}
+		readSubMeters();
+		if(meterSnapshot.isBehind(meterState)) {
+			meterSnapshot.publish(meterState);
+		}
+		ds.loop();
+		ea.loop();
 	} catch(const std::exception& e) {
 		debugE_P(PSTR("Exception in readHanPort (%s)"), e.what());
 		meterState.setLastError(METER_ERROR_EXCEPTION);
@@ -962,6 +1006,7 @@ void handleNtpChange() {
 
 		ws.setTimezone(tz);
 		ds.setTimezone(tz);
+		rollup.setTimezone(tz);
 		ea.setTimezone(tz);
 	}
 
@@ -1275,6 +1320,10 @@ void toggleSetupMode() {
 
 bool readHanPort() {
 	if(mc == NULL) return false;
+	if(passthroughMqtt != NULL) {
+		// Frames queued for passthrough while decoding are published here, outside the receive loop
+		passthroughMqtt->flush();
+	}
 	if(pulseMc != NULL) {
 		pulseMc->onPulse(pulses);
 		pulses = 0;
@@ -1302,17 +1351,85 @@ bool readHanPort() {
 		if(data->getListType() > 0) {
 			handleDataSuccess(data);
 		}
-		delete data;
+		mc->releaseData(data);
 	}
 	yield();
 	return true;
 }
 
+void configureSubMeters() {
+	#if METER_CHANNELS > 1
+	for(uint8_t i = 1; i < METER_CHANNELS; i++) {
+		MeterChannel& channel = subMeters[i-1];
+		MeterConfig subConfig;
+		bool enabled = config.getSubMeterConfig(i, subConfig);
+		// GPIO16 puts the main meter on the UART sub-meters would use
+		if(enabled && (meterConfig.rxPin == 16 || subConfig.rxPin == meterConfig.rxPin)) {
+			debugW_P(PSTR("Sub-meter %d conflicts with main meter on GPIO %d, disabled"), i, meterConfig.rxPin);
+			enabled = false;
+		}
+		if(!enabled) {
+			if(channel.mc != NULL) {
+				delete channel.mc;
+				channel.mc = NULL;
+			}
+			ws.setChannelState(i, NULL);
+			continue;
+		}
+		if(channel.mc == NULL) {
+			channel.mc = new PassiveMeterCommunicator(&Debug);
+		}
+		channel.mc->setChannel(i);
+		channel.mc->configure(subConfig, tz);
+		ws.setChannelState(i, &channel.state);
+	}
+	#endif
+}
+
+void readSubMeters() {
+	#if METER_CHANNELS > 1
+	for(uint8_t i = 1; i < METER_CHANNELS; i++) {
+		MeterChannel& channel = subMeters[i-1];
+		if(channel.mc == NULL) continue;
+		if(!channel.mc->loop()) {
+			channel.state.setLastError(channel.mc->getLastError());
+			continue;
+		}
+		channel.state.setLastError(channel.mc->getLastError());
+
+		AmsData* data = channel.mc->getData(channel.state);
+		if(data != NULL) {
+			if(data->getListType() > 0) {
+				channel.state.clearChanges();
+				channel.state.apply(*data);
+				ws.dataChanged(i, channel.state.getChanges());
+				if(mqttHandler != NULL && !channel.mc->isDataUnchanged()) {
+					mqttHandler->publishChannel(i, &channel.state);
+				}
+			}
+			channel.mc->releaseData(data);
+		}
+		yield();
+	}
+	#endif
+}
+
 void handleDataSuccess(AmsData* data) {
 	if(!setupMode && !hw.ledBlink(LED_GREEN, 1))
 		hw.ledBlink(LED_INTERNAL, 1);
 
-	if(mqttHandler != NULL) {
+	// Applied before publishing, so the handlers can tell from the changed fields what to send
+	meterState.clearChanges();
+	meterState.apply(*data);
+	rollup.update(meterState, time(nullptr));
+	rtp.update(rollup);
+	ws.dataChanged(0, meterState.getChanges());
+	#if defined(_CLOUDCONNECTOR_H)
+	if(cloud != NULL) cloud->dataChanged(meterState.getChanges());
+	#endif
+
+	// Nothing new to tell MQTT when the meter repeated its last frame
+	if(mqttHandler != NULL && !mc->isDataUnchanged()) {
 		#if defined(ESP32)
 			esp_task_wdt_reset();
 		#elif defined(ESP8266)
@@ -1344,34 +1461,44 @@ void handleDataSuccess(AmsData* data) {
 		}
 	}
 
-	meterState.apply(*data);
-	rtp.update(meterState);
+	// Hours and days are taken from the rollup as they close. The meter counters are only used
+	// below for what the rollup does not have, like the first hour and day after a reboot.
+	bool saveData = ds.updateHour(rollup);
+	if(ds.updateDay(rollup)) saveData = true;
+	#if defined(_CLOUDCONNECTOR_H)
+	if(saveData && cloud != NULL) cloud->forceUpdate();
+	#endif
 
-	bool saveData = false;
 	if(!ds.isHappy() && now > FirmwareVersion::BuildEpoch) { // Must use "isHappy()" in case day state gets reset and lastTimestamp is "now"
 		debugD_P(PSTR("Its time to update data storage"));
 		tmElements_t tm;
 		breakTime(now, tm);
 		if(tm.Minute == 0 && data->getListType() >= 3) {
 			debugV_P(PSTR(" using actual data"));
-			saveData = ds.update(data);
-			#if defined(_CLOUDCONNECTOR_H)
-			if(saveData && cloud != NULL) cloud->forceUpdate();
-			#endif
+			if(ds.update(data)) {
+				saveData = true;
+				#if defined(_CLOUDCONNECTOR_H)
+				if(cloud != NULL) cloud->forceUpdate();
+				#endif
+			}
 		} else if(tm.Minute == 1) {
 			debugV_P(PSTR(" no data, clear"));
 			AmsData nullData;
-			saveData = ds.update(&nullData);
-		}
-		if(saveData) {
-			debugI_P(PSTR("Saving data"));
-			ds.save();
+			if(ds.update(&nullData)) saveData = true;
 		}
 	}
+	if(saveData) {
+		debugI_P(PSTR("Saving data"));
+		ds.requestSave();
+	}
+
+	ts.update(rollup);
+	hist.update(rollup);
+	ds.updateQuarter(rollup);
 
 	if(ea.update(data)) {
 		debugI_P(PSTR("Saving energy accounting"));
-		ea.save();
+		ea.requestSave();
 	}
 }
 
@@ -1469,6 +1596,7 @@ void MQTT_connect() {
 		if(mqttHandler->getFormat() != mqttConfig.payloadFormat) {
 			delete mqttHandler;
 			mqttHandler = NULL;
+			passthroughMqtt = NULL;
 		} else if(config.isMqttChanged()) {
 			mqttHandler->setConfig(mqttConfig);
 		}
@@ -1495,12 +1623,17 @@ void MQTT_connect() {
 				config.getHomeAssistantConfig(haconf);
 				mqttHandler = new HomeAssistantMqttHandler(mqttConfig, &Debug, (char*) commonBuffer, sysConfig.boardType, haconf, &hw);
 				break;
-			case 255:
-				mqttHandler = new PassthroughMqttHandler(mqttConfig, &Debug, (char*) commonBuffer);
+			case PASSTHROUGH_FORMAT_BINARY:
+			case PASSTHROUGH_FORMAT_HEX:
+				passthroughMqtt = new PassthroughMqttHandler(mqttConfig, &Debug, (char*) commonBuffer);
+				mqttHandler = passthroughMqtt;
 				break;
 		}
 	}
 	ws.setMqttHandler(mqttHandler);
+	if(passiveMc != NULL) {
+		passiveMc->setPassthroughMqttHandler(passthroughMqtt);
+	}
 
 	if(mqttHandler != NULL) {
 		mqttHandler->connect();
@@ -1526,6 +1659,7 @@ void configFileParse() {
 	bool lMqtt = false;
 	bool lWeb = false;
 	bool lMeter = false;
+	bool lSubMeter[METER_CHANNELS] = { false };
 	bool lGpio = false;
 	bool lDomo = false;
 	bool lHa = false;
@@ -1542,6 +1676,7 @@ void configFileParse() {
 	MqttConfig mqtt;
 	WebConfig web;
 	MeterConfig meter;
+	MeterConfig subMeter[METER_CHANNELS];
 	GpioConfig gpio;
 	DomoticzConfig domo;
 	HomeAssistantConfig haconf;
@@ -1664,6 +1799,31 @@ void configFileParse() {
 		} else if(strncmp_P(buf, PSTR("gpioHanPinPullup "), 17) == 0) {
 			if(!lMeter) { config.getMeterConfig(meter); lMeter = true; };
 			meter.rxPinPullup = String(buf+17).toInt() == 1;
+		} else if(strncmp_P(buf, PSTR("subMeter"), 8) == 0 && isdigit(buf[8])) {
+			// subMeter<channel><setting> <value>
+			uint8_t ch = buf[8] - '0';
+			const char* key = buf+9;
+			if(ch >= 1 && ch < METER_CHANNELS) {
+				if(!lSubMeter[ch]) { config.getSubMeterConfig(ch, subMeter[ch]); lSubMeter[ch] = true; };
+				MeterConfig& sub = subMeter[ch];
+				if(strncmp_P(key, PSTR("Baud "), 5) == 0) {
+					sub.baud = String(key+5).toInt();
+				} else if(strncmp_P(key, PSTR("Parity "), 7) == 0) {
+					if(strncmp_P(key+7, PSTR("7N1"), 3) == 0) sub.parity = 2;
+					if(strncmp_P(key+7, PSTR("8N1"), 3) == 0) sub.parity = 3;
+					if(strncmp_P(key+7, PSTR("8N2"), 3) == 0) sub.parity = 7;
+					if(strncmp_P(key+7, PSTR("7E1"), 3) == 0) sub.parity = 10;
+					if(strncmp_P(key+7, PSTR("8E1"), 3) == 0) sub.parity = 11;
+				} else if(strncmp_P(key, PSTR("Invert "), 7) == 0) {
+					sub.invert = String(key+7).toInt() == 1;
+				} else if(strncmp_P(key, PSTR("EncryptionKey "), 14) == 0) {
+					fromHex(sub.encryptionKey, String(key+14), 16);
+				} else if(strncmp_P(key, PSTR("AuthenticationKey "), 18) == 0) {
+					fromHex(sub.authenticationKey, String(key+18), 16);
+				} else if(strncmp_P(key, PSTR("HanPin "), 7) == 0) {
+					sub.rxPin = String(key+7).toInt();
+				}
+			}
 		} else if(strncmp_P(buf, PSTR("gpioApPin "), 10) == 0) {
 			if(!lGpio) { config.getGpioConfig(gpio); lGpio = true; };
 			gpio.apPin = String(buf+10).toInt();
@@ -2006,6 +2166,9 @@ void configFileParse() {
 	if(lMqtt) config.setMqttConfig(mqtt);
 	if(lWeb) config.setWebConfig(web);
 	if(lMeter) config.setMeterConfig(meter);
+	for(uint8_t i = 1; i < METER_CHANNELS; i++) {
+		if(lSubMeter[i]) config.setSubMeterConfig(i, subMeter[i]);
+	}
 	if(lGpio) config.setGpioConfig(gpio);
 	if(lDomo) config.setDomoticzConfig(domo);
 	if(lHa) config.setHomeAssistantConfig(haconf);
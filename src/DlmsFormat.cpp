@@ -0,0 +1,97 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#include "DlmsFormat.h"
+#include "IEC6205675.h"
+#include "LNG.h"
+#include "LNG2.h"
+
+// L&G proprietary list, a structure holding an array of OBIS descriptors followed by the values
+static uint8_t probeLng(const char* payload, uint16_t length) {
+    if(length < 4) return 0;
+    return payload[0] == CosemTypeStructure && payload[2] == CosemTypeArray && payload[1] == payload[3] ? 3 : 0;
+}
+
+static void decodeLng(AmsData& target, const char* payload, DlmsFormatContext& fc) {
+    LNG decoded(*fc.meterState, payload, fc.meterState->getMeterType(), fc.meterConfig, *fc.ctx);
+    target = decoded;
+}
+
+// L&G proprietary list without OBIS codes, starting with six long unsigned values
+static uint8_t probeLng2(const char* payload, uint16_t length) {
+    if(length < 18 || payload[0] != CosemTypeStructure) return 0;
+    for(uint8_t i = 2; i <= 17; i += 3) {
+        if(payload[i] != CosemTypeLongUnsigned) return 0;
+    }
+    return 2;
+}
+
+static void decodeLng2(AmsData& target, const char* payload, DlmsFormatContext& fc) {
+    LNG2 decoded(*fc.meterState, payload, fc.meterState->getMeterType(), fc.meterConfig, *fc.ctx);
+    target = decoded;
+}
+
+// Named lists start with a structure holding the list id as an octet string
+static bool hasListId(const char* payload, uint16_t length, const char* id, uint8_t idLength) {
+    if(length < 4 + idLength || payload[0] != CosemTypeStructure || payload[2] != CosemTypeOctetString) return false;
+    return (uint8_t) payload[3] >= idLength && (uint16_t) (uint8_t) payload[3] + 4 <= length && memcmp(payload + 4, id, idLength) == 0;
+}
+
+// Kaifa list without OBIS codes, identified by KFM_001
+static uint8_t probeKaifa(const char* payload, uint16_t length) {
+    return hasListId(payload, length, "KFM_001", 7) ? 3 : 0;
+}
+
+static void decodeKaifa(AmsData& target, const char* payload, DlmsFormatContext& fc) {
+    IEC6205675 decoded(payload, fc.meterState->getMeterType(), fc.meterConfig, *fc.ctx, *fc.meterState, fc.layoutCache, AmsListLayoutKaifa);
+    target = decoded;
+}
+
+// Iskra list without OBIS codes, with an id starting with ISK
+static uint8_t probeIskra(const char* payload, uint16_t length) {
+    return hasListId(payload, length, "ISK", 3) ? 3 : 0;
+}
+
+static void decodeIskra(AmsData& target, const char* payload, DlmsFormatContext& fc) {
+    IEC6205675 decoded(payload, fc.meterState->getMeterType(), fc.meterConfig, *fc.ctx, *fc.meterState, fc.layoutCache, AmsListLayoutIskra);
+    target = decoded;
+}
+
+// Everything else in a structure or array is treated as a list of OBIS codes and values. The
+// named lists above are refused, so a meter last decoded here is probed again when it sends one.
+static uint8_t probeObis(const char* payload, uint16_t length) {
+    if(length < 2 || (payload[0] != CosemTypeStructure && payload[0] != CosemTypeArray)) return 0;
+    if(probeKaifa(payload, length) > 0 || probeIskra(payload, length) > 0) return 0;
+    return 1;
+}
+
+static void decodeObis(AmsData& target, const char* payload, DlmsFormatContext& fc) {
+    IEC6205675 decoded(payload, fc.meterState->getMeterType(), fc.meterConfig, *fc.ctx, *fc.meterState, fc.layoutCache);
+    target = decoded;
+}
+
+const DlmsFormat DLMS_FORMATS[] = {
+    { "LNG", true, probeLng, decodeLng },
+    { "LNG2", true, probeLng2, decodeLng2 },
+    { "Kaifa", false, probeKaifa, decodeKaifa },
+    { "Iskra", false, probeIskra, decodeIskra },
+    { "DLMS", false, probeObis, decodeObis }
+};
+const uint8_t DLMS_FORMAT_COUNT = sizeof(DLMS_FORMATS) / sizeof(DLMS_FORMATS[0]);
+
+// Returns the index of the format best matching the payload, or -1 if none of them can decode it
+int8_t dlmsFormatProbe(const char* payload, uint16_t length) {
+    int8_t best = -1;
+    uint8_t bestScore = 0;
+    for(uint8_t i = 0; i < DLMS_FORMAT_COUNT; i++) {
+        uint8_t score = DLMS_FORMATS[i].probe(payload, length);
+        if(score > bestScore) {
+            best = i;
+            bestScore = score;
+        }
+    }
+    return best;
+}
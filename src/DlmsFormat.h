@@ -0,0 +1,36 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#ifndef _DLMSFORMAT_H
+#define _DLMSFORMAT_H
+
+#include "AmsData.h"
+#include "AmsConfiguration.h"
+#include "DataParser.h"
+#include "CosemIndex.h"
+
+struct DlmsFormatContext {
+    AmsData* meterState;
+    MeterConfig* meterConfig;
+    DataParserContext* ctx;
+    CosemLayoutCache* layoutCache;
+};
+
+// A decoder for one layout of DLMS application data. probe() returns how well the payload
+// matches, 0 if this format cannot decode it. The highest score wins.
+struct DlmsFormat {
+    const char* name;
+    bool merge; // Decoded frame is applied on top of the meter state
+    uint8_t (*probe)(const char* payload, uint16_t length);
+    void (*decode)(AmsData& target, const char* payload, DlmsFormatContext& fc);
+};
+
+extern const DlmsFormat DLMS_FORMATS[];
+extern const uint8_t DLMS_FORMAT_COUNT;
+
+int8_t dlmsFormatProbe(const char* payload, uint16_t length);
+
+#endif
@@ -0,0 +1,34 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#include "FrameReceiver.h"
+
+FrameReceiver::FrameReceiver(uint16_t ringSize) : ring(ringSize) {
+    this->ringSize = ringSize;
+}
+
+FrameReceiver::~FrameReceiver() {
+}
+
+Stream* FrameReceiver::getStream() {
+    return &ring;
+}
+
+uint16_t FrameReceiver::getRingSize() {
+    return ringSize;
+}
+
+uint32_t FrameReceiver::getOverflows() {
+    return ring.getOverflows();
+}
+
+void FrameReceiver::received(const uint8_t* buf, size_t length) {
+    ring.write(buf, length);
+}
+
+void FrameReceiver::idle() {
+    ring.endFrame();
+}
@@ -0,0 +1,40 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#ifndef _FRAMERECEIVER_H
+#define _FRAMERECEIVER_H
+
+#include "Arduino.h"
+#include "FrameRingBuffer.h"
+
+// Moves bytes from a port into a FrameRingBuffer from a context of its own, marking a frame
+// boundary each time the line goes idle, so loop() only ever reads complete frames. On ESP32
+// this is the UART event task, on the host a thread reading a pipe or pty.
+class FrameReceiver {
+public:
+    FrameReceiver(uint16_t ringSize);
+    virtual ~FrameReceiver();
+
+    virtual bool begin() = 0;
+    // Stops receiving. Once this returns the ring is no longer written to, and the receiver
+    // can be deleted.
+    virtual void end() = 0;
+
+    // Complete frames, for loop() to read
+    Stream* getStream();
+    uint16_t getRingSize();
+    uint32_t getOverflows();
+
+protected:
+    FrameRingBuffer ring;
+    uint16_t ringSize;
+
+    // Called from the receiving context only
+    void received(const uint8_t* buf, size_t length);
+    void idle();
+};
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#include "FrameRingBuffer.h"
+
+FrameRingBuffer::FrameRingBuffer(uint16_t size) {
+    this->buf = (uint8_t*) malloc(size);
+    this->size = buf == NULL ? 0 : size;
+}
+
+FrameRingBuffer::~FrameRingBuffer() {
+    if(buf != NULL) free(buf);
+}
+
+size_t FrameRingBuffer::write(uint8_t b) {
+    return write(&b, 1);
+}
+
+size_t FrameRingBuffer::write(const uint8_t *buffer, size_t length) {
+    if(size == 0) return 0;
+    uint16_t h = head;
+    for(size_t i = 0; i < length; i++) {
+        uint16_t next = (h + 1) % size;
+        if(next == tail) {
+            // Reader is too far behind, the rest of this frame is lost
+            frameOverflow = true;
+            break;
+        }
+        buf[h] = buffer[i];
+        h = next;
+    }
+    head = h;
+    return length;
+}
+
+void FrameRingBuffer::endFrame() {
+    if(frameOverflow) {
+        // Drop the incomplete frame instead of handing the reader a truncated one
+        head = boundary;
+        frameOverflow = false;
+        overflows++;
+    } else {
+        boundary = head;
+    }
+}
+
+int FrameRingBuffer::available() {
+    if(size == 0) return 0;
+    return (boundary + size - tail) % size;
+}
+
+int FrameRingBuffer::read() {
+    if(tail == boundary) return -1;
+    uint8_t b = buf[tail];
+    tail = (tail + 1) % size;
+    return b;
+}
+
+int FrameRingBuffer::peek() {
+    if(tail == boundary) return -1;
+    return buf[tail];
+}
+
+void FrameRingBuffer::flush() {
+}
+
+uint32_t FrameRingBuffer::getOverflows() {
+    return overflows;
+}
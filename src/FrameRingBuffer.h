@@ -0,0 +1,44 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#ifndef _FRAMERINGBUFFER_H
+#define _FRAMERINGBUFFER_H
+
+#include "Arduino.h"
+
+// Byte ring filled from the UART receive task and read as a Stream from loop(). The writer
+// marks where the line went idle with endFrame(), and the reader only sees bytes up to the
+// last such mark, so a frame is never picked up before it has been completely received.
+// Safe for one writer and one reader without locking.
+class FrameRingBuffer : public Stream {
+public:
+    FrameRingBuffer(uint16_t size);
+    ~FrameRingBuffer();
+
+    // Writer side
+    size_t write(uint8_t b);
+    size_t write(const uint8_t *buffer, size_t length);
+    void endFrame();
+
+    // Reader side
+    int available();
+    int read();
+    int peek();
+    void flush();
+
+    uint32_t getOverflows();
+
+private:
+    uint8_t *buf = NULL;
+    uint16_t size = 0;
+    volatile uint16_t head = 0; // Next position to write, only changed by writer
+    volatile uint16_t boundary = 0; // End of last complete frame, only changed by writer
+    volatile uint16_t tail = 0; // Next position to read, only changed by reader
+    bool frameOverflow = false;
+    volatile uint32_t overflows = 0;
+};
+
+#endif
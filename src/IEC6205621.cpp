@@ -11,127 +11,138 @@ IEC6205621::IEC6205621(const char* p, Timezone* tz, MeterConfig* meterConfig) {
 	if(strlen(p) < 16)
 		return;
 
-	String payload(p+1);
+	DsmrValues values;
+	tokenize(p+1, values);
+	droppedValues = values.dropped;
 
 	lastUpdateMillis = millis64();
-	listId = payload.substring(payload.startsWith("/") ? 1 : 0, payload.indexOf("\n"));
 
-	if(listId.startsWith(F("ADN"))) {
+	// Header line, identifying the meter
+	const char* header = p+1;
+	if(*header == '/') header++;
+	const char* headerEnd = strchr(header, '\n');
+	uint8_t headerLength = headerEnd == NULL ? strlen(header) : headerEnd - header;
+	uint8_t listIdLength = 4;
+
+	if(strncmp_P(header, PSTR("ADN"), 3) == 0) {
 		meterType = AmsTypeAidon;
-		listId = listId.substring(0,4);
-	} else if(listId.startsWith(F("KFM"))) {
+	} else if(strncmp_P(header, PSTR("KFM"), 3) == 0) {
 		meterType = AmsTypeKaifa;
-		listId = listId.substring(0,4);
-	} else if(listId.startsWith(F("KMP"))) {
+	} else if(strncmp_P(header, PSTR("KMP"), 3) == 0) {
 		meterType = AmsTypeKamstrup;
-		listId = listId.substring(0,4);
-	} else if(listId.startsWith(F("KAM"))) {
+	} else if(strncmp_P(header, PSTR("KAM"), 3) == 0) {
 		meterType = AmsTypeKamstrup;
-		listId = listId.substring(0,4);
-	} else if(listId.startsWith(F("ISk"))) {
+	} else if(strncmp_P(header, PSTR("ISk"), 3) == 0) {
 		meterType = AmsTypeIskra;
-		listId = listId.substring(0,5);
-	} else if(listId.startsWith(F("XMX"))) {
+		listIdLength = 5;
+	} else if(strncmp_P(header, PSTR("XMX"), 3) == 0) {
 		meterType = AmsTypeLandisGyr;
-		listId = listId.substring(0,6);
-	} else if(listId.startsWith(F("Ene")) || listId.startsWith(F("EST"))) {
+		listIdLength = 6;
+	} else if(strncmp_P(header, PSTR("Ene"), 3) == 0 || strncmp_P(header, PSTR("EST"), 3) == 0) {
 		meterType = AmsTypeSagemcom;
-		listId = listId.substring(0,4);
-	} else if(listId.startsWith(F("LGF"))) {
+	} else if(strncmp_P(header, PSTR("LGF"), 3) == 0) {
 		meterType = AmsTypeLandisGyr;
-		listId = listId.substring(0,4);
 	} else {
 		meterType = AmsTypeUnknown;
-		listId = listId.substring(0,4);
 	}
-	
-	meterId = extract(payload, F("96.1.0"));
-	if(meterId.isEmpty()) {
-		meterId = extract(payload, F("0.0.5"));
+	if(listIdLength > headerLength) listIdLength = headerLength;
+
+	char str[64];
+	memcpy(str, header, listIdLength);
+	str[listIdLength] = '\0';
+	listId = String(str);
+
+	if(extractString(values, 96, 1, 0, str, sizeof(str)) > 0 || extractString(values, 0, 0, 5, str, sizeof(str)) > 0) {
+		meterId = String(str);
 	}
 
-	meterModel = extract(payload, F("96.1.1"));
-	if(meterModel.isEmpty()) {
-		meterModel = extract(payload, F("96.1.7"));
-		if(meterModel.isEmpty()) {
-			meterModel = payload.substring(payload.indexOf(listId) + listId.length(), payload.indexOf(F("\n")));
-			meterModel.trim();
-		}
+	if(extractString(values, 96, 1, 1, str, sizeof(str)) > 0 || extractString(values, 96, 1, 7, str, sizeof(str)) > 0) {
+		meterModel = String(str);
+	} else {
+		// Use whatever follows the list ID in the header
+		const char* model = header + listIdLength;
+		const char* modelEnd = header + headerLength;
+		while(model < modelEnd && isspace(*model)) model++;
+		while(modelEnd > model && isspace(*(modelEnd-1))) modelEnd--;
+		uint8_t modelLength = min((int) (modelEnd - model), (int) sizeof(str)-1);
+		memcpy(str, model, modelLength);
+		str[modelLength] = '\0';
+		meterModel = String(str);
 	}
 
-	String timestamp = extract(payload, F("1.0.0"));
-	if(timestamp.length() > 10) {
+	uint8_t tsLength = extractString(values, 1, 0, 0, str, sizeof(str));
+	if(tsLength > 10) {
 		tmElements_t tm;
-		tm.Year = (timestamp.substring(0,2).toInt() + 2000) - 1970;
-		tm.Month = timestamp.substring(4,6).toInt();
-		tm.Day = timestamp.substring(2,4).toInt();
-		tm.Hour = timestamp.substring(6,8).toInt();
-		tm.Minute = timestamp.substring(8,10).toInt();
-		tm.Second = timestamp.substring(10,12).toInt();
+		tm.Year = (parseDigits(str, 2) + 2000) - 1970;
+		tm.Month = parseDigits(str+4, 2);
+		tm.Day = parseDigits(str+2, 2);
+		tm.Hour = parseDigits(str+6, 2);
+		tm.Minute = parseDigits(str+8, 2);
+		tm.Second = parseDigits(str+10, 2);
 		meterTimestamp = makeTime(tm);
 		if(tz != NULL) meterTimestamp = tz->toUTC(meterTimestamp);
 	}
 
-	activeImportPower = (uint16_t) (extractDouble(payload, F("1.7.0")));
-	activeExportPower = (uint16_t) (extractDouble(payload, F("2.7.0")));
-	reactiveImportPower = (uint16_t) (extractDouble(payload, F("3.7.0")));
-	reactiveExportPower = (uint16_t) (extractDouble(payload, F("4.7.0")));
+	activeImportPower = (uint16_t) (extractDouble(values, 1, 7, 0));
+	activeExportPower = (uint16_t) (extractDouble(values, 2, 7, 0));
+	reactiveImportPower = (uint16_t) (extractDouble(values, 3, 7, 0));
+	reactiveExportPower = (uint16_t) (extractDouble(values, 4, 7, 0));
 
 	if(activeImportPower > 0)
 		listType = 1;
 	
-	l1voltage = extractFloat(payload, F("32.7.0"));
-	l2voltage = extractFloat(payload, F("52.7.0"));
-	l3voltage = extractFloat(payload, F("72.7.0"));
+	l1voltage = toMilli(extractFloat(values, 32, 7, 0));
+	l2voltage = toMilli(extractFloat(values, 52, 7, 0));
+	l3voltage = toMilli(extractFloat(values, 72, 7, 0));
 
-	l1current = extractFloat(payload, F("31.7.0"));
-	l2current = extractFloat(payload, F("51.7.0"));
-	l3current = extractFloat(payload, F("71.7.0"));
+	l1current = toMilli(extractFloat(values, 31, 7, 0));
+	l2current = toMilli(extractFloat(values, 51, 7, 0));
+	l3current = toMilli(extractFloat(values, 71, 7, 0));
 
-	l1activeImportPower = extractFloat(payload, F("21.7.0"));
-	l2activeImportPower = extractFloat(payload, F("41.7.0"));
-	l3activeImportPower = extractFloat(payload, F("61.7.0"));
+	l1activeImportPower = extractFloat(values, 21, 7, 0);
+	l2activeImportPower = extractFloat(values, 41, 7, 0);
+	l3activeImportPower = extractFloat(values, 61, 7, 0);
 	
-	l1activeExportPower = extractFloat(payload, F("22.7.0"));
-	l2activeExportPower = extractFloat(payload, F("42.7.0"));
-	l3activeExportPower = extractFloat(payload, F("62.7.0"));
+	l1activeExportPower = extractFloat(values, 22, 7, 0);
+	l2activeExportPower = extractFloat(values, 42, 7, 0);
+	l3activeExportPower = extractFloat(values, 62, 7, 0);
 	
 	if(l1voltage > 0 || l2voltage > 0 || l3voltage > 0)
 		listType = 2;
 
 	double val = 0.0;
 	
-	val = extractDouble(payload, F("1.8.0"));
+	val = extractDouble(values, 1, 8, 0);
 	if(val == 0) {
 		for(int i = 1; i < 9; i++) {
-			val += extractDouble(payload, "1.8." + String(i,10));
+			val += extractDouble(values, 1, 8, i);
 		}
 	}
-	if(val > 0) activeImportCounter = val / 1000;
+	if(val > 0) activeImportCounter = toMilliWh(val / 1000);
 
-	val = extractDouble(payload, F("2.8.0"));
+	val = extractDouble(values, 2, 8, 0);
 	if(val == 0) {
 		for(int i = 1; i < 9; i++) {
-			val += extractDouble(payload, "2.8." + String(i,10));
+			val += extractDouble(values, 2, 8, i);
 		}
 	}
-	if(val > 0) activeExportCounter = val / 1000;
+	if(val > 0) activeExportCounter = toMilliWh(val / 1000);
 
-	val = extractDouble(payload, F("3.8.0"));
+	val = extractDouble(values, 3, 8, 0);
 	if(val == 0) {
 		for(int i = 1; i < 9; i++) {
-			val += extractDouble(payload, "3.8." + String(i,10));
+			val += extractDouble(values, 3, 8, i);
 		}
 	}
-	if(val > 0) reactiveImportCounter = val / 1000;
+	if(val > 0) reactiveImportCounter = toMilliWh(val / 1000);
 
-	val = extractDouble(payload, F("4.8.0"));
+	val = extractDouble(values, 4, 8, 0);
 	if(val == 0) {
 		for(int i = 1; i < 9; i++) {
-			val += extractDouble(payload, "4.8." + String(i,10));
+			val += extractDouble(values, 4, 8, i);
 		}
 	}
-	if(val > 0) reactiveExportCounter = val / 1000;
+	if(val > 0) reactiveExportCounter = toMilliWh(val / 1000);
 
 	if(activeImportCounter > 0 || activeExportCounter > 0 || reactiveImportCounter > 0 || reactiveExportCounter > 0)
 		listType = 3;
@@ -140,65 +151,128 @@ IEC6205621::IEC6205621(const char* p, Timezone* tz, MeterConfig* meterConfig) {
 		listType = 4;
 
     if(meterConfig->wattageMultiplier > 0) {
-        activeImportPower = activeImportPower > 0 ? activeImportPower * (meterConfig->wattageMultiplier / 1000.0) : 0;
-        activeExportPower = activeExportPower > 0 ? activeExportPower * (meterConfig->wattageMultiplier / 1000.0) : 0;
-        reactiveImportPower = reactiveImportPower > 0 ? reactiveImportPower * (meterConfig->wattageMultiplier / 1000.0) : 0;
-        reactiveExportPower = reactiveExportPower > 0 ? reactiveExportPower * (meterConfig->wattageMultiplier / 1000.0) : 0;
+        activeImportPower = activeImportPower > 0 ? ((uint64_t) activeImportPower * meterConfig->wattageMultiplier) / 1000 : 0;
+        activeExportPower = activeExportPower > 0 ? ((uint64_t) activeExportPower * meterConfig->wattageMultiplier) / 1000 : 0;
+        reactiveImportPower = reactiveImportPower > 0 ? ((uint64_t) reactiveImportPower * meterConfig->wattageMultiplier) / 1000 : 0;
+        reactiveExportPower = reactiveExportPower > 0 ? ((uint64_t) reactiveExportPower * meterConfig->wattageMultiplier) / 1000 : 0;
     }
     if(meterConfig->voltageMultiplier > 0) {
-        l1voltage = l1voltage > 0 ? l1voltage * (meterConfig->voltageMultiplier / 1000.0) : 0;
-        l2voltage = l2voltage > 0 ? l2voltage * (meterConfig->voltageMultiplier / 1000.0) : 0;
-        l3voltage = l3voltage > 0 ? l3voltage * (meterConfig->voltageMultiplier / 1000.0) : 0;
+        l1voltage = l1voltage > 0 ? ((uint64_t) l1voltage * meterConfig->voltageMultiplier) / 1000 : 0;
+        l2voltage = l2voltage > 0 ? ((uint64_t) l2voltage * meterConfig->voltageMultiplier) / 1000 : 0;
+        l3voltage = l3voltage > 0 ? ((uint64_t) l3voltage * meterConfig->voltageMultiplier) / 1000 : 0;
     }
     if(meterConfig->amperageMultiplier > 0) {
-        l1current = l1current > 0 ? l1current * (meterConfig->amperageMultiplier / 1000.0) : 0;
-        l2current = l2current > 0 ? l2current * (meterConfig->amperageMultiplier / 1000.0) : 0;
-        l3current = l3current > 0 ? l3current * (meterConfig->amperageMultiplier / 1000.0) : 0;
+        l1current = l1current > 0 ? ((int64_t) l1current * meterConfig->amperageMultiplier) / 1000 : 0;
+        l2current = l2current > 0 ? ((int64_t) l2current * meterConfig->amperageMultiplier) / 1000 : 0;
+        l3current = l3current > 0 ? ((int64_t) l3current * meterConfig->amperageMultiplier) / 1000 : 0;
     }
     if(meterConfig->accumulatedMultiplier > 0) {
-        activeImportCounter = activeImportCounter > 0 ? activeImportCounter * (meterConfig->accumulatedMultiplier / 1000.0) : 0;
-        activeExportCounter = activeExportCounter > 0 ? activeExportCounter * (meterConfig->accumulatedMultiplier / 1000.0) : 0;
-        reactiveImportCounter = reactiveImportCounter > 0 ? reactiveImportCounter * (meterConfig->accumulatedMultiplier / 1000.0) : 0;
-        reactiveExportCounter = reactiveExportCounter > 0 ? reactiveExportCounter * (meterConfig->accumulatedMultiplier / 1000.0) : 0;
+        activeImportCounter = activeImportCounter > 0 ? (activeImportCounter * meterConfig->accumulatedMultiplier) / 1000 : 0;
+        activeExportCounter = activeExportCounter > 0 ? (activeExportCounter * meterConfig->accumulatedMultiplier) / 1000 : 0;
+        reactiveImportCounter = reactiveImportCounter > 0 ? (reactiveImportCounter * meterConfig->accumulatedMultiplier) / 1000 : 0;
+        reactiveExportCounter = reactiveExportCounter > 0 ? (reactiveExportCounter * meterConfig->accumulatedMultiplier) / 1000 : 0;
     }
 
 	threePhase = l1voltage > 0 && l2voltage > 0 && l3voltage > 0;
 	twoPhase = (l1voltage > 0 && l2voltage > 0) || (l2voltage > 0 && l3voltage > 0) || (l3voltage > 0  && l1voltage > 0);
 }
 
-String IEC6205621::extract(String payload, String obis) {
-	int a = payload.indexOf(String(":" + obis + "("));
-	if(a > 0) {
-		int b = payload.indexOf(F(")"), a);
-		if(b > a) {
-			return payload.substring(a+obis.length()+2, b);
+// Splits the telegram into lines of the form "A-B:C.D.E(value)" and remembers where the value
+// of each C.D.E code is, so the telegram is only scanned once
+void IEC6205621::tokenize(const char* p, DsmrValues& values) {
+	values.payload = p;
+	values.count = 0;
+	values.dropped = 0;
+
+	const char* line = p;
+	while(*line != '\0') {
+		const char* colon = NULL;
+		const char* ptr = line;
+		while(*ptr != '\0' && *ptr != '\n' && *ptr != '(') {
+			if(*ptr == ':') colon = ptr;
+			ptr++;
 		}
+		if(*ptr == '(' && colon != NULL) {
+			const char* open = ptr;
+			uint8_t code[3];
+			uint8_t parts = 0;
+			const char* c = colon+1;
+			while(c < open && parts < 3) {
+				uint16_t num = 0;
+				const char* digits = c;
+				while(c < open && isdigit(*c)) {
+					num = num * 10 + (*c - '0');
+					c++;
+				}
+				if(c == digits || num > 255) break;
+				code[parts++] = num;
+				if(c < open && *c == '.') c++;
+				else break;
+			}
+			if(parts == 3 && c == open) {
+				const char* close = open+1;
+				while(*close != '\0' && *close != '\n' && *close != ')') close++;
+				if(*close == ')' && values.count == DSMR_MAX_VALUES) {
+					if(values.dropped < UINT8_MAX) values.dropped++;
+				} else if(*close == ')') {
+					DsmrValue& v = values.items[values.count++];
+					v.c = code[0];
+					v.d = code[1];
+					v.e = code[2];
+					v.start = open + 1 - p;
+					v.length = min((int) (close - open - 1), 255);
+				}
+			}
+		}
+
+		// Next line
+		while(*ptr != '\0' && *ptr != '\n') ptr++;
+		if(*ptr == '\n') ptr++;
+		line = ptr;
 	}
-	return "";
 }
 
-double IEC6205621::extractDouble(String payload, String obis) {
-	String str = extract(payload, obis);
-	if(str.isEmpty()) {
-		return 0.0;
+DsmrValue* IEC6205621::find(DsmrValues& values, uint8_t c, uint8_t d, uint8_t e) {
+	for(uint8_t i = 0; i < values.count; i++) {
+		DsmrValue& v = values.items[i];
+		if(v.c == c && v.d == d && v.e == e) return &v;
 	}
+	return NULL;
+}
 
-	int a = str.indexOf(F("*"));
-	String val = str.substring(0,a);
-	String unit = str.substring(a+1);
-
-	return unit.startsWith(F("k")) ? val.toDouble() * 1000 : val.toDouble();
+uint8_t IEC6205621::extractString(DsmrValues& values, uint8_t c, uint8_t d, uint8_t e, char* target, uint8_t size) {
+	DsmrValue* v = find(values, c, d, e);
+	if(v == NULL) return 0;
+	uint8_t len = min(v->length, (uint8_t) (size-1));
+	memcpy(target, values.payload + v->start, len);
+	target[len] = '\0';
+	return len;
 }
 
-float IEC6205621::extractFloat(String payload, String obis) {
-	String str = extract(payload, obis);
-	if(str.isEmpty()) {
+double IEC6205621::extractDouble(DsmrValues& values, uint8_t c, uint8_t d, uint8_t e) {
+	DsmrValue* v = find(values, c, d, e);
+	if(v == NULL || v->length == 0) {
 		return 0.0;
 	}
 
-	int a = str.indexOf(F("*"));
-	String val = str.substring(0,a);
-	String unit = str.substring(a+1);
+	const char* str = values.payload + v->start;
+	double val = atof(str);
+	const char* unit = (const char*) memchr(str, '*', v->length);
+	return unit != NULL && *(unit+1) == 'k' ? val * 1000 : val;
+}
 
-	return unit.startsWith(F("k")) ? val.toFloat() * 1000 : val.toFloat();
+float IEC6205621::extractFloat(DsmrValues& values, uint8_t c, uint8_t d, uint8_t e) {
+	return extractDouble(values, c, d, e);
+}
+
+uint8_t IEC6205621::getDroppedValues() {
+	return droppedValues;
+}
+
+uint8_t IEC6205621::parseDigits(const char* str, uint8_t len) {
+	uint8_t ret = 0;
+	for(uint8_t i = 0; i < len && isdigit(str[i]); i++) {
+		ret = ret * 10 + (str[i] - '0');
+	}
+	return ret;
 }
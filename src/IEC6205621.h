@@ -12,13 +12,38 @@
 #include "Timezone.h"
 #include "AmsConfiguration.h"
 
+// Value lines kept from a telegram. DSMR 5 telegrams from three phase meters with a gas meter
+// attached have about 35, the electricity values come first. Lines past this are dropped.
+#define DSMR_MAX_VALUES 48
+
+// Packed, as the table is on the stack while a telegram is decoded
+struct DsmrValue {
+    uint8_t c, d, e;
+    uint16_t start;
+    uint8_t length;
+} __attribute__((packed));
+
+struct DsmrValues {
+    const char* payload;
+    DsmrValue items[DSMR_MAX_VALUES];
+    uint8_t count;
+    uint8_t dropped;
+};
+
 class IEC6205621 : public AmsData {
 public:
     IEC6205621(const char* payload, Timezone* tz, MeterConfig* meterConfig);
 
+    uint8_t getDroppedValues();
+
 private:
-    String extract(String payload, String obis);
-    double extractDouble(String payload, String obis);
-    float extractFloat(String payload, String obis);
+    uint8_t droppedValues = 0;
+
+    void tokenize(const char* payload, DsmrValues& values);
+    DsmrValue* find(DsmrValues& values, uint8_t c, uint8_t d, uint8_t e);
+    uint8_t extractString(DsmrValues& values, uint8_t c, uint8_t d, uint8_t e, char* target, uint8_t size);
+    double extractDouble(DsmrValues& values, uint8_t c, uint8_t d, uint8_t e);
+    float extractFloat(DsmrValues& values, uint8_t c, uint8_t d, uint8_t e);
+    uint8_t parseDigits(const char* str, uint8_t len);
 };
 #endif
@@ -5,13 +5,56 @@
  */
 
 #include "IEC6205675.h"
-#include "lwip/def.h"
 #include "Timezone.h"
 #include "ntohll.h"
 #include "Uptime.h"
 
-IEC6205675::IEC6205675(const char* d, uint8_t useMeterType, MeterConfig* meterConfig, DataParserContext &ctx, AmsData &state) {
-    float val;
+static const uint8_t AMS_OBIS_UNKNOWN_1[4] = { 25, 9, 0, 255 };
+static const uint8_t AMS_OBIS_VERSION[4] = {  0, 2, 129, 255 };
+static const uint8_t AMS_OBIS_ACTIVE_IMPORT[4] = {  1, 7, 0, 255 };
+
+// Values found by OBIS code in generic lists. Entries are applied in this order, so fallbacks
+// (like METER_MODEL_2) must come after the code they are a fallback for.
+static const AmsObisMapping AMS_OBIS_MAP[] PROGMEM = {
+    { {  0, 2, 129, 255 }, AmsObisFieldListId,                 AmsObisValueString,    1, 1 },
+    { { 96, 1, 1, 255 },   AmsObisFieldMeterModel,             AmsObisValueString,    1, 1 },
+    { { 96, 1, 7, 255 },   AmsObisFieldMeterModel,             AmsObisValueString,    1, 1 },
+    { { 96, 1, 0, 255 },   AmsObisFieldMeterId,                AmsObisValueString,    1, 1 },
+    { {  0, 0, 5, 255 },   AmsObisFieldMeterId,                AmsObisValueString,    1, 1 },
+    { {  1, 0, 0, 255 },   AmsObisFieldMeterTimestamp,         AmsObisValueTimestamp, 1, 1 },
+    { {  1, 7, 0, 255 },   AmsObisFieldActiveImportPower,      AmsObisValueNumber,    1, 1 },
+    { {  2, 7, 0, 255 },   AmsObisFieldActiveExportPower,      AmsObisValueNumber,    1, 1 },
+    { {  3, 7, 0, 255 },   AmsObisFieldReactiveImportPower,    AmsObisValueNumber,    1, 1 },
+    { {  4, 7, 0, 255 },   AmsObisFieldReactiveExportPower,    AmsObisValueNumber,    1, 1 },
+    { { 32, 7, 0, 255 },   AmsObisFieldL1Voltage,              AmsObisValueNumber,    2, 1 },
+    { { 52, 7, 0, 255 },   AmsObisFieldL2Voltage,              AmsObisValueNumber,    2, 1 },
+    { { 72, 7, 0, 255 },   AmsObisFieldL3Voltage,              AmsObisValueNumber,    2, 1 },
+    { { 31, 7, 0, 255 },   AmsObisFieldL1Current,              AmsObisValueNumber,    2, 1 },
+    { { 51, 7, 0, 255 },   AmsObisFieldL2Current,              AmsObisValueNumber,    2, 1 },
+    { { 71, 7, 0, 255 },   AmsObisFieldL3Current,              AmsObisValueNumber,    2, 1 },
+    { {  1, 8, 0, 255 },   AmsObisFieldActiveImportCounter,    AmsObisValueNumber,    3, 1000 },
+    { {  2, 8, 0, 255 },   AmsObisFieldActiveExportCounter,    AmsObisValueNumber,    3, 1000 },
+    { {  3, 8, 0, 255 },   AmsObisFieldReactiveImportCounter,  AmsObisValueNumber,    3, 1000 },
+    { {  4, 8, 0, 255 },   AmsObisFieldReactiveExportCounter,  AmsObisValueNumber,    3, 1000 },
+    { { 13, 7, 0, 255 },   AmsObisFieldPowerFactor,            AmsObisValueNumber,    4, 1 },
+    { { 33, 7, 0, 255 },   AmsObisFieldL1PowerFactor,          AmsObisValueNumber,    4, 1 },
+    { { 53, 7, 0, 255 },   AmsObisFieldL2PowerFactor,          AmsObisValueNumber,    4, 1 },
+    { { 73, 7, 0, 255 },   AmsObisFieldL3PowerFactor,          AmsObisValueNumber,    4, 1 },
+    { { 21, 7, 0, 255 },   AmsObisFieldL1ActiveImportPower,    AmsObisValueNumber,    4, 1 },
+    { { 41, 7, 0, 255 },   AmsObisFieldL2ActiveImportPower,    AmsObisValueNumber,    4, 1 },
+    { { 61, 7, 0, 255 },   AmsObisFieldL3ActiveImportPower,    AmsObisValueNumber,    4, 1 },
+    { { 22, 7, 0, 255 },   AmsObisFieldL1ActiveExportPower,    AmsObisValueNumber,    4, 1 },
+    { { 42, 7, 0, 255 },   AmsObisFieldL2ActiveExportPower,    AmsObisValueNumber,    4, 1 },
+    { { 62, 7, 0, 255 },   AmsObisFieldL3ActiveExportPower,    AmsObisValueNumber,    4, 1 },
+    { { 21, 8, 0, 255 },   AmsObisFieldL1ActiveImportCounter,  AmsObisValueNumber,    4, 1000 },
+    { { 41, 8, 0, 255 },   AmsObisFieldL2ActiveImportCounter,  AmsObisValueNumber,    4, 1000 },
+    { { 61, 8, 0, 255 },   AmsObisFieldL3ActiveImportCounter,  AmsObisValueNumber,    4, 1000 },
+    { { 22, 8, 0, 255 },   AmsObisFieldL1ActiveExportCounter,  AmsObisValueNumber,    4, 1000 },
+    { { 42, 8, 0, 255 },   AmsObisFieldL2ActiveExportCounter,  AmsObisValueNumber,    4, 1000 },
+    { { 62, 8, 0, 255 },   AmsObisFieldL3ActiveExportCounter,  AmsObisValueNumber,    4, 1000 },
+};
+
+IEC6205675::IEC6205675(const char* d, uint8_t useMeterType, MeterConfig* meterConfig, DataParserContext &ctx, AmsData &state, CosemLayoutCache* layoutCache, uint8_t layout) {
     char str[64];
 
     TimeChangeRule CEST = {"CEST", Last, Sun, Mar, 2, 120};
@@ -19,231 +62,55 @@ IEC6205675::IEC6205675(const char* d, uint8_t useMeterType, MeterConfig* meterCo
     Timezone tz(CEST, CET);
 
     this->packageTimestamp = ctx.timestamp;
-
-    val = getNumber(AMS_OBIS_ACTIVE_IMPORT, sizeof(AMS_OBIS_ACTIVE_IMPORT), ((char *) (d)));
-    if(val == NOVALUE) {
-        CosemData* data = getCosemDataAt(1, ((char *) (d)));
-        
-        // Kaifa special case...
+    index = layoutCache->get(d, ctx.length);
+
+    if(layout == AmsListLayoutKaifa) {
+        this->packageTimestamp = this->packageTimestamp > 0 ? tz.toUTC(this->packageTimestamp) : 0;
+        decodeKaifa(tz);
+    } else if(layout == AmsListLayoutIskra) {
+        this->packageTimestamp = this->packageTimestamp > 0 ? tz.toUTC(this->packageTimestamp) : 0;
+        decodeIskra(state);
+    } else if(findObis(AMS_OBIS_ACTIVE_IMPORT) == NULL) {
+        CosemData* data = getCosemDataAt(1);
         if(data->base.type == CosemTypeOctetString) {
             this->packageTimestamp = this->packageTimestamp > 0 ? tz.toUTC(this->packageTimestamp) : 0;
 
-            memcpy(str, data->oct.data, data->oct.length);
-            str[data->oct.length] = 0x00;
-            String listId = String(str);
-            if(listId.startsWith(F("KFM_001"))) {
-                this->listId = listId;
-                meterType = AmsTypeKaifa;
-
-                int idx = 0;
-                data = getCosemDataAt(idx, ((char *) (d)));
-                idx+=2;
-                if(data->base.length == 0x0D || data->base.length == 0x12) {
-                    listType = data->base.length == 0x12 ? 3 : 2;
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    memcpy(str, data->oct.data, data->oct.length);
-                    str[data->oct.length] = 0x00;
-                    meterId = String(str);
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    memcpy(str, data->oct.data, data->oct.length);
-                    str[data->oct.length] = 0x00;
-                    meterModel = String(str);
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    activeImportPower = ntohl(data->dlu.data);
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    activeExportPower = ntohl(data->dlu.data);
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    reactiveImportPower = ntohl(data->dlu.data);
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    reactiveExportPower = ntohl(data->dlu.data);
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l1current = ntohl(data->dlu.data) / 1000.0;
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l2current = ntohl(data->dlu.data) / 1000.0;
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l3current = ntohl(data->dlu.data) / 1000.0;
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l1voltage = ntohl(data->dlu.data) / 10.0;
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l2voltage = ntohl(data->dlu.data) / 10.0;
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l3voltage = ntohl(data->dlu.data) / 10.0;
-                } else if(data->base.length == 0x09 || data->base.length == 0x0E) {
-                    listType = data->base.length == 0x0E ? 3 : 2;
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    memcpy(str, data->oct.data, data->oct.length);
-                    str[data->oct.length] = 0x00;
-                    meterId = String(str);
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    memcpy(str, data->oct.data, data->oct.length);
-                    str[data->oct.length] = 0x00;
-                    meterModel = String(str);
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    activeImportPower = ntohl(data->dlu.data);
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    activeExportPower = ntohl(data->dlu.data);
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    reactiveImportPower = ntohl(data->dlu.data);
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    reactiveExportPower = ntohl(data->dlu.data);
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l1current = ntohl(data->dlu.data) / 1000.0;
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l1voltage = ntohl(data->dlu.data) / 10.0;
-                }
-
-                if(listType >= 2 && memcmp(meterModel.c_str(), "MA304T3", 7) == 0) {
-                    l2voltage = sqrt(pow(l1voltage - l3voltage * cos(60 * (PI/180)), 2) + pow(l3voltage * sin(60 * (PI/180)),2));
-                    l2currentMissing = true;
-                }
-
-                if(listType == 3) {
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    switch(data->base.type) {
-                        case CosemTypeOctetString: {
-                            if(data->oct.length == 0x0C) {
-                                AmsOctetTimestamp* amst = (AmsOctetTimestamp*) data;
-                                time_t ts = decodeCosemDateTime(amst->dt);
-                                meterTimestamp = tz.toUTC(ts);
-                            }
-                        }
-                    }
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    activeImportCounter = ntohl(data->dlu.data) / 1000.0;
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    activeExportCounter = ntohl(data->dlu.data) / 1000.0;
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    reactiveImportCounter = ntohl(data->dlu.data) / 1000.0;
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    reactiveExportCounter = ntohl(data->dlu.data) / 1000.0;
-                }
-
-                lastUpdateMillis = millis64();
-            } else if(listId.startsWith("ISK")) { // Iskra special case
-                this->listId = listId;
-                meterType = AmsTypeIskra;
-
-                int idx = 0;
-                data = getCosemDataAt(idx++, ((char *) (d)));
-                if(data->base.length == 0x12) {
-                    listType = 2;
-
-                    idx++;
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    memcpy(str, data->oct.data, data->oct.length);
-                    str[data->oct.length] = 0x00;
-                    meterId = String(str);
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    activeImportPower = ntohl(data->dlu.data);
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    activeExportPower = ntohl(data->dlu.data);
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    reactiveImportPower = ntohl(data->dlu.data);
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    reactiveExportPower = ntohl(data->dlu.data);
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l1voltage = ntohs(data->lu.data) / 10.0;
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l2voltage = ntohs(data->lu.data) / 10.0;
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l3voltage = ntohs(data->lu.data) / 10.0;
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l1current = ntohs(data->lu.data) / 100.0;
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l2current = ntohs(data->lu.data) / 100.0;
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l3current = ntohs(data->lu.data) / 100.0;
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l1activeImportPower = ntohl(data->dlu.data);
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l2activeImportPower = ntohl(data->dlu.data);
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l3activeImportPower = ntohl(data->dlu.data);
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l1activeExportPower = ntohl(data->dlu.data);
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l2activeExportPower = ntohl(data->dlu.data);
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    l3activeExportPower = ntohl(data->dlu.data);
-                    
-                    lastUpdateMillis = millis64();
-                } else if(data->base.length == 0x0C) {
-                    apply(state);
-                    
-                    listType = 3;
-                    idx += 4;
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    activeImportCounter = ntohl(data->dlu.data) / 1000.0;
-                    idx += 2;
-                    
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    activeExportCounter = ntohl(data->dlu.data) / 1000.0;
-                    idx += 2;
-
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    reactiveImportCounter = ntohl(data->dlu.data) / 1000.0;
-                    data = getCosemDataAt(idx++, ((char *) (d)));
-                    reactiveExportCounter = ntohl(data->dlu.data) / 1000.0;
-
-                    lastUpdateMillis = millis64();
-                }
-            } else if(useMeterType == AmsTypeIskra && data->base.type == CosemTypeOctetString) { // Iskra special case
+            if(useMeterType == AmsTypeIskra) { // Iskra special case
                 meterType = AmsTypeIskra;
                 uint8_t idx = 5;
 
-                data = getCosemDataAt(idx++, ((char *) (d)));
+                data = getCosemDataAt(idx++);
                 if(data != NULL) {
-                    activeImportCounter = ntohl(data->dlu.data) / 1000.0;
+                    activeImportCounter = (uint64_t) ntohl(data->dlu.data) * 1000;
                 }
     
-                data = getCosemDataAt(idx++, ((char *) (d)));
+                data = getCosemDataAt(idx++);
                 if(data != NULL) {
-                    activeExportCounter = ntohl(data->dlu.data) / 1000.0;
+                    activeExportCounter = (uint64_t) ntohl(data->dlu.data) * 1000;
                 }
     
-                data = getCosemDataAt(idx++, ((char *) (d)));
+                data = getCosemDataAt(idx++);
                 if(data != NULL) {
-                    reactiveImportCounter = ntohl(data->dlu.data) / 1000.0;
+                    reactiveImportCounter = (uint64_t) ntohl(data->dlu.data) * 1000;
                 }
     
-                data = getCosemDataAt(idx++, ((char *) (d)));
+                data = getCosemDataAt(idx++);
                 if(data != NULL) {
-                    reactiveExportCounter = ntohl(data->dlu.data) / 1000.0;
+                    reactiveExportCounter = (uint64_t) ntohl(data->dlu.data) * 1000;
                 }
 
-                data = getCosemDataAt(idx++, ((char *) (d)));
+                data = getCosemDataAt(idx++);
                 if(data != NULL) {
                     activeImportPower = ntohl(data->dlu.data);
                 }
 
-                data = getCosemDataAt(idx++, ((char *) (d)));
+                data = getCosemDataAt(idx++);
                 if(data != NULL) {
                     activeExportPower = ntohl(data->dlu.data);
                 }
 
                 uint8_t str_len = 0;
-                str_len = getString(AMS_OBIS_UNKNOWN_1, sizeof(AMS_OBIS_UNKNOWN_1), ((char *) (d)), str);
+                str_len = getString(AMS_OBIS_UNKNOWN_1, str);
                 if(str_len > 0) {
                     meterId = String(str);
                 }
@@ -252,7 +119,7 @@ IEC6205675::IEC6205675(const char* d, uint8_t useMeterType, MeterConfig* meterCo
                 lastUpdateMillis = millis64();
             } else if(useMeterType == AmsTypeUnknown) {
                 uint8_t str_len = 0;
-                str_len = getString(AMS_OBIS_UNKNOWN_1, sizeof(AMS_OBIS_UNKNOWN_1), ((char *) (d)), str);
+                str_len = getString(AMS_OBIS_UNKNOWN_1, str);
                 if(str_len > 0) {
                     meterType = AmsTypeIskra;
                     meterId = String(str);
@@ -268,11 +135,8 @@ IEC6205675::IEC6205675(const char* d, uint8_t useMeterType, MeterConfig* meterCo
             lastUpdateMillis = millis64();
         }
     } else {
-        listType = 1;
-        activeImportPower = val;
-
         meterType = AmsTypeUnknown;
-        CosemData* version = findObis(AMS_OBIS_VERSION, sizeof(AMS_OBIS_VERSION), d);
+        CosemData* version = findObis(AMS_OBIS_VERSION);
         if(version != NULL && (version->base.type == CosemTypeString || version->base.type == CosemTypeOctetString)) {
             if(memcmp(version->str.data, "AIDON", 5) == 0) {
                 meterType = AmsTypeAidon;
@@ -282,7 +146,7 @@ IEC6205675::IEC6205675(const char* d, uint8_t useMeterType, MeterConfig* meterCo
                 meterType = AmsTypeKaifa;
             }
         } else {
-            version = getCosemDataAt(1, ((char *) (d)));
+            version = getCosemDataAt(1);
             if(version->base.type == CosemTypeString) {
                 if(memcmp(version->str.data, "Kamstrup", 8) == 0) {
                     meterType = AmsTypeKamstrup;
@@ -304,197 +168,7 @@ IEC6205675::IEC6205675(const char* d, uint8_t useMeterType, MeterConfig* meterCo
             }
         }
 
-        uint8_t str_len = 0;
-        str_len = getString(AMS_OBIS_VERSION, sizeof(AMS_OBIS_VERSION), ((char *) (d)), str);
-        if(str_len > 0) {
-            listId = String(str);
-        }
-
-        val = getNumber(AMS_OBIS_ACTIVE_EXPORT, sizeof(AMS_OBIS_ACTIVE_EXPORT), ((char *) (d)));
-        if(val != NOVALUE) {
-            activeExportPower = val;
-        }
-
-        val = getNumber(AMS_OBIS_REACTIVE_IMPORT, sizeof(AMS_OBIS_REACTIVE_IMPORT), ((char *) (d)));
-        if(val != NOVALUE) {
-            reactiveImportPower = val;
-        }
-
-        val = getNumber(AMS_OBIS_REACTIVE_EXPORT, sizeof(AMS_OBIS_REACTIVE_EXPORT), ((char *) (d)));
-        if(val != NOVALUE) {
-            reactiveExportPower = val;
-        }
-
-        val = getNumber(AMS_OBIS_VOLTAGE_L1, sizeof(AMS_OBIS_VOLTAGE_L1), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 2;
-            l1voltage = val;
-        }
-        val = getNumber(AMS_OBIS_VOLTAGE_L2, sizeof(AMS_OBIS_VOLTAGE_L2), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 2;
-            l2voltage = val;
-        }
-        val = getNumber(AMS_OBIS_VOLTAGE_L3, sizeof(AMS_OBIS_VOLTAGE_L3), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 2;
-            l3voltage = val;
-        }
-
-        val = getNumber(AMS_OBIS_CURRENT_L1, sizeof(AMS_OBIS_CURRENT_L1), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 2;
-            l1current = val;
-        }
-        val = getNumber(AMS_OBIS_CURRENT_L2, sizeof(AMS_OBIS_CURRENT_L2), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 2;
-            l2current = val;
-        } else if(listType == 2) {
-            l2currentMissing = true;
-        }
-        val = getNumber(AMS_OBIS_CURRENT_L3, sizeof(AMS_OBIS_CURRENT_L3), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 2;
-            l3current = val;
-        }
-
-        val = getNumber(AMS_OBIS_ACTIVE_IMPORT_COUNT, sizeof(AMS_OBIS_ACTIVE_IMPORT_COUNT), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 3;
-            activeImportCounter = val / 1000.0;
-        }
-        val = getNumber(AMS_OBIS_ACTIVE_EXPORT_COUNT, sizeof(AMS_OBIS_ACTIVE_EXPORT_COUNT), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 3;
-            activeExportCounter = val / 1000.0;
-        }
-        val = getNumber(AMS_OBIS_REACTIVE_IMPORT_COUNT, sizeof(AMS_OBIS_REACTIVE_IMPORT_COUNT), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 3;
-            reactiveImportCounter = val / 1000.0;
-        }
-        val = getNumber(AMS_OBIS_REACTIVE_EXPORT_COUNT, sizeof(AMS_OBIS_REACTIVE_EXPORT_COUNT), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 3;
-            reactiveExportCounter = val / 1000.0;
-        }
-
-        str_len = getString(AMS_OBIS_METER_MODEL, sizeof(AMS_OBIS_METER_MODEL), ((char *) (d)), str);
-        if(str_len > 0) {
-            meterModel = String(str);
-        } else {
-            str_len = getString(AMS_OBIS_METER_MODEL_2, sizeof(AMS_OBIS_METER_MODEL_2), ((char *) (d)), str);
-            if(str_len > 0) {
-                meterModel = String(str);
-            }
-        }
-
-        str_len = getString(AMS_OBIS_METER_ID, sizeof(AMS_OBIS_METER_ID), ((char *) (d)), str);
-        if(str_len > 0) {
-            meterId = String(str);
-        } else {
-            str_len = getString(AMS_OBIS_METER_ID_2, sizeof(AMS_OBIS_METER_ID_2), ((char *) (d)), str);
-            if(str_len > 0) {
-                meterId = String(str);
-            }
-        }
-
-        CosemData* meterTs = findObis(AMS_OBIS_METER_TIMESTAMP, sizeof(AMS_OBIS_METER_TIMESTAMP), ((char *) (d)));
-        if(meterTs != NULL) {
-            AmsOctetTimestamp* amst = (AmsOctetTimestamp*) meterTs;
-            time_t ts = decodeCosemDateTime(amst->dt);
-            if(meterType == AmsTypeAidon || meterType == AmsTypeKamstrup) {
-                meterTimestamp = ts - 3600;
-            } else {
-                meterTimestamp = ts;
-            }
-        }
-
-        val = getNumber(AMS_OBIS_POWER_FACTOR, sizeof(AMS_OBIS_POWER_FACTOR), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 4;
-            powerFactor = val;
-        }
-        val = getNumber(AMS_OBIS_POWER_FACTOR_L1, sizeof(AMS_OBIS_POWER_FACTOR_L1), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 4;
-            l1PowerFactor = val;
-        }
-        val = getNumber(AMS_OBIS_POWER_FACTOR_L2, sizeof(AMS_OBIS_POWER_FACTOR_L2), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 4;
-            l2PowerFactor = val;
-        }
-        val = getNumber(AMS_OBIS_POWER_FACTOR_L3, sizeof(AMS_OBIS_POWER_FACTOR_L3), ((char *) (d)));
-        if(val != NOVALUE) {
-            listType = 4;
-            l3PowerFactor = val;
-        }
-
-        val = getNumber(AMS_OBIS_ACTIVE_IMPORT_L1, sizeof(AMS_OBIS_ACTIVE_IMPORT_L1), ((char *) (d)));
-        if (val != NOVALUE) {
-            listType = 4;
-            l1activeImportPower = val;
-        }
-        val = getNumber(AMS_OBIS_ACTIVE_IMPORT_L2, sizeof(AMS_OBIS_ACTIVE_IMPORT_L2), ((char *) (d)));
-        if (val != NOVALUE) {
-            listType = 4;
-            l2activeImportPower = val;
-        }
-        val = getNumber(AMS_OBIS_ACTIVE_IMPORT_L3, sizeof(AMS_OBIS_ACTIVE_IMPORT_L3), ((char *) (d)));
-        if (val != NOVALUE) {
-            listType = 4;
-            l3activeImportPower = val;
-        }
-
-        val = getNumber(AMS_OBIS_ACTIVE_EXPORT_L1, sizeof(AMS_OBIS_ACTIVE_EXPORT_L1), ((char *) (d)));
-        if (val != NOVALUE) {
-            listType = 4;
-            l1activeExportPower = val;
-        }
-        val = getNumber(AMS_OBIS_ACTIVE_EXPORT_L2, sizeof(AMS_OBIS_ACTIVE_EXPORT_L2), ((char *) (d)));
-        if (val != NOVALUE) {
-            listType = 4;
-            l2activeExportPower = val;
-        }
-        val = getNumber(AMS_OBIS_ACTIVE_EXPORT_L3, sizeof(AMS_OBIS_ACTIVE_EXPORT_L3), ((char *) (d)));
-        if (val != NOVALUE) {
-            listType = 4;
-            l3activeExportPower = val;
-        }
-        val = getNumber(AMS_OBIS_ACTIVE_IMPORT_L1_COUNT, sizeof(AMS_OBIS_ACTIVE_IMPORT_L1_COUNT), ((char *) (d)));
-        if (val != NOVALUE) {
-            listType = 4;
-            l1activeImportCounter = val/1000;
-        }
-        val = getNumber(AMS_OBIS_ACTIVE_IMPORT_L2_COUNT, sizeof(AMS_OBIS_ACTIVE_IMPORT_L2_COUNT), ((char *) (d)));
-        if (val != NOVALUE) {
-            listType = 4;
-            l2activeImportCounter = val/1000;
-        }
-        val = getNumber(AMS_OBIS_ACTIVE_IMPORT_L3_COUNT, sizeof(AMS_OBIS_ACTIVE_IMPORT_L3_COUNT), ((char *) (d)));
-        if (val != NOVALUE) {
-            listType = 4;
-            l3activeImportCounter = val/1000;
-        }
-        val = getNumber(AMS_OBIS_ACTIVE_EXPORT_L1_COUNT, sizeof(AMS_OBIS_ACTIVE_EXPORT_L1_COUNT), ((char *) (d)));
-        if (val != NOVALUE) {
-            listType = 4;
-            l1activeExportCounter = val/1000;
-        }
-        val = getNumber(AMS_OBIS_ACTIVE_EXPORT_L2_COUNT, sizeof(AMS_OBIS_ACTIVE_EXPORT_L2_COUNT), ((char *) (d)));
-        if (val != NOVALUE) {
-            listType = 4;
-            l2activeExportCounter = val/1000;
-        }
-        val = getNumber(AMS_OBIS_ACTIVE_EXPORT_L2_COUNT, sizeof(AMS_OBIS_ACTIVE_EXPORT_L2_COUNT), ((char *) (d)));
-        if (val != NOVALUE) {
-            listType = 4;
-            l3activeExportCounter = val/1000;
-        }
-
-
+        applyObisValues();
 
         if(meterType == AmsTypeKamstrup) {
             if(listType >= 3) {
@@ -524,15 +198,15 @@ IEC6205675::IEC6205675(const char* d, uint8_t useMeterType, MeterConfig* meterCo
             if(l3PowerFactor != 0)
                 l3PowerFactor /= 100;
         } else if(meterType == AmsTypeSagemcom) {
-            CosemData* meterTs = getCosemDataAt(1, ((char *) (d)));
-            if(meterTs != NULL) {
+            CosemData* meterTs = getCosemDataAt(1);
+            if(meterTs->base.type != CosemTypeNull) {
                 AmsOctetTimestamp* amst = (AmsOctetTimestamp*) meterTs;
                 time_t ts = decodeCosemDateTime(amst->dt);
                 meterTimestamp = ts;
             }
 
-            CosemData* mid = getCosemDataAt(58, ((char *) (d))); // TODO: Get last item
-            if(mid != NULL) {
+            CosemData* mid = getCosemDataAt(58); // TODO: Get last item
+            if(mid->base.type != CosemTypeNull) {
                 switch(mid->base.type) {
                     case CosemTypeString:
                         memcpy(str, mid->oct.data, mid->oct.length);
@@ -552,26 +226,26 @@ IEC6205675::IEC6205675(const char* d, uint8_t useMeterType, MeterConfig* meterCo
     }
 
     if(meterConfig->wattageMultiplier > 0) {
-        activeImportPower = activeImportPower > 0 ? activeImportPower * (meterConfig->wattageMultiplier / 1000.0) : 0;
-        activeExportPower = activeExportPower > 0 ? activeExportPower * (meterConfig->wattageMultiplier / 1000.0) : 0;
-        reactiveImportPower = reactiveImportPower > 0 ? reactiveImportPower * (meterConfig->wattageMultiplier / 1000.0) : 0;
-        reactiveExportPower = reactiveExportPower > 0 ? reactiveExportPower * (meterConfig->wattageMultiplier / 1000.0) : 0;
+        activeImportPower = activeImportPower > 0 ? ((uint64_t) activeImportPower * meterConfig->wattageMultiplier) / 1000 : 0;
+        activeExportPower = activeExportPower > 0 ? ((uint64_t) activeExportPower * meterConfig->wattageMultiplier) / 1000 : 0;
+        reactiveImportPower = reactiveImportPower > 0 ? ((uint64_t) reactiveImportPower * meterConfig->wattageMultiplier) / 1000 : 0;
+        reactiveExportPower = reactiveExportPower > 0 ? ((uint64_t) reactiveExportPower * meterConfig->wattageMultiplier) / 1000 : 0;
     }
     if(meterConfig->voltageMultiplier > 0) {
-        l1voltage = l1voltage > 0 ? l1voltage * (meterConfig->voltageMultiplier / 1000.0) : 0;
-        l2voltage = l2voltage > 0 ? l2voltage * (meterConfig->voltageMultiplier / 1000.0) : 0;
-        l3voltage = l3voltage > 0 ? l3voltage * (meterConfig->voltageMultiplier / 1000.0) : 0;
+        l1voltage = l1voltage > 0 ? ((uint64_t) l1voltage * meterConfig->voltageMultiplier) / 1000 : 0;
+        l2voltage = l2voltage > 0 ? ((uint64_t) l2voltage * meterConfig->voltageMultiplier) / 1000 : 0;
+        l3voltage = l3voltage > 0 ? ((uint64_t) l3voltage * meterConfig->voltageMultiplier) / 1000 : 0;
     }
     if(meterConfig->amperageMultiplier > 0) {
-        l1current = l1current > 0 ? l1current * (meterConfig->amperageMultiplier / 1000.0) : 0;
-        l2current = l2current > 0 ? l2current * (meterConfig->amperageMultiplier / 1000.0) : 0;
-        l3current = l3current > 0 ? l3current * (meterConfig->amperageMultiplier / 1000.0) : 0;
+        l1current = l1current > 0 ? ((int64_t) l1current * meterConfig->amperageMultiplier) / 1000 : 0;
+        l2current = l2current > 0 ? ((int64_t) l2current * meterConfig->amperageMultiplier) / 1000 : 0;
+        l3current = l3current > 0 ? ((int64_t) l3current * meterConfig->amperageMultiplier) / 1000 : 0;
     }
     if(meterConfig->accumulatedMultiplier > 0) {
-        activeImportCounter = activeImportCounter > 0 ? activeImportCounter * (meterConfig->accumulatedMultiplier / 1000.0) : 0;
-        activeExportCounter = activeExportCounter > 0 ? activeExportCounter * (meterConfig->accumulatedMultiplier / 1000.0) : 0;
-        reactiveImportCounter = reactiveImportCounter > 0 ? reactiveImportCounter * (meterConfig->accumulatedMultiplier / 1000.0) : 0;
-        reactiveExportCounter = reactiveExportCounter > 0 ? reactiveExportCounter * (meterConfig->accumulatedMultiplier / 1000.0) : 0;
+        activeImportCounter = activeImportCounter > 0 ? (activeImportCounter * meterConfig->accumulatedMultiplier) / 1000 : 0;
+        activeExportCounter = activeExportCounter > 0 ? (activeExportCounter * meterConfig->accumulatedMultiplier) / 1000 : 0;
+        reactiveImportCounter = reactiveImportCounter > 0 ? (reactiveImportCounter * meterConfig->accumulatedMultiplier) / 1000 : 0;
+        reactiveExportCounter = reactiveExportCounter > 0 ? (reactiveExportCounter * meterConfig->accumulatedMultiplier) / 1000 : 0;
     }
 
     threePhase = l1voltage > 0 && l2voltage > 0 && l3voltage > 0;
@@ -587,93 +261,214 @@ IEC6205675::IEC6205675(const char* d, uint8_t useMeterType, MeterConfig* meterCo
     }
 }
 
-CosemData* IEC6205675::getCosemDataAt(uint8_t index, const char* ptr) {
-    CosemData* item = (CosemData*) ptr;
-    int i = 0;
-    char* pos = (char*) ptr;
-    while(pos-ptr < 900) {
-        item = (CosemData*) pos;
-        if(i == index) return item;
-        switch(item->base.type) {
-            case CosemTypeArray:
-            case CosemTypeStructure:
-                pos += 2;
-                break;
-            case CosemTypeOctetString:
-            case CosemTypeString:
-                pos += 2 + item->base.length;
-                break;
-            case CosemTypeLongSigned:
-            case CosemTypeLongUnsigned:
-                pos += 3;
-                break;
-            case CosemTypeDLongSigned:
-            case CosemTypeDLongUnsigned:
-                pos += 5;
-                break;
-            case CosemTypeLong64Signed:
-            case CosemTypeLong64Unsigned:
-                pos += 9;
-                break;
-            case CosemTypeNull:
-                pos += 1;
-                break;
-            default:
-                pos += 2;
-        }
-        i++;
+// Kaifa list with the id KFM_001 and the values by position
+void IEC6205675::decodeKaifa(Timezone& tz) {
+    char str[64];
+    CosemData* data = getCosemDataAt(1);
+    memcpy(str, data->oct.data, data->oct.length);
+    str[data->oct.length] = 0x00;
+    this->listId = str;
+    meterType = AmsTypeKaifa;
+
+    int idx = 0;
+    data = getCosemDataAt(idx);
+    idx+=2;
+    if(data->base.length == 0x0D || data->base.length == 0x12) {
+        listType = data->base.length == 0x12 ? 3 : 2;
+
+        data = getCosemDataAt(idx++);
+        memcpy(str, data->oct.data, data->oct.length);
+        str[data->oct.length] = 0x00;
+        meterId = String(str);
+
+        data = getCosemDataAt(idx++);
+        memcpy(str, data->oct.data, data->oct.length);
+        str[data->oct.length] = 0x00;
+        meterModel = String(str);
+
+        data = getCosemDataAt(idx++);
+        activeImportPower = ntohl(data->dlu.data);
+        data = getCosemDataAt(idx++);
+        activeExportPower = ntohl(data->dlu.data);
+
+        data = getCosemDataAt(idx++);
+        reactiveImportPower = ntohl(data->dlu.data);
+        data = getCosemDataAt(idx++);
+        reactiveExportPower = ntohl(data->dlu.data);
+
+        data = getCosemDataAt(idx++);
+        l1current = ntohl(data->dlu.data);
+        data = getCosemDataAt(idx++);
+        l2current = ntohl(data->dlu.data);
+        data = getCosemDataAt(idx++);
+        l3current = ntohl(data->dlu.data);
+
+        data = getCosemDataAt(idx++);
+        l1voltage = ntohl(data->dlu.data) * 100;
+        data = getCosemDataAt(idx++);
+        l2voltage = ntohl(data->dlu.data) * 100;
+        data = getCosemDataAt(idx++);
+        l3voltage = ntohl(data->dlu.data) * 100;
+    } else if(data->base.length == 0x09 || data->base.length == 0x0E) {
+        listType = data->base.length == 0x0E ? 3 : 2;
+
+        data = getCosemDataAt(idx++);
+        memcpy(str, data->oct.data, data->oct.length);
+        str[data->oct.length] = 0x00;
+        meterId = String(str);
+
+        data = getCosemDataAt(idx++);
+        memcpy(str, data->oct.data, data->oct.length);
+        str[data->oct.length] = 0x00;
+        meterModel = String(str);
+
+        data = getCosemDataAt(idx++);
+        activeImportPower = ntohl(data->dlu.data);
+        data = getCosemDataAt(idx++);
+        activeExportPower = ntohl(data->dlu.data);
+
+        data = getCosemDataAt(idx++);
+        reactiveImportPower = ntohl(data->dlu.data);
+        data = getCosemDataAt(idx++);
+        reactiveExportPower = ntohl(data->dlu.data);
+
+        data = getCosemDataAt(idx++);
+        l1current = ntohl(data->dlu.data);
+
+        data = getCosemDataAt(idx++);
+        l1voltage = ntohl(data->dlu.data) * 100;
     }
-    return NULL;
-}
 
-CosemData* IEC6205675::findObis(uint8_t* obis, int matchlength, const char* ptr) {
-    CosemData* item = (CosemData*) ptr;
-    int ret = 0;
-    char* pos = (char*) ptr;
-    while(pos-ptr < 900) {
-        item = (CosemData*) pos;
-        if(ret == 1) return item;
-        switch(item->base.type) {
-            case CosemTypeArray:
-            case CosemTypeStructure:
-                pos += 2;
-                break;
+    if(listType >= 2 && memcmp(meterModel.c_str(), "MA304T3", 7) == 0) {
+        l2voltage = sqrt(pow(l1voltage - l3voltage * cos(60 * (PI/180)), 2) + pow(l3voltage * sin(60 * (PI/180)),2));
+        l2currentMissing = true;
+    }
+
+    if(listType == 3) {
+        data = getCosemDataAt(idx++);
+        switch(data->base.type) {
             case CosemTypeOctetString: {
-                ret = 1;
-                uint8_t* found = item->oct.data;
-                int x = 6 - matchlength;
-                for(int i = x; i < 6; i++) {
-                    if(found[i] != obis[i-x]) ret = 0;
+                if(data->oct.length == 0x0C) {
+                    AmsOctetTimestamp* amst = (AmsOctetTimestamp*) data;
+                    time_t ts = decodeCosemDateTime(amst->dt);
+                    meterTimestamp = tz.toUTC(ts);
                 }
-            } // Fallthrough
-            case CosemTypeString: {
-                pos += 2 + item->base.length;
-                break;
             }
-            case CosemTypeLongSigned:
-            case CosemTypeLongUnsigned:
-                pos += 3;
-                break;
-            case CosemTypeDLongSigned:
-            case CosemTypeDLongUnsigned:
-                pos += 5;
-                break;
-            case CosemTypeLong64Signed:
-            case CosemTypeLong64Unsigned:
-                pos += 9;
-                break;
-            case CosemTypeNull:
-                pos += 1;
-                break;
-            default:
-                pos += 2;
         }
+
+        data = getCosemDataAt(idx++);
+        activeImportCounter = (uint64_t) ntohl(data->dlu.data) * 1000;
+        data = getCosemDataAt(idx++);
+        activeExportCounter = (uint64_t) ntohl(data->dlu.data) * 1000;
+
+        data = getCosemDataAt(idx++);
+        reactiveImportCounter = (uint64_t) ntohl(data->dlu.data) * 1000;
+        data = getCosemDataAt(idx++);
+        reactiveExportCounter = (uint64_t) ntohl(data->dlu.data) * 1000;
     }
-    return NULL;
+
+    lastUpdateMillis = millis64();
 }
 
-uint8_t IEC6205675::getString(uint8_t* obis, int matchlength, const char* ptr, char* target) {
-    CosemData* item = findObis(obis, matchlength, ptr);
+// Iskra list with an id starting with ISK and the values by position
+void IEC6205675::decodeIskra(AmsData& state) {
+    char str[64];
+    CosemData* data = getCosemDataAt(1);
+    memcpy(str, data->oct.data, data->oct.length);
+    str[data->oct.length] = 0x00;
+    this->listId = str;
+    meterType = AmsTypeIskra;
+
+    int idx = 0;
+    data = getCosemDataAt(idx++);
+    if(data->base.length == 0x12) {
+        listType = 2;
+
+        idx++;
+        data = getCosemDataAt(idx++);
+        memcpy(str, data->oct.data, data->oct.length);
+        str[data->oct.length] = 0x00;
+        meterId = String(str);
+
+        data = getCosemDataAt(idx++);
+        activeImportPower = ntohl(data->dlu.data);
+        data = getCosemDataAt(idx++);
+        activeExportPower = ntohl(data->dlu.data);
+
+        data = getCosemDataAt(idx++);
+        reactiveImportPower = ntohl(data->dlu.data);
+        data = getCosemDataAt(idx++);
+        reactiveExportPower = ntohl(data->dlu.data);
+
+        data = getCosemDataAt(idx++);
+        l1voltage = ntohs(data->lu.data) * 100;
+        data = getCosemDataAt(idx++);
+        l2voltage = ntohs(data->lu.data) * 100;
+        data = getCosemDataAt(idx++);
+        l3voltage = ntohs(data->lu.data) * 100;
+
+        data = getCosemDataAt(idx++);
+        l1current = ntohs(data->lu.data) * 10;
+        data = getCosemDataAt(idx++);
+        l2current = ntohs(data->lu.data) * 10;
+        data = getCosemDataAt(idx++);
+        l3current = ntohs(data->lu.data) * 10;
+
+        data = getCosemDataAt(idx++);
+        l1activeImportPower = ntohl(data->dlu.data);
+        data = getCosemDataAt(idx++);
+        l2activeImportPower = ntohl(data->dlu.data);
+        data = getCosemDataAt(idx++);
+        l3activeImportPower = ntohl(data->dlu.data);
+
+        data = getCosemDataAt(idx++);
+        l1activeExportPower = ntohl(data->dlu.data);
+        data = getCosemDataAt(idx++);
+        l2activeExportPower = ntohl(data->dlu.data);
+        data = getCosemDataAt(idx++);
+        l3activeExportPower = ntohl(data->dlu.data);
+        
+        lastUpdateMillis = millis64();
+    } else if(data->base.length == 0x0C) {
+        apply(state);
+        
+        listType = 3;
+        idx += 4;
+
+        data = getCosemDataAt(idx++);
+        activeImportCounter = (uint64_t) ntohl(data->dlu.data) * 1000;
+        idx += 2;
+        
+        data = getCosemDataAt(idx++);
+        activeExportCounter = (uint64_t) ntohl(data->dlu.data) * 1000;
+        idx += 2;
+
+        data = getCosemDataAt(idx++);
+        reactiveImportCounter = (uint64_t) ntohl(data->dlu.data) * 1000;
+        data = getCosemDataAt(idx++);
+        reactiveExportCounter = (uint64_t) ntohl(data->dlu.data) * 1000;
+
+        lastUpdateMillis = millis64();
+    }
+}
+
+// Positions past the end of the payload read as a null item, not as whatever follows the payload
+static CosemData COSEM_NULL_ITEM;
+
+CosemData* IEC6205675::getCosemDataAt(uint8_t idx) {
+    CosemData* data = index->getAt(idx);
+    return data != NULL ? data : &COSEM_NULL_ITEM;
+}
+
+CosemData* IEC6205675::findObis(const uint8_t* obis) {
+    return index->find(obis);
+}
+
+uint8_t IEC6205675::getString(const uint8_t* obis, char* target) {
+    return getString(findObis(obis), target);
+}
+
+uint8_t IEC6205675::getString(CosemData* item, char* target) {
     if(item != NULL) {
         switch(item->base.type) {
             case CosemTypeString:
@@ -689,9 +484,93 @@ uint8_t IEC6205675::getString(uint8_t* obis, int matchlength, const char* ptr, c
     return 0;
 }
 
-float IEC6205675::getNumber(uint8_t* obis, int matchlength, const char* ptr) {
-    CosemData* item = findObis(obis, matchlength, ptr);
-    return getNumber(item);
+void IEC6205675::applyObisValues() {
+    char str[64];
+    bool hasL2current = false, hasPhaseValues = false;
+    AmsObisMapping m;
+    for(uint8_t i = 0; i < sizeof(AMS_OBIS_MAP) / sizeof(AMS_OBIS_MAP[0]); i++) {
+        memcpy_P(&m, &AMS_OBIS_MAP[i], sizeof(m));
+        CosemData* item = findObis(m.obis);
+        if(item == NULL) continue;
+
+        switch(m.valueType) {
+            case AmsObisValueString: {
+                uint8_t len = getString(item, str);
+                if(len == 0) continue;
+                switch(m.field) {
+                    case AmsObisFieldListId:
+                        listId = String(str);
+                        break;
+                    case AmsObisFieldMeterModel:
+                        if(!meterModel.isEmpty()) continue;
+                        meterModel = String(str);
+                        break;
+                    case AmsObisFieldMeterId:
+                        if(!meterId.isEmpty()) continue;
+                        meterId = String(str);
+                        break;
+                }
+                break;
+            }
+            case AmsObisValueTimestamp: {
+                AmsOctetTimestamp* amst = (AmsOctetTimestamp*) item;
+                time_t ts = decodeCosemDateTime(amst->dt);
+                if(meterType == AmsTypeAidon || meterType == AmsTypeKamstrup) {
+                    meterTimestamp = ts - 3600;
+                } else {
+                    meterTimestamp = ts;
+                }
+                break;
+            }
+            case AmsObisValueNumber: {
+                double val = getNumber(item);
+                if(m.divisor > 1) val /= m.divisor;
+                setObisValue(m.field, val);
+                if(m.field == AmsObisFieldL2Current) hasL2current = true;
+                if(m.listType == 2) hasPhaseValues = true;
+                if(m.listType > listType) listType = m.listType;
+                break;
+            }
+        }
+    }
+    if(hasPhaseValues && !hasL2current) {
+        l2currentMissing = true;
+    }
+}
+
+void IEC6205675::setObisValue(uint8_t field, double val) {
+    switch(field) {
+        case AmsObisFieldActiveImportPower: activeImportPower = val; break;
+        case AmsObisFieldActiveExportPower: activeExportPower = val; break;
+        case AmsObisFieldReactiveImportPower: reactiveImportPower = val; break;
+        case AmsObisFieldReactiveExportPower: reactiveExportPower = val; break;
+        case AmsObisFieldL1Voltage: l1voltage = toMilli(val); break;
+        case AmsObisFieldL2Voltage: l2voltage = toMilli(val); break;
+        case AmsObisFieldL3Voltage: l3voltage = toMilli(val); break;
+        case AmsObisFieldL1Current: l1current = toMilli(val); break;
+        case AmsObisFieldL2Current: l2current = toMilli(val); break;
+        case AmsObisFieldL3Current: l3current = toMilli(val); break;
+        case AmsObisFieldActiveImportCounter: activeImportCounter = toMilliWh(val); break;
+        case AmsObisFieldActiveExportCounter: activeExportCounter = toMilliWh(val); break;
+        case AmsObisFieldReactiveImportCounter: reactiveImportCounter = toMilliWh(val); break;
+        case AmsObisFieldReactiveExportCounter: reactiveExportCounter = toMilliWh(val); break;
+        case AmsObisFieldPowerFactor: powerFactor = toMilli(val); break;
+        case AmsObisFieldL1PowerFactor: l1PowerFactor = toMilli(val); break;
+        case AmsObisFieldL2PowerFactor: l2PowerFactor = toMilli(val); break;
+        case AmsObisFieldL3PowerFactor: l3PowerFactor = toMilli(val); break;
+        case AmsObisFieldL1ActiveImportPower: l1activeImportPower = val; break;
+        case AmsObisFieldL2ActiveImportPower: l2activeImportPower = val; break;
+        case AmsObisFieldL3ActiveImportPower: l3activeImportPower = val; break;
+        case AmsObisFieldL1ActiveExportPower: l1activeExportPower = val; break;
+        case AmsObisFieldL2ActiveExportPower: l2activeExportPower = val; break;
+        case AmsObisFieldL3ActiveExportPower: l3activeExportPower = val; break;
+        case AmsObisFieldL1ActiveImportCounter: l1activeImportCounter = toMilliWh(val); break;
+        case AmsObisFieldL2ActiveImportCounter: l2activeImportCounter = toMilliWh(val); break;
+        case AmsObisFieldL3ActiveImportCounter: l3activeImportCounter = toMilliWh(val); break;
+        case AmsObisFieldL1ActiveExportCounter: l1activeExportCounter = toMilliWh(val); break;
+        case AmsObisFieldL2ActiveExportCounter: l2activeExportCounter = toMilliWh(val); break;
+        case AmsObisFieldL3ActiveExportCounter: l3activeExportCounter = toMilliWh(val); break;
+    }
 }
 
 float IEC6205675::getNumber(CosemData* item) {
@@ -746,18 +625,3 @@ float IEC6205675::getNumber(CosemData* item) {
     }
     return NOVALUE;
 }
-
-time_t IEC6205675::getTimestamp(uint8_t* obis, int matchlength, const char* ptr) {
-    CosemData* item = findObis(obis, matchlength, ptr);
-    if(item != NULL) {
-        switch(item->base.type) {
-            case CosemTypeOctetString: {
-                if(item->oct.length == 0x0C) {
-                    AmsOctetTimestamp* ts = (AmsOctetTimestamp*) item;
-                    return decodeCosemDateTime(ts->dt);
-                }
-            }
-        }
-    }
-    return 0;
-}
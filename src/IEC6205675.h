@@ -11,9 +11,70 @@
 #include "AmsConfiguration.h"
 #include "DataParser.h"
 #include "Cosem.h"
+#include "CosemIndex.h"
+#include "Timezone.h"
 
 #define NOVALUE 0xFFFFFFFF
 
+enum AmsObisField {
+    AmsObisFieldListId,
+    AmsObisFieldMeterId,
+    AmsObisFieldMeterModel,
+    AmsObisFieldMeterTimestamp,
+    AmsObisFieldActiveImportPower,
+    AmsObisFieldActiveExportPower,
+    AmsObisFieldReactiveImportPower,
+    AmsObisFieldReactiveExportPower,
+    AmsObisFieldL1Voltage,
+    AmsObisFieldL2Voltage,
+    AmsObisFieldL3Voltage,
+    AmsObisFieldL1Current,
+    AmsObisFieldL2Current,
+    AmsObisFieldL3Current,
+    AmsObisFieldActiveImportCounter,
+    AmsObisFieldActiveExportCounter,
+    AmsObisFieldReactiveImportCounter,
+    AmsObisFieldReactiveExportCounter,
+    AmsObisFieldPowerFactor,
+    AmsObisFieldL1PowerFactor,
+    AmsObisFieldL2PowerFactor,
+    AmsObisFieldL3PowerFactor,
+    AmsObisFieldL1ActiveImportPower,
+    AmsObisFieldL2ActiveImportPower,
+    AmsObisFieldL3ActiveImportPower,
+    AmsObisFieldL1ActiveExportPower,
+    AmsObisFieldL2ActiveExportPower,
+    AmsObisFieldL3ActiveExportPower,
+    AmsObisFieldL1ActiveImportCounter,
+    AmsObisFieldL2ActiveImportCounter,
+    AmsObisFieldL3ActiveImportCounter,
+    AmsObisFieldL1ActiveExportCounter,
+    AmsObisFieldL2ActiveExportCounter,
+    AmsObisFieldL3ActiveExportCounter
+};
+
+enum AmsObisValueType {
+    AmsObisValueNumber,
+    AmsObisValueString,
+    AmsObisValueTimestamp
+};
+
+struct AmsObisMapping {
+    uint8_t obis[4];
+    uint8_t field;
+    uint8_t valueType;
+    uint8_t listType; // Lowest list type a frame containing this value can be
+    uint16_t divisor;
+};
+
+// How the values of a list are found. Lists of OBIS codes and values are the default, the
+// others are named lists recognized by their id, see DLMS_FORMATS.
+enum AmsListLayout {
+    AmsListLayoutObis,
+    AmsListLayoutKaifa,
+    AmsListLayoutIskra
+};
+
 struct AmsOctetTimestamp {
     uint8_t type;
     CosemDateTime dt;
@@ -21,54 +82,19 @@ struct AmsOctetTimestamp {
 
 class IEC6205675 : public AmsData {
 public:
-    IEC6205675(const char* payload, uint8_t useMeterType, MeterConfig* meterConfig, DataParserContext &ctx, AmsData &state);
+    IEC6205675(const char* payload, uint8_t useMeterType, MeterConfig* meterConfig, DataParserContext &ctx, AmsData &state, CosemLayoutCache* layoutCache, uint8_t layout = AmsListLayoutObis);
 
 private:
-    CosemData* getCosemDataAt(uint8_t index, const char* ptr);
-    CosemData* findObis(uint8_t* obis, int matchlength, const char* ptr);
-    uint8_t getString(uint8_t* obis, int matchlength, const char* ptr, char* target);
-    float getNumber(uint8_t* obis, int matchlength, const char* ptr);
-    float getNumber(CosemData*);
-    time_t getTimestamp(uint8_t* obis, int matchlength, const char* ptr);
-
-    uint8_t AMS_OBIS_UNKNOWN_1[4]                 = { 25, 9, 0, 255 };
-
-    uint8_t AMS_OBIS_VERSION[4]                 = {  0, 2, 129, 255 };
-    uint8_t AMS_OBIS_METER_MODEL[4]             = { 96, 1, 1, 255 };
-    uint8_t AMS_OBIS_METER_MODEL_2[4]           = { 96, 1, 7, 255 };
-    uint8_t AMS_OBIS_METER_ID[4]                = { 96, 1, 0, 255 };
-    uint8_t AMS_OBIS_METER_ID_2[4]              = {  0, 0, 5, 255 };
-    uint8_t AMS_OBIS_METER_TIMESTAMP[4]         = {  1, 0, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_IMPORT[4]           = {  1, 7, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_EXPORT[4]           = {  2, 7, 0, 255 };
-    uint8_t AMS_OBIS_REACTIVE_IMPORT[4]         = {  3, 7, 0, 255 };
-    uint8_t AMS_OBIS_REACTIVE_EXPORT[4]         = {  4, 7, 0, 255 };
-    uint8_t AMS_OBIS_CURRENT_L1[4]              = { 31, 7, 0, 255 };
-    uint8_t AMS_OBIS_CURRENT_L2[4]              = { 51, 7, 0, 255 };
-    uint8_t AMS_OBIS_CURRENT_L3[4]              = { 71, 7, 0, 255 };
-    uint8_t AMS_OBIS_VOLTAGE_L1[4]              = { 32, 7, 0, 255 };
-    uint8_t AMS_OBIS_VOLTAGE_L2[4]              = { 52, 7, 0, 255 };
-    uint8_t AMS_OBIS_VOLTAGE_L3[4]              = { 72, 7, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_IMPORT_COUNT[4]     = {  1, 8, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_EXPORT_COUNT[4]     = {  2, 8, 0, 255 };
-    uint8_t AMS_OBIS_REACTIVE_IMPORT_COUNT[4]   = {  3, 8, 0, 255 };
-    uint8_t AMS_OBIS_REACTIVE_EXPORT_COUNT[4]   = {  4, 8, 0, 255 };
-    uint8_t AMS_OBIS_POWER_FACTOR[4]            = { 13, 7, 0, 255 };
-    uint8_t AMS_OBIS_POWER_FACTOR_L1[4]         = { 33, 7, 0, 255 };
-    uint8_t AMS_OBIS_POWER_FACTOR_L2[4]         = { 53, 7, 0, 255 };
-    uint8_t AMS_OBIS_POWER_FACTOR_L3[4]         = { 73, 7, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_IMPORT_L1[4]        = { 21, 7, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_IMPORT_L2[4]        = { 41, 7, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_IMPORT_L3[4]        = { 61, 7, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_EXPORT_L1[4]        = { 22, 7, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_EXPORT_L2[4]        = { 42, 7, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_EXPORT_L3[4]        = { 62, 7, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_IMPORT_L1_COUNT[4]  = {  21, 8, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_IMPORT_L2_COUNT[4]  = {  41, 8, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_IMPORT_L3_COUNT[4]  = {  61, 8, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_EXPORT_L1_COUNT[4]  = {  22, 8, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_EXPORT_L2_COUNT[4]  = {  42, 8, 0, 255 };
-    uint8_t AMS_OBIS_ACTIVE_EXPORT_L3_COUNT[4]  = {  62, 8, 0, 255 };
+    CosemIndex* index;
 
+    CosemData* getCosemDataAt(uint8_t idx);
+    CosemData* findObis(const uint8_t* obis);
+    uint8_t getString(const uint8_t* obis, char* target);
+    uint8_t getString(CosemData* item, char* target);
+    float getNumber(CosemData*);
+    void applyObisValues();
+    void decodeKaifa(Timezone& tz);
+    void decodeIskra(AmsData& state);
+    void setObisValue(uint8_t field, double val);
 };
 #endif
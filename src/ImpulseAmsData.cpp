@@ -16,6 +16,6 @@ ImpulseAmsData::ImpulseAmsData(AmsData& state, uint16_t pulsePerKwh, uint8_t pul
 }
 
 ImpulseAmsData::ImpulseAmsData(double activeImportCounter) {
-    this->activeImportCounter = activeImportCounter;
+    this->activeImportCounter = toMilliWh(activeImportCounter);
     this->listType = 3;
 }
\ No newline at end of file
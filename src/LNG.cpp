@@ -5,7 +5,6 @@
  */
 
 #include "LNG.h"
-#include "lwip/def.h"
 #include "ntohll.h"
 #include "Uptime.h"
 
@@ -53,22 +52,22 @@ LNG::LNG(AmsData& meterState, const char* payload, uint8_t useMeterType, MeterCo
                             reactiveExportPower = getNumber(item);
                             break;
                         case 31:
-                            l1current = getNumber(item) / 100.0;
+                            l1current = getNumber(item) * 10;
                             break;
                         case 51:
-                            l2current = getNumber(item) / 100.0;
+                            l2current = getNumber(item) * 10;
                             break;
                         case 71:
-                            l3current = getNumber(item) / 100.0;
+                            l3current = getNumber(item) * 10;
                             break;
                         case 32:
-                            l1voltage = getNumber(item) / 10.0;
+                            l1voltage = getNumber(item) * 100;
                             break;
                         case 52:
-                            l2voltage = getNumber(item) / 10.0;
+                            l2voltage = getNumber(item) * 100;
                             break;
                         case 72:
-                            l3voltage = getNumber(item) / 10.0;
+                            l3voltage = getNumber(item) * 100;
                             break;
                     }
                 }
@@ -78,19 +77,19 @@ LNG::LNG(AmsData& meterState, const char* payload, uint8_t useMeterType, MeterCo
                     switch(descriptor->obis[2]) {
                         case 1:
                             o180 = getNumber(item);
-                            activeImportCounter = o180 / 1000.0;
+                            activeImportCounter = o180 * 1000;
                             break;
                         case 2:
                             o280 = getNumber(item);
-                            activeExportCounter = o280 / 1000.0;
+                            activeExportCounter = o280 * 1000;
                             break;
                         case 3:
                             o380 = getNumber(item);
-                            reactiveImportCounter = o380 / 1000.0;
+                            reactiveImportCounter = o380 * 1000;
                             break;
                         case 4:
                             o480 = getNumber(item);
-                            reactiveExportCounter = o480 / 1000.0;
+                            reactiveExportCounter = o480 * 1000;
                             break;
                         case 5:
                             o580 = getNumber(item);
@@ -157,17 +156,17 @@ LNG::LNG(AmsData& meterState, const char* payload, uint8_t useMeterType, MeterCo
             }
 
             if(o181 > 0 || o182 > 0) {
-                activeImportCounter = (o181 + o182) / 1000.0;
+                activeImportCounter = (o181 + o182) * 1000;
             }
             if(o281 > 0 || o282 > 0) {
-                activeExportCounter = (o281 + o282) / 1000.0;
+                activeExportCounter = (o281 + o282) * 1000;
             }
 
             if(o580 > 0 || o680 > 0) {
-                reactiveImportCounter = (o580 + o680) / 1000.0;
+                reactiveImportCounter = (o580 + o680) * 1000;
             }
             if(o780 > 0 || o880 > 0) {
-                reactiveExportCounter = (o780 + o880) / 1000.0;
+                reactiveExportCounter = (o780 + o880) * 1000;
             }
 
             if((*data) == 0x09) {
@@ -184,26 +183,26 @@ LNG::LNG(AmsData& meterState, const char* payload, uint8_t useMeterType, MeterCo
         }
         lastUpdateMillis = millis64();
         if(meterConfig->wattageMultiplier > 0) {
-            activeImportPower = activeImportPower > 0 ? activeImportPower * (meterConfig->wattageMultiplier / 1000.0) : 0;
-            activeExportPower = activeExportPower > 0 ? activeExportPower * (meterConfig->wattageMultiplier / 1000.0) : 0;
-            reactiveImportPower = reactiveImportPower > 0 ? reactiveImportPower * (meterConfig->wattageMultiplier / 1000.0) : 0;
-            reactiveExportPower = reactiveExportPower > 0 ? reactiveExportPower * (meterConfig->wattageMultiplier / 1000.0) : 0;
+            activeImportPower = activeImportPower > 0 ? ((uint64_t) activeImportPower * meterConfig->wattageMultiplier) / 1000 : 0;
+            activeExportPower = activeExportPower > 0 ? ((uint64_t) activeExportPower * meterConfig->wattageMultiplier) / 1000 : 0;
+            reactiveImportPower = reactiveImportPower > 0 ? ((uint64_t) reactiveImportPower * meterConfig->wattageMultiplier) / 1000 : 0;
+            reactiveExportPower = reactiveExportPower > 0 ? ((uint64_t) reactiveExportPower * meterConfig->wattageMultiplier) / 1000 : 0;
         }
         if(meterConfig->voltageMultiplier > 0) {
-            l1voltage = l1voltage > 0 ? l1voltage * (meterConfig->voltageMultiplier / 1000.0) : 0;
-            l2voltage = l2voltage > 0 ? l2voltage * (meterConfig->voltageMultiplier / 1000.0) : 0;
-            l3voltage = l3voltage > 0 ? l3voltage * (meterConfig->voltageMultiplier / 1000.0) : 0;
+            l1voltage = l1voltage > 0 ? ((uint64_t) l1voltage * meterConfig->voltageMultiplier) / 1000 : 0;
+            l2voltage = l2voltage > 0 ? ((uint64_t) l2voltage * meterConfig->voltageMultiplier) / 1000 : 0;
+            l3voltage = l3voltage > 0 ? ((uint64_t) l3voltage * meterConfig->voltageMultiplier) / 1000 : 0;
         }
         if(meterConfig->amperageMultiplier > 0) {
-            l1current = l1current > 0 ? l1current * (meterConfig->amperageMultiplier / 1000.0) : 0;
-            l2current = l2current > 0 ? l2current * (meterConfig->amperageMultiplier / 1000.0) : 0;
-            l3current = l3current > 0 ? l3current * (meterConfig->amperageMultiplier / 1000.0) : 0;
+            l1current = l1current > 0 ? ((int64_t) l1current * meterConfig->amperageMultiplier) / 1000 : 0;
+            l2current = l2current > 0 ? ((int64_t) l2current * meterConfig->amperageMultiplier) / 1000 : 0;
+            l3current = l3current > 0 ? ((int64_t) l3current * meterConfig->amperageMultiplier) / 1000 : 0;
         }
         if(meterConfig->accumulatedMultiplier > 0) {
-            activeImportCounter = activeImportCounter > 0 ? activeImportCounter * (meterConfig->accumulatedMultiplier / 1000.0) : 0;
-            activeExportCounter = activeExportCounter > 0 ? activeExportCounter * (meterConfig->accumulatedMultiplier / 1000.0) : 0;
-            reactiveImportCounter = reactiveImportCounter > 0 ? reactiveImportCounter * (meterConfig->accumulatedMultiplier / 1000.0) : 0;
-            reactiveExportCounter = reactiveExportCounter > 0 ? reactiveExportCounter * (meterConfig->accumulatedMultiplier / 1000.0) : 0;
+            activeImportCounter = activeImportCounter > 0 ? (activeImportCounter * meterConfig->accumulatedMultiplier) / 1000 : 0;
+            activeExportCounter = activeExportCounter > 0 ? (activeExportCounter * meterConfig->accumulatedMultiplier) / 1000 : 0;
+            reactiveImportCounter = reactiveImportCounter > 0 ? (reactiveImportCounter * meterConfig->accumulatedMultiplier) / 1000 : 0;
+            reactiveExportCounter = reactiveExportCounter > 0 ? (reactiveExportCounter * meterConfig->accumulatedMultiplier) / 1000 : 0;
         }
 
         threePhase = l1voltage > 0 && l2voltage > 0 && l3voltage > 0;
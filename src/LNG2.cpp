@@ -15,18 +15,18 @@ LNG2::LNG2(AmsData& meterState, const char* payload, uint8_t useMeterType, Meter
         this->packageTimestamp = ctx.timestamp;
 
         Lng2Data_3p* d = (Lng2Data_3p*) payload;
-        this->l1voltage = ntohs(d->u1.data);
-        this->l2voltage = ntohs(d->u2.data);
-        this->l3voltage = ntohs(d->u3.data);
+        this->l1voltage = ntohs(d->u1.data) * 1000;
+        this->l2voltage = ntohs(d->u2.data) * 1000;
+        this->l3voltage = ntohs(d->u3.data) * 1000;
 
-        this->l1current = ntohs(d->i1.data) / 100.0;
-        this->l2current = ntohs(d->i2.data) / 100.0;
-        this->l3current = ntohs(d->i3.data) / 100.0;
+        this->l1current = ntohs(d->i1.data) * 10;
+        this->l2current = ntohs(d->i2.data) * 10;
+        this->l3current = ntohs(d->i3.data) * 10;
 
         this->activeImportPower = ntohl(d->activeImport.data);
         this->activeExportPower = ntohl(d->activeExport.data);
-        this->activeImportCounter = ntohl(d->acumulatedImport.data) / 1000.0;
-        this->activeExportCounter = ntohl(d->accumulatedExport.data) / 1000.0;
+        this->activeImportCounter = (uint64_t) ntohl(d->acumulatedImport.data) * 1000;
+        this->activeExportCounter = (uint64_t) ntohl(d->accumulatedExport.data) * 1000;
 
         char str[64];
         uint8_t str_len = getString((CosemData*) &d->meterId, str);
@@ -17,12 +17,14 @@
 class MeterCommunicator {
 public:
     virtual ~MeterCommunicator() {};
-    virtual void configure(MeterConfig&, Timezone*);
-    virtual bool loop();
-    virtual AmsData* getData(AmsData& meterState);
-    virtual int getLastError();
-    virtual bool isConfigChanged();
-    virtual void getCurrentConfig(MeterConfig& meterConfig);
+    virtual void configure(MeterConfig&, Timezone*) = 0;
+    virtual bool loop() = 0;
+    virtual AmsData* getData(AmsData& meterState) = 0;
+    virtual void releaseData(AmsData* data) { delete data; };
+    virtual bool isDataUnchanged() { return false; };
+    virtual int getLastError() = 0;
+    virtual bool isConfigChanged() = 0;
+    virtual void getCurrentConfig(MeterConfig& meterConfig) = 0;
 };
 
 #endif
@@ -5,15 +5,26 @@
  */
 
 #include "PassiveMeterCommunicator.h"
-#include "IEC6205675.h"
 #include "IEC6205621.h"
-#include "LNG.h"
-#include "LNG2.h"
+#include "DlmsFormat.h"
+#include "Uptime.h"
+#include "UartFrameReceiver.h"
 
 #if defined(ESP32)
 #include <driver/uart.h>
 #endif
 
+// Runs from the RX pin interrupt while serial autodetect is capturing the line
+static void IRAM_ATTR onAutodetectEdge(void* arg) {
+	AutodetectCapture* capture = (AutodetectCapture*) arg;
+	uint32_t now = micros();
+	if(capture->count < AUTODETECT_CAPTURE_RUNS) {
+		uint32_t run = now - capture->lastEdge;
+		capture->runs[capture->count++] = run > 0xFFFF ? 0xFFFF : run;
+	}
+	capture->lastEdge = now;
+}
+
 #if defined(AMS_REMOTE_DEBUG)
 PassiveMeterCommunicator::PassiveMeterCommunicator(RemoteDebug* debugger) {
     this->debugger = debugger;
@@ -24,6 +35,34 @@ PassiveMeterCommunicator::PassiveMeterCommunicator(Stream* debugger) {
 }
 #endif
 
+PassiveMeterCommunicator::~PassiveMeterCommunicator() {
+	// Stops the receiving task before the ring goes away
+	if(rxReceiver != NULL) {
+		delete rxReceiver;
+		rxReceiver = NULL;
+	}
+	// Only a capture this instance started is detached, the pin interrupt writes into its buffer
+	if(autodetectCapture.runs != NULL) {
+		detachInterrupt(digitalPinToInterrupt(autodetectCapture.pin));
+		free(autodetectCapture.runs);
+		autodetectCapture.runs = NULL;
+	}
+	if(hdlcParser != NULL) delete hdlcParser;
+	if(mbusParser != NULL) delete mbusParser;
+	if(gbtParser != NULL) delete gbtParser;
+	if(gcmParser != NULL) delete gcmParser;
+	if(llcParser != NULL) delete llcParser;
+	if(dlmsParser != NULL) delete dlmsParser;
+	if(dsmrParser != NULL) delete dsmrParser;
+	#if defined(ESP8266)
+	if(swSerial != NULL) {
+		swSerial->end();
+		delete swSerial;
+	}
+	#endif
+	if(hanBuffer != NULL) free(hanBuffer);
+}
+
 void PassiveMeterCommunicator::configure(MeterConfig& meterConfig, Timezone* tz) {
     this->meterConfig = meterConfig;
 	if(meterConfig.baud == 0) {
@@ -33,9 +72,24 @@ void PassiveMeterCommunicator::configure(MeterConfig& meterConfig, Timezone* tz)
     this->tz = tz;
     setupHanPort(meterConfig.baud, meterConfig.parity, meterConfig.invert);
     if(gcmParser != NULL) {
-        delete gcmParser;
-        gcmParser = NULL;
+        gcmParser->setKeys(meterConfig.encryptionKey, meterConfig.authenticationKey);
     }
+    // Multipliers and meter type affect decoding, a repeated payload must be decoded again
+    frameDigest.invalidate();
+    dlmsFormat = -1;
+}
+
+void PassiveMeterCommunicator::setChannel(uint8_t channel) {
+	this->channel = channel;
+}
+
+// Parsers keep segmentation and key state per stream, but a layout only depends on the payload, so
+// one cache serves every channel. It is created on the first DLMS frame and kept from then on.
+CosemLayoutCache* PassiveMeterCommunicator::layoutCache = NULL;
+
+CosemLayoutCache* PassiveMeterCommunicator::getLayoutCache() {
+	if(layoutCache == NULL) layoutCache = new CosemLayoutCache();
+	return layoutCache;
 }
 
 bool PassiveMeterCommunicator::loop() {
@@ -45,6 +99,13 @@ bool PassiveMeterCommunicator::loop() {
     if(autodetect) handleAutodetect(now);
 
 	unsigned long start, end;
+	if(rxReceiver != NULL && rxReceiver->getOverflows() != rxRingOverflows) {
+		rxRingOverflows = rxReceiver->getOverflows();
+		#if defined(AMS_REMOTE_DEBUG)
+if (debugger->isActive(RemoteDebug::WARNING))
+#endif
+debugger->printf_P(PSTR("Frame dropped, RX ring buffer full (%lu times)\n"), rxRingOverflows);
+	}
 	if(!hanSerial->available()) {
 		return false;
 	}
@@ -57,25 +118,42 @@ bool PassiveMeterCommunicator::loop() {
 	}
 
 	dataAvailable = false;
-	ctx = {0,0,0,0};
+	ctx = {};
 	memset(ctx.system_title, 0, 8);
     pos = DATA_PARSE_INCOMPLETE;
 	// For each byte received, check if we have a complete frame we can handle
 	start = millis();
+	// Frames holding earlier segments of an APDU are kept where they were received, the frame
+	// currently being received follows right after them
+	uint8_t* frame = hanBuffer + segmentOffset;
 	while(hanSerial->available() && pos == DATA_PARSE_INCOMPLETE) {
 		// If buffer was overflowed, reset
-		if(len >= hanBufferSize) {
+		if(segmentOffset + len >= hanBufferSize) {
+			if(segmentOffset > 0 && compactSegments()) {
+				frame = hanBuffer + segmentOffset;
+				continue;
+			}
 			hanSerial->readBytes(hanBuffer, hanBufferSize);
 			len = 0;
+			segmentOffset = 0;
+			segments.begin();
 			#if defined(AMS_REMOTE_DEBUG)
 if (debugger->isActive(RemoteDebug::INFO))
 #endif
 debugger->printf_P(PSTR("Buffer overflow, resetting\n"));
 			return false;
 		}
-		hanBuffer[len++] = hanSerial->read();
+		frame[len++] = hanSerial->read();
 		ctx.length = len;
-		pos = unwrapData((uint8_t *) hanBuffer, ctx);
+		// Only unwrap when the outer frame is complete, instead of reparsing the buffer for every byte
+		pos = frameAssembler.append(frame, len);
+		if(pos == DATA_PARSE_INCOMPLETE) {
+			yield();
+			continue;
+		} else if(pos < 0) {
+			break;
+		}
+		pos = unwrapData(frame, ctx);
 		if(ctx.type > 0 && pos >= 0) {
 			switch(ctx.type) {
 				case DATA_TAG_DLMS:
@@ -121,6 +199,7 @@ if (debugger->isActive(RemoteDebug::ERROR))
 #endif
 debugger->printf_P(PSTR("Unknown tag %02X at pos %d\n"), ctx.type, pos);
 					len = 0;
+					segmentOffset = 0;
 					return false;
 			}
 		}
@@ -142,36 +221,28 @@ if (debugger->isActive(RemoteDebug::WARNING))
 #endif
 debugger->printf_P(PSTR("Unknown data received\n"));
         lastError = pos;
-		len = len + hanSerial->readBytes(hanBuffer+len, hanBufferSize-len);
-		#if defined(AMS_REMOTE_DEBUG)
-if (debugger->isActive(RemoteDebug::VERBOSE))
-#endif
-{
-			debugger->printf_P(PSTR("  payload:\n"));
-			debugPrint(hanBuffer, 0, len);
-		}
+		len = len + hanSerial->readBytes(frame+len, hanBufferSize-segmentOffset-len);
+		trace.record(FrameTraceError, ctx.type, pos, frame, len);
 		len = 0;
+		segmentOffset = 0;
 		return false;
 	}
 	if(pos == DATA_PARSE_INTERMEDIATE_SEGMENT) {
+		// Keep the frame, its payload is in the scatter list. Receive the next frame after it.
+		segmentOffset += len;
 		len = 0;
 		return false;
 	} else if(pos < 0) {
         lastError = pos;
 		printHanReadError(pos);
-		len += hanSerial->readBytes(hanBuffer+len, hanBufferSize-len);
+		len += hanSerial->readBytes(frame+len, hanBufferSize-segmentOffset-len);
         if(pt != NULL) {
-            pt->publishBytes(hanBuffer, len);
+            pt->publishBytes(frame, len);
         }
-		#if defined(AMS_REMOTE_DEBUG)
-if (debugger->isActive(RemoteDebug::VERBOSE))
-#endif
-{
-			debugger->printf_P(PSTR("  payload:\n"));
-			debugPrint(hanBuffer, 0, len);
-		}
+		trace.record(FrameTraceError, ctx.type, pos, frame, len);
 		while(hanSerial->available()) hanSerial->read(); // Make sure it is all empty, in case we overflowed buffer above
 		len = 0;
+		segmentOffset = 0;
 		return false;
 	}
 
@@ -181,18 +252,15 @@ if (debugger->isActive(RemoteDebug::WARNING))
 #endif
 debugger->printf_P(PSTR("Ended up with context type %d, return code %d and length: %lu/%lu\n"), ctx.type, pos, ctx.length, len);
         lastError = pos;
-		len = len + hanSerial->readBytes(hanBuffer+len, hanBufferSize-len);
-		#if defined(AMS_REMOTE_DEBUG)
-if (debugger->isActive(RemoteDebug::VERBOSE))
-#endif
-{
-			debugger->printf_P(PSTR("  payload:\n"));
-			debugPrint(hanBuffer, 0, len);
-		}
+		len = len + hanSerial->readBytes(frame+len, hanBufferSize-segmentOffset-len);
+		trace.record(FrameTraceError, ctx.type, pos, frame, len);
 		len = 0;
+		segmentOffset = 0;
 		return false;
 	}
 
+	segmentOffset = 0;
+
 	// Data is valid, clear the rest of the buffer to avoid tainted parsing
 	for(int i = pos+ctx.length; i<hanBufferSize; i++) {
 		hanBuffer[i] = 0x00;
@@ -214,63 +282,74 @@ AmsData* PassiveMeterCommunicator::getData(AmsData& meterState) {
     AmsData* data = NULL;
 	char* payload = ((char *) (hanBuffer)) + pos;
 	if(maxDetectedPayloadSize < pos) maxDetectedPayloadSize = pos;
-	if(ctx.type == DATA_TAG_DLMS) {
-        if(pt != NULL) {
-            pt->publishBytes((uint8_t*) payload, ctx.length);
-        }
-
+	if(ctx.type == DATA_TAG_DLMS && pt != NULL) {
+		pt->publishBytes((uint8_t*) payload, ctx.length);
+	}
+	trace.record(FrameTracePayload, ctx.type, DATA_PARSE_OK, (uint8_t*) payload, ctx.length);
+	dataUnchanged = (ctx.type == DATA_TAG_DLMS || ctx.type == DATA_TAG_DSMR) && frameDigest.matches((uint8_t*) payload, ctx);
+	if(dataUnchanged) {
 		#if defined(AMS_REMOTE_DEBUG)
 if (debugger->isActive(RemoteDebug::VERBOSE))
 #endif
-debugger->printf_P(PSTR("Using application data:\n"));
+debugger->printf_P(PSTR("Payload unchanged, using last decoded frame\n"));
+		digestFrame.setLastUpdateMillis(millis64());
+	} else if(ctx.type == DATA_TAG_DLMS) {
 		#if defined(AMS_REMOTE_DEBUG)
 if (debugger->isActive(RemoteDebug::VERBOSE))
 #endif
-debugPrint((byte*) payload, 0, ctx.length);
+debugger->printf_P(PSTR("Using application data\n"));
 
-		// Rudimentary detector for L&G proprietary format, this is terrible code... Fix later
-		if(payload[0] == CosemTypeStructure && payload[2] == CosemTypeArray && payload[1] == payload[3]) {
+		// Once a format has decoded a frame from this meter, use it directly as long as it still fits
+		int8_t format = dlmsFormat;
+		if(format < 0 || DLMS_FORMATS[format].probe(payload, ctx.length) == 0) {
+			format = dlmsFormatProbe(payload, ctx.length);
+		}
+		if(format < 0) {
+			digestFrame.reset();
+			digestMerge = true;
+		} else {
 			#if defined(AMS_REMOTE_DEBUG)
 if (debugger->isActive(RemoteDebug::VERBOSE))
 #endif
-debugger->printf_P(PSTR("LNG\n"));
-			LNG lngData = LNG(meterState, payload, meterState.getMeterType(), &meterConfig, ctx);
-			if(lngData.getListType() >= 1) {
-				data = new AmsData();
-				data->apply(meterState);
-				data->apply(lngData);
-			}
-		} else if(payload[0] == CosemTypeStructure && 
-			payload[2] == CosemTypeLongUnsigned && 
-			payload[5] == CosemTypeLongUnsigned && 
-			payload[8] == CosemTypeLongUnsigned && 
-			payload[11] == CosemTypeLongUnsigned && 
-			payload[14] == CosemTypeLongUnsigned && 
-			payload[17] == CosemTypeLongUnsigned
-		) {
+debugger->printf_P(PSTR("%s\n"), DLMS_FORMATS[format].name);
+			DlmsFormatContext fc = { &meterState, &meterConfig, &ctx, getLayoutCache() };
+			DLMS_FORMATS[format].decode(digestFrame, payload, fc);
+			digestMerge = DLMS_FORMATS[format].merge;
+			// A format that stops producing data is dropped, the next frame is probed again
+			dlmsFormat = digestFrame.getListType() >= 1 ? format : -1;
 			#if defined(AMS_REMOTE_DEBUG)
-if (debugger->isActive(RemoteDebug::VERBOSE))
+if (debugger->isActive(RemoteDebug::DEBUG))
 #endif
-debugger->printf_P(PSTR("LNG2\n"));
-			LNG2 lngData = LNG2(meterState, payload, meterState.getMeterType(), &meterConfig, ctx);
-			if(lngData.getListType() >= 1) {
-				data = new AmsData();
-				data->apply(meterState);
-				data->apply(lngData);
-			}
-		} else {
+debugger->printf_P(PSTR("Layout cache hits: %lu, misses: %lu\n"), layoutCache->getHits(), layoutCache->getMisses());
+		}
+	} else if(ctx.type == DATA_TAG_DSMR) {
+		IEC6205621 decoded(payload, tz, &meterConfig);
+		if(decoded.getDroppedValues() > 0) {
 			#if defined(AMS_REMOTE_DEBUG)
-if (debugger->isActive(RemoteDebug::VERBOSE))
+if (debugger->isActive(RemoteDebug::WARNING))
 #endif
-debugger->printf_P(PSTR("DLMS\n"));
-			// TODO: Split IEC6205675 into DataParserKaifa and DataParserObis. This way we can add other means of parsing, for those other proprietary formats
-			data = new IEC6205675(payload, meterState.getMeterType(), &meterConfig, ctx, meterState);
+debugger->printf_P(PSTR("DSMR telegram has more than %d values, %d lines dropped\n"), DSMR_MAX_VALUES, decoded.getDroppedValues());
 		}
-	} else if(ctx.type == DATA_TAG_DSMR) {
-		data = new IEC6205621(payload, tz, &meterConfig);
+		digestFrame = decoded;
+		digestMerge = false;
+	}
+	if(ctx.type == DATA_TAG_DLMS || ctx.type == DATA_TAG_DSMR) {
+		if(!digestMerge) {
+			data = acquireFrameSlot();
+			*data = digestFrame;
+		} else if(digestFrame.getListType() >= 1) {
+			data = acquireFrameSlot();
+			data->apply(meterState);
+			data->apply(digestFrame);
+		}
+		#if defined(AMS_REMOTE_DEBUG)
+if (debugger->isActive(RemoteDebug::DEBUG))
+#endif
+debugger->printf_P(PSTR("Frame digest hits: %lu, misses: %lu\n"), frameDigest.getHits(), frameDigest.getMisses());
 	}
 	len = 0;
     if(data != NULL) {
+        decodedFrames++;
         if(data->getListType() > 0) {
             validDataReceived = true;
             if(rxBufferErrors > 0) rxBufferErrors--;
@@ -280,6 +359,63 @@ debugger->printf_P(PSTR("DLMS\n"));
     return data;
 }
 
+AmsData* PassiveMeterCommunicator::acquireFrameSlot() {
+	for(uint8_t i = 0; i < 2; i++) {
+		uint8_t slot = (nextFrameSlot + i) % 2;
+		if(!frameSlotInUse[slot]) {
+			frameSlotInUse[slot] = true;
+			nextFrameSlot = (slot + 1) % 2;
+			frameSlots[slot].reset();
+			return &frameSlots[slot];
+		}
+	}
+	// Both slots are still held by the caller, fall back to the heap
+	frameAllocations++;
+	#if defined(AMS_REMOTE_DEBUG)
+if (debugger->isActive(RemoteDebug::WARNING))
+#endif
+debugger->printf_P(PSTR("No free frame slot, allocated %lu frames of %lu on heap\n"), frameAllocations, decodedFrames);
+	return new AmsData();
+}
+
+void PassiveMeterCommunicator::releaseData(AmsData* data) {
+	for(uint8_t i = 0; i < 2; i++) {
+		if(data == &frameSlots[i]) {
+			frameSlotInUse[i] = false;
+			return;
+		}
+	}
+	delete data;
+}
+
+uint32_t PassiveMeterCommunicator::getDecodedFrames() {
+	return decodedFrames;
+}
+
+uint32_t PassiveMeterCommunicator::getFrameAllocations() {
+	return frameAllocations;
+}
+
+bool PassiveMeterCommunicator::isDataUnchanged() {
+	return dataUnchanged;
+}
+
+uint32_t PassiveMeterCommunicator::getDigestHits() {
+	return frameDigest.getHits();
+}
+
+uint32_t PassiveMeterCommunicator::getDigestMisses() {
+	return frameDigest.getMisses();
+}
+
+void PassiveMeterCommunicator::setPassthroughMqttHandler(PassthroughMqttHandler* pt) {
+	this->pt = pt;
+}
+
+FrameTrace* PassiveMeterCommunicator::getTrace() {
+	return &trace;
+}
+
 int PassiveMeterCommunicator::getLastError() {
 	#if defined ESP8266
 	if(hwSerial != NULL) {
@@ -311,10 +447,24 @@ void PassiveMeterCommunicator::getCurrentConfig(MeterConfig& meterConfig) {
 }
 
 
+// Makes room for the frame being received when it does not fit after the frames holding the
+// earlier segments, by gathering their payloads at the start of the buffer
+bool PassiveMeterCommunicator::compactSegments() {
+	uint8_t* frame = hanBuffer + segmentOffset;
+	uint16_t kept = segments.gather();
+	if(kept == 0 || kept >= segmentOffset) return false;
+	memmove(hanBuffer + kept, frame, len);
+	segmentOffset = kept;
+	return true;
+}
+
 int16_t PassiveMeterCommunicator::unwrapData(uint8_t *buf, DataParserContext &context) {
-	int16_t ret = 0;
+	// Offsets returned are from the start of hanBuffer, buf may be a frame received after earlier segments
+	int16_t ret = buf - hanBuffer;
 	bool doRet = false;
-	uint16_t end = hanBufferSize;
+	segments.setBuffer(hanBuffer, hanBufferSize);
+	context.segments = &segments;
+	uint16_t end = hanBufferSize - ret;
 	uint8_t tag = (*buf);
 	uint8_t lastTag = DATA_TAG_NONE;
 	while(tag != DATA_TAG_NONE) {
@@ -323,7 +473,7 @@ int16_t PassiveMeterCommunicator::unwrapData(uint8_t *buf, DataParserContext &co
 		switch(tag) {
 			case DATA_TAG_HDLC:
 				if(hdlcParser == NULL) hdlcParser = new HDLCParser();
-				res = hdlcParser->parse(buf, context);
+				res = hdlcParser->parse(buf, context, frameAssembler.isVerified());
 				if(context.length < 3) doRet = true;
 				break;
 			case DATA_TAG_MBUS:
@@ -449,14 +599,16 @@ if (debugger->isActive(RemoteDebug::VERBOSE))
 debugger->printf_P(PSTR("RES frame:\n"));
                 break;
         }
-        #if defined(AMS_REMOTE_DEBUG)
-if (debugger->isActive(RemoteDebug::VERBOSE))
-#endif
-debugPrint(buf, 0, curLen);
+		// Outer frames are kept as received, for the layers inside them the result is enough
+		trace.record(FrameTraceLayer, tag, res, tag == DATA_TAG_HDLC || tag == DATA_TAG_MBUS ? buf : NULL, curLen);
 		if(res == DATA_PARSE_FINAL_SEGMENT) {
-			if(tag == DATA_TAG_MBUS) {
-				res = mbusParser->write(buf, context);
-			}
+			// The raw frames have been passed on, the payloads can now be gathered into one APDU at
+			// the start of the buffer. This is the only time they are moved.
+			context.length = segments.gather();
+			buf = hanBuffer;
+			end = hanBufferSize;
+			ret = 0;
+			res = 0;
 		}
 
 		if(res < 0) {
@@ -482,22 +634,6 @@ debugger->printf_P(PSTR("Got to end of unwrap method...\n"));
 	return DATA_PARSE_UNKNOWN_DATA;
 }
 
-void PassiveMeterCommunicator::debugPrint(byte *buffer, int start, int length) {
-	for (int i = start; i < start + length; i++) {
-		if (buffer[i] < 0x10)
-			debugger->print(F("0"));
-		debugger->print(buffer[i], HEX);
-		debugger->print(F(" "));
-		if ((i - start + 1) % 16 == 0)
-			debugger->println(F(""));
-		else if ((i - start + 1) % 4 == 0)
-			debugger->print(F(" "));
-
-		yield(); // Let other get some resources too
-	}
-	debugger->println(F(""));
-}
-
 void PassiveMeterCommunicator::printHanReadError(int pos) {
 	#if defined(AMS_REMOTE_DEBUG)
 if (debugger->isActive(RemoteDebug::WARNING))
@@ -586,6 +722,11 @@ if (debugger->isActive(RemoteDebug::INFO))
 #endif
 debugger->printf_P(PSTR("(setupHanPort) Setting up HAN on pin %d/%d with baud %d and parity %d\n"), rxpin, txpin, baud, parityOrdinal);
 
+	// Stop the receiving task from feeding the ring while the port is reconfigured
+	if(rxReceiver != NULL) {
+		rxReceiver->end();
+	}
+
 	if(parityOrdinal == 0) {
 		parityOrdinal = 3; // 8N1
 	}
@@ -603,7 +744,7 @@ debugger->printf_P(PSTR("(setupHanPort) Setting up HAN on pin %d/%d with baud %d
 		hwSerial = &Serial1;
 		uart_num = UART_NUM_1;
 		#if defined(CONFIG_IDF_TARGET_ESP32)
-			if(rxpin == 16) {
+			if(rxpin == 16 || channel > 0) {
 				hwSerial = &Serial2;
 				uart_num = UART_NUM_2;
 			}
@@ -629,7 +770,7 @@ debugger->printf_P(PSTR("Hardware serial\n"));
 		Serial.flush();
 		#if defined(ESP8266)
 			SerialConfig serialConfig;
-		#elif defined(ESP32)
+		#else
 			uint32_t serialConfig;
 		#endif
 		switch(parityOrdinal) {
@@ -651,7 +792,13 @@ debugger->printf_P(PSTR("Hardware serial\n"));
 		}
 		if(meterConfig.bufferSize < 4) meterConfig.bufferSize = 4; // 64 bytes (1) is default for software serial, 256 bytes (4) for hardware
 
-		hwSerial->setRxBufferSize(64 * meterConfig.bufferSize);
+		#if defined(ESP32)
+			// With the ring, the driver is only drained when the line goes idle, so it has to hold a
+			// whole frame. Frames longer than the receive buffer are not read anyway.
+			hwSerial->setRxBufferSize(passive ? max(64 * meterConfig.bufferSize * 2, 512) : 64 * meterConfig.bufferSize);
+		#else
+			hwSerial->setRxBufferSize(64 * meterConfig.bufferSize);
+		#endif
 		#if defined(ESP32)
 			hwSerial->begin(baud, serialConfig, -1, -1, invert);
 			uart_set_pin(uart_num, txpin, rxpin, -1, -1);
@@ -761,6 +908,27 @@ debugger->printf_P(PSTR("Software serial not available\n"));
 	}
 	hanBufferSize = max(64 * meterConfig.bufferSize * 2, 512);
 	hanBuffer = (uint8_t*) malloc(hanBufferSize);
+	segmentOffset = 0;
+	segments.begin();
+
+	#if defined(ESP32)
+		// Let the UART event task move bytes out of the driver whenever the line goes idle, so
+		// a busy loop() does not overrun the driver buffer. loop() then reads from the ring.
+		if(rxReceiver != NULL) {
+			delete rxReceiver;
+			rxReceiver = NULL;
+		}
+		if(passive && hwSerial != NULL) {
+			rxReceiver = new UartFrameReceiver(hwSerial, hanBufferSize * 2, PASSIVE_RX_IDLE_SYMBOLS);
+			rxRingOverflows = 0;
+			rxReceiver->begin();
+			hanSerial = rxReceiver->getStream();
+			#if defined(AMS_REMOTE_DEBUG)
+if (debugger->isActive(RemoteDebug::DEBUG))
+#endif
+debugger->printf_P(PSTR("Using %d byte RX ring buffer with idle line frame boundaries\n"), hanBufferSize * 2);
+		}
+	#endif
 
 	// The library automatically sets the pullup in Serial.begin()
 	if(!meterConfig.rxPinPullup) {
@@ -880,6 +1048,9 @@ void PassiveMeterCommunicator::handleAutodetect(unsigned long now) {
     if(!autodetect) return;
 
 	if(!validDataReceived) {
+		if(!autodetectCaptureDone && (meterConfig.baud == 0 || meterConfig.parity == 0)) {
+			if(handleAutodetectCapture(now)) return;
+		}
 		if(now - meterAutodetectLastChange > 20000 && (meterConfig.baud == 0 || meterConfig.parity == 0)) {
 			autodetect = true;
 			if(autodetectCount == 2)  {
@@ -908,3 +1079,69 @@ debugger->printf_P(PSTR("Meter serial autodetected, saving: %d, %d, %s\n"), auto
 		setupHanPort(meterConfig.baud, meterConfig.parity, meterConfig.invert);
 	}
 }
+
+// Records the RX line once and scores every baud rate, parity and inversion against it, so the
+// right setup can be used straight away instead of trying them one by one. Returns true while
+// the capture is still running.
+bool PassiveMeterCommunicator::handleAutodetectCapture(unsigned long now) {
+	int8_t pin = meterConfig.rxPin == 113 ? 13 : meterConfig.rxPin;
+	AutodetectCapture& capture = autodetectCapture;
+	if(capture.runs == NULL) {
+		if(hanBuffer == NULL || pin <= 0) {
+			autodetectCaptureDone = true;
+			return false;
+		}
+		capture.runs = (uint16_t*) malloc(AUTODETECT_CAPTURE_RUNS * sizeof(uint16_t));
+		if(capture.runs == NULL) {
+			autodetectCaptureDone = true;
+			return false;
+		}
+		capture.pin = pin;
+		capture.count = 0;
+		capture.lastEdge = micros();
+		autodetectCaptureStart = now;
+		// The first run recorded is the level the line has now
+		capture.startLevel = digitalRead(pin);
+		attachInterruptArg(digitalPinToInterrupt(pin), onAutodetectEdge, &capture, CHANGE);
+		return true;
+	}
+	if(capture.count < AUTODETECT_CAPTURE_RUNS && now - autodetectCaptureStart < AUTODETECT_CAPTURE_MS) {
+		return true;
+	}
+	detachInterrupt(digitalPinToInterrupt(capture.pin));
+	autodetectCaptureDone = true;
+
+	uint16_t count = capture.count;
+	if(count < AUTODETECT_CAPTURE_RUNS) {
+		uint32_t run = micros() - capture.lastEdge;
+		capture.runs[count++] = run > 0xFFFF ? 0xFFFF : run;
+	}
+	SerialLineCapture line = { capture.runs, count, capture.startLevel == HIGH };
+	SerialAutodetectScore best;
+	bool found = serialAutodetectBest(line, AUTO_BAUD_RATES, sizeof(AUTO_BAUD_RATES) / sizeof(AUTO_BAUD_RATES[0]), best, hanBuffer, hanBufferSize);
+	free(capture.runs);
+	capture.runs = NULL;
+	len = 0;
+
+	if(found) {
+		#if defined(AMS_REMOTE_DEBUG)
+if (debugger->isActive(RemoteDebug::INFO))
+#endif
+debugger->printf_P(PSTR("Meter serial autodetect, captured %d levels, best match %d, %d, %s (score %ld, %d bytes, %d errors, %d tags, %d checksums)\n"), count, best.baud, best.parity, best.invert ? "true" : "false", best.score, best.bytes, best.framingErrors + best.parityErrors, best.tagHits, best.checksumPasses);
+		autodetectBaud = best.baud;
+		autodetectParity = best.parity;
+		autodetectInvert = best.invert;
+		meterConfig.bufferSize = max((uint32_t) 1, autodetectBaud / 14400);
+		setupHanPort(autodetectBaud, autodetectParity, autodetectInvert);
+		meterAutodetectLastChange = now;
+	} else {
+		#if defined(AMS_REMOTE_DEBUG)
+if (debugger->isActive(RemoteDebug::INFO))
+#endif
+debugger->printf_P(PSTR("Meter serial autodetect, captured %d levels without a match, trying one setup at a time\n"), count);
+		// Capturing took over the pin interrupt, so set the port up again before rotating
+		setupHanPort(meterConfig.baud, meterConfig.parity, meterConfig.invert);
+		meterAutodetectLastChange = 0;
+	}
+	return false;
+}
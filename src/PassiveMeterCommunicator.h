@@ -13,8 +13,12 @@
 #endif
 #include "AmsConfiguration.h"
 #include "DataParsers.h"
+#include "DataSegments.h"
 #include "Timezone.h"
 #include "PassthroughMqttHandler.h"
+#include "FrameReceiver.h"
+#include "SerialAutodetect.h"
+#include "FrameTrace.h"
 
 #if defined(ESP8266)
 #include "SoftwareSerial.h"
@@ -22,6 +26,23 @@
 
 const uint32_t AUTO_BAUD_RATES[] = { 2400, 115200 };
 
+// Character times without data before the RX line is considered idle and a frame complete
+#define PASSIVE_RX_IDLE_SYMBOLS 10
+
+// Line levels recorded from the RX pin before falling back to trying one serial setup at a time
+#define AUTODETECT_CAPTURE_RUNS 1024
+#define AUTODETECT_CAPTURE_MS 12000
+
+// RX line recorded for serial autodetect. Each meter has its own, written from the interrupt
+// of its RX pin while the capture runs.
+struct AutodetectCapture {
+    uint16_t* runs;
+    volatile uint16_t count;
+    volatile uint32_t lastEdge;
+    int8_t pin;
+    bool startLevel;
+};
+
 class PassiveMeterCommunicator : public MeterCommunicator  {
 public:
     #if defined(AMS_REMOTE_DEBUG)
@@ -29,17 +50,28 @@ public:
     #else
     PassiveMeterCommunicator(Stream* debugger);
     #endif
+    ~PassiveMeterCommunicator();
     void configure(MeterConfig&, Timezone*);
     bool loop();
     AmsData* getData(AmsData& meterState);
+    void releaseData(AmsData* data);
     int getLastError();
     bool isConfigChanged();
     void getCurrentConfig(MeterConfig& meterConfig);
     void setPassthroughMqttHandler(PassthroughMqttHandler*);
+    void setChannel(uint8_t channel);
+    static CosemLayoutCache* getLayoutCache();
 
     HardwareSerial* getHwSerial();
     void rxerr(int err);
 
+    uint32_t getDecodedFrames();
+    uint32_t getFrameAllocations();
+    bool isDataUnchanged();
+    uint32_t getDigestHits();
+    uint32_t getDigestMisses();
+    FrameTrace* getTrace();
+
 protected:
     #if defined(AMS_REMOTE_DEBUG)
     RemoteDebug* debugger = NULL;
@@ -47,6 +79,7 @@ protected:
     Stream* debugger = NULL;
     #endif
     MeterConfig meterConfig;
+    uint8_t channel = 0; // 0 is the main meter, anything above is a sub-meter on its own UART
     bool configChanged = false;
     Timezone* tz;
 
@@ -59,6 +92,8 @@ protected:
     SoftwareSerial *swSerial = NULL;
     #endif
     HardwareSerial *hwSerial = NULL;
+    FrameReceiver *rxReceiver = NULL;
+    uint32_t rxRingOverflows = 0;
     uint8_t rxBufferErrors = 0;
 
     bool autodetect = false, validDataReceived = false;
@@ -68,15 +103,22 @@ protected:
     uint8_t autodetectParity = 11;
     bool autodetectInvert = false;
     uint8_t autodetectCount = 0;
+    bool autodetectCaptureDone = false;
+    unsigned long autodetectCaptureStart = 0;
+    AutodetectCapture autodetectCapture = { NULL, 0, 0, -1, HIGH };
 
     bool dataAvailable = false;
     int len = 0;
     int pos = DATA_PARSE_INCOMPLETE;
+    uint16_t segmentOffset = 0; // Where the next frame is received, after frames holding earlier segments
+    DataSegments segments;
     int lastError = DATA_PARSE_OK;
     bool serialInit = false;
     bool maxDetectPayloadDetectDone = false;
     uint8_t maxDetectedPayloadSize = 64;
-    DataParserContext ctx = {0,0,0,0};
+    DataParserContext ctx = {};
+    FrameAssembler frameAssembler;
+    FrameTrace trace;
 
     HDLCParser *hdlcParser = NULL;
     MBUSParser *mbusParser = NULL;
@@ -85,12 +127,30 @@ protected:
     LLCParser *llcParser = NULL;
     DLMSParser *dlmsParser = NULL;
     DSMRParser *dsmrParser = NULL;
+    static CosemLayoutCache *layoutCache; // Shared by all channels
+    int8_t dlmsFormat = -1; // Index in DLMS_FORMATS of the format last used for this meter
+
+    // Decoded frames are handed out from these two slots in turn, so the previous result
+    // stays intact while the next one is filled and no heap allocation is needed per frame
+    AmsData frameSlots[2];
+    bool frameSlotInUse[2] = { false, false };
+    uint8_t nextFrameSlot = 0;
+    uint32_t decodedFrames = 0;
+    uint32_t frameAllocations = 0;
+
+    // Last decoded frame, reused as is when the next payload is identical
+    FrameDigest frameDigest;
+    AmsData digestFrame;
+    bool digestMerge = false; // Decoded frame is applied on top of the meter state, as for L&G
+    bool dataUnchanged = false;
 
     void setupHanPort(uint32_t baud, uint8_t parityOrdinal, bool invert, bool passive = true);
     int16_t unwrapData(uint8_t *buf, DataParserContext &context);
-    void debugPrint(byte *buffer, int start, int length);
+    bool compactSegments();
     void printHanReadError(int pos);
     void handleAutodetect(unsigned long now);
+    bool handleAutodetectCapture(unsigned long now);
+    AmsData* acquireFrameSlot();
 };
 
 #endif
@@ -7,7 +7,7 @@
 #include "PassthroughMqttHandler.h"
 #include "hexutils.h"
 
-bool PassthroughMqttHandler::publish(AmsData* data, AmsData* previousState, EnergyAccounting* ea, PriceService* ps) {
+bool PassthroughMqttHandler::publish(AmsData* data, AmsData* meterState, EnergyAccounting* ea, PriceService* ps) {
     return false;
 }
 
@@ -23,22 +23,59 @@ bool PassthroughMqttHandler::publishSystem(HwTools* hw, PriceService* ps, Energy
     return false;
 }
 
+// Called while a frame is being decoded, so only queue the data here. It is published by flush().
 bool PassthroughMqttHandler::publishBytes(uint8_t* buf, uint16_t len) {
-    mqtt.publish(topic.c_str(), toHex(buf, len));
-    bool ret = mqtt.loop();
-    delay(10);
-    return ret;
+    return enqueue(buf, len, 0);
 }
 
 bool PassthroughMqttHandler::publishString(char* str) {
-    mqtt.publish(topic.c_str(), str);
-    bool ret = mqtt.loop();
-    delay(10);
-    return ret;
+    return enqueue((uint8_t*) str, strlen(str), PASSTHROUGH_RECORD_TEXT);
+}
+
+// Each record is a two byte big endian header followed by the data, see PASSTHROUGH_RECORD_TEXT
+bool PassthroughMqttHandler::enqueue(const uint8_t* buf, uint16_t len, uint16_t flags) {
+    if(len >= PASSTHROUGH_RECORD_TEXT || queued + len + 2 > PASSTHROUGH_QUEUE_SIZE) {
+        dropped++;
+        return false;
+    }
+    uint16_t header = len | flags;
+    queue[queued++] = header >> 8;
+    queue[queued++] = header & 0xFF;
+    memcpy(queue + queued, buf, len);
+    queued += len;
+    return true;
+}
+
+// Publishes what has been queued since last time. In binary format the whole queue goes out as one
+// message, records and headers as they are. Otherwise each record is sent as before, hex or text.
+bool PassthroughMqttHandler::flush() {
+    if(queued == 0) return false;
+
+    if(binary) {
+        mqtt.publish(topic.c_str(), (char*) queue, queued);
+    } else {
+        for(uint16_t pos = 0; pos < queued; ) {
+            uint16_t header = (queue[pos] << 8) | queue[pos+1];
+            uint16_t len = header & ~PASSTHROUGH_RECORD_TEXT;
+            uint8_t* data = queue + pos + 2;
+            if(header & PASSTHROUGH_RECORD_TEXT) {
+                mqtt.publish(topic.c_str(), (char*) data, len);
+            } else {
+                mqtt.publish(topic.c_str(), toHex(data, len));
+            }
+            pos += len + 2;
+        }
+    }
+    queued = 0;
+    return mqtt.loop();
+}
+
+uint32_t PassthroughMqttHandler::getDropped() {
+    return dropped;
 }
 
 uint8_t PassthroughMqttHandler::getFormat() {
-    return 255;
+    return binary ? PASSTHROUGH_FORMAT_BINARY : PASSTHROUGH_FORMAT_HEX;
 }
 
 void PassthroughMqttHandler::onMessage(String &topic, String &payload) {
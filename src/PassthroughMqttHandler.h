@@ -9,28 +9,52 @@
 
 #include "AmsMqttHandler.h"
 
+#define PASSTHROUGH_FORMAT_HEX 255
+#define PASSTHROUGH_FORMAT_BINARY 7
+
+// Frames are queued while decoding and published together by flush()
+#define PASSTHROUGH_QUEUE_SIZE 1536
+#define PASSTHROUGH_MQTT_BUFFER_SIZE 1024
+
+// In binary format one message holds every record queued since the last flush(). A record is a
+// two byte big endian header followed by the data. The low 15 bits of the header are the length
+// of the data. The top bit is PASSTHROUGH_RECORD_TEXT for a text record, like a DSMR telegram,
+// and clear for raw bytes, like an HDLC frame or the DLMS payload from it.
+#define PASSTHROUGH_RECORD_TEXT 0x8000
+
 class PassthroughMqttHandler : public AmsMqttHandler {
 public:
     #if defined(AMS_REMOTE_DEBUG)
-    PassthroughMqttHandler(MqttConfig& mqttConfig, RemoteDebug* debugger, char* buf) : AmsMqttHandler(mqttConfig, debugger, buf) {
+    PassthroughMqttHandler(MqttConfig& mqttConfig, RemoteDebug* debugger, char* buf) : AmsMqttHandler(mqttConfig, debugger, buf, PASSTHROUGH_MQTT_BUFFER_SIZE) {
         this->topic = String(mqttConfig.publishTopic);
+        this->binary = mqttConfig.payloadFormat == PASSTHROUGH_FORMAT_BINARY;
     };
     #else
-    PassthroughMqttHandler(MqttConfig& mqttConfig, Stream* debugger, char* buf) : AmsMqttHandler(mqttConfig, debugger, buf) {
+    PassthroughMqttHandler(MqttConfig& mqttConfig, Stream* debugger, char* buf) : AmsMqttHandler(mqttConfig, debugger, buf, PASSTHROUGH_MQTT_BUFFER_SIZE) {
         this->topic = String(mqttConfig.publishTopic);
+        this->binary = mqttConfig.payloadFormat == PASSTHROUGH_FORMAT_BINARY;
     };
     #endif
-    bool publish(AmsData* data, AmsData* previousState, EnergyAccounting* ea, PriceService* ps);
+    bool publish(AmsData* data, AmsData* meterState, EnergyAccounting* ea, PriceService* ps);
     bool publishTemperatures(AmsConfiguration*, HwTools*);
     bool publishPrices(PriceService*);
     bool publishSystem(HwTools* hw, PriceService* ps, EnergyAccounting* ea);
+    bool publishChannel(uint8_t channel, AmsData* data) { return false; };
     bool publishBytes(uint8_t* buf, uint16_t len);
     bool publishString(char* str);
+    bool flush();
+    uint32_t getDropped();
+
+    uint8_t getFormat();
 
 private:
     String topic;
-    void onMessage(String &topic, String &payload);
+    bool binary = false;
+    uint8_t queue[PASSTHROUGH_QUEUE_SIZE];
+    uint16_t queued = 0;
+    uint32_t dropped = 0;
 
-    uint8_t getFormat();
+    void onMessage(String &topic, String &payload);
+    bool enqueue(const uint8_t* buf, uint16_t len, uint16_t flags);
 };
 #endif
@@ -0,0 +1,56 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#include "UartFrameReceiver.h"
+
+#if defined(ESP32)
+UartFrameReceiver::UartFrameReceiver(HardwareSerial* port, uint16_t ringSize, uint8_t idleSymbols) : FrameReceiver(ringSize) {
+    this->port = port;
+    this->idleSymbols = idleSymbols;
+    lock = xSemaphoreCreateMutex();
+}
+
+UartFrameReceiver::~UartFrameReceiver() {
+    end();
+    if(lock != NULL) vSemaphoreDelete(lock);
+}
+
+bool UartFrameReceiver::begin() {
+    if(port == NULL || lock == NULL) return false;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    active = true;
+    xSemaphoreGive(lock);
+    port->setRxTimeout(idleSymbols);
+    port->onReceive([this]() { onIdle(); }, true);
+    return true;
+}
+
+void UartFrameReceiver::end() {
+    if(lock == NULL) return;
+    port->onReceive(NULL);
+    // The event task may already be inside onIdle(), taking the lock waits for it to leave.
+    // Anything it calls after this sees the receiver inactive and leaves the ring alone.
+    xSemaphoreTake(lock, portMAX_DELAY);
+    active = false;
+    xSemaphoreGive(lock);
+}
+
+// Runs in the UART event task
+void UartFrameReceiver::onIdle() {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if(active) {
+        uint8_t buf[64];
+        int available;
+        while((available = port->available()) > 0) {
+            size_t read = port->read(buf, min(available, (int) sizeof(buf)));
+            if(read == 0) break;
+            received(buf, read);
+        }
+        idle();
+    }
+    xSemaphoreGive(lock);
+}
+#endif
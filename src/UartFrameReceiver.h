@@ -0,0 +1,36 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ * 
+ */
+
+#ifndef _UARTFRAMERECEIVER_H
+#define _UARTFRAMERECEIVER_H
+
+#include "FrameReceiver.h"
+
+#if defined(ESP32)
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// Drains the UART driver from the UART event task each time the RX line has been idle for
+// idleSymbols. The driver is only drained on idle, so its buffer has to hold a whole frame.
+class UartFrameReceiver : public FrameReceiver {
+public:
+    UartFrameReceiver(HardwareSerial* port, uint16_t ringSize, uint8_t idleSymbols);
+    ~UartFrameReceiver();
+
+    bool begin();
+    void end();
+
+private:
+    HardwareSerial* port;
+    uint8_t idleSymbols;
+    SemaphoreHandle_t lock = NULL;
+    bool active = false;
+
+    void onIdle();
+};
+#endif
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _BENCHUTIL_H
+#define _BENCHUTIL_H
+
+#include <chrono>
+#include <string.h>
+
+// Benchmarks take --quick to only check that they still run, as done from ctest
+inline bool benchQuick(int argc, char** argv) {
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--quick") == 0) return true;
+    }
+    return false;
+}
+
+class BenchTimer {
+public:
+    BenchTimer() : start(std::chrono::steady_clock::now()) {}
+    double seconds() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    double micros() {
+        return seconds() * 1e6;
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Takes the frames decoded from each capture through the two steps that follow on every frame:
+// AmsData::apply() onto the meter state and formatting the JSON MQTT payload. Reports the time
+// per frame of each and the size of the payload.
+
+#include <stdio.h>
+#include "BenchUtil.h"
+#include "CaptureReplay.h"
+#include "FrameCapture.h"
+#include "EnergyAccounting.h"
+#include "HwTools.h"
+#include "JsonMqttHandler.h"
+
+class BenchJson : public JsonMqttHandler {
+public:
+    BenchJson(MqttConfig& config, Stream* debugger, char* buf, HwTools* hw) : JsonMqttHandler(config, debugger, buf, hw) {
+        mqtt.setConnected(true);
+    }
+    std::vector<MQTTMessage>& getPublished() { return mqtt.getPublished(); }
+    // Times the formatting of every document, not the skipping of unchanged ones
+    void markAllChanged() { pendingChanges = AMS_DATA_ALL_FIELDS; }
+};
+
+int main(int argc, char** argv) {
+    uint32_t rounds = benchQuick(argc, argv) ? 5 : 100000;
+
+    HostDebug debug;
+    GpioConfig gpio;
+    memset(&gpio, 0, sizeof(gpio));
+    HwTools hw;
+    hw.setup(&gpio);
+    EnergyAccountingConfig eaConfig;
+    memset(&eaConfig, 0, sizeof(eaConfig));
+    EnergyAccountingRealtimeData rtd;
+    memset(&rtd, 0, sizeof(rtd));
+    EnergyAccounting ea(&debug, &rtd);
+    ea.setup(NULL, &eaConfig);
+
+    MqttConfig mqttConfig;
+    memset(&mqttConfig, 0, sizeof(mqttConfig));
+    strcpy(mqttConfig.publishTopic, "ams");
+    strcpy(mqttConfig.clientId, "bench");
+    static char json[2048];
+    BenchJson handler(mqttConfig, &debug, json, &hw);
+
+    printf("%-24s %6s %10s %10s %10s\n", "capture", "frames", "apply us", "json us", "json bytes");
+    for(const std::string& path : listCaptures(capturesDir())) {
+        CaptureReplay replay;
+        std::vector<AmsData> frames = replay.decodeFrames(splitFrames(loadCapture(path)));
+        if(frames.empty()) continue;
+
+        AmsData state;
+        BenchTimer applyTimer;
+        for(uint32_t i = 0; i < rounds; i++) {
+            for(AmsData& frame : frames) {
+                hostAdvanceMillis(2500);
+                state.apply(frame);
+            }
+        }
+        double applyUs = applyTimer.micros();
+
+        size_t bytes = 0;
+        BenchTimer jsonTimer;
+        for(uint32_t i = 0; i < rounds; i++) {
+            for(AmsData& frame : frames) {
+                handler.markAllChanged();
+                handler.publish(&frame, &state, &ea, NULL);
+                if(i == 0 && !handler.getPublished().empty()) bytes += handler.getPublished().back().payload.size();
+                handler.getPublished().clear();
+            }
+        }
+        double jsonUs = jsonTimer.micros();
+
+        uint64_t total = (uint64_t) rounds * frames.size();
+        printf("%-24s %6zu %10.3f %10.3f %10zu\n",
+            captureName(path).c_str(),
+            frames.size(),
+            applyUs / total,
+            jsonUs / total,
+            bytes / frames.size()
+        );
+    }
+    return 0;
+}
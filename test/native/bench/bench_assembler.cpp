@@ -0,0 +1,100 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Cost of finding the end of a frame. "reparse" runs the whole unwrap chain after every
+// received byte, as loop() did before FrameAssembler. "assembled" feeds the bytes to
+// FrameAssembler and unwraps once, when it reports the outer frame as complete.
+
+#include <stdio.h>
+#include "BenchUtil.h"
+#include "CaptureReplay.h"
+#include "FrameAssembler.h"
+#include "DsmrTelegram.h"
+#include "FrameCapture.h"
+
+static uint32_t parserRuns = 0;
+
+static int16_t reparse(HostMeterCommunicator& mc, const std::vector<uint8_t>& frame) {
+    memcpy(mc.getBuffer(), frame.data(), frame.size());
+    DataParserContext ctx;
+    int16_t pos = DATA_PARSE_INCOMPLETE;
+    for(uint16_t len = 1; len <= frame.size() && pos == DATA_PARSE_INCOMPLETE; len++) {
+        pos = mc.unwrap(len, ctx);
+        parserRuns++;
+    }
+    return pos;
+}
+
+static int16_t assembled(HostMeterCommunicator& mc, FrameAssembler& assembler, const std::vector<uint8_t>& frame) {
+    uint8_t* buf = mc.getBuffer();
+    memcpy(buf, frame.data(), frame.size());
+    DataParserContext ctx;
+    for(uint16_t len = 1; len <= frame.size(); len++) {
+        int8_t res = assembler.append(buf, len);
+        if(res == DATA_PARSE_INCOMPLETE) continue;
+        if(res < 0) return res;
+        parserRuns++;
+        int16_t pos = mc.unwrap(len, ctx);
+        if(pos != DATA_PARSE_INCOMPLETE) return pos;
+    }
+    return DATA_PARSE_INCOMPLETE;
+}
+
+static void run(const char* name, const std::vector<std::vector<uint8_t>>& frames, uint32_t rounds) {
+    size_t bytes = 0;
+    for(const std::vector<uint8_t>& frame : frames) bytes += frame.size();
+
+    CaptureReplay replay;
+    HostMeterCommunicator& mc = replay.getMeter();
+    FrameAssembler assembler;
+
+    uint32_t reparseOk = 0;
+    parserRuns = 0;
+    BenchTimer reparseTimer;
+    for(uint32_t i = 0; i < rounds; i++) {
+        for(const std::vector<uint8_t>& frame : frames) {
+            if(reparse(mc, frame) >= 0) reparseOk++;
+        }
+    }
+    double reparseUs = reparseTimer.micros();
+    double reparseRuns = (double) parserRuns / (rounds * frames.size());
+
+    uint32_t assembledOk = 0;
+    parserRuns = 0;
+    BenchTimer assembledTimer;
+    for(uint32_t i = 0; i < rounds; i++) {
+        for(const std::vector<uint8_t>& frame : frames) {
+            if(assembled(mc, assembler, frame) >= 0) assembledOk++;
+        }
+    }
+    double assembledUs = assembledTimer.micros();
+    double assembledRuns = (double) parserRuns / (rounds * frames.size());
+
+    uint64_t total = (uint64_t) rounds * frames.size();
+    printf("%-24s %6zu %12.2f %12.1f %6u %12.2f %12.1f %6u\n",
+        name,
+        bytes,
+        reparseUs / total,
+        reparseRuns,
+        reparseOk / rounds,
+        assembledUs / total,
+        assembledRuns,
+        assembledOk / rounds
+    );
+}
+
+int main(int argc, char** argv) {
+    uint32_t rounds = benchQuick(argc, argv) ? 2 : 500;
+
+    printf("%-24s %6s %12s %12s %6s %12s %12s %6s\n", "capture", "bytes", "reparse us", "runs/frame", "ok", "assembled us", "runs/frame", "ok");
+    for(const std::string& path : listCaptures(capturesDir())) {
+        std::vector<std::vector<uint8_t>> frames = splitFrames(loadCapture(path));
+        if(frames.empty()) continue;
+        run(captureName(path).c_str(), frames, rounds);
+    }
+    run("DSMR (generated)", { dsmrTelegram() }, rounds);
+    return 0;
+}
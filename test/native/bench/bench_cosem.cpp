@@ -0,0 +1,82 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// OBIS lookups in the captured list payloads. "scan" walks the payload from the start for each
+// code, as IEC6205675::findObis() did before CosemIndex. "index" builds the index and then looks
+// up every code, "cached" is the same with the layout already in CosemLayoutCache.
+
+#include <stdio.h>
+#include "BenchUtil.h"
+#include "CaptureReplay.h"
+#include "CosemIndex.h"
+#include "FrameCapture.h"
+
+// The codes IEC6205675 looks up for a list 3 frame
+static const uint8_t LOOKUPS[][4] = {
+    { 0, 2, 129, 255 }, { 1, 7, 0, 255 }, { 2, 7, 0, 255 }, { 3, 7, 0, 255 }, { 4, 7, 0, 255 },
+    { 31, 7, 0, 255 }, { 51, 7, 0, 255 }, { 71, 7, 0, 255 }, { 32, 7, 0, 255 }, { 52, 7, 0, 255 },
+    { 72, 7, 0, 255 }, { 1, 8, 0, 255 }, { 2, 8, 0, 255 }, { 3, 8, 0, 255 }, { 4, 8, 0, 255 },
+    { 96, 1, 0, 255 }, { 96, 1, 7, 255 }, { 1, 0, 0, 255 }, { 13, 7, 0, 255 }, { 25, 9, 0, 255 },
+};
+static const uint8_t LOOKUP_COUNT = sizeof(LOOKUPS) / sizeof(LOOKUPS[0]);
+
+static volatile uintptr_t sink;
+
+static CosemData* scan(const char* ptr, uint16_t length, const uint8_t* obis) {
+    uint16_t pos = 0;
+    while(pos < length && pos < COSEM_MAX_SCAN) {
+        CosemData* item = (CosemData*) (ptr + pos);
+        uint16_t size = CosemIndex::itemSize(item);
+        if(item->base.type == CosemTypeOctetString && item->base.length == 6 && memcmp(item->oct.data + 2, obis, 4) == 0) {
+            return (CosemData*) (ptr + pos + size);
+        }
+        pos += size;
+    }
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    uint32_t rounds = benchQuick(argc, argv) ? 10 : 100000;
+
+    printf("%-24s %6s %6s %10s %10s %10s\n", "capture", "bytes", "items", "scan us", "index us", "cached us");
+    for(const std::string& path : listCaptures(capturesDir())) {
+        CaptureReplay replay;
+        std::vector<std::vector<uint8_t>> payloads = replay.unwrapFrames(splitFrames(loadCapture(path)));
+        if(payloads.empty()) continue;
+        // The largest list from the meter
+        std::vector<uint8_t> payload;
+        for(const std::vector<uint8_t>& p : payloads) if(p.size() > payload.size()) payload = p;
+        const char* ptr = (const char*) payload.data();
+        uint16_t length = payload.size();
+        uintptr_t acc = 0;
+
+        BenchTimer scanTimer;
+        for(uint32_t i = 0; i < rounds; i++) {
+            for(uint8_t l = 0; l < LOOKUP_COUNT; l++) acc += (uintptr_t) scan(ptr, length, LOOKUPS[l]);
+        }
+        double scanUs = scanTimer.micros() / rounds;
+
+        CosemIndex index;
+        BenchTimer indexTimer;
+        for(uint32_t i = 0; i < rounds; i++) {
+            index.build(ptr, length);
+            for(uint8_t l = 0; l < LOOKUP_COUNT; l++) acc += (uintptr_t) index.find(LOOKUPS[l]);
+        }
+        double indexUs = indexTimer.micros() / rounds;
+
+        CosemLayoutCache cache;
+        BenchTimer cachedTimer;
+        for(uint32_t i = 0; i < rounds; i++) {
+            CosemIndex* cached = cache.get(ptr, length);
+            for(uint8_t l = 0; l < LOOKUP_COUNT; l++) acc += (uintptr_t) cached->find(LOOKUPS[l]);
+        }
+        double cachedUs = cachedTimer.micros() / rounds;
+        sink = acc;
+
+        printf("%-24s %6u %6u %10.3f %10.3f %10.3f\n", captureName(path).c_str(), length, index.getCount(), scanUs, indexUs, cachedUs);
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Throughput of the table driven CRCs in crc.cpp against the bit by bit versions they replaced,
+// over the captured frames
+
+#include <stdio.h>
+#include "BenchUtil.h"
+#include "crc.h"
+#include "CrcReference.h"
+#include "FrameCapture.h"
+
+typedef uint16_t (*CrcFunction)(const uint8_t* p, int len);
+
+static volatile uint16_t sink;
+
+static double megabytesPerSecond(CrcFunction fn, const std::vector<std::vector<uint8_t>>& frames, size_t bytes, uint32_t rounds) {
+    BenchTimer timer;
+    uint16_t acc = 0;
+    for(uint32_t i = 0; i < rounds; i++) {
+        for(const std::vector<uint8_t>& frame : frames) acc ^= fn(frame.data(), frame.size());
+    }
+    sink = acc;
+    return (double) bytes * rounds / timer.seconds() / 1e6;
+}
+
+int main(int argc, char** argv) {
+    uint32_t rounds = benchQuick(argc, argv) ? 10 : 20000;
+
+    std::vector<std::vector<uint8_t>> frames;
+    size_t bytes = 0;
+    for(const std::string& path : listCaptures(capturesDir())) {
+        for(const std::vector<uint8_t>& frame : splitFrames(loadCapture(path))) {
+            frames.push_back(frame);
+            bytes += frame.size();
+        }
+    }
+    printf("%zu frames, %zu bytes\n", frames.size(), bytes);
+    printf("%-12s %14s %14s %8s\n", "crc", "bitwise MB/s", "table MB/s", "speedup");
+
+    struct { const char* name; CrcFunction bitwise; CrcFunction table; } crcs[] = {
+        { "x25", crc16_x25_bitwise, crc16_x25 },
+        { "a001", crc16_bitwise, crc16 },
+        { "1021", crc16_1021_bitwise, crc16_1021 },
+    };
+    for(auto& crc : crcs) {
+        double bitwise = megabytesPerSecond(crc.bitwise, frames, bytes, rounds);
+        double table = megabytesPerSecond(crc.table, frames, bytes, rounds);
+        printf("%-12s %14.1f %14.1f %7.1fx\n", crc.name, bitwise, table, table / bitwise);
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Replays every capture in frames/ through PassiveMeterCommunicator and reports decoded
+// frames per second, heap allocations per frame and the peak heap used while decoding.
+
+#include <stdio.h>
+#include "BenchUtil.h"
+#include "CaptureReplay.h"
+#include "FrameCapture.h"
+#include "HostHeap.h"
+
+int main(int argc, char** argv) {
+    uint32_t rounds = benchQuick(argc, argv) ? 5 : 2000;
+
+    printf("%-24s %6s %8s %12s %12s %12s %12s\n", "capture", "frames", "decoded", "frames/s", "setup allocs", "allocs/frame", "peak heap");
+    for(const std::string& path : listCaptures(capturesDir())) {
+        std::vector<std::vector<uint8_t>> frames = splitFrames(loadCapture(path));
+        if(frames.empty()) {
+            printf("%-24s %6s\n", captureName(path).c_str(), "-");
+            continue;
+        }
+
+        hostHeapReset();
+        CaptureReplay replay;
+        // First round allocates the parsers and caches, that is only done once per meter
+        uint32_t decoded = 0;
+        for(const std::vector<uint8_t>& frame : frames) decoded += replay.feed(frame);
+        HostHeapStats setup = hostHeapStats();
+
+        hostHeapReset();
+        BenchTimer timer;
+        for(uint32_t i = 0; i < rounds; i++) {
+            for(const std::vector<uint8_t>& frame : frames) replay.feed(frame);
+        }
+        double elapsed = timer.seconds();
+        HostHeapStats steady = hostHeapStats();
+
+        uint64_t total = (uint64_t) rounds * frames.size();
+        printf("%-24s %6zu %8u %12.0f %12lu %12.2f %12ld\n",
+            captureName(path).c_str(),
+            frames.size(),
+            decoded,
+            total / elapsed,
+            (unsigned long) setup.allocations,
+            (double) steady.allocations / total,
+            (long) (setup.peak + steady.peak)
+        );
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Decodes a DSMR telegram with IEC6205621 and with the String based extraction it used before
+// tokenize(), reporting telegrams per second and heap allocations per telegram for each.
+
+#include <stdio.h>
+#include <string>
+#include "BenchUtil.h"
+#include "DsmrTelegram.h"
+#include "HostHeap.h"
+#include "IEC6205621.h"
+
+// What IEC6205621 did for each value: search the whole telegram for ":<obis>(", copying
+// Strings on the way
+static String legacyExtract(String payload, String obis) {
+    int a = payload.indexOf(String(":" + obis + "("));
+    if(a > 0) {
+        int b = payload.indexOf(F(")"), a);
+        if(b > a) {
+            return payload.substring(a+obis.length()+2, b);
+        }
+    }
+    return "";
+}
+
+static double legacyExtractDouble(String payload, String obis) {
+    String str = legacyExtract(payload, obis);
+    if(str.isEmpty()) {
+        return 0.0;
+    }
+    int a = str.indexOf(F("*"));
+    String val = str.substring(0,a);
+    String unit = str.substring(a+1);
+    return unit.startsWith(F("k")) ? val.toDouble() * 1000 : val.toDouble();
+}
+
+static double legacyCounter(String& payload, const char* total, const char* tariff) {
+    double val = legacyExtractDouble(payload, total);
+    if(val == 0) {
+        for(int i = 1; i < 9; i++) {
+            val += legacyExtractDouble(payload, tariff + String(i,10));
+        }
+    }
+    return val;
+}
+
+static double legacyDecode(const char* p) {
+    String payload(p+1);
+    String listId = payload.substring(payload.startsWith("/") ? 1 : 0, payload.indexOf("\n"));
+    listId = listId.substring(0,4);
+    String meterId = legacyExtract(payload, F("96.1.0"));
+    if(meterId.isEmpty()) meterId = legacyExtract(payload, F("0.0.5"));
+    String meterModel = legacyExtract(payload, F("96.1.1"));
+    String timestamp = legacyExtract(payload, F("1.0.0"));
+    double sum = 0;
+    const char* codes[] = { "1.7.0", "2.7.0", "3.7.0", "4.7.0", "32.7.0", "52.7.0", "72.7.0", "31.7.0", "51.7.0",
+        "71.7.0", "21.7.0", "41.7.0", "61.7.0", "22.7.0", "42.7.0", "62.7.0" };
+    for(const char* code : codes) sum += legacyExtractDouble(payload, code);
+    sum += legacyCounter(payload, "1.8.0", "1.8.");
+    sum += legacyCounter(payload, "2.8.0", "2.8.");
+    sum += legacyCounter(payload, "3.8.0", "3.8.");
+    sum += legacyCounter(payload, "4.8.0", "4.8.");
+    return sum + meterId.length() + meterModel.length() + timestamp.length();
+}
+
+static volatile double sink;
+
+int main(int argc, char** argv) {
+    uint32_t rounds = benchQuick(argc, argv) ? 10 : 20000;
+    MeterConfig config;
+    memset(&config, 0, sizeof(config));
+
+    printf("%-10s %6s %14s %14s %14s %14s\n", "lines", "bytes", "legacy tg/s", "allocs/tg", "tokenized tg/s", "allocs/tg");
+    uint16_t extras[] = { 0, 15 };
+    for(uint16_t extra : extras) {
+        std::vector<uint8_t> telegram = dsmrTelegram(extra);
+        std::string text(telegram.begin(), telegram.end());
+
+        hostHeapReset();
+        BenchTimer legacyTimer;
+        double acc = 0;
+        for(uint32_t i = 0; i < rounds; i++) acc += legacyDecode(text.c_str());
+        double legacySeconds = legacyTimer.seconds();
+        HostHeapStats legacyHeap = hostHeapStats();
+
+        hostHeapReset();
+        BenchTimer tokenizedTimer;
+        for(uint32_t i = 0; i < rounds; i++) {
+            IEC6205621 decoded(text.c_str(), NULL, &config);
+            acc += decoded.getActiveImportPower();
+        }
+        double tokenizedSeconds = tokenizedTimer.seconds();
+        HostHeapStats tokenizedHeap = hostHeapStats();
+        sink = acc;
+
+        printf("%-10u %6zu %14.0f %14.1f %14.0f %14.1f\n",
+            19 + extra,
+            telegram.size(),
+            rounds / legacySeconds,
+            (double) legacyHeap.allocations / rounds,
+            rounds / tokenizedSeconds,
+            (double) tokenizedHeap.allocations / rounds
+        );
+    }
+    printf("DsmrValues on the stack: %zu bytes\n", sizeof(DsmrValues));
+    return 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Decrypt time of frames/Kamstup-Encrypted.raw, encrypted under test keys, with the key
+// schedule kept between frames against expanding it for every frame as before. The second
+// case alternates between two key pairs, so every parse() has to set the key up again.
+
+#include <stdio.h>
+#include "BenchUtil.h"
+#include "FrameCapture.h"
+#include "GcmFrames.h"
+#include "GcmParser.h"
+#include "HostHeap.h"
+
+static uint8_t keys[2][2][16] = {
+    { { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F },
+      { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F } },
+    { { 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xAB, 0xAC, 0xAD, 0xAE, 0xAF },
+      { 0xB0, 0xB1, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xBB, 0xBC, 0xBD, 0xBE, 0xBF } },
+};
+
+struct Result {
+    double us;
+    double allocations;
+    uint32_t failed;
+};
+
+static Result run(const std::vector<uint8_t> frames[2], size_t apdu, uint32_t rounds, bool rekey) {
+    GCMParser parser(keys[0][0], keys[0][1]);
+    std::vector<uint8_t> buf(frames[0].size());
+    Result ret = { 0, 0, 0 };
+    hostHeapReset();
+    BenchTimer timer;
+    for(uint32_t i = 0; i < rounds; i++) {
+        uint8_t k = rekey ? i % 2 : 0;
+        parser.setKeys(keys[k][0], keys[k][1]);
+        memcpy(buf.data(), frames[k].data(), buf.size());
+        DataParserContext ctx = {};
+        ctx.length = buf.size() - apdu - 3;
+        if(parser.parse(buf.data() + apdu, ctx) <= 0) ret.failed++;
+    }
+    ret.us = timer.micros() / rounds;
+    ret.allocations = (double) hostHeapStats().allocations / rounds;
+    return ret;
+}
+
+int main(int argc, char** argv) {
+    if(!gcmAvailable()) {
+        printf("Built without mbedtls, nothing to measure\n");
+        return 0;
+    }
+    uint32_t rounds = benchQuick(argc, argv) ? 10 : 200000;
+
+    std::vector<uint8_t> plain = loadCapture(std::string(capturesDir()) + "/Kamstup-Encrypted.raw");
+    std::vector<uint8_t> frames[2] = {
+        gcmEncryptFrame(plain, keys[0][0], keys[0][1]),
+        gcmEncryptFrame(plain, keys[1][0], keys[1][1]),
+    };
+    size_t apdu = gcmApduOffset(frames[0]);
+    if(frames[0].empty() || frames[1].empty() || apdu == 0) {
+        printf("Could not encrypt the capture\n");
+        return 1;
+    }
+
+    printf("%zu byte frame, %u rounds\n", frames[0].size(), rounds);
+    printf("%-14s %12s %12s %14s %8s\n", "key schedule", "us/frame", "MB/s", "allocs/frame", "failed");
+    struct { const char* name; bool rekey; } cases[] = {
+        { "kept", false },
+        { "every frame", true },
+    };
+    for(auto& c : cases) {
+        Result r = run(frames, apdu, rounds, c.rekey);
+        printf("%-14s %12.3f %12.1f %14.2f %8u\n", c.name, r.us, frames[0].size() / r.us, r.allocations, r.failed);
+        if(r.failed > 0) return 1;
+    }
+    return 0;
+}
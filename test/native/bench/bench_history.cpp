@@ -0,0 +1,138 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Appends a year of synthetic hourly import and export to the compressed history for a few
+// load profiles, as counter positions the way update() does. Reports the bytes per hour on flash against two raw uint32 values, how many
+// hours the ring keeps, the append time and how fast the cursor streams it back. Every
+// decoded hour is checked against what was appended.
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include "BenchUtil.h"
+#include "AmsHistory.h"
+#include "HostDebug.h"
+#include "LittleFS.h"
+
+struct Profile {
+    const char* name;
+    uint32_t (*importWh)(uint32_t hour, uint32_t noise);
+    uint32_t (*exportWh)(uint32_t hour, uint32_t noise);
+};
+
+// Evening and morning peaks on a base load
+static uint32_t householdImport(uint32_t hour, uint32_t noise) {
+    uint8_t h = hour % 24;
+    uint32_t base = 350 + (h >= 7 && h <= 8 ? 900 : 0) + (h >= 17 && h <= 21 ? 1500 : 0);
+    return base + noise % 400;
+}
+
+static uint32_t none(uint32_t hour, uint32_t noise) {
+    return 0;
+}
+
+// Imports at night and exports around noon
+static uint32_t solarImport(uint32_t hour, uint32_t noise) {
+    uint8_t h = hour % 24;
+    return h >= 9 && h <= 16 ? 0 : 300 + noise % 500;
+}
+
+static uint32_t solarExport(uint32_t hour, uint32_t noise) {
+    uint8_t h = hour % 24;
+    if(h < 9 || h > 16) return 0;
+    return (uint32_t) (4000 * sin((h - 8) * M_PI / 9)) + noise % 1500;
+}
+
+// Heat pump and car charging, large swings from hour to hour
+static uint32_t heatingImport(uint32_t hour, uint32_t noise) {
+    return 1500 + noise % 9000;
+}
+
+static const Profile profiles[] = {
+    { "household", householdImport, none },
+    { "solar", solarImport, solarExport },
+    { "heating", heatingImport, none },
+};
+
+int main(int argc, char** argv) {
+    bool quick = benchQuick(argc, argv);
+    uint32_t hours = quick ? 24 * 30 : 24 * 365;
+    uint32_t passes = quick ? 1 : 100;
+    const time_t start = 1700006400;
+
+    HostDebug debug;
+    printf("%-10s %10s %10s %12s %10s %12s %14s %10s\n", "profile", "appended", "kept", "bytes/hour", "ratio", "us/append", "points/s", "errors");
+    for(const Profile& profile : profiles) {
+        LittleFS.format();
+        AmsHistory history(&debug);
+        history.load();
+
+        // Some hours are left out, as when the device was off
+        std::vector<HistoryPoint> appended;
+        uint32_t seed = 12345;
+        uint32_t importPosition = 12345678;
+        uint32_t exportPosition = 2345678;
+        BenchTimer appendTimer;
+        for(uint32_t i = 0; i < hours; i++) {
+            seed = seed * 1103515245 + 12345;
+            uint32_t noise = (seed >> 8) & 0xFFFF;
+            importPosition += profile.importWh(i, noise);
+            exportPosition += profile.exportWh(i, noise);
+            if(noise % 500 == 0) {
+                i += 1 + noise % 5;
+                continue;
+            }
+            HistoryPoint point = { (time_t) (start + i * 3600), importPosition, exportPosition };
+            if(history.append(point.timestamp, point.importWh, point.exportWh)) {
+                appended.push_back(point);
+            }
+        }
+        double appendUs = appendTimer.micros();
+
+        // Reloaded as after a reboot, then streamed back from the oldest block
+        AmsHistory reloaded(&debug);
+        reloaded.load();
+        uint32_t kept = 0;
+        uint32_t errors = 0;
+        BenchTimer decodeTimer;
+        for(uint32_t pass = 0; pass < passes; pass++) {
+            AmsHistoryCursor cursor(&reloaded);
+            HistoryPoint point;
+            uint32_t n = 0;
+            size_t idx = 0;
+            if(cursor.seek(0)) {
+                while(cursor.next(point)) {
+                    if(pass == 0) {
+                        while(idx < appended.size() && appended[idx].timestamp < point.timestamp) idx++;
+                        if(idx >= appended.size()
+                            || appended[idx].timestamp != point.timestamp
+                            || appended[idx].importWh != point.importWh
+                            || appended[idx].exportWh != point.exportWh) {
+                            errors++;
+                        }
+                    }
+                    n++;
+                }
+            }
+            kept = n;
+        }
+        double decodeUs = decodeTimer.micros();
+
+        double bytesPerHour = (double) reloaded.getBlockCount() * HISTORY_BLOCK_SIZE / kept;
+        printf("%-10s %10zu %10u %12.2f %9.2fx %12.3f %14.0f %10u\n",
+            profile.name,
+            appended.size(),
+            kept,
+            bytesPerHour,
+            2 * sizeof(uint32_t) / bytesPerHour,
+            appendUs / appended.size(),
+            (double) kept * passes / decodeUs * 1e6,
+            errors
+        );
+        if(errors > 0 || kept == 0) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Decodes the captured OBIS lists with IEC6205675 over and over, once with a layout cache that
+// persists between frames as it does in PassiveMeterCommunicator and once with an empty cache
+// for every frame. Reports the hit rate and the time saved per frame.
+
+#include <stdio.h>
+#include "BenchUtil.h"
+#include "CaptureReplay.h"
+#include "DlmsFormat.h"
+#include "FrameCapture.h"
+#include "IEC6205675.h"
+
+static MeterConfig config;
+static AmsData state;
+
+static void decode(std::vector<uint8_t>& payload, CosemLayoutCache* cache) {
+    DataParserContext ctx = {};
+    ctx.type = DATA_TAG_DLMS;
+    ctx.length = payload.size();
+    IEC6205675 decoded((const char*) payload.data(), AmsTypeAutodetect, &config, ctx, state, cache);
+}
+
+int main(int argc, char** argv) {
+    uint32_t rounds = benchQuick(argc, argv) ? 5 : 20000;
+    memset(&config, 0, sizeof(config));
+
+    printf("%-24s %6s %8s %8s %10s %10s %10s\n", "capture", "frames", "misses", "hit rate", "cold us", "cached us", "saved us");
+    for(const std::string& path : listCaptures(capturesDir())) {
+        CaptureReplay replay;
+        std::vector<std::vector<uint8_t>> payloads;
+        for(const std::vector<uint8_t>& payload : replay.unwrapFrames(splitFrames(loadCapture(path)))) {
+            int8_t format = dlmsFormatProbe((const char*) payload.data(), payload.size());
+            if(format >= 0 && strcmp(DLMS_FORMATS[format].name, "DLMS") == 0) payloads.push_back(payload);
+        }
+        if(payloads.empty()) continue;
+
+        BenchTimer coldTimer;
+        for(uint32_t i = 0; i < rounds; i++) {
+            for(std::vector<uint8_t>& payload : payloads) {
+                CosemLayoutCache cold;
+                decode(payload, &cold);
+            }
+        }
+        double coldUs = coldTimer.micros();
+
+        CosemLayoutCache cache;
+        BenchTimer cachedTimer;
+        for(uint32_t i = 0; i < rounds; i++) {
+            for(std::vector<uint8_t>& payload : payloads) decode(payload, &cache);
+        }
+        double cachedUs = cachedTimer.micros();
+
+        uint64_t total = (uint64_t) rounds * payloads.size();
+        printf("%-24s %6zu %8u %7.2f%% %10.3f %10.3f %10.3f\n",
+            captureName(path).c_str(),
+            payloads.size(),
+            cache.getMisses(),
+            100.0 * cache.getHits() / (cache.getHits() + cache.getMisses()),
+            coldUs / total,
+            cachedUs / total,
+            (coldUs - cachedUs) / total
+        );
+    }
+    return 0;
+}
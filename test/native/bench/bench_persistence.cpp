@@ -0,0 +1,135 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Write amplification of the day, month and quarter plots and the energy accounting file.
+// Each simulated hour has the hourly save and one edit from the UI a second later, saved
+// either directly or through requestSave(). Reports what reached the LittleFS shim against
+// the bytes of the records that actually changed, and the write calls the old byte at a time
+// save would have made for the same saves.
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "BenchUtil.h"
+#include "AmsDataStorage.h"
+#include "EnergyAccounting.h"
+#include "HostDebug.h"
+#include "LittleFS.h"
+
+struct Records {
+    DayDataPoints day;
+    MonthDataPoints month;
+    EnergyAccountingData ea;
+};
+
+class Persistence {
+public:
+    Persistence() : ds(&debug), ea(&debug, &rtd) {
+        memset(&rtd, 0, sizeof(rtd));
+    }
+
+    // Bytes of the records that differ from when they were last written
+    uint32_t changed() {
+        Records now = { ds.getDayData(), ds.getMonthData(), ea.getData() };
+        uint32_t bytes = 0;
+        if(memcmp(&now.day, &last.day, sizeof(now.day)) != 0) bytes += sizeof(now.day);
+        if(memcmp(&now.month, &last.month, sizeof(now.month)) != 0) bytes += sizeof(now.month);
+        if(memcmp(&now.ea, &last.ea, sizeof(now.ea)) != 0) bytes += sizeof(now.ea);
+        last = now;
+        return bytes;
+    }
+
+    HostDebug debug;
+    EnergyAccountingRealtimeData rtd;
+    AmsDataStorage ds;
+    EnergyAccounting ea;
+    Records last;
+};
+
+int main(int argc, char** argv) {
+    uint32_t days = benchQuick(argc, argv) ? 1 : 30;
+
+    printf("%-10s %8s %8s %8s %8s %10s %12s %10s %10s %10s\n", "mode", "requests", "files", "writes", "renames", "bytes", "changed", "amplif.", "old calls", "us/save");
+    for(int coalesce = 0; coalesce < 2; coalesce++) {
+        LittleFS.format();
+        hostSetMicros(0);
+        Persistence p;
+        p.ds.save();
+        p.ea.save();
+        p.changed();
+        LittleFS.resetStats();
+
+        uint32_t requests = 0;
+        uint32_t changed = 0;
+        uint32_t flushes = 0;
+        BenchTimer timer;
+        for(uint32_t hour = 0; hour < days * 24; hour++) {
+            uint8_t h = hour % 24;
+
+            // The hourly save, with the hour stored and the accounting updated
+            p.ds.setHourImport(h, 1000 + hour % 700);
+            p.ds.setHourExport(h, hour % 300);
+            if(h == 0) p.ds.setDayImport(1 + (hour / 24) % 28, 24000 + hour);
+            EnergyAccountingData data = p.ea.getData();
+            data.costThisMonth += 150;
+            p.ea.setData(data);
+            if(coalesce) {
+                p.ds.requestSave();
+                p.ea.requestSave();
+            } else {
+                p.ds.save();
+                p.ea.save();
+                changed += p.changed();
+                flushes++;
+            }
+            requests++;
+
+            // An edit from the UI a second later
+            hostAdvanceMillis(1000);
+            p.ds.setHourImport(h, 1100 + hour % 700);
+            if(coalesce) {
+                p.ds.requestSave();
+            } else {
+                p.ds.save();
+                changed += p.changed();
+                flushes++;
+            }
+            requests++;
+
+            hostAdvanceMillis(AMSFILE_SAVE_DELAY);
+            if(coalesce) {
+                bool saved = p.ds.loop();
+                saved |= p.ea.loop();
+                if(saved) {
+                    changed += p.changed();
+                    flushes++;
+                }
+            }
+            hostAdvanceMillis(3600000 - 1000 - AMSFILE_SAVE_DELAY);
+        }
+        double us = timer.micros();
+        fs::FSStats stats = LittleFS.getStats();
+
+        // The hourly save wrote both plots and the accounting data, the UI edit both plots again,
+        // one byte per call
+        uint32_t byteAtATime = days * 24 * (sizeof(DayDataPoints) + sizeof(MonthDataPoints) + sizeof(EnergyAccountingData))
+            + days * 24 * (sizeof(DayDataPoints) + sizeof(MonthDataPoints));
+
+        printf("%-10s %8u %8u %8u %8u %10" PRIu64 " %12u %9.2fx %10u %10.2f\n",
+            coalesce ? "coalesced" : "direct",
+            requests,
+            stats.opens,
+            stats.writeCalls,
+            stats.renames,
+            stats.bytesWritten,
+            changed,
+            (double) stats.bytesWritten / changed,
+            byteAtATime,
+            us / flushes
+        );
+        if(stats.writeCalls != stats.renames * 2) return 1;
+    }
+    return 0;
+}
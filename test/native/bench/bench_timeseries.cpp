@@ -0,0 +1,66 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Runs days of frames, one every 10 seconds, through the rollup into the time series. Reports
+// the time per frame, what the flushes wrote to the LittleFS shim and the time to query the
+// last day back.
+
+#include <stdio.h>
+#include "BenchUtil.h"
+#include "AmsTimeSeries.h"
+#include "HostDebug.h"
+#include "LittleFS.h"
+
+int main(int argc, char** argv) {
+    uint32_t days = benchQuick(argc, argv) ? 1 : 14;
+    const time_t start = 1700006400;
+
+    HostDebug debug;
+    LittleFS.format();
+    LittleFS.resetStats();
+    AmsTimeSeries ts(&debug);
+    AmsRollup rollup;
+    AmsData data;
+
+    uint32_t frames = 0;
+    uint32_t records = 0;
+    double counter = 1000.0;
+    BenchTimer updateTimer;
+    for(time_t now = start; now < start + days * 86400; now += 10) {
+        uint32_t power = 500 + (now / 60) % 2000;
+        data.apply(OBIS_ACTIVE_IMPORT, power);
+        data.apply(OBIS_ACTIVE_IMPORT_COUNT, counter);
+        data.setLastUpdateMillis((uint64_t) (now - start) * 1000);
+        rollup.update(data, now);
+        if(ts.update(rollup)) records++;
+        frames++;
+        counter += power * 10.0 / 3600 / 1000;
+    }
+    double updateUs = updateTimer.micros();
+    ts.flush();
+    fs::FSStats stats = LittleFS.getStats();
+
+    static TimeSeriesRecord day[1440];
+    uint32_t queries = benchQuick(argc, argv) ? 1 : 100;
+    time_t last = start + (days - 1) * 86400;
+    uint16_t found = 0;
+    BenchTimer queryTimer;
+    for(uint32_t i = 0; i < queries; i++) {
+        found = ts.query(last, last + 86399, day, 1440);
+    }
+    double queryUs = queryTimer.micros();
+
+    printf("%-28s %12u\n", "days", days);
+    printf("%-28s %12u\n", "frames", frames);
+    printf("%-28s %12u\n", "records", records);
+    printf("%-28s %12.3f\n", "us per frame", updateUs / frames);
+    printf("%-28s %12u\n", "file opens", stats.opens);
+    printf("%-28s %12u\n", "write calls", stats.writeCalls);
+    printf("%-28s %12.1f\n", "bytes written per record", (double) stats.bytesWritten / records);
+    printf("%-28s %12u\n", "records in last day", found);
+    printf("%-28s %12.1f\n", "us per day query", queryUs / queries);
+    return 0;
+}
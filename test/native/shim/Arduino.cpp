@@ -0,0 +1,107 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "Arduino.h"
+
+EspClass ESP;
+
+static uint64_t hostClock = 0;
+static int pinLevels[256];
+static void (*pinInterrupts[256])() = { NULL };
+static void (*pinInterruptsArg[256])(void*) = { NULL };
+static void* pinInterruptArgs[256] = { NULL };
+
+unsigned long millis() {
+    return hostClock / 1000;
+}
+
+unsigned long micros() {
+    return hostClock;
+}
+
+uint64_t hostMicros() {
+    return hostClock;
+}
+
+void hostSetMicros(uint64_t us) {
+    hostClock = us;
+}
+
+void hostAdvanceMillis(unsigned long ms) {
+    hostClock += (uint64_t) ms * 1000;
+}
+
+void delay(unsigned long ms) {
+    hostAdvanceMillis(ms);
+}
+
+void delayMicroseconds(unsigned int us) {
+    hostClock += us;
+}
+
+void yield() {
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if(mode == INPUT_PULLUP) pinLevels[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    pinLevels[pin] = val;
+}
+
+int digitalRead(uint8_t pin) {
+    return pinLevels[pin];
+}
+
+int analogRead(uint8_t pin) {
+    return 0;
+}
+
+int digitalPinToInterrupt(uint8_t pin) {
+    return pin;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int mode) {
+    pinInterrupts[interrupt] = isr;
+    pinInterruptsArg[interrupt] = NULL;
+}
+
+void attachInterruptArg(uint8_t interrupt, void (*isr)(void*), void* arg, int mode) {
+    pinInterrupts[interrupt] = NULL;
+    pinInterruptsArg[interrupt] = isr;
+    pinInterruptArgs[interrupt] = arg;
+}
+
+void detachInterrupt(uint8_t interrupt) {
+    pinInterrupts[interrupt] = NULL;
+    pinInterruptsArg[interrupt] = NULL;
+    pinInterruptArgs[interrupt] = NULL;
+}
+
+void hostSetPinLevel(uint8_t pin, int level) {
+    bool changed = pinLevels[pin] != level;
+    pinLevels[pin] = level;
+    if(!changed) return;
+    if(pinInterrupts[pin] != NULL) pinInterrupts[pin]();
+    if(pinInterruptsArg[pin] != NULL) pinInterruptsArg[pin](pinInterruptArgs[pin]);
+}
+
+void (*hostGetInterrupt(uint8_t pin))() {
+    return pinInterrupts[pin];
+}
+
+bool hostHasInterrupt(uint8_t pin) {
+    return pinInterrupts[pin] != NULL || pinInterruptsArg[pin] != NULL;
+}
+
+long random(long max) {
+    return max <= 0 ? 0 : rand() % max;
+}
+
+long random(long min, long max) {
+    return max <= min ? min : min + random(max - min);
+}
@@ -0,0 +1,113 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _ARDUINO_H
+#define _ARDUINO_H
+
+// Minimal Arduino core for building the decoder, data and storage libraries on the host.
+// Only what those libraries use is provided. Time is simulated, it only moves when a test
+// or benchmark moves it, so runs are repeatable.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define F(s) ((const __FlashStringHelper*) (s))
+#define FPSTR(p) ((const __FlashStringHelper*) (p))
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+
+#define pgm_read_byte(addr) (*(const uint8_t*) (addr))
+#define pgm_read_word(addr) (*(const uint16_t*) (addr))
+#define pgm_read_dword(addr) (*(const uint32_t*) (addr))
+#define pgm_read_ptr(addr) (*(void* const*) (addr))
+#define memcpy_P memcpy
+#define memcmp_P memcmp
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strlen_P strlen
+#define strstr_P strstr
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+#define vsnprintf_P vsnprintf
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define OUTPUT_OPEN_DRAIN 0x12
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define HEX 16
+#define DEC 10
+#define OCT 8
+#define BIN 2
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+class __FlashStringHelper;
+
+using std::min;
+using std::max;
+
+template<class T, class L, class H>
+auto constrain(T x, L low, H high) -> decltype(x < low ? low : (x > high ? high : x)) {
+    return x < low ? low : (x > high ? high : x);
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// Simulated clock, see hostSetMicros() and hostAdvanceMillis()
+void hostSetMicros(uint64_t us);
+void hostAdvanceMillis(unsigned long ms);
+uint64_t hostMicros();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int mode);
+void attachInterruptArg(uint8_t interrupt, void (*isr)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t interrupt);
+
+// Pin interrupts attached through attachInterrupt() or attachInterruptArg(), for tests driving a pin by hand
+void hostSetPinLevel(uint8_t pin, int level);
+void (*hostGetInterrupt(uint8_t pin))();
+bool hostHasInterrupt(uint8_t pin);
+
+long random(long max);
+long random(long min, long max);
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#include "Esp.h"
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _DALLASTEMPERATURE_H
+#define _DALLASTEMPERATURE_H
+
+#include "OneWire.h"
+
+#define DEVICE_DISCONNECTED_C -127
+
+typedef uint8_t DeviceAddress[8];
+
+// No sensors on the bus
+class DallasTemperature {
+public:
+    DallasTemperature(OneWire* oneWire) {}
+    void begin() {}
+    void requestTemperatures() {}
+    uint8_t getDeviceCount() { return 0; }
+    bool getAddress(uint8_t* address, uint8_t index) { return false; }
+    float getTempC(const uint8_t* address) { return DEVICE_DISCONNECTED_C; }
+};
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _EEPROM_H
+#define _EEPROM_H
+
+#include "Arduino.h"
+
+class EEPROMClass {
+public:
+    void begin(size_t size) {}
+    uint8_t read(int address) { return address < (int) sizeof(data) ? data[address] : 0xFF; }
+    void write(int address, uint8_t value) { if(address < (int) sizeof(data)) data[address] = value; }
+    bool commit() { return true; }
+    void end() {}
+
+    template<typename T> T& get(int address, T& t) {
+        memcpy(&t, data + address, sizeof(T));
+        return t;
+    }
+    template<typename T> const T& put(int address, const T& t) {
+        memcpy(data + address, &t, sizeof(T));
+        return t;
+    }
+
+private:
+    uint8_t data[4096];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
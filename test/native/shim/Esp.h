@@ -0,0 +1,24 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _ESP_H
+#define _ESP_H
+
+#include <stdint.h>
+
+class EspClass {
+public:
+    uint32_t getFreeHeap() { return 100000; }
+    uint32_t getChipId() { return 0x123456; }
+    void wdtFeed() {}
+    // Counted instead of restarting, for tests checking what happens before a restart
+    void restart() { restarts++; }
+    uint32_t restarts = 0;
+};
+
+extern EspClass ESP;
+
+#endif
@@ -0,0 +1,197 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "FS.h"
+#include "LittleFS.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+fs::FS LittleFS;
+
+namespace fs {
+
+struct FileImpl {
+    FS* fs;
+    FILE* fp;
+    std::string name;
+    ~FileImpl() {
+        if(fp != NULL) fclose(fp);
+    }
+};
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t *buf, size_t size) {
+    if(!impl || impl->fp == NULL) return 0;
+    FS* fs = impl->fs;
+    fs->stats.writeCalls++;
+    size_t allowed = fs->allowWrite(size);
+    size_t written = allowed > 0 ? fwrite(buf, 1, allowed, impl->fp) : 0;
+    fs->stats.bytesWritten += written;
+    return written;
+}
+
+int File::available() {
+    if(!impl || impl->fp == NULL) return 0;
+    return size() - position();
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+    if(!impl || impl->fp == NULL) return -1;
+    int c = fgetc(impl->fp);
+    if(c != EOF) ungetc(c, impl->fp);
+    return c == EOF ? -1 : c;
+}
+
+void File::flush() {
+    if(impl && impl->fp != NULL) fflush(impl->fp);
+}
+
+size_t File::read(uint8_t *buf, size_t size) {
+    if(!impl || impl->fp == NULL) return 0;
+    return fread(buf, 1, size, impl->fp);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if(!impl || impl->fp == NULL) return false;
+    int whence = mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END;
+    return fseek(impl->fp, pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if(!impl || impl->fp == NULL) return 0;
+    return ftell(impl->fp);
+}
+
+size_t File::size() const {
+    if(!impl || impl->fp == NULL) return 0;
+    fflush(impl->fp);
+    struct stat st;
+    if(fstat(fileno(impl->fp), &st) != 0) return 0;
+    return st.st_size;
+}
+
+void File::close() {
+    if(impl && impl->fp != NULL) {
+        fclose(impl->fp);
+        impl->fp = NULL;
+    }
+    impl.reset();
+}
+
+const char* File::name() const {
+    return impl ? impl->name.c_str() : "";
+}
+
+File::operator bool() const {
+    return impl && impl->fp != NULL;
+}
+
+void FS::setRoot(const char* root) {
+    this->root = root;
+}
+
+const char* FS::getRoot() {
+    return root.c_str();
+}
+
+bool FS::begin() {
+    if(root.empty()) {
+        char tmpl[] = "/tmp/amsfsXXXXXX";
+        if(mkdtemp(tmpl) == NULL) return false;
+        root = tmpl;
+    }
+    ::mkdir(root.c_str(), 0755);
+    struct stat st;
+    return stat(root.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+void FS::end() {
+}
+
+bool FS::format() {
+    if(!begin()) return false;
+    DIR* dir = opendir(root.c_str());
+    if(dir == NULL) return false;
+    struct dirent* entry;
+    while((entry = readdir(dir)) != NULL) {
+        if(entry->d_type != DT_REG) continue;
+        ::unlink((root + "/" + entry->d_name).c_str());
+    }
+    closedir(dir);
+    return true;
+}
+
+std::string FS::resolve(const char* path) {
+    begin();
+    std::string ret = root;
+    if(path[0] != '/') ret += "/";
+    return ret + path;
+}
+
+bool FS::exists(const char* path) {
+    struct stat st;
+    return stat(resolve(path).c_str(), &st) == 0;
+}
+
+File FS::open(const char* path, const char* mode) {
+    const char* fmode = "rb";
+    if(strcmp(mode, "w") == 0) fmode = "wb";
+    else if(strcmp(mode, "a") == 0) fmode = "ab";
+    else if(strcmp(mode, "r+") == 0) fmode = "r+b";
+    else if(strcmp(mode, "w+") == 0) fmode = "w+b";
+    else if(strcmp(mode, "a+") == 0) fmode = "a+b";
+    FILE* fp = fopen(resolve(path).c_str(), fmode);
+    if(fp == NULL) return File();
+    stats.opens++;
+    std::shared_ptr<FileImpl> impl(new FileImpl { this, fp, path });
+    return File(impl);
+}
+
+bool FS::remove(const char* path) {
+    stats.removes++;
+    return ::unlink(resolve(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+    stats.renames++;
+    return ::rename(resolve(pathFrom).c_str(), resolve(pathTo).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    return ::mkdir(resolve(path).c_str(), 0755) == 0;
+}
+
+bool FS::rmdir(const char* path) {
+    return ::rmdir(resolve(path).c_str()) == 0;
+}
+
+void FS::resetStats() {
+    stats = {0,0,0,0,0};
+}
+
+void FS::failWritesAfter(int64_t bytes) {
+    writeBudget = bytes;
+}
+
+size_t FS::allowWrite(size_t size) {
+    if(writeBudget < 0) return size;
+    size_t allowed = (int64_t) size < writeBudget ? size : writeBudget;
+    writeBudget -= allowed;
+    return allowed;
+}
+
+}
@@ -0,0 +1,95 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _FS_H
+#define _FS_H
+
+#include <memory>
+#include <string>
+#include <stdio.h>
+#include "Stream.h"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+struct FileImpl;
+
+// Handle to an open file, copies share it like on the device
+class File : public Stream {
+public:
+    File() {}
+    File(std::shared_ptr<FileImpl> impl) : impl(impl) {}
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buf, size_t size);
+    int available();
+    int read();
+    int peek();
+    void flush();
+    size_t read(uint8_t *buf, size_t size);
+    size_t readBytes(char *buffer, size_t length) { return read((uint8_t*) buffer, length); }
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void close();
+    const char* name() const;
+    operator bool() const;
+
+private:
+    std::shared_ptr<FileImpl> impl;
+};
+
+// Counters for everything that reaches the flash, to compare how much a change writes
+struct FSStats {
+    uint32_t opens;
+    uint32_t writeCalls;
+    uint64_t bytesWritten;
+    uint32_t renames;
+    uint32_t removes;
+};
+
+// File system kept in a directory on the host
+class FS {
+public:
+    bool begin();
+    void end();
+    bool format();
+    bool exists(const char* path);
+    File open(const char* path, const char* mode = "r");
+    bool remove(const char* path);
+    bool rename(const char* pathFrom, const char* pathTo);
+    bool mkdir(const char* path);
+    bool rmdir(const char* path);
+
+    // Host only
+    void setRoot(const char* root);
+    const char* getRoot();
+    FSStats getStats() { return stats; }
+    void resetStats();
+    // Lets the next bytes written through, then fails every write like a full or dying flash.
+    // Negative to write normally again.
+    void failWritesAfter(int64_t bytes);
+
+private:
+    friend class File;
+    std::string root;
+    FSStats stats = {0,0,0,0,0};
+    int64_t writeBudget = -1;
+
+    std::string resolve(const char* path);
+    size_t allowWrite(size_t size);
+};
+
+}
+
+using fs::File;
+using fs::FS;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif
@@ -0,0 +1,16 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _HTTPCLIENT_H
+#define _HTTPCLIENT_H
+
+#include "Arduino.h"
+
+// Price fetching is not run on the host, this only lets PriceService.h be included
+class HTTPClient {
+};
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "HardwareSerial.h"
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, SerialMode mode, uint8_t tx_pin, bool invert) {
+    this->baud = baud;
+    this->config = config;
+    this->invert = invert;
+    rx.clear();
+    overrun = false;
+}
+
+void HardwareSerial::end() {
+    baud = 0;
+    rx.clear();
+}
+
+size_t HardwareSerial::setRxBufferSize(size_t size) {
+    rxBufferSize = size;
+    return size;
+}
+
+bool HardwareSerial::hasOverrun() {
+    bool ret = overrun;
+    overrun = false;
+    return ret;
+}
+
+int HardwareSerial::available() {
+    return rx.size();
+}
+
+int HardwareSerial::read() {
+    if(rx.empty()) return -1;
+    uint8_t c = rx.front();
+    rx.pop_front();
+    return c;
+}
+
+int HardwareSerial::peek() {
+    return rx.empty() ? -1 : rx.front();
+}
+
+size_t HardwareSerial::read(uint8_t *buffer, size_t size) {
+    return readBytes(buffer, size);
+}
+
+void HardwareSerial::inject(const uint8_t *buffer, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        if(rx.size() >= rxBufferSize) {
+            overrun = true;
+            return;
+        }
+        rx.push_back(buffer[i]);
+    }
+}
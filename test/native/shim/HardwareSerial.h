@@ -0,0 +1,77 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Like on the device, any core header brings in all of Arduino.h
+#include "Arduino.h"
+
+#ifndef _HARDWARESERIAL_H
+#define _HARDWARESERIAL_H
+
+#include <deque>
+#include "Stream.h"
+
+#define SERIAL_5N1 0x10
+#define SERIAL_6N1 0x14
+#define SERIAL_7N1 0x18
+#define SERIAL_8N1 0x1c
+#define SERIAL_5N2 0x30
+#define SERIAL_6N2 0x34
+#define SERIAL_7N2 0x38
+#define SERIAL_8N2 0x3c
+#define SERIAL_7E1 0x1a
+#define SERIAL_8E1 0x1e
+#define SERIAL_7E2 0x3a
+#define SERIAL_8E2 0x3e
+#define SERIAL_7O1 0x1b
+#define SERIAL_8O1 0x1f
+
+enum SerialMode { SERIAL_FULL = 0, SERIAL_RX_ONLY = 1, SERIAL_TX_ONLY = 2 };
+
+// UART that receives what a test injects and drops everything written to it
+class HardwareSerial : public Stream {
+public:
+    HardwareSerial(int uart_nr) : uart_nr(uart_nr) {}
+
+    void begin(unsigned long baud) { begin(baud, SERIAL_8N1); }
+    void begin(unsigned long baud, uint32_t config, SerialMode mode = SERIAL_FULL, uint8_t tx_pin = 1, bool invert = false);
+    void end();
+    size_t setRxBufferSize(size_t size);
+    void pins(uint8_t tx, uint8_t rx) {}
+    bool hasRxError() { return false; }
+    bool hasOverrun();
+
+    int available();
+    int read();
+    int peek();
+    size_t read(uint8_t *buffer, size_t size);
+    using Stream::readBytes;
+    size_t write(uint8_t c) { return 1; }
+    size_t write(const uint8_t *buffer, size_t size) { return size; }
+    void flush() {}
+    operator bool() const { return true; }
+
+    // Bytes as received on the RX pin. What does not fit in the RX buffer is lost and
+    // reported as an overrun, as on the device.
+    void inject(const uint8_t *buffer, size_t size);
+    unsigned long getBaud() { return baud; }
+    uint32_t getConfig() { return config; }
+    bool isInverted() { return invert; }
+
+private:
+    int uart_nr;
+    unsigned long baud = 0;
+    uint32_t config = 0;
+    bool invert = false;
+    size_t rxBufferSize = 256;
+    bool overrun = false;
+    std::deque<uint8_t> rx;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif
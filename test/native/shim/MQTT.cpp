@@ -0,0 +1,25 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "MQTT.h"
+
+// Like lwmqtt, only the fixed header and topic are encoded in the client buffer, the payload
+// is written to the network directly and can be any size
+bool MQTTClient::publish(const char topic[], const char payload[], int length, bool retained, int qos) {
+    if(!isConnected) return false;
+    if((int) (strlen(topic) + 7) > bufSize) return false;
+    published.push_back({ topic, std::string(payload, length), retained, qos });
+    return true;
+}
+
+// Incoming messages go through the read buffer, with dropOverflow larger ones are skipped
+void MQTTClient::deliver(const char topic[], const char payload[]) {
+    if(callback == NULL) return;
+    if(dropOverflowEnabled && (int) (strlen(topic) + strlen(payload) + 7) > bufSize) return;
+    String t(topic);
+    String p(payload);
+    callback(t, p);
+}
@@ -0,0 +1,79 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _MQTT_H
+#define _MQTT_H
+
+// MQTT client that records what is published instead of sending it, so tests and benchmarks
+// can count messages and bytes on the wire
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "WiFiClient.h"
+
+typedef enum {
+    LWMQTT_SUCCESS = 0,
+    LWMQTT_BUFFER_TOO_SHORT = -1,
+    LWMQTT_MISSING_OR_WRONG_PACKET = -9,
+} lwmqtt_err_t;
+
+struct MQTTMessage {
+    std::string topic;
+    std::string payload;
+    bool retained;
+    int qos;
+};
+
+typedef std::function<void(String &topic, String &payload)> MQTTClientCallbackSimpleFunction;
+
+class MQTTClient {
+public:
+    explicit MQTTClient(int bufSize = 128) : bufSize(bufSize) {}
+
+    void begin(const char hostname[], int port, Client &client) { began = true; }
+    void onMessage(MQTTClientCallbackSimpleFunction cb) { callback = cb; }
+    void setWill(const char topic[], const char payload[], bool retained, int qos) {}
+    void dropOverflow(bool enabled) { dropOverflowEnabled = enabled; }
+
+    bool connect(const char clientId[], bool skip = false) { return isConnected = began; }
+    bool connect(const char clientId[], const char username[], const char password[], bool skip = false) { return isConnected = began; }
+
+    bool publish(const String &topic) { return publish(topic.c_str(), "", 0, false, 0); }
+    bool publish(const char topic[]) { return publish(topic, "", 0, false, 0); }
+    bool publish(const String &topic, const String &payload) { return publish(topic.c_str(), payload.c_str(), payload.length(), false, 0); }
+    bool publish(const String &topic, const String &payload, bool retained, int qos) { return publish(topic.c_str(), payload.c_str(), payload.length(), retained, qos); }
+    bool publish(const char topic[], const String &payload) { return publish(topic, payload.c_str(), payload.length(), false, 0); }
+    bool publish(const char topic[], const String &payload, bool retained, int qos) { return publish(topic, payload.c_str(), payload.length(), retained, qos); }
+    bool publish(const char topic[], const char payload[]) { return publish(topic, payload, strlen(payload), false, 0); }
+    bool publish(const char topic[], const char payload[], bool retained, int qos) { return publish(topic, payload, strlen(payload), retained, qos); }
+    bool publish(const char topic[], const char payload[], int length) { return publish(topic, payload, length, false, 0); }
+    bool publish(const char topic[], const char payload[], int length, bool retained, int qos);
+
+    bool subscribe(const String &topic, int qos = 0) { return isConnected; }
+    bool subscribe(const char topic[], int qos = 0) { return isConnected; }
+    bool loop() { return isConnected; }
+    bool connected() { return isConnected; }
+    bool disconnect() { isConnected = false; return true; }
+    lwmqtt_err_t lastError() { return LWMQTT_SUCCESS; }
+
+    // Host only
+    void setConnected(bool connected) { began = true; isConnected = connected; }
+    std::vector<MQTTMessage>& getPublished() { return published; }
+    void clearPublished() { published.clear(); }
+    void deliver(const char topic[], const char payload[]);
+
+private:
+    int bufSize;
+    bool began = false;
+    bool isConnected = false;
+    bool dropOverflowEnabled = false;
+    MQTTClientCallbackSimpleFunction callback = NULL;
+    std::vector<MQTTMessage> published;
+};
+
+#endif
@@ -0,0 +1,17 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _ONEWIRE_H
+#define _ONEWIRE_H
+
+#include "Arduino.h"
+
+class OneWire {
+public:
+    OneWire(uint8_t pin) {}
+};
+
+#endif
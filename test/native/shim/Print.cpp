@@ -0,0 +1,155 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "Print.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while(size--) {
+        if(write(*buffer++)) n++;
+        else break;
+    }
+    return n;
+}
+
+size_t Print::write(const char *str) {
+    if(str == NULL) return 0;
+    return write((const uint8_t*) str, strlen(str));
+}
+
+static size_t vprint(Print* out, const char *format, va_list args) {
+    char buf[256];
+    va_list copy;
+    va_copy(copy, args);
+    int len = vsnprintf(buf, sizeof(buf), format, copy);
+    va_end(copy);
+    if(len < 0) return 0;
+    if((size_t) len < sizeof(buf)) return out->write((const uint8_t*) buf, len);
+    char* big = new char[len + 1];
+    vsnprintf(big, len + 1, format, args);
+    size_t n = out->write((const uint8_t*) big, len);
+    delete[] big;
+    return n;
+}
+
+size_t Print::printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t n = vprint(this, format, args);
+    va_end(args);
+    return n;
+}
+
+size_t Print::printf_P(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t n = vprint(this, format, args);
+    va_end(args);
+    return n;
+}
+
+size_t Print::print(const __FlashStringHelper *str) {
+    return write((const char*) str);
+}
+
+size_t Print::print(const String &str) {
+    return write((const uint8_t*) str.c_str(), str.length());
+}
+
+size_t Print::print(const char str[]) {
+    return write(str);
+}
+
+size_t Print::print(char c) {
+    return write((uint8_t) c);
+}
+
+size_t Print::print(unsigned char n, int base) {
+    return print(String(n, (unsigned char) base));
+}
+
+size_t Print::print(int n, int base) {
+    return print(String(n, (unsigned char) base));
+}
+
+size_t Print::print(unsigned int n, int base) {
+    return print(String(n, (unsigned char) base));
+}
+
+size_t Print::print(long n, int base) {
+    return print(String(n, (unsigned char) base));
+}
+
+size_t Print::print(unsigned long n, int base) {
+    return print(String(n, (unsigned char) base));
+}
+
+size_t Print::print(long long n, int base) {
+    return print(String(n, (unsigned char) base));
+}
+
+size_t Print::print(unsigned long long n, int base) {
+    return print(String(n, (unsigned char) base));
+}
+
+size_t Print::print(double n, int digits) {
+    return print(String(n, (unsigned char) digits));
+}
+
+size_t Print::println(void) {
+    return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper *str) {
+    return print(str) + println();
+}
+
+size_t Print::println(const String &str) {
+    return print(str) + println();
+}
+
+size_t Print::println(const char str[]) {
+    return print(str) + println();
+}
+
+size_t Print::println(char c) {
+    return print(c) + println();
+}
+
+size_t Print::println(unsigned char n, int base) {
+    return print(n, base) + println();
+}
+
+size_t Print::println(int n, int base) {
+    return print(n, base) + println();
+}
+
+size_t Print::println(unsigned int n, int base) {
+    return print(n, base) + println();
+}
+
+size_t Print::println(long n, int base) {
+    return print(n, base) + println();
+}
+
+size_t Print::println(unsigned long n, int base) {
+    return print(n, base) + println();
+}
+
+size_t Print::println(long long n, int base) {
+    return print(n, base) + println();
+}
+
+size_t Print::println(unsigned long long n, int base) {
+    return print(n, base) + println();
+}
+
+size_t Print::println(double n, int digits) {
+    return print(n, digits) + println();
+}
@@ -0,0 +1,62 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Like on the device, any core header brings in all of Arduino.h
+#include "Arduino.h"
+
+#ifndef _PRINT_H
+#define _PRINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "WString.h"
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str);
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t*) buffer, size); }
+
+    size_t printf(const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+    size_t printf_P(const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+
+    size_t print(const __FlashStringHelper *);
+    size_t print(const String &);
+    size_t print(const char[]);
+    size_t print(char);
+    size_t print(unsigned char, int = DEC_BASE);
+    size_t print(int, int = DEC_BASE);
+    size_t print(unsigned int, int = DEC_BASE);
+    size_t print(long, int = DEC_BASE);
+    size_t print(unsigned long, int = DEC_BASE);
+    size_t print(long long, int = DEC_BASE);
+    size_t print(unsigned long long, int = DEC_BASE);
+    size_t print(double, int = 2);
+
+    size_t println(const __FlashStringHelper *);
+    size_t println(const String &);
+    size_t println(const char[]);
+    size_t println(char);
+    size_t println(unsigned char, int = DEC_BASE);
+    size_t println(int, int = DEC_BASE);
+    size_t println(unsigned int, int = DEC_BASE);
+    size_t println(long, int = DEC_BASE);
+    size_t println(unsigned long, int = DEC_BASE);
+    size_t println(long long, int = DEC_BASE);
+    size_t println(unsigned long long, int = DEC_BASE);
+    size_t println(double, int = 2);
+    size_t println(void);
+
+    virtual void flush() {}
+
+private:
+    static const int DEC_BASE = 10;
+};
+
+#endif
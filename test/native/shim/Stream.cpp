@@ -0,0 +1,27 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "Stream.h"
+
+size_t Stream::readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    while(count < length && available() > 0) {
+        int c = read();
+        if(c < 0) break;
+        *buffer++ = (char) c;
+        count++;
+    }
+    return count;
+}
+
+String Stream::readString() {
+    String ret;
+    int c;
+    while(available() > 0 && (c = read()) >= 0) {
+        ret += (char) c;
+    }
+    return ret;
+}
@@ -0,0 +1,33 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+// Like on the device, any core header brings in all of Arduino.h
+#include "Arduino.h"
+
+#ifndef _STREAM_H
+#define _STREAM_H
+
+#include "Print.h"
+
+// Reads never block, the host has no other task that could deliver more bytes while waiting
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { this->timeout = timeout; }
+    unsigned long getTimeout() { return timeout; }
+
+    virtual size_t readBytes(char *buffer, size_t length);
+    virtual size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char*) buffer, length); }
+    String readString();
+
+protected:
+    unsigned long timeout = 1000;
+};
+
+#endif
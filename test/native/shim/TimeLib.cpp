@@ -0,0 +1,123 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "TimeLib.h"
+#include "Arduino.h"
+
+static const uint8_t monthDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+static time_t sysTime = 0;
+static uint64_t sysTimeSetAt = 0;
+
+#define LEAP_YEAR(Y) (((1970 + (Y)) > 0) && !((1970 + (Y)) % 4) && (((1970 + (Y)) % 100) || !((1970 + (Y)) % 400)))
+
+time_t makeTime(const tmElements_t &tm) {
+    time_t seconds = tm.Year * SECS_PER_DAY * 365;
+    for(int i = 0; i < tm.Year; i++) {
+        if(LEAP_YEAR(i)) seconds += SECS_PER_DAY;
+    }
+    for(int i = 1; i < tm.Month; i++) {
+        if(i == 2 && LEAP_YEAR(tm.Year)) {
+            seconds += SECS_PER_DAY * 29;
+        } else {
+            seconds += SECS_PER_DAY * monthDays[i - 1];
+        }
+    }
+    seconds += (tm.Day - 1) * SECS_PER_DAY;
+    seconds += tm.Hour * SECS_PER_HOUR;
+    seconds += tm.Minute * SECS_PER_MIN;
+    seconds += tm.Second;
+    return seconds;
+}
+
+void breakTime(time_t timeInput, tmElements_t &tm) {
+    uint32_t time = (uint32_t) timeInput;
+    tm.Second = time % 60;
+    time /= 60;
+    tm.Minute = time % 60;
+    time /= 60;
+    tm.Hour = time % 24;
+    time /= 24;
+    tm.Wday = ((time + 4) % 7) + 1;
+
+    uint8_t year = 0;
+    unsigned long days = 0;
+    while((unsigned) (days += (LEAP_YEAR(year) ? 366 : 365)) <= time) {
+        year++;
+    }
+    tm.Year = year;
+    days -= LEAP_YEAR(year) ? 366 : 365;
+    time -= days;
+
+    uint8_t month;
+    for(month = 0; month < 12; month++) {
+        uint8_t monthLength = (month == 1 && LEAP_YEAR(year)) ? 29 : monthDays[month];
+        if(time >= monthLength) {
+            time -= monthLength;
+        } else {
+            break;
+        }
+    }
+    tm.Month = month + 1;
+    tm.Day = time + 1;
+}
+
+time_t now() {
+    return sysTime + (time_t) ((hostMicros() - sysTimeSetAt) / 1000000);
+}
+
+void setTime(time_t t) {
+    sysTime = t;
+    sysTimeSetAt = hostMicros();
+}
+
+// Replaces the libc time() the firmware reads the wall clock with. After setTime() it is the
+// same clock as now(), setTime(0) gives the real clock back.
+time_t time(time_t* t) noexcept {
+    time_t ret;
+    if(sysTime != 0) {
+        ret = now();
+    } else {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ret = ts.tv_sec;
+    }
+    if(t != NULL) *t = ret;
+    return ret;
+}
+
+static tmElements_t broken(time_t t) {
+    tmElements_t tm;
+    breakTime(t, tm);
+    return tm;
+}
+
+int year(time_t t) {
+    return tmYearToCalendar(broken(t).Year);
+}
+
+int month(time_t t) {
+    return broken(t).Month;
+}
+
+int day(time_t t) {
+    return broken(t).Day;
+}
+
+int hour(time_t t) {
+    return broken(t).Hour;
+}
+
+int minute(time_t t) {
+    return broken(t).Minute;
+}
+
+int second(time_t t) {
+    return broken(t).Second;
+}
+
+int weekday(time_t t) {
+    return broken(t).Wday;
+}
@@ -0,0 +1,58 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _TIMELIB_H
+#define _TIMELIB_H
+
+// The parts of the Arduino Time library the firmware uses. now() follows the simulated clock
+// in Arduino.h, starting from whatever setTime() was given. Once set, time() follows it too.
+
+#include <stdint.h>
+#include <time.h>
+
+typedef struct {
+    uint8_t Second;
+    uint8_t Minute;
+    uint8_t Hour;
+    uint8_t Wday; // Day of week, Sunday is day 1
+    uint8_t Day;
+    uint8_t Month;
+    uint8_t Year; // Offset from 1970
+} tmElements_t, TimeElements, *tmElementsPtr_t;
+
+#define tmYearToCalendar(Y) ((Y) + 1970)
+#define CalendarYrToTm(Y) ((Y) - 1970)
+
+#define SECS_PER_MIN ((time_t)(60UL))
+#define SECS_PER_HOUR ((time_t)(3600UL))
+#define SECS_PER_DAY ((time_t)(SECS_PER_HOUR * 24UL))
+#define DAYS_PER_WEEK ((time_t)(7UL))
+#define SECS_PER_WEEK ((time_t)(SECS_PER_DAY * DAYS_PER_WEEK))
+#define SECS_PER_YEAR ((time_t)(SECS_PER_DAY * 365UL))
+
+#define numberOfSeconds(_time_) ((_time_) % SECS_PER_MIN)
+#define numberOfMinutes(_time_) (((_time_) / SECS_PER_MIN) % SECS_PER_MIN)
+#define numberOfHours(_time_) (((_time_) % SECS_PER_DAY) / SECS_PER_HOUR)
+#define dayOfWeek(_time_) ((((_time_) / SECS_PER_DAY + 4) % DAYS_PER_WEEK) + 1)
+#define elapsedDays(_time_) ((_time_) / SECS_PER_DAY)
+#define elapsedSecsToday(_time_) ((_time_) % SECS_PER_DAY)
+#define previousMidnight(_time_) (((_time_) / SECS_PER_DAY) * SECS_PER_DAY)
+#define nextMidnight(_time_) (previousMidnight(_time_) + SECS_PER_DAY)
+
+time_t makeTime(const tmElements_t &tm);
+void breakTime(time_t time, tmElements_t &tm);
+
+time_t now();
+void setTime(time_t t);
+int year(time_t t);
+int month(time_t t);
+int day(time_t t);
+int hour(time_t t);
+int minute(time_t t);
+int second(time_t t);
+int weekday(time_t t);
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "Timezone.h"
+#include <string.h>
+
+Timezone::Timezone(TimeChangeRule dstStart, TimeChangeRule stdStart) : dstRule(dstStart), stdRule(stdStart) {
+}
+
+Timezone::Timezone(TimeChangeRule stdTime) : dstRule(stdTime), stdRule(stdTime) {
+}
+
+// Local time the rule takes effect in the given year
+time_t Timezone::toTime(TimeChangeRule r, int year) {
+    uint8_t m = r.month;
+    uint8_t w = r.week;
+    if(w == 0) {
+        // Last week of the month: go to the first week of the next month and back one week
+        if(++m > 12) {
+            m = 1;
+            year++;
+        }
+        w = 1;
+    }
+    tmElements_t tm;
+    tm.Hour = r.hour;
+    tm.Minute = 0;
+    tm.Second = 0;
+    tm.Day = 1;
+    tm.Month = m;
+    tm.Year = CalendarYrToTm(year);
+    time_t t = makeTime(tm);
+    t += ((r.dow - weekday(t) + 7) % 7 + (w - 1) * 7) * SECS_PER_DAY;
+    if(r.week == 0) t -= 7 * SECS_PER_DAY;
+    return t;
+}
+
+void Timezone::dstBounds(int year, time_t &dstStartUTC, time_t &stdStartUTC) {
+    dstStartUTC = toTime(dstRule, year) - stdRule.offset * SECS_PER_MIN;
+    stdStartUTC = toTime(stdRule, year) - dstRule.offset * SECS_PER_MIN;
+}
+
+bool Timezone::utcIsDST(time_t utc) {
+    if(stdRule.offset == dstRule.offset) return false;
+    time_t dstStartUTC, stdStartUTC;
+    dstBounds(year(utc), dstStartUTC, stdStartUTC);
+    if(stdStartUTC > dstStartUTC) {
+        return utc >= dstStartUTC && utc < stdStartUTC;
+    }
+    // Southern hemisphere
+    return !(utc >= stdStartUTC && utc < dstStartUTC);
+}
+
+bool Timezone::locIsDST(time_t local) {
+    if(stdRule.offset == dstRule.offset) return false;
+    time_t dstStart = toTime(dstRule, year(local));
+    time_t stdStart = toTime(stdRule, year(local));
+    if(stdStart > dstStart) {
+        return local >= dstStart && local < stdStart;
+    }
+    return !(local >= stdStart && local < dstStart);
+}
+
+time_t Timezone::toLocal(time_t utc) {
+    return utc + (utcIsDST(utc) ? dstRule.offset : stdRule.offset) * SECS_PER_MIN;
+}
+
+time_t Timezone::toLocal(time_t utc, TimeChangeRule **tcr) {
+    bool isDst = utcIsDST(utc);
+    *tcr = isDst ? &dstRule : &stdRule;
+    return utc + (isDst ? dstRule.offset : stdRule.offset) * SECS_PER_MIN;
+}
+
+time_t Timezone::toUTC(time_t local) {
+    return local - (locIsDST(local) ? dstRule.offset : stdRule.offset) * SECS_PER_MIN;
+}
@@ -0,0 +1,45 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _TIMEZONE_H
+#define _TIMEZONE_H
+
+#include "TimeLib.h"
+
+enum week_t { Last, First, Second, Third, Fourth };
+enum dow_t { Sun = 1, Mon, Tue, Wed, Thu, Fri, Sat };
+enum month_t { Jan = 1, Feb, Mar, Apr, May, Jun, Jul, Aug, Sep, Oct, Nov, Dec };
+
+struct TimeChangeRule {
+    char abbrev[6];
+    uint8_t week;
+    uint8_t dow;
+    uint8_t month;
+    uint8_t hour;
+    int offset; // Minutes from UTC
+};
+
+// Same interface as the Arduino Timezone library: DST starts and ends at local wall clock time
+class Timezone {
+public:
+    Timezone(TimeChangeRule dstStart, TimeChangeRule stdStart);
+    Timezone(TimeChangeRule stdTime);
+
+    time_t toLocal(time_t utc);
+    time_t toLocal(time_t utc, TimeChangeRule **tcr);
+    time_t toUTC(time_t local);
+    bool utcIsDST(time_t utc);
+    bool locIsDST(time_t local);
+
+private:
+    TimeChangeRule dstRule;
+    TimeChangeRule stdRule;
+
+    time_t toTime(TimeChangeRule r, int year);
+    void dstBounds(int year, time_t &dstStartUTC, time_t &stdStartUTC);
+};
+
+#endif
@@ -0,0 +1,395 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "WString.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <utility>
+#include <algorithm>
+
+static void formatInteger(char* buf, size_t size, unsigned long long value, bool negative, unsigned char base) {
+    char tmp[72];
+    int pos = 0;
+    if(base < 2 || base > 36) base = 10;
+    do {
+        uint8_t digit = value % base;
+        tmp[pos++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while(value > 0);
+    size_t out = 0;
+    if(negative && out + 1 < size) buf[out++] = '-';
+    while(pos > 0 && out + 1 < size) buf[out++] = tmp[--pos];
+    buf[out] = '\0';
+}
+
+String::String(const char* cstr) {
+    if(cstr != NULL) copy(cstr, strlen(cstr));
+}
+
+String::String(const char* cstr, unsigned int length) {
+    if(cstr != NULL) copy(cstr, length);
+}
+
+String::String(const String& str) {
+    copy(str.c_str(), str.len);
+}
+
+String::String(String&& str) : buffer(str.buffer), capacity(str.capacity), len(str.len) {
+    str.buffer = NULL;
+    str.capacity = 0;
+    str.len = 0;
+}
+
+String::String(const __FlashStringHelper* str) : String((const char*) str) {
+}
+
+String::String(char c) {
+    char buf[2] = { c, '\0' };
+    copy(buf, 1);
+}
+
+String::String(unsigned char value, unsigned char base) : String((unsigned long long) value, base) {
+}
+
+String::String(int value, unsigned char base) : String((long long) value, base) {
+}
+
+String::String(unsigned int value, unsigned char base) : String((unsigned long long) value, base) {
+}
+
+String::String(long value, unsigned char base) : String((long long) value, base) {
+}
+
+String::String(unsigned long value, unsigned char base) : String((unsigned long long) value, base) {
+}
+
+String::String(long long value, unsigned char base) {
+    char buf[72];
+    bool negative = value < 0 && base == 10;
+    formatInteger(buf, sizeof(buf), negative ? 0ULL - (unsigned long long) value : (unsigned long long) value, negative, base);
+    copy(buf, strlen(buf));
+}
+
+String::String(unsigned long long value, unsigned char base) {
+    char buf[72];
+    formatInteger(buf, sizeof(buf), value, false, base);
+    copy(buf, strlen(buf));
+}
+
+String::String(float value, unsigned char decimalPlaces) : String((double) value, decimalPlaces) {
+}
+
+String::String(double value, unsigned char decimalPlaces) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+    copy(buf, strlen(buf));
+}
+
+String::~String() {
+    free(buffer);
+}
+
+void String::invalidate() {
+    free(buffer);
+    buffer = NULL;
+    capacity = len = 0;
+}
+
+bool String::grow(unsigned int size) {
+    if(buffer != NULL && capacity >= size) return true;
+    char* grown = (char*) realloc(buffer, size + 1);
+    if(grown == NULL) return false;
+    if(buffer == NULL) grown[0] = '\0';
+    buffer = grown;
+    capacity = size;
+    return true;
+}
+
+bool String::reserve(unsigned int size) {
+    return grow(size);
+}
+
+String& String::copy(const char* cstr, unsigned int length) {
+    // An empty String has no buffer, as on the device
+    if(length == 0 && buffer == NULL) {
+        len = 0;
+        return *this;
+    }
+    if(!grow(length)) {
+        invalidate();
+        return *this;
+    }
+    memmove(buffer, cstr, length);
+    buffer[length] = '\0';
+    len = length;
+    return *this;
+}
+
+String& String::operator=(const String& rhs) {
+    if(this != &rhs) copy(rhs.c_str(), rhs.len);
+    return *this;
+}
+
+String& String::operator=(String&& rhs) {
+    if(this != &rhs) {
+        free(buffer);
+        buffer = rhs.buffer;
+        capacity = rhs.capacity;
+        len = rhs.len;
+        rhs.buffer = NULL;
+        rhs.capacity = rhs.len = 0;
+    }
+    return *this;
+}
+
+String& String::operator=(const char* cstr) {
+    if(cstr == NULL) {
+        invalidate();
+        return *this;
+    }
+    return copy(cstr, strlen(cstr));
+}
+
+String& String::operator=(const __FlashStringHelper* str) {
+    return *this = (const char*) str;
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+    if(cstr == NULL) return false;
+    if(length == 0) return true;
+    if(!grow(len + length)) return false;
+    memmove(buffer + len, cstr, length);
+    len += length;
+    buffer[len] = '\0';
+    return true;
+}
+
+bool String::concat(const String& str) {
+    return concat(str.c_str(), str.len);
+}
+
+bool String::concat(const char* cstr) {
+    return cstr != NULL && concat(cstr, strlen(cstr));
+}
+
+bool String::concat(char c) {
+    return concat(&c, 1);
+}
+
+bool String::concat(int num) {
+    return concat(String(num));
+}
+
+bool String::concat(unsigned int num) {
+    return concat(String(num));
+}
+
+bool String::concat(long num) {
+    return concat(String(num));
+}
+
+bool String::concat(unsigned long num) {
+    return concat(String(num));
+}
+
+bool String::concat(float num) {
+    return concat(String(num));
+}
+
+bool String::concat(double num) {
+    return concat(String(num));
+}
+
+int String::compareTo(const String& s) const {
+    return strcmp(c_str(), s.c_str());
+}
+
+bool String::equals(const String& s) const {
+    return len == s.len && compareTo(s) == 0;
+}
+
+bool String::equals(const char* cstr) const {
+    return strcmp(c_str(), cstr == NULL ? "" : cstr) == 0;
+}
+
+bool String::equalsIgnoreCase(const String& s) const {
+    return len == s.len && strcasecmp(c_str(), s.c_str()) == 0;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String& prefix, unsigned int offset) const {
+    if(offset + prefix.len > len) return false;
+    return strncmp(c_str() + offset, prefix.c_str(), prefix.len) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    if(suffix.len > len) return false;
+    return strcmp(c_str() + len - suffix.len, suffix.c_str()) == 0;
+}
+
+char String::charAt(unsigned int index) const {
+    return operator[](index);
+}
+
+void String::setCharAt(unsigned int index, char c) {
+    if(index < len) buffer[index] = c;
+}
+
+char String::operator[](unsigned int index) const {
+    return index < len ? buffer[index] : 0;
+}
+
+char& String::operator[](unsigned int index) {
+    static char dummy;
+    if(index >= len) {
+        dummy = 0;
+        return dummy;
+    }
+    return buffer[index];
+}
+
+void String::getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index) const {
+    if(bufsize == 0 || buf == NULL) return;
+    if(index >= len) {
+        buf[0] = 0;
+        return;
+    }
+    unsigned int n = std::min(bufsize - 1, len - index);
+    memcpy(buf, buffer + index, n);
+    buf[n] = 0;
+}
+
+void String::toCharArray(char* buf, unsigned int bufsize, unsigned int index) const {
+    getBytes((unsigned char*) buf, bufsize, index);
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+    if(fromIndex >= len) return -1;
+    const char* found = strchr(buffer + fromIndex, ch);
+    return found == NULL ? -1 : found - buffer;
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+    if(fromIndex >= len) return -1;
+    const char* found = strstr(buffer + fromIndex, str.c_str());
+    return found == NULL ? -1 : found - buffer;
+}
+
+int String::lastIndexOf(char ch) const {
+    if(len == 0) return -1;
+    const char* found = strrchr(buffer, ch);
+    return found == NULL ? -1 : found - buffer;
+}
+
+int String::lastIndexOf(const String& str) const {
+    if(str.len == 0 || str.len > len) return -1;
+    for(int i = len - str.len; i >= 0; i--) {
+        if(strncmp(buffer + i, str.c_str(), str.len) == 0) return i;
+    }
+    return -1;
+}
+
+String String::substring(unsigned int beginIndex) const {
+    return substring(beginIndex, len);
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if(beginIndex > endIndex) std::swap(beginIndex, endIndex);
+    if(beginIndex >= len) return String();
+    if(endIndex > len) endIndex = len;
+    return String(buffer + beginIndex, endIndex - beginIndex);
+}
+
+void String::replace(char find, char replace) {
+    for(unsigned int i = 0; i < len; i++) {
+        if(buffer[i] == find) buffer[i] = replace;
+    }
+}
+
+void String::replace(const String& find, const String& replace) {
+    if(len == 0 || find.len == 0) return;
+    String out;
+    unsigned int pos = 0;
+    int idx;
+    while((idx = indexOf(find, pos)) >= 0) {
+        out.concat(buffer + pos, idx - pos);
+        out.concat(replace);
+        pos = idx + find.len;
+    }
+    out.concat(buffer + pos, len - pos);
+    *this = std::move(out);
+}
+
+void String::remove(unsigned int index) {
+    remove(index, (unsigned int) -1);
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if(index >= len) return;
+    if(count > len - index) count = len - index;
+    memmove(buffer + index, buffer + index + count, len - index - count + 1);
+    len -= count;
+}
+
+void String::toLowerCase() {
+    for(unsigned int i = 0; i < len; i++) buffer[i] = tolower((unsigned char) buffer[i]);
+}
+
+void String::toUpperCase() {
+    for(unsigned int i = 0; i < len; i++) buffer[i] = toupper((unsigned char) buffer[i]);
+}
+
+void String::trim() {
+    if(len == 0) return;
+    unsigned int begin = 0;
+    while(begin < len && isspace((unsigned char) buffer[begin])) begin++;
+    unsigned int end = len;
+    while(end > begin && isspace((unsigned char) buffer[end - 1])) end--;
+    len = end - begin;
+    memmove(buffer, buffer + begin, len);
+    buffer[len] = '\0';
+}
+
+long String::toInt() const {
+    return atol(c_str());
+}
+
+float String::toFloat() const {
+    return atof(c_str());
+}
+
+double String::toDouble() const {
+    return atof(c_str());
+}
+
+String operator+(const String& lhs, const String& rhs) {
+    String ret(lhs);
+    ret.concat(rhs);
+    return ret;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+    String ret(lhs);
+    ret.concat(rhs);
+    return ret;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+    String ret(lhs);
+    ret.concat(rhs);
+    return ret;
+}
+
+String operator+(const String& lhs, char rhs) {
+    String ret(lhs);
+    ret.concat(rhs);
+    return ret;
+}
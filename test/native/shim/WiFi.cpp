@@ -0,0 +1,9 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "WiFi.h"
+
+WiFiClass WiFi;
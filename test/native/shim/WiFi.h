@@ -0,0 +1,20 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _WIFI_H
+#define _WIFI_H
+
+#include "WiFiClient.h"
+
+class WiFiClass {
+public:
+    String macAddress() { return String("02:00:00:00:00:01"); }
+    int RSSI() { return -60; }
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,30 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _WIFICLIENT_H
+#define _WIFICLIENT_H
+
+#include "Arduino.h"
+
+class Client : public Stream {
+public:
+    size_t write(uint8_t c) { return 1; }
+    size_t write(const uint8_t *buf, size_t size) { return size; }
+    int available() { return 0; }
+    int read() { return -1; }
+    int peek() { return -1; }
+    void stop() {}
+};
+
+class WiFiClient : public Client {
+};
+
+class WiFiClientSecure : public WiFiClient {
+public:
+    void setInsecure() {}
+};
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _GENERATED_VERSION_H
+#define _GENERATED_VERSION_H
+
+#define VERSION_STRING "native"
+#define BUILD_EPOCH 1700000000
+
+#endif
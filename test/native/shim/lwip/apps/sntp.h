@@ -0,0 +1,10 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _LWIP_APPS_SNTP_H
+#define _LWIP_APPS_SNTP_H
+
+#endif
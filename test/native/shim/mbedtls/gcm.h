@@ -0,0 +1,49 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _MBEDTLS_GCM_H
+#define _MBEDTLS_GCM_H
+
+// The GCM part of the mbedtls 2.x API, as used on ESP32, for linking the system libmbedcrypto
+// on hosts that have the library but not its headers. The context is only handled through
+// pointers by the library, so it is kept opaque here and made larger than the real one.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MBEDTLS_GCM_ENCRYPT 1
+#define MBEDTLS_GCM_DECRYPT 0
+
+#define MBEDTLS_ERR_GCM_AUTH_FAILED -0x0012
+#define MBEDTLS_ERR_GCM_BAD_INPUT -0x0014
+
+typedef enum {
+    MBEDTLS_CIPHER_ID_NONE = 0,
+    MBEDTLS_CIPHER_ID_NULL,
+    MBEDTLS_CIPHER_ID_AES,
+} mbedtls_cipher_id_t;
+
+typedef struct mbedtls_gcm_context {
+    uint64_t opaque[128];
+} mbedtls_gcm_context;
+
+extern "C" {
+void mbedtls_gcm_init(mbedtls_gcm_context *ctx);
+int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx, mbedtls_cipher_id_t cipher, const unsigned char *key, unsigned int keybits);
+int mbedtls_gcm_crypt_and_tag(mbedtls_gcm_context *ctx, int mode, size_t length,
+    const unsigned char *iv, size_t iv_len, const unsigned char *add, size_t add_len,
+    const unsigned char *input, unsigned char *output, size_t tag_len, unsigned char *tag);
+int mbedtls_gcm_auth_decrypt(mbedtls_gcm_context *ctx, size_t length,
+    const unsigned char *iv, size_t iv_len, const unsigned char *add, size_t add_len,
+    const unsigned char *tag, size_t tag_len, const unsigned char *input, unsigned char *output);
+int mbedtls_gcm_starts(mbedtls_gcm_context *ctx, int mode, const unsigned char *iv, size_t iv_len,
+    const unsigned char *add, size_t add_len);
+int mbedtls_gcm_update(mbedtls_gcm_context *ctx, size_t length, const unsigned char *input, unsigned char *output);
+int mbedtls_gcm_finish(mbedtls_gcm_context *ctx, unsigned char *tag, size_t tag_len);
+void mbedtls_gcm_free(mbedtls_gcm_context *ctx);
+}
+
+#endif
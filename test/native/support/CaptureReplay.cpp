@@ -0,0 +1,81 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "CaptureReplay.h"
+
+CaptureReplay::CaptureReplay(uint8_t bufferSize) : port(9) {
+    memset(&config, 0, sizeof(config));
+    config.bufferSize = bufferSize;
+    config.rxPin = 0xFF;
+    config.txPin = 0xFF;
+    TimeChangeRule CEST = {"CEST", Last, Sun, Mar, 2, 120};
+    TimeChangeRule CET = {"CET ", Last, Sun, Oct, 3, 60};
+    tz = new Timezone(CEST, CET);
+    port.setRxBufferSize(65536);
+    port.begin(2400);
+    mc = new HostMeterCommunicator(&debug);
+    mc->attach(&port, config, tz);
+}
+
+CaptureReplay::~CaptureReplay() {
+    delete mc;
+    delete tz;
+}
+
+uint32_t CaptureReplay::feed(const uint8_t* buf, size_t len) {
+    uint32_t decoded = 0;
+    port.inject(buf, len);
+    while(port.available() > 0) {
+        if(!mc->loop()) continue;
+        AmsData* data = mc->getData(state);
+        if(data != NULL) {
+            if(data->getListType() > 0) {
+                state.apply(*data);
+                decoded++;
+            }
+            mc->releaseData(data);
+        }
+    }
+    return decoded;
+}
+
+uint32_t CaptureReplay::feedFrames(const std::vector<std::vector<uint8_t>>& frames) {
+    uint32_t decoded = 0;
+    for(const std::vector<uint8_t>& frame : frames) decoded += feed(frame);
+    return decoded;
+}
+
+std::vector<AmsData> CaptureReplay::decodeFrames(const std::vector<std::vector<uint8_t>>& frames) {
+    std::vector<AmsData> decoded;
+    for(const std::vector<uint8_t>& frame : frames) {
+        port.inject(frame.data(), frame.size());
+        while(port.available() > 0) {
+            if(!mc->loop()) continue;
+            AmsData* data = mc->getData(state);
+            if(data != NULL) {
+                if(data->getListType() > 0) decoded.push_back(*data);
+                mc->releaseData(data);
+            }
+        }
+    }
+    return decoded;
+}
+
+std::vector<std::vector<uint8_t>> CaptureReplay::unwrapFrames(const std::vector<std::vector<uint8_t>>& frames) {
+    std::vector<std::vector<uint8_t>> payloads;
+    for(const std::vector<uint8_t>& frame : frames) {
+        port.inject(frame.data(), frame.size());
+        while(port.available() > 0) {
+            if(!mc->loop()) continue;
+            std::vector<uint8_t> payload = mc->getPayload();
+            if(!payload.empty()) payloads.push_back(payload);
+            // The receive buffer is only handed back once the data has been taken
+            AmsData* data = mc->getData(state);
+            if(data != NULL) mc->releaseData(data);
+        }
+    }
+    return payloads;
+}
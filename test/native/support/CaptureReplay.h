@@ -0,0 +1,45 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _CAPTUREREPLAY_H
+#define _CAPTUREREPLAY_H
+
+#include <vector>
+#include "HostMeterCommunicator.h"
+#include "HostDebug.h"
+
+// One meter fed from a simulated UART, handled the way readHanPort() does it
+class CaptureReplay {
+public:
+    CaptureReplay(uint8_t bufferSize = 8);
+    ~CaptureReplay();
+
+    // Receives the bytes and decodes every frame they complete. Returns how many frames
+    // produced data, which has then been applied to the meter state.
+    uint32_t feed(const uint8_t* buf, size_t len);
+    uint32_t feed(const std::vector<uint8_t>& bytes) { return feed(bytes.data(), bytes.size()); }
+    // Feeds one frame at a time, like they arrive from the meter
+    uint32_t feedFrames(const std::vector<std::vector<uint8_t>>& frames);
+    // Returns the data decoded from each frame, without applying it to the meter state
+    std::vector<AmsData> decodeFrames(const std::vector<std::vector<uint8_t>>& frames);
+    // Returns the payload of each frame completed, as it was before getData() decoded it
+    std::vector<std::vector<uint8_t>> unwrapFrames(const std::vector<std::vector<uint8_t>>& frames);
+
+    HostMeterCommunicator& getMeter() { return *mc; }
+    AmsData& getState() { return state; }
+    MeterConfig& getConfig() { return config; }
+    HardwareSerial& getPort() { return port; }
+
+private:
+    HostDebug debug;
+    HardwareSerial port;
+    MeterConfig config;
+    Timezone* tz;
+    HostMeterCommunicator* mc;
+    AmsData state;
+};
+
+#endif
@@ -0,0 +1,18 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _CRCREFERENCE_H
+#define _CRCREFERENCE_H
+
+#include <stdint.h>
+
+// The bit by bit implementations crc.cpp had before it went table driven, to check the
+// tables against and to benchmark them with
+uint16_t crc16_x25_bitwise(const uint8_t* p, int len);
+uint16_t crc16_bitwise(const uint8_t* p, int len);
+uint16_t crc16_1021_bitwise(const uint8_t* p, int len);
+
+#endif
@@ -0,0 +1,49 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "DsmrTelegram.h"
+#include <stdio.h>
+#include <string>
+#include "crc.h"
+
+static const char* DSMR_LINES[] = {
+    "/ISK5\\2M550T-1012\r\n",
+    "\r\n",
+    "1-3:0.2.8(50)\r\n",
+    "0-0:1.0.0(200909133520S)\r\n",
+    "0-0:96.1.1(4530303434303037313331363530323137)\r\n",
+    "1-0:1.8.1(000123.456*kWh)\r\n",
+    "1-0:1.8.2(000234.567*kWh)\r\n",
+    "1-0:2.8.1(000001.234*kWh)\r\n",
+    "1-0:2.8.2(000002.345*kWh)\r\n",
+    "0-0:96.14.0(0002)\r\n",
+    "1-0:1.7.0(01.193*kW)\r\n",
+    "1-0:2.7.0(00.000*kW)\r\n",
+    "1-0:32.7.0(230.1*V)\r\n",
+    "1-0:52.7.0(231.2*V)\r\n",
+    "1-0:72.7.0(229.8*V)\r\n",
+    "1-0:31.7.0(003*A)\r\n",
+    "1-0:51.7.0(002*A)\r\n",
+    "1-0:71.7.0(001*A)\r\n",
+    "1-0:21.7.0(00.561*kW)\r\n",
+    "1-0:41.7.0(00.422*kW)\r\n",
+    "1-0:61.7.0(00.210*kW)\r\n",
+};
+
+std::vector<uint8_t> dsmrTelegram(uint16_t extraLines) {
+    std::string telegram;
+    for(const char* line : DSMR_LINES) telegram += line;
+    for(uint16_t i = 0; i < extraLines; i++) {
+        char line[40];
+        snprintf(line, sizeof(line), "0-1:96.%u.%u(%05u)\r\n", 100 + i / 10, i % 10, i);
+        telegram += line;
+    }
+    telegram += "!";
+    char crc[8];
+    snprintf(crc, sizeof(crc), "%04X\r\n", crc16((const uint8_t*) telegram.data(), telegram.size()));
+    telegram += crc;
+    return std::vector<uint8_t>(telegram.begin(), telegram.end());
+}
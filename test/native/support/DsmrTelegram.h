@@ -0,0 +1,17 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _DSMRTELEGRAM_H
+#define _DSMRTELEGRAM_H
+
+#include <stdint.h>
+#include <vector>
+
+// There is no DSMR capture in frames/, this builds a DSMR 5 telegram from a three phase meter
+// instead. extraLines adds that many more value lines before the CRC, which is correct.
+std::vector<uint8_t> dsmrTelegram(uint16_t extraLines = 0);
+
+#endif
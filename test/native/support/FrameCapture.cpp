@@ -0,0 +1,110 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "FrameCapture.h"
+#include "FrameAssembler.h"
+#include "DataParser.h"
+#include <algorithm>
+#include <ctype.h>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+
+static bool isHexToken(const std::string& token) {
+    if(token.empty() || token.size() % 2 != 0) return false;
+    for(char c : token) {
+        if(!isxdigit((unsigned char) c)) return false;
+    }
+    return true;
+}
+
+std::vector<uint8_t> loadCapture(const std::string& path) {
+    std::vector<uint8_t> ret;
+    std::ifstream in(path);
+    std::string line;
+    while(std::getline(in, line)) {
+        size_t comment = std::min(line.find("//"), line.find(" - "));
+        if(comment != std::string::npos) line = line.substr(0, comment);
+        if(!line.empty() && line[0] == '#') continue;
+
+        std::istringstream tokens(line);
+        std::vector<uint8_t> bytes;
+        std::string token;
+        bool valid = true;
+        while(tokens >> token) {
+            if(!isHexToken(token)) {
+                valid = false;
+                break;
+            }
+            for(size_t i = 0; i < token.size(); i += 2) {
+                bytes.push_back(strtoul(token.substr(i, 2).c_str(), NULL, 16));
+            }
+        }
+        if(valid) ret.insert(ret.end(), bytes.begin(), bytes.end());
+    }
+    return ret;
+}
+
+std::vector<std::string> listCaptures(const std::string& dir) {
+    std::vector<std::string> ret;
+    DIR* d = opendir(dir.c_str());
+    if(d == NULL) return ret;
+    struct dirent* entry;
+    while((entry = readdir(d)) != NULL) {
+        std::string name = entry->d_name;
+        if(name.size() > 4 && name.compare(name.size() - 4, 4, ".raw") == 0) {
+            ret.push_back(dir + "/" + name);
+        }
+    }
+    closedir(d);
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+std::vector<std::vector<uint8_t>> splitFrames(const std::vector<uint8_t>& stream) {
+    std::vector<std::vector<uint8_t>> ret;
+    FrameAssembler assembler;
+    size_t start = 0;
+    while(start < stream.size()) {
+        uint8_t tag = stream[start];
+        size_t end = start;
+        int8_t res = DATA_PARSE_INCOMPLETE;
+        if(tag == DATA_TAG_HDLC || tag == DATA_TAG_MBUS || tag == DATA_TAG_DSMR) {
+            assembler.reset();
+            while(end < stream.size() && res == DATA_PARSE_INCOMPLETE) {
+                end++;
+                res = assembler.append(stream.data() + start, end - start);
+            }
+        }
+        size_t len = end - start;
+        // The assembler also says OK for frames it cannot measure, only keep ones that are closed
+        bool closed = res == DATA_PARSE_OK && len > 4 && (
+            (tag == DATA_TAG_HDLC && stream[end - 1] == DATA_TAG_HDLC) ||
+            (tag == DATA_TAG_MBUS && stream[end - 1] == 0x16) ||
+            tag == DATA_TAG_DSMR
+        );
+        if(closed) {
+            ret.push_back(std::vector<uint8_t>(stream.begin() + start, stream.begin() + end));
+            start = end;
+        } else {
+            start++;
+        }
+    }
+    return ret;
+}
+
+std::string captureName(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+const char* capturesDir() {
+    return AMS_CAPTURES_DIR;
+}
+
+std::vector<std::vector<uint8_t>> captureFrames(const char* name) {
+    return splitFrames(loadCapture(std::string(capturesDir()) + "/" + name));
+}
@@ -0,0 +1,33 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _FRAMECAPTURE_H
+#define _FRAMECAPTURE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Captures under frames/ are annotated hex dumps. Comments after "//" or " - " are dropped,
+// as are lines with anything but hex bytes in them, like the field legends.
+std::vector<uint8_t> loadCapture(const std::string& path);
+
+// Path of every frames/*.raw, sorted
+std::vector<std::string> listCaptures(const std::string& dir);
+
+// Outer frames found in a capture, split the same way PassiveMeterCommunicator receives them.
+// Bytes that do not start a frame are skipped.
+std::vector<std::vector<uint8_t>> splitFrames(const std::vector<uint8_t>& stream);
+
+std::string captureName(const std::string& path);
+
+// Directory with the captures, given to the binaries at build time
+const char* capturesDir();
+
+// Frames of one capture in capturesDir(), by file name
+std::vector<std::vector<uint8_t>> captureFrames(const char* name);
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "GcmFrames.h"
+#include "GcmParser.h"
+#include "crc.h"
+
+bool gcmAvailable() {
+    #if defined(GCM_MBEDTLS)
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+size_t gcmApduOffset(const std::vector<uint8_t>& frame) {
+    size_t pos = 3; // Flag and frame format
+    while(pos < frame.size() && (frame[pos] & 0x01) == 0) pos++; // Destination address
+    pos++;
+    while(pos < frame.size() && (frame[pos] & 0x01) == 0) pos++; // Source address
+    pos += 1 + 1 + 2; // Last address byte, control and HCS
+    if(pos + 3 < frame.size() && frame[pos] == 0xE6 && frame[pos + 1] == 0xE7) pos += 3;
+    return pos < frame.size() && frame[pos] == GCM_TAG ? pos : 0;
+}
+
+std::vector<uint8_t> gcmEncryptFrame(const std::vector<uint8_t>& frame, const uint8_t* encryptionKey, const uint8_t* authenticationKey) {
+    std::vector<uint8_t> ret(frame);
+    size_t pos = gcmApduOffset(ret);
+    if(pos == 0) return std::vector<uint8_t>();
+    pos++;
+
+    uint8_t titleLength = ret[pos++];
+    uint8_t iv[12];
+    memcpy(iv, &ret[pos], titleLength);
+    pos += titleLength;
+
+    uint32_t len = 0;
+    uint8_t prefix = ret[pos];
+    uint8_t lengthBytes = prefix == 0x81 ? 1 : prefix == 0x82 ? 2 : prefix == 0x84 ? 4 : 0;
+    if(lengthBytes > 0) pos++;
+    for(uint8_t i = 0; i < (lengthBytes == 0 ? 1 : lengthBytes); i++) {
+        len = (len << 8) | ret[pos++];
+    }
+
+    uint8_t aad[17];
+    aad[0] = ret[pos++];
+    memcpy(aad + 1, authenticationKey, 16);
+    memcpy(iv + 8, &ret[pos], 4);
+    pos += 4;
+
+    // Security tag and frame counter are in the length, with the 12 byte tag after the cipher
+    size_t cipherLength = len - 5 - 12;
+    if(pos + cipherLength + 12 + 3 != ret.size()) return std::vector<uint8_t>();
+
+    #if defined(GCM_MBEDTLS)
+    mbedtls_gcm_context ctx;
+    mbedtls_gcm_init(&ctx);
+    mbedtls_gcm_setkey(&ctx, MBEDTLS_CIPHER_ID_AES, encryptionKey, 128);
+    int res = mbedtls_gcm_crypt_and_tag(&ctx, MBEDTLS_GCM_ENCRYPT, cipherLength, iv, sizeof(iv), aad, sizeof(aad),
+        &ret[pos], &ret[pos], 12, &ret[pos + cipherLength]);
+    mbedtls_gcm_free(&ctx);
+    if(res != 0) return std::vector<uint8_t>();
+    #else
+    return std::vector<uint8_t>();
+    #endif
+
+    uint16_t fcs = crc16_x25(&ret[1], ret.size() - 4);
+    ret[ret.size() - 3] = fcs >> 8;
+    ret[ret.size() - 2] = fcs & 0xFF;
+    return ret;
+}
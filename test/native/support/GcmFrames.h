@@ -0,0 +1,28 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _GCMFRAMES_H
+#define _GCMFRAMES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// frames/Kamstup-Encrypted.raw has the header of an encrypted frame followed by the plaintext,
+// as the keys were never recorded. These turn it into a frame a meter with known keys could
+// have sent.
+
+// True when the host build links mbedtls, see test/native/CMakeLists.txt
+bool gcmAvailable();
+
+// Offset of the GCM tag in an HDLC frame, after the header and LLC bytes, 0 if there is none
+size_t gcmApduOffset(const std::vector<uint8_t>& frame);
+
+// Encrypts the plaintext of an HDLC frame in place of it, with the system title and frame
+// counter from its GCM header. Sets the authentication tag and a new FCS.
+std::vector<uint8_t> gcmEncryptFrame(const std::vector<uint8_t>& frame, const uint8_t* encryptionKey, const uint8_t* authenticationKey);
+
+#endif
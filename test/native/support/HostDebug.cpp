@@ -0,0 +1,21 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "HostDebug.h"
+
+HostDebug::HostDebug() {
+    enabled = getenv("AMS_NATIVE_DEBUG") != NULL;
+}
+
+size_t HostDebug::write(uint8_t c) {
+    if(enabled) fputc(c, stderr);
+    return 1;
+}
+
+size_t HostDebug::write(const uint8_t *buffer, size_t size) {
+    if(enabled) fwrite(buffer, 1, size, stderr);
+    return size;
+}
@@ -0,0 +1,27 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _HOSTDEBUG_H
+#define _HOSTDEBUG_H
+
+#include "Arduino.h"
+
+// Debug output for the code under test. Silent unless AMS_NATIVE_DEBUG is set in the
+// environment, then it goes to stderr.
+class HostDebug : public Stream {
+public:
+    HostDebug();
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buffer, size_t size);
+    int available() { return 0; }
+    int read() { return -1; }
+    int peek() { return -1; }
+
+private:
+    bool enabled;
+};
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "HostHeap.h"
+#include <atomic>
+#include <malloc.h>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_calloc(size_t nmemb, size_t size);
+void __libc_free(void* ptr);
+}
+
+static std::atomic<uint64_t> allocations(0);
+static std::atomic<uint64_t> frees(0);
+static std::atomic<int64_t> current(0);
+static std::atomic<int64_t> peak(0);
+
+static void track(int64_t delta) {
+    int64_t now = current.fetch_add(delta) + delta;
+    int64_t seen = peak.load();
+    while(now > seen && !peak.compare_exchange_weak(seen, now)) {}
+}
+
+extern "C" void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    if(ptr != NULL) {
+        allocations++;
+        track(malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+extern "C" void* calloc(size_t nmemb, size_t size) {
+    void* ptr = __libc_calloc(nmemb, size);
+    if(ptr != NULL) {
+        allocations++;
+        track(malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    size_t before = ptr != NULL ? malloc_usable_size(ptr) : 0;
+    void* ret = __libc_realloc(ptr, size);
+    if(ret != NULL || size == 0) {
+        allocations++;
+        track((int64_t) (ret != NULL ? malloc_usable_size(ret) : 0) - (int64_t) before);
+    }
+    return ret;
+}
+
+extern "C" void free(void* ptr) {
+    if(ptr == NULL) return;
+    frees++;
+    track(-(int64_t) malloc_usable_size(ptr));
+    __libc_free(ptr);
+}
+
+void hostHeapReset() {
+    allocations = 0;
+    frees = 0;
+    current = 0;
+    peak = 0;
+}
+
+HostHeapStats hostHeapStats() {
+    return { allocations.load(), frees.load(), current.load(), peak.load() };
+}
@@ -0,0 +1,24 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _HOSTHEAP_H
+#define _HOSTHEAP_H
+
+#include <stdint.h>
+
+// malloc, realloc, calloc and free are replaced in the test and benchmark binaries, so every
+// heap allocation made by the firmware code, including String and new, is counted here
+struct HostHeapStats {
+    uint64_t allocations;
+    uint64_t frees;
+    int64_t current; // Bytes allocated since the last reset and not yet freed
+    int64_t peak;
+};
+
+void hostHeapReset();
+HostHeapStats hostHeapStats();
+
+#endif
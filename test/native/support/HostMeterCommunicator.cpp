@@ -0,0 +1,51 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "HostMeterCommunicator.h"
+
+void HostMeterCommunicator::attach(Stream* input, MeterConfig& meterConfig, Timezone* tz) {
+    this->meterConfig = meterConfig;
+    this->tz = tz;
+    if(this->meterConfig.bufferSize < 1) this->meterConfig.bufferSize = 1;
+    hanSerial = input;
+    if(hanBuffer != NULL) free(hanBuffer);
+    hanBufferSize = max(64 * this->meterConfig.bufferSize * 2, 512);
+    hanBuffer = (uint8_t*) malloc(hanBufferSize);
+    segmentOffset = 0;
+    segments.begin();
+    len = 0;
+    // Nothing to throw away, the input starts at a frame boundary
+    serialInit = true;
+}
+
+void HostMeterCommunicator::attach(FrameReceiver* receiver, MeterConfig& meterConfig, Timezone* tz) {
+    if(rxReceiver != NULL) delete rxReceiver;
+    rxReceiver = receiver;
+    rxRingOverflows = 0;
+    attach(receiver->getStream(), meterConfig, tz);
+    receiver->begin();
+}
+
+void HostMeterCommunicator::setKeys(const uint8_t* encryptionKey, const uint8_t* authenticationKey) {
+    memcpy(meterConfig.encryptionKey, encryptionKey, 16);
+    memcpy(meterConfig.authenticationKey, authenticationKey, 16);
+    if(gcmParser != NULL) {
+        gcmParser->setKeys(meterConfig.encryptionKey, meterConfig.authenticationKey);
+    }
+    frameDigest.invalidate();
+}
+
+int16_t HostMeterCommunicator::unwrap(uint16_t length, DataParserContext& context) {
+    context = {};
+    memset(context.system_title, 0, 8);
+    context.length = length;
+    return unwrapData(hanBuffer, context);
+}
+
+std::vector<uint8_t> HostMeterCommunicator::getPayload() {
+    if(!dataAvailable || pos < 0) return std::vector<uint8_t>();
+    return std::vector<uint8_t>(hanBuffer + pos, hanBuffer + pos + ctx.length);
+}
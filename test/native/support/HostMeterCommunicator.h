@@ -0,0 +1,42 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _HOSTMETERCOMMUNICATOR_H
+#define _HOSTMETERCOMMUNICATOR_H
+
+#include <vector>
+#include "PassiveMeterCommunicator.h"
+
+// PassiveMeterCommunicator reading from any Stream instead of a UART set up by configure()
+class HostMeterCommunicator : public PassiveMeterCommunicator {
+public:
+    HostMeterCommunicator(Stream* debugger) : PassiveMeterCommunicator(debugger) {}
+
+    void attach(Stream* input, MeterConfig& meterConfig, Timezone* tz);
+    // Reads complete frames from the receiver, which is started here and owned from then on
+    void attach(FrameReceiver* receiver, MeterConfig& meterConfig, Timezone* tz);
+
+    // Changes the keys the way configure() does, without setting up a port
+    void setKeys(const uint8_t* encryptionKey, const uint8_t* authenticationKey);
+
+    // Receive buffer, for benchmarks placing a frame there themselves
+    uint8_t* getBuffer() { return hanBuffer; }
+    uint16_t getBufferSize() { return hanBufferSize; }
+    // Payload of the frame loop() last completed, before getData() decodes it
+    std::vector<uint8_t> getPayload();
+    // Runs the layer parsers over the first length bytes of the receive buffer
+    int16_t unwrap(uint16_t length, DataParserContext& context);
+
+    // Serial autodetect, starting with a capture of the RX pin on the next loop()
+    void startAutodetect() { autodetect = true; meterConfig.baud = 0; meterConfig.parity = 0; }
+    bool isCapturing() { return autodetectCapture.runs != NULL; }
+    uint16_t getCapturedRuns() { return autodetectCapture.count; }
+    uint32_t getAutodetectBaud() { return autodetectBaud; }
+    uint8_t getAutodetectParity() { return autodetectParity; }
+    bool getAutodetectInvert() { return autodetectInvert; }
+};
+
+#endif
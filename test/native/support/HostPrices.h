@@ -0,0 +1,26 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _HOSTPRICES_H
+#define _HOSTPRICES_H
+
+#include <vector>
+#include "PriceService.h"
+
+// The host build links PriceService from PriceServiceDouble.cpp. Nothing is fetched, prices
+// are served from the points set here, each covering resolution minutes from its start.
+struct HostPricePoint {
+    time_t start;
+    uint16_t minutes;
+    float value;
+};
+
+void hostSetPrices(uint8_t direction, const std::vector<HostPricePoint>& points);
+// Consecutive points of resolution minutes from start, one for each value
+void hostSetPrices(uint8_t direction, time_t start, uint16_t resolution, const std::vector<float>& values);
+void hostClearPrices();
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "PipeFrameReceiver.h"
+#include <poll.h>
+#include <unistd.h>
+
+PipeFrameReceiver::PipeFrameReceiver(int fd, uint16_t ringSize, uint16_t idleMillis) : FrameReceiver(ringSize) {
+    this->fd = fd;
+    this->idleMillis = idleMillis;
+}
+
+PipeFrameReceiver::~PipeFrameReceiver() {
+    end();
+}
+
+bool PipeFrameReceiver::begin() {
+    if(fd < 0 || active) return false;
+    active = true;
+    thread = std::thread(&PipeFrameReceiver::run, this);
+    return true;
+}
+
+void PipeFrameReceiver::end() {
+    {
+        // Same handover as on ESP32, a pass through the loop in progress is waited for
+        std::lock_guard<std::mutex> guard(lock);
+        active = false;
+    }
+    if(thread.joinable()) thread.join();
+}
+
+uint32_t PipeFrameReceiver::getFrames() {
+    return frames;
+}
+
+void PipeFrameReceiver::run() {
+    bool pending = false;
+    uint8_t buf[64];
+    while(active) {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        int res = poll(&pfd, 1, idleMillis);
+        std::lock_guard<std::mutex> guard(lock);
+        if(!active) break;
+        if(res > 0) {
+            ssize_t read = ::read(fd, buf, sizeof(buf));
+            if(read > 0) {
+                received(buf, read);
+                pending = true;
+                continue;
+            }
+            // Writer closed, whatever was received last is a complete frame
+            if(pending) {
+                idle();
+                frames++;
+            }
+            break;
+        } else if(res == 0 && pending) {
+            idle();
+            frames++;
+            pending = false;
+        }
+    }
+}
@@ -0,0 +1,40 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _PIPEFRAMERECEIVER_H
+#define _PIPEFRAMERECEIVER_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "FrameReceiver.h"
+
+// Host counterpart of UartFrameReceiver. Reads a pipe or pty from a thread of its own, the
+// way the UART event task drains the driver, and ends a frame once nothing has been read
+// for idleMillis. Real time is used here, not the simulated clock.
+class PipeFrameReceiver : public FrameReceiver {
+public:
+    PipeFrameReceiver(int fd, uint16_t ringSize, uint16_t idleMillis = 5);
+    ~PipeFrameReceiver();
+
+    bool begin();
+    void end();
+
+    // Frames ended so far, for tests waiting on the receiving thread
+    uint32_t getFrames();
+
+private:
+    int fd;
+    uint16_t idleMillis;
+    std::thread thread;
+    std::mutex lock;
+    std::atomic<bool> active { false };
+    std::atomic<uint32_t> frames { 0 };
+
+    void run();
+};
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "HostPrices.h"
+
+static std::vector<HostPricePoint> importPrices;
+static std::vector<HostPricePoint> exportPrices;
+
+static std::vector<HostPricePoint>& pricesFor(uint8_t direction) {
+    return direction == PRICE_DIRECTION_EXPORT ? exportPrices : importPrices;
+}
+
+void hostSetPrices(uint8_t direction, const std::vector<HostPricePoint>& points) {
+    if(direction & PRICE_DIRECTION_IMPORT) importPrices = points;
+    if(direction & PRICE_DIRECTION_EXPORT) exportPrices = points;
+}
+
+void hostSetPrices(uint8_t direction, time_t start, uint16_t resolution, const std::vector<float>& values) {
+    std::vector<HostPricePoint> points;
+    for(size_t i = 0; i < values.size(); i++) {
+        points.push_back({ (time_t) (start + i * resolution * 60), resolution, values[i] });
+    }
+    hostSetPrices(direction, points);
+}
+
+void hostClearPrices() {
+    importPrices.clear();
+    exportPrices.clear();
+}
+
+PriceService::PriceService(Stream* Debug) : priceConfig(std::vector<PriceConfig>()) {
+    debugger = Debug;
+    buf = NULL;
+}
+
+void PriceService::setup(PriceServiceConfig& config) {
+    if(this->config == NULL) {
+        this->config = new PriceServiceConfig();
+    }
+    memcpy(this->config, &config, sizeof(config));
+}
+
+bool PriceService::loop() {
+    return false;
+}
+
+char* PriceService::getToken() {
+    return config == NULL ? (char*) "" : config->entsoeToken;
+}
+
+char* PriceService::getCurrency() {
+    return config == NULL ? (char*) "NOK" : config->currency;
+}
+
+char* PriceService::getArea() {
+    return config == NULL ? (char*) "NO1" : config->area;
+}
+
+char* PriceService::getSource() {
+    return (char*) "HOST";
+}
+
+float PriceService::getValue(uint8_t direction, time_t ts) {
+    for(const HostPricePoint& p : pricesFor(direction)) {
+        if(ts >= p.start && ts < p.start + p.minutes * 60) return p.value;
+    }
+    return PRICE_NO_VALUE;
+}
+
+float PriceService::getEnergyPrice(uint8_t direction, time_t ts) {
+    return getValue(direction, ts);
+}
+
+// Average of the points in the hour, as the real service does for quarter hour prices
+float PriceService::getValueForHour(uint8_t direction, time_t ts, int8_t hour) {
+    time_t start = ts - (ts % 3600) + hour * 3600;
+    float sum = 0;
+    uint8_t count = 0;
+    for(const HostPricePoint& p : pricesFor(direction)) {
+        if(p.start >= start && p.start < start + 3600) {
+            sum += p.value;
+            count++;
+        } else if(p.start < start && p.start + p.minutes * 60 > start) {
+            return p.value;
+        }
+    }
+    return count == 0 ? PRICE_NO_VALUE : sum / count;
+}
+
+float PriceService::getValueForHour(uint8_t direction, int8_t hour) {
+    return getValueForHour(direction, time(nullptr), hour);
+}
+
+float PriceService::getEnergyPriceForHour(uint8_t direction, time_t ts, int8_t hour) {
+    return getValueForHour(direction, ts, hour);
+}
+
+std::vector<PriceConfig>& PriceService::getPriceConfig() {
+    return priceConfig;
+}
+
+void PriceService::setPriceConfig(uint8_t index, PriceConfig &priceConfig) {
+    if(this->priceConfig.size() <= index) this->priceConfig.resize(index + 1);
+    this->priceConfig[index] = priceConfig;
+}
+
+void PriceService::cropPriceConfig(uint8_t size) {
+    if(priceConfig.size() > size) priceConfig.resize(size);
+}
+
+PricePart PriceService::getPricePart(uint8_t index) {
+    PricePart part;
+    memset(&part, 0, sizeof(part));
+    return part;
+}
+
+int16_t PriceService::getLastError() {
+    return 0;
+}
+
+bool PriceService::load() {
+    return true;
+}
+
+bool PriceService::save() {
+    return true;
+}
@@ -0,0 +1,81 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "SegmentedFrames.h"
+#include "crc.h"
+
+std::vector<uint8_t> hdlcPayload(const std::vector<uint8_t>& frame) {
+    size_t pos = 3;
+    while((frame[pos] & 0x01) == 0x00) pos++; // Destination address
+    pos++;
+    while((frame[pos] & 0x01) == 0x00) pos++; // Source address
+    pos++;
+    pos += 3; // Control and HCS
+    return std::vector<uint8_t>(frame.begin() + pos, frame.end() - 3);
+}
+
+static std::vector<uint8_t> hdlcFrame(const uint8_t* payload, size_t length, bool segmented) {
+    std::vector<uint8_t> frame;
+    uint16_t format = 0xA000 | (segmented ? 0x0800 : 0) | ((length + 10) & 0x7FF);
+    frame.push_back(0x7E);
+    frame.push_back(format >> 8);
+    frame.push_back(format & 0xFF);
+    frame.push_back(0x41); // Destination
+    frame.push_back(0x08); // Source, two bytes
+    frame.push_back(0x83);
+    frame.push_back(0x13); // Control
+    uint16_t hcs = crc16_x25(frame.data() + 1, frame.size() - 1);
+    frame.push_back(hcs >> 8);
+    frame.push_back(hcs & 0xFF);
+    frame.insert(frame.end(), payload, payload + length);
+    uint16_t fcs = crc16_x25(frame.data() + 1, frame.size() - 1);
+    frame.push_back(fcs >> 8);
+    frame.push_back(fcs & 0xFF);
+    frame.push_back(0x7E);
+    return frame;
+}
+
+std::vector<std::vector<uint8_t>> hdlcSegments(const std::vector<uint8_t>& payload, size_t segmentSize) {
+    std::vector<std::vector<uint8_t>> frames;
+    for(size_t off = 0; off < payload.size(); off += segmentSize) {
+        size_t length = std::min(segmentSize, payload.size() - off);
+        frames.push_back(hdlcFrame(payload.data() + off, length, off + length < payload.size()));
+    }
+    return frames;
+}
+
+std::vector<std::vector<uint8_t>> mbusSegments(const std::vector<uint8_t>& apdu, size_t segmentSize) {
+    std::vector<std::vector<uint8_t>> frames;
+    uint8_t sequence = 0;
+    for(size_t off = 0; off < apdu.size(); off += segmentSize) {
+        size_t length = std::min(segmentSize, apdu.size() - off);
+        bool final = off + length == apdu.size();
+        std::vector<uint8_t> body = { 0x53, 0xFF, (uint8_t) ((final ? 0x10 : 0x00) | (sequence++ & 0x0F)), 0x01, 0x67 };
+        body.insert(body.end(), apdu.begin() + off, apdu.begin() + off + length);
+        std::vector<uint8_t> frame = { 0x68, (uint8_t) body.size(), (uint8_t) body.size(), 0x68 };
+        frame.insert(frame.end(), body.begin(), body.end());
+        uint8_t sum = 0;
+        for(uint8_t b : body) sum += b;
+        frame.push_back(sum);
+        frame.push_back(0x16);
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+std::vector<std::vector<uint8_t>> gbtSegments(const std::vector<uint8_t>& apdu, size_t segmentSize) {
+    std::vector<std::vector<uint8_t>> frames;
+    uint16_t sequence = 1;
+    for(size_t off = 0; off < apdu.size(); off += segmentSize) {
+        size_t length = std::min(segmentSize, apdu.size() - off);
+        bool final = off + length == apdu.size();
+        std::vector<uint8_t> payload = { 0xE6, 0xE7, 0x00, 0xE0, (uint8_t) (final ? 0x80 : 0x00), (uint8_t) (sequence >> 8), (uint8_t) (sequence & 0xFF), 0x00, 0x00, (uint8_t) length };
+        payload.insert(payload.end(), apdu.begin() + off, apdu.begin() + off + length);
+        frames.push_back(hdlcFrame(payload.data(), payload.size(), false));
+        sequence++;
+    }
+    return frames;
+}
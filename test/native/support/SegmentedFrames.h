@@ -0,0 +1,29 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _SEGMENTEDFRAMES_H
+#define _SEGMENTEDFRAMES_H
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+// None of the captures are segmented, so segmented streams are built from the APDUs in them.
+// Payloads are split into pieces of at most segmentSize bytes.
+
+// Payload of an HDLC frame, from after the HCS up to the FCS, LLC header included
+std::vector<uint8_t> hdlcPayload(const std::vector<uint8_t>& frame);
+
+// HDLC frames with the segmentation bit set on all but the last
+std::vector<std::vector<uint8_t>> hdlcSegments(const std::vector<uint8_t>& payload, size_t segmentSize);
+
+// M-Bus long frames as sent by Austrian meters, with the sequence number and final bit in CI
+std::vector<std::vector<uint8_t>> mbusSegments(const std::vector<uint8_t>& apdu, size_t segmentSize);
+
+// Unsegmented HDLC frames, each carrying one general block transfer block of the APDU
+std::vector<std::vector<uint8_t>> gbtSegments(const std::vector<uint8_t>& apdu, size_t segmentSize);
+
+#endif
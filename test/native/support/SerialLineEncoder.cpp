@@ -0,0 +1,56 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include "SerialLineEncoder.h"
+
+SerialLine encodeSerialLine(const std::vector<std::vector<uint8_t>>& frames, uint32_t baud, uint8_t parity, bool invert, uint32_t gapMicros) {
+    uint8_t dataBits = (parity & 0x01) ? 8 : 7;
+    bool hasParity = (parity & 0x08) == 0x08;
+    bool idle = !invert;
+    double bitTime = 1000000.0 / baud;
+
+    // Levels bit by bit, then merged into runs with the edges rounded to whole microseconds
+    std::vector<std::pair<double, bool>> levels;
+    for(const std::vector<uint8_t>& frame : frames) {
+        levels.push_back({ (double) gapMicros, idle });
+        for(uint8_t b : frame) {
+            levels.push_back({ bitTime, !idle });
+            uint8_t ones = 0;
+            for(uint8_t i = 0; i < dataBits; i++) {
+                bool one = (b >> i) & 0x01;
+                if(one) ones++;
+                levels.push_back({ bitTime, one ? idle : !idle });
+            }
+            if(hasParity) levels.push_back({ bitTime, (ones % 2) ? idle : !idle });
+            levels.push_back({ bitTime, idle });
+        }
+    }
+    levels.push_back({ (double) gapMicros, idle });
+
+    SerialLine line;
+    line.startLevel = idle;
+    double t = 0, runStart = 0;
+    bool level = idle;
+    for(const std::pair<double, bool>& l : levels) {
+        if(l.second != level) {
+            line.runs.push_back((uint16_t) min(llround(t) - llround(runStart), 0xFFFFLL));
+            runStart = t;
+            level = l.second;
+        }
+        t += l.first;
+    }
+    line.runs.push_back((uint16_t) min(llround(t) - llround(runStart), 0xFFFFLL));
+    return line;
+}
+
+void playSerialLine(uint8_t pin, const SerialLine& line, size_t from, size_t to) {
+    bool level = line.startLevel ^ (from & 1);
+    for(size_t i = from; i < line.runs.size() && i < to; i++) {
+        hostSetMicros(hostMicros() + line.runs[i]);
+        level = !level;
+        hostSetPinLevel(pin, level ? HIGH : LOW);
+    }
+}
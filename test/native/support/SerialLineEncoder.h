@@ -0,0 +1,30 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#ifndef _SERIALLINEENCODER_H
+#define _SERIALLINEENCODER_H
+
+#include <vector>
+#include "SerialAutodetect.h"
+
+// RX line as the autodetect capture records it, for bytes sent with the given serial settings
+struct SerialLine {
+    std::vector<uint16_t> runs;
+    bool startLevel;
+
+    SerialLineCapture capture(size_t maxRuns = 0xFFFF) const {
+        return { runs.data(), (uint16_t) min(runs.size(), maxRuns), startLevel };
+    }
+};
+
+// Encodes the frames back to back at baud with the parity ordinal used by MeterConfig,
+// with gapMicros of idle line before each frame
+SerialLine encodeSerialLine(const std::vector<std::vector<uint8_t>>& frames, uint32_t baud, uint8_t parity, bool invert, uint32_t gapMicros = 20000);
+
+// Plays the line on the pin through hostSetPinLevel(), moving the simulated clock along
+void playSerialLine(uint8_t pin, const SerialLine& line, size_t from = 0, size_t to = SIZE_MAX);
+
+#endif
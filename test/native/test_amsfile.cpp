@@ -0,0 +1,140 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "AmsFile.h"
+#include "LittleFS.h"
+
+static const char* Path = "/record.bin";
+static const char* TempPath = "/record.bin.tmp";
+
+struct Record {
+    uint32_t counter;
+    uint16_t values[8];
+};
+
+class AmsFileTest : public ::testing::Test {
+protected:
+    uint8_t buf[sizeof(Record) + sizeof(AmsFileTrailer)];
+
+    void SetUp() override {
+        LittleFS.format();
+        LittleFS.failWritesAfter(-1);
+    }
+
+    void TearDown() override {
+        LittleFS.failWritesAfter(-1);
+    }
+
+    Record record(uint32_t counter) {
+        Record r;
+        r.counter = counter;
+        for(uint8_t i = 0; i < 8; i++) r.values[i] = counter + i;
+        return r;
+    }
+
+    bool write(AmsFile& file, const Record& r) {
+        return file.write((const uint8_t*) &r, sizeof(r));
+    }
+
+    // Record read through a new AmsFile, as after a reboot
+    uint32_t readCounter() {
+        AmsFile file(Path);
+        if(file.read(buf, sizeof(buf)) != sizeof(Record)) return 0;
+        return ((Record*) buf)->counter;
+    }
+
+    void writeRaw(const char* path, const uint8_t* data, size_t len) {
+        File file = LittleFS.open(path, "w");
+        file.write(data, len);
+        file.close();
+    }
+
+    size_t fileSize(const char* path) {
+        File file = LittleFS.open(path, "r");
+        size_t size = file.size();
+        file.close();
+        return size;
+    }
+};
+
+TEST_F(AmsFileTest, WritesRecordWithTrailer) {
+    AmsFile file(Path);
+    ASSERT_TRUE(write(file, record(1)));
+    EXPECT_EQ(sizeof(Record) + sizeof(AmsFileTrailer), fileSize(Path));
+    EXPECT_FALSE(LittleFS.exists(TempPath));
+    EXPECT_EQ(1u, readCounter());
+
+    // The same record is not written again
+    LittleFS.resetStats();
+    ASSERT_TRUE(write(file, record(1)));
+    EXPECT_EQ(0u, LittleFS.getStats().opens);
+}
+
+TEST_F(AmsFileTest, RejectsCrcMismatch) {
+    AmsFile file(Path);
+    ASSERT_TRUE(write(file, record(1)));
+
+    File raw = LittleFS.open(Path, "r");
+    size_t len = raw.read(buf, sizeof(buf));
+    raw.close();
+    buf[3] ^= 0x40;
+    writeRaw(Path, buf, len);
+
+    AmsFile reloaded(Path);
+    EXPECT_EQ(-1, reloaded.read(buf, sizeof(buf)));
+}
+
+// A write cut short leaves the record before it
+TEST_F(AmsFileTest, ShortWriteKeepsOldRecord) {
+    AmsFile file(Path);
+    ASSERT_TRUE(write(file, record(1)));
+
+    LittleFS.failWritesAfter(sizeof(Record) / 2);
+    EXPECT_FALSE(write(file, record(2)));
+    LittleFS.failWritesAfter(-1);
+    EXPECT_FALSE(LittleFS.exists(TempPath));
+    EXPECT_EQ(1u, readCounter());
+
+    ASSERT_TRUE(write(file, record(2)));
+    EXPECT_EQ(2u, readCounter());
+}
+
+// Power lost after the temporary file was complete, but before the rename
+TEST_F(AmsFileTest, RecoversOrphanedTempFile) {
+    AmsFile file(Path);
+    ASSERT_TRUE(write(file, record(1)));
+    ASSERT_TRUE(LittleFS.rename(Path, TempPath));
+    ASSERT_FALSE(LittleFS.exists(Path));
+
+    EXPECT_EQ(1u, readCounter());
+    EXPECT_TRUE(LittleFS.exists(Path));
+    EXPECT_FALSE(LittleFS.exists(TempPath));
+}
+
+// A temporary file cut short has no trailer, and is not taken for a file from old firmware
+TEST_F(AmsFileTest, IgnoresTruncatedTempFile) {
+    Record r = record(1);
+    writeRaw(TempPath, (uint8_t*) &r, sizeof(r) - 6);
+
+    AmsFile reloaded(Path);
+    EXPECT_EQ(-1, reloaded.read(buf, sizeof(buf)));
+    EXPECT_FALSE(LittleFS.exists(Path));
+}
+
+// Files from firmware before the trailer are read as they are, and get one on the next write
+TEST_F(AmsFileTest, ReadsFileWithoutTrailer) {
+    Record r = record(7);
+    writeRaw(Path, (uint8_t*) &r, sizeof(r));
+
+    AmsFile file(Path);
+    ASSERT_EQ((int16_t) sizeof(Record), file.read(buf, sizeof(buf)));
+    EXPECT_EQ(0, memcmp(&r, buf, sizeof(r)));
+
+    ASSERT_TRUE(write(file, r));
+    EXPECT_EQ(sizeof(Record) + sizeof(AmsFileTrailer), fileSize(Path));
+    EXPECT_EQ(7u, readCounter());
+}
@@ -0,0 +1,101 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "CosemIndex.h"
+#include "CaptureReplay.h"
+#include "FrameCapture.h"
+#include "ntohll.h"
+
+static const uint8_t ACTIVE_IMPORT[4] = { 1, 7, 0, 255 };
+
+static std::vector<uint8_t> payloadOf(const char* capture) {
+    CaptureReplay r;
+    std::vector<std::vector<uint8_t>> payloads = r.unwrapFrames(captureFrames(capture));
+    return payloads.empty() ? std::vector<uint8_t>() : payloads.back();
+}
+
+// A structure with n OBIS codes each followed by its value, value i for OBIS 1.0.i.7.0.255
+static std::vector<uint8_t> obisList(uint8_t n) {
+    std::vector<uint8_t> payload = { CosemTypeStructure, (uint8_t) (n * 2) };
+    for(uint8_t i = 0; i < n; i++) {
+        uint8_t item[] = { CosemTypeOctetString, 6, 1, 0, i, 7, 0, 255, CosemTypeDLongUnsigned, 0, 0, 0, i };
+        payload.insert(payload.end(), item, item + sizeof(item));
+    }
+    return payload;
+}
+
+TEST(CosemIndex, FindsCapturedValues) {
+    std::vector<uint8_t> payload = payloadOf("Kamstrup-Sweden.raw");
+    ASSERT_FALSE(payload.empty());
+    CosemIndex index;
+    index.build((const char*) payload.data(), payload.size());
+    CosemData* data = index.find(ACTIVE_IMPORT);
+    ASSERT_NE(nullptr, data);
+    EXPECT_EQ(CosemTypeDLongUnsigned, data->base.type);
+    EXPECT_EQ(2269u, ntohl(data->dlu.data));
+}
+
+TEST(CosemIndex, StaysWithinLength) {
+    std::vector<uint8_t> payload = payloadOf("Aidon-Sweden.raw");
+    ASSERT_GT(payload.size(), 100u);
+    // Cut the payload in the middle of the list, the rest of the buffer must not be looked at
+    uint16_t length = payload.size() / 2;
+    memset(payload.data() + length, CosemTypeArray, payload.size() - length);
+
+    CosemIndex index;
+    index.build((const char*) payload.data(), length);
+    ASSERT_GT(index.getCount(), 0);
+    for(uint8_t i = 0; i < index.getCount(); i++) {
+        CosemData* item = index.getAt(i);
+        ASSERT_NE(nullptr, item);
+        EXPECT_LE((uint8_t*) item - payload.data() + CosemIndex::itemSize(item), length);
+    }
+    EXPECT_EQ(nullptr, index.getAt(index.getCount()));
+}
+
+TEST(CosemIndex, LayoutNotReusedForShorterPayload) {
+    std::vector<uint8_t> payload = payloadOf("Kamstrup-Sweden.raw");
+    CosemIndex index;
+    index.build((const char*) payload.data(), payload.size());
+    EXPECT_TRUE(index.matches((const char*) payload.data(), payload.size()));
+    EXPECT_FALSE(index.matches((const char*) payload.data(), payload.size() - 1));
+}
+
+TEST(CosemIndex, FullObisMapFallsBackToScan) {
+    // More codes than the map holds, while still within COSEM_MAX_SCAN
+    std::vector<uint8_t> payload = obisList(COSEM_OBIS_MAP_SIZE + 4);
+    CosemIndex index;
+    index.build((const char*) payload.data(), payload.size());
+    EXPECT_TRUE(index.isObisMapFull());
+    for(uint8_t i = 0; i < COSEM_OBIS_MAP_SIZE + 4; i++) {
+        uint8_t obis[4] = { i, 7, 0, 255 };
+        CosemData* data = index.find(obis);
+        ASSERT_NE(nullptr, data) << (int) i;
+        EXPECT_EQ(i, ntohl(data->dlu.data));
+    }
+}
+
+TEST(CosemIndex, SmallListFitsInObisMap) {
+    std::vector<uint8_t> payload = obisList(20);
+    CosemIndex index;
+    index.build((const char*) payload.data(), payload.size());
+    EXPECT_FALSE(index.isObisMapFull());
+    uint8_t missing[4] = { 99, 7, 0, 255 };
+    EXPECT_EQ(nullptr, index.find(missing));
+}
+
+TEST(CosemLayoutCache, ReusesLayout) {
+    std::vector<uint8_t> payload = payloadOf("Kamstrup-Sweden.raw");
+    CosemLayoutCache cache;
+    CosemIndex* first = cache.get((const char*) payload.data(), payload.size());
+    // Same layout, other values
+    payload[payload.size() - 2] ^= 0x01;
+    CosemIndex* second = cache.get((const char*) payload.data(), payload.size());
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(1u, cache.getHits());
+    EXPECT_EQ(1u, cache.getMisses());
+}
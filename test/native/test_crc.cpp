@@ -0,0 +1,83 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "crc.h"
+#include "CrcReference.h"
+#include "FrameCapture.h"
+#include "HdlcParser.h"
+
+static const uint8_t CHECK[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+TEST(Crc, X25KnownAnswer) {
+    // CRC-16/X-25 check value is 0x906E, crc16_x25() returns it byte swapped, as it is on the wire
+    EXPECT_EQ(0x6E90, crc16_x25(CHECK, sizeof(CHECK)));
+}
+
+TEST(Crc, A001KnownAnswer) {
+    // CRC-16/ARC, used by DSMR
+    EXPECT_EQ(0xBB3D, crc16(CHECK, sizeof(CHECK)));
+}
+
+TEST(Crc, Poly1021KnownAnswer) {
+    // Register shifted without augmenting zeroes, so not the XMODEM check value (0x31C3)
+    EXPECT_EQ(crc16_1021_bitwise(CHECK, sizeof(CHECK)), crc16_1021(CHECK, sizeof(CHECK)));
+    uint8_t augmented[sizeof(CHECK) + 2] = {};
+    memcpy(augmented, CHECK, sizeof(CHECK));
+    EXPECT_EQ(0x31C3, crc16_1021(augmented, sizeof(augmented)));
+}
+
+TEST(Crc, TablesMatchBitwise) {
+    uint8_t buf[256];
+    for(int i = 0; i < 256; i++) buf[i] = (i * 167 + 13) & 0xFF;
+    for(int len = 0; len <= 256; len += 17) {
+        EXPECT_EQ(crc16_x25_bitwise(buf, len), crc16_x25(buf, len)) << len;
+        EXPECT_EQ(crc16_bitwise(buf, len), crc16(buf, len)) << len;
+        EXPECT_EQ(crc16_1021_bitwise(buf, len), crc16_1021(buf, len)) << len;
+    }
+}
+
+TEST(Crc, StreamingMatchesOneShot) {
+    for(int split = 0; split <= (int) sizeof(CHECK); split++) {
+        uint16_t x25 = crc16_x25_update(crc16_x25_init(), CHECK, split);
+        x25 = crc16_x25_update(x25, CHECK + split, sizeof(CHECK) - split);
+        EXPECT_EQ(crc16_x25(CHECK, sizeof(CHECK)), crc16_x25_final(x25));
+
+        uint16_t a001 = crc16_update(crc16_init(), CHECK, split);
+        a001 = crc16_update(a001, CHECK + split, sizeof(CHECK) - split);
+        EXPECT_EQ(crc16(CHECK, sizeof(CHECK)), crc16_final(a001));
+
+        uint16_t p1021 = crc16_1021_update(crc16_1021_init(), CHECK, split);
+        p1021 = crc16_1021_update(p1021, CHECK + split, sizeof(CHECK) - split);
+        EXPECT_EQ(crc16_1021(CHECK, sizeof(CHECK)), crc16_1021_final(p1021));
+    }
+}
+
+TEST(Crc, CapturedHdlcFcs) {
+    // The FCS is the two bytes before the end flag, over everything after the start flag
+    uint32_t checked = 0;
+    for(const std::string& path : listCaptures(capturesDir())) {
+        for(const std::vector<uint8_t>& frame : splitFrames(loadCapture(path))) {
+            if(frame[0] != HDLC_FLAG) continue;
+            size_t n = frame.size();
+            uint16_t fcs = (frame[n - 3] << 8) | frame[n - 2];
+            EXPECT_EQ(fcs, crc16_x25(frame.data() + 1, n - 4)) << captureName(path);
+            checked++;
+        }
+    }
+    EXPECT_GE(checked, 10u);
+}
+
+TEST(Crc, HdlcParserTrustsVerifiedFcs) {
+    std::vector<uint8_t> frame = captureFrames("Kamstrup-Sweden.raw").at(0);
+    frame[frame.size() - 2] ^= 0x01;
+    HDLCParser parser;
+    DataParserContext ctx = {};
+    ctx.length = frame.size();
+    EXPECT_EQ(DATA_PARSE_FOOTER_CHECKSUM_ERROR, parser.parse(frame.data(), ctx, false));
+    ctx.length = frame.size();
+    EXPECT_GT(parser.parse(frame.data(), ctx, true), 0);
+}
@@ -0,0 +1,81 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "FrameCapture.h"
+#include "CaptureReplay.h"
+#include "DlmsFormat.h"
+
+static uint32_t replay(CaptureReplay& r, const char* name) {
+    return r.feedFrames(captureFrames(name));
+}
+
+TEST(FrameCapture, LoadsEveryCapture) {
+    std::vector<std::string> captures = listCaptures(capturesDir());
+    ASSERT_GE(captures.size(), 10u);
+    for(const std::string& path : captures) {
+        EXPECT_FALSE(loadCapture(path).empty()) << path;
+    }
+}
+
+TEST(Replay, AidonSweden) {
+    CaptureReplay r;
+    ASSERT_EQ(1u, replay(r, "Aidon-Sweden.raw"));
+    AmsData& s = r.getState();
+    EXPECT_EQ(2021u, s.getActiveImportPower());
+    EXPECT_FLOAT_EQ(227.5, s.getL1Voltage());
+    EXPECT_NEAR(63068.772, s.getActiveImportCounter(), 0.001);
+}
+
+TEST(Replay, KamstrupSweden) {
+    CaptureReplay r;
+    ASSERT_EQ(1u, replay(r, "Kamstrup-Sweden.raw"));
+    AmsData& s = r.getState();
+    EXPECT_EQ(3, s.getListType());
+    EXPECT_STREQ("6841131BN245101092", s.getMeterModel().c_str());
+    EXPECT_EQ(2269u, s.getActiveImportPower());
+    EXPECT_FLOAT_EQ(241.0, s.getL1Voltage());
+    EXPECT_NEAR(320141.58, s.getActiveImportCounter(), 0.001);
+}
+
+TEST(Replay, Kamstrup1pEveryFrame) {
+    CaptureReplay r;
+    ASSERT_EQ(3u, replay(r, "Kamstrup-1p.raw"));
+    AmsData& s = r.getState();
+    EXPECT_STREQ("6861111BN242101040", s.getMeterModel().c_str());
+    EXPECT_EQ(619u, s.getActiveImportPower());
+}
+
+TEST(Replay, KaifaSkipsMaskedFrames) {
+    // The annotated frames have masked meter IDs, only the unmasked list 3 frame is complete
+    CaptureReplay r;
+    EXPECT_EQ(1u, replay(r, "Kaifa-TN-3p.raw"));
+    EXPECT_STREQ("MA304H3E", r.getState().getMeterModel().c_str());
+    EXPECT_EQ(0x040Cu, r.getState().getActiveImportPower());
+}
+
+// Only the KFM_001 list goes to the Kaifa entry, list 1 has no id and is decoded as an OBIS list
+TEST(DlmsFormat, KaifaListHasItsOwnEntry) {
+    CaptureReplay r;
+    std::vector<std::string> names;
+    for(const std::vector<uint8_t>& payload : r.unwrapFrames(captureFrames("Kaifa-TN-3p.raw"))) {
+        int8_t format = dlmsFormatProbe((const char*) payload.data(), payload.size());
+        ASSERT_GE(format, 0);
+        names.push_back(DLMS_FORMATS[format].name);
+    }
+    EXPECT_EQ(std::vector<std::string>({ "DLMS", "Kaifa" }), names);
+
+    const char notAList[] = { CosemTypeDLongUnsigned, 0, 0, 4, 0x0C };
+    EXPECT_EQ(-1, dlmsFormatProbe(notAList, sizeof(notAList)));
+}
+
+TEST(Replay, RepeatedFramesKeepDecoding) {
+    std::vector<std::vector<uint8_t>> frames = captureFrames("Kamstrup-1p.raw");
+    CaptureReplay r;
+    uint32_t decoded = 0;
+    for(int i = 0; i < 50; i++) decoded += r.feedFrames(frames);
+    EXPECT_EQ(50u * frames.size(), decoded);
+}
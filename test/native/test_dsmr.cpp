@@ -0,0 +1,68 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include "CaptureReplay.h"
+#include "DsmrTelegram.h"
+#include "HostHeap.h"
+#include "IEC6205621.h"
+
+static MeterConfig emptyConfig() {
+    MeterConfig config;
+    memset(&config, 0, sizeof(config));
+    return config;
+}
+
+TEST(Dsmr, DecodesTelegram) {
+    CaptureReplay r;
+    ASSERT_EQ(1u, r.feed(dsmrTelegram()));
+    AmsData& s = r.getState();
+    EXPECT_EQ(4, s.getListType());
+    // 96.1.1 is read as the model, the ID is only taken from 96.1.0 or 0.0.5
+    EXPECT_STREQ("4530303434303037313331363530323137", s.getMeterModel().c_str());
+    EXPECT_EQ(1193u, s.getActiveImportPower());
+    EXPECT_FLOAT_EQ(230.1, s.getL1Voltage());
+    EXPECT_FLOAT_EQ(229.8, s.getL3Voltage());
+    EXPECT_FLOAT_EQ(3, s.getL1Current());
+    EXPECT_EQ(561u, s.getL1ActiveImportPower());
+    // No 1.8.0 in the telegram, so the tariff registers are added up
+    EXPECT_NEAR(358.023, s.getActiveImportCounter(), 0.0005);
+    EXPECT_NEAR(3.579, s.getActiveExportCounter(), 0.0005);
+    EXPECT_TRUE(s.isThreePhase());
+}
+
+TEST(Dsmr, LongTelegramKeepsElectricityValues) {
+    std::vector<uint8_t> telegram = dsmrTelegram(DSMR_MAX_VALUES);
+    std::string text(telegram.begin(), telegram.end());
+    MeterConfig config = emptyConfig();
+    IEC6205621 decoded(text.c_str(), NULL, &config);
+    // 19 value lines in the base telegram, the added ones come after them
+    EXPECT_EQ(19, decoded.getDroppedValues());
+    EXPECT_STREQ("ISK5", decoded.getListId().c_str());
+    EXPECT_EQ(1193u, decoded.getActiveImportPower());
+    EXPECT_NEAR(358.023, decoded.getActiveImportCounter(), 0.0005);
+}
+
+TEST(Dsmr, NothingDroppedFromRegularTelegram) {
+    std::vector<uint8_t> telegram = dsmrTelegram(DSMR_MAX_VALUES - 19);
+    std::string text(telegram.begin(), telegram.end());
+    MeterConfig config = emptyConfig();
+    IEC6205621 decoded(text.c_str(), NULL, &config);
+    EXPECT_EQ(0, decoded.getDroppedValues());
+}
+
+TEST(Dsmr, OnlyStoredStringsAllocate) {
+    std::vector<uint8_t> telegram = dsmrTelegram();
+    std::string text(telegram.begin(), telegram.end());
+    MeterConfig config = emptyConfig();
+    hostHeapReset();
+    {
+        IEC6205621 decoded(text.c_str(), NULL, &config);
+    }
+    // List ID, meter ID and meter model
+    EXPECT_LE(hostHeapStats().allocations, 3u);
+}
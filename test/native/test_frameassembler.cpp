@@ -0,0 +1,83 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "FrameAssembler.h"
+#include "DsmrTelegram.h"
+#include "FrameCapture.h"
+
+// Feeds the frame one byte at a time, returns the length at which the assembler stopped
+// reporting DATA_PARSE_INCOMPLETE and what it returned then
+static std::pair<size_t, int8_t> assemble(FrameAssembler& fa, const std::vector<uint8_t>& frame) {
+    for(size_t len = 1; len <= frame.size(); len++) {
+        int8_t res = fa.append(frame.data(), len);
+        if(res != DATA_PARSE_INCOMPLETE) return { len, res };
+    }
+    return { frame.size(), DATA_PARSE_INCOMPLETE };
+}
+
+TEST(FrameAssembler, CompletesHdlcFramesOnLastByte) {
+    for(const std::string& path : listCaptures(capturesDir())) {
+        for(const std::vector<uint8_t>& frame : splitFrames(loadCapture(path))) {
+            if(frame[0] != DATA_TAG_HDLC) continue;
+            FrameAssembler fa;
+            std::pair<size_t, int8_t> res = assemble(fa, frame);
+            EXPECT_EQ(frame.size(), res.first) << captureName(path);
+            EXPECT_EQ(DATA_PARSE_OK, res.second) << captureName(path);
+        }
+    }
+}
+
+TEST(FrameAssembler, RejectsBadFcs) {
+    std::vector<uint8_t> frame = captureFrames("Kamstrup-Sweden.raw").at(0);
+    frame[frame.size() - 2] ^= 0x01;
+    FrameAssembler fa;
+    std::pair<size_t, int8_t> res = assemble(fa, frame);
+    EXPECT_EQ(frame.size(), res.first);
+    EXPECT_EQ(DATA_PARSE_FOOTER_CHECKSUM_ERROR, res.second);
+}
+
+TEST(FrameAssembler, RejectsMissingEndFlag) {
+    std::vector<uint8_t> frame = captureFrames("Kamstrup-Sweden.raw").at(0);
+    frame.back() = 0x00;
+    FrameAssembler fa;
+    EXPECT_EQ(DATA_PARSE_BOUNDRY_FLAG_MISSING, assemble(fa, frame).second);
+}
+
+TEST(FrameAssembler, StartsOverOnFirstByte) {
+    std::vector<std::vector<uint8_t>> frames = captureFrames("Kamstrup-1p.raw");
+    ASSERT_EQ(3u, frames.size());
+    FrameAssembler fa;
+    // A frame abandoned half way does not affect the next one
+    fa.append(frames[0].data(), frames[0].size() / 2);
+    for(const std::vector<uint8_t>& frame : frames) {
+        EXPECT_EQ(DATA_PARSE_OK, assemble(fa, frame).second);
+    }
+}
+
+TEST(FrameAssembler, CompletesMbusOnLength) {
+    std::vector<uint8_t> frame = captureFrames("austria.raw").at(0);
+    ASSERT_EQ(DATA_TAG_MBUS, frame[0]);
+    FrameAssembler fa;
+    std::pair<size_t, int8_t> res = assemble(fa, frame);
+    EXPECT_EQ(frame.size(), res.first);
+    EXPECT_EQ(DATA_PARSE_OK, res.second);
+}
+
+TEST(FrameAssembler, CompletesDsmrAfterCrcLine) {
+    std::vector<uint8_t> telegram = dsmrTelegram();
+    FrameAssembler fa;
+    std::pair<size_t, int8_t> res = assemble(fa, telegram);
+    EXPECT_EQ(telegram.size(), res.first);
+    EXPECT_EQ(DATA_PARSE_OK, res.second);
+}
+
+TEST(FrameAssembler, UnknownDataParsedOnEveryByte) {
+    uint8_t buf[] = { DATA_TAG_DLMS, 0x00, 0x00 };
+    FrameAssembler fa;
+    EXPECT_EQ(DATA_PARSE_OK, fa.append(buf, 1));
+    EXPECT_EQ(DATA_PARSE_OK, fa.append(buf, 2));
+}
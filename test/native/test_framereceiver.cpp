@@ -0,0 +1,205 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "PipeFrameReceiver.h"
+#include "HostMeterCommunicator.h"
+#include "HostDebug.h"
+#include "FrameCapture.h"
+
+static void sleepMillis(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static bool waitForFrames(PipeFrameReceiver& receiver, uint32_t frames) {
+    for(int i = 0; i < 2000 && receiver.getFrames() < frames; i++) sleepMillis(1);
+    return receiver.getFrames() >= frames;
+}
+
+// Writes the frame in a few pieces with short pauses, like a UART FIFO being emptied
+static void writeFrame(int fd, const std::vector<uint8_t>& frame, size_t pieces = 3) {
+    size_t step = (frame.size() + pieces - 1) / pieces;
+    for(size_t off = 0; off < frame.size(); off += step) {
+        ASSERT_EQ((ssize_t) min(step, frame.size() - off), write(fd, frame.data() + off, min(step, frame.size() - off)));
+        sleepMillis(1);
+    }
+}
+
+class PipeTest : public ::testing::Test {
+protected:
+    int fds[2];
+
+    void SetUp() override {
+        ASSERT_EQ(0, pipe(fds));
+    }
+
+    void TearDown() override {
+        if(fds[0] >= 0) close(fds[0]);
+        if(fds[1] >= 0) close(fds[1]);
+    }
+
+    void closeWriter() {
+        close(fds[1]);
+        fds[1] = -1;
+    }
+};
+
+TEST_F(PipeTest, OnlyCompleteFramesAreVisible) {
+    std::vector<uint8_t> frame = captureFrames("Kamstrup-1p.raw")[0];
+    PipeFrameReceiver receiver(fds[0], 1024, 100);
+    ASSERT_TRUE(receiver.begin());
+    Stream* stream = receiver.getStream();
+
+    size_t half = frame.size() / 2;
+    ASSERT_EQ((ssize_t) half, write(fds[1], frame.data(), half));
+    sleepMillis(20);
+    EXPECT_EQ(0, stream->available());
+
+    ASSERT_EQ((ssize_t) (frame.size() - half), write(fds[1], frame.data() + half, frame.size() - half));
+    ASSERT_TRUE(waitForFrames(receiver, 1));
+    ASSERT_EQ((int) frame.size(), stream->available());
+    for(uint8_t b : frame) EXPECT_EQ(b, stream->read());
+}
+
+TEST_F(PipeTest, FrameLargerThanRingIsDroppedWhole) {
+    std::vector<uint8_t> frame = captureFrames("Kamstrup-1p.raw")[0];
+    ASSERT_GT(frame.size(), 64u);
+    PipeFrameReceiver receiver(fds[0], 64, 20);
+    ASSERT_TRUE(receiver.begin());
+
+    writeFrame(fds[1], frame);
+    ASSERT_TRUE(waitForFrames(receiver, 1));
+    EXPECT_EQ(1u, receiver.getOverflows());
+    EXPECT_EQ(0, receiver.getStream()->available());
+
+    // The ring recovers for the next frame that fits
+    std::vector<uint8_t> small(frame.begin(), frame.begin() + 32);
+    writeFrame(fds[1], small, 1);
+    ASSERT_TRUE(waitForFrames(receiver, 2));
+    EXPECT_EQ(32, receiver.getStream()->available());
+}
+
+TEST_F(PipeTest, MeterDecodesFramesFromPipe) {
+    std::vector<std::vector<uint8_t>> frames = captureFrames("Kamstrup-1p.raw");
+    ASSERT_EQ(3u, frames.size());
+
+    HostDebug debug;
+    MeterConfig config;
+    memset(&config, 0, sizeof(config));
+    config.bufferSize = 8;
+    PipeFrameReceiver* receiver = new PipeFrameReceiver(fds[0], 2048, 20);
+    HostMeterCommunicator mc(&debug);
+    mc.attach(receiver, config, NULL);
+
+    AmsData state;
+    uint32_t decoded = 0;
+    for(size_t i = 0; i < frames.size(); i++) {
+        writeFrame(fds[1], frames[i]);
+        ASSERT_TRUE(waitForFrames(*receiver, i + 1));
+        while(receiver->getStream()->available() > 0) {
+            if(!mc.loop()) continue;
+            AmsData* data = mc.getData(state);
+            if(data != NULL) {
+                if(data->getListType() > 0) {
+                    state.apply(*data);
+                    decoded++;
+                }
+                mc.releaseData(data);
+            }
+        }
+    }
+    EXPECT_EQ(3u, decoded);
+    EXPECT_EQ(619u, state.getActiveImportPower());
+}
+
+TEST_F(PipeTest, EndStopsWritesWhileBytesKeepArriving) {
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    PipeFrameReceiver receiver(fds[0], 4096, 1);
+    ASSERT_TRUE(receiver.begin());
+
+    std::atomic<bool> feeding { true };
+    std::thread writer([&]() {
+        uint8_t b[16];
+        memset(b, 0x55, sizeof(b));
+        while(feeding) {
+            if(write(fds[1], b, sizeof(b)) < 0) sleepMillis(1);
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    });
+
+    sleepMillis(30);
+    receiver.end();
+    int available = receiver.getStream()->available();
+    uint32_t frames = receiver.getFrames();
+    sleepMillis(30);
+    EXPECT_EQ(available, receiver.getStream()->available());
+    EXPECT_EQ(frames, receiver.getFrames());
+
+    feeding = false;
+    writer.join();
+}
+
+TEST_F(PipeTest, MeterCanBeDeletedWhileBytesKeepArriving) {
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    std::vector<uint8_t> frame = captureFrames("Kamstrup-1p.raw")[0];
+
+    HostDebug debug;
+    MeterConfig config;
+    memset(&config, 0, sizeof(config));
+    config.bufferSize = 8;
+    HostMeterCommunicator* mc = new HostMeterCommunicator(&debug);
+    mc->attach(new PipeFrameReceiver(fds[0], 2048, 1), config, NULL);
+
+    std::atomic<bool> feeding { true };
+    std::thread writer([&]() {
+        while(feeding) {
+            if(write(fds[1], frame.data(), frame.size()) < 0) sleepMillis(1);
+            sleepMillis(2);
+        }
+    });
+
+    sleepMillis(20);
+    delete mc;
+    sleepMillis(10);
+
+    feeding = false;
+    writer.join();
+}
+
+TEST(PtyReceiver, ReadsFramesFromPty) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(master, 0);
+    ASSERT_EQ(0, grantpt(master));
+    ASSERT_EQ(0, unlockpt(master));
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    ASSERT_GE(slave, 0);
+    struct termios tio;
+    ASSERT_EQ(0, tcgetattr(slave, &tio));
+    cfmakeraw(&tio);
+    ASSERT_EQ(0, tcsetattr(slave, TCSANOW, &tio));
+
+    std::vector<std::vector<uint8_t>> frames = captureFrames("Kamstrup-1p.raw");
+    PipeFrameReceiver receiver(slave, 2048, 20);
+    ASSERT_TRUE(receiver.begin());
+    for(size_t i = 0; i < frames.size(); i++) {
+        writeFrame(master, frames[i]);
+        ASSERT_TRUE(waitForFrames(receiver, i + 1));
+    }
+    receiver.end();
+
+    Stream* stream = receiver.getStream();
+    for(const std::vector<uint8_t>& frame : frames) {
+        for(uint8_t b : frame) ASSERT_EQ(b, stream->read());
+    }
+    EXPECT_EQ(0, stream->available());
+
+    close(slave);
+    close(master);
+}
@@ -0,0 +1,106 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "CaptureReplay.h"
+#include "FrameCapture.h"
+#include "GcmFrames.h"
+#include "GcmParser.h"
+#include "HostHeap.h"
+
+static uint8_t EncryptionKey[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F };
+static uint8_t AuthenticationKey[16] = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F };
+static uint8_t OtherEncryptionKey[16] = { 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xAB, 0xAC, 0xAD, 0xAE, 0xAF };
+static uint8_t OtherAuthenticationKey[16] = { 0xB0, 0xB1, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xBB, 0xBC, 0xBD, 0xBE, 0xBF };
+
+class GcmTest : public ::testing::Test {
+protected:
+    std::vector<uint8_t> plain;
+    std::vector<uint8_t> frame;
+    size_t apdu;
+
+    void SetUp() override {
+        if(!gcmAvailable()) GTEST_SKIP() << "Built without mbedtls";
+        // Loaded whole, its FCS is for the ciphertext and the frame splitter would drop it
+        plain = loadCapture(std::string(capturesDir()) + "/Kamstup-Encrypted.raw");
+        frame = gcmEncryptFrame(plain, EncryptionKey, AuthenticationKey);
+        ASSERT_FALSE(frame.empty());
+        apdu = gcmApduOffset(frame);
+        ASSERT_GT(apdu, 0u);
+    }
+
+    // Parses a copy of the frame, which is decrypted in place. Returns the offset of the
+    // plaintext from the GCM tag, or the error.
+    int8_t parse(GCMParser& parser, std::vector<uint8_t>& buf, DataParserContext& ctx) {
+        ctx = {};
+        ctx.length = buf.size() - apdu - 3; // FCS and flag
+        return parser.parse(&buf[apdu], ctx);
+    }
+};
+
+TEST_F(GcmTest, DecryptsInPlace) {
+    ASSERT_NE(plain, frame);
+    GCMParser parser(EncryptionKey, AuthenticationKey);
+    std::vector<uint8_t> buf = frame;
+    DataParserContext ctx;
+    int8_t res = parse(parser, buf, ctx);
+    ASSERT_GT(res, 0);
+    EXPECT_EQ(0, memcmp(ctx.system_title, &plain[apdu + 2], 8));
+    size_t start = apdu + res;
+    EXPECT_EQ(0x0F, buf[start]);
+    EXPECT_EQ(0, memcmp(&plain[start], &buf[start], ctx.length));
+}
+
+TEST_F(GcmTest, DecodesThroughMeter) {
+    CaptureReplay replay;
+    replay.getMeter().setKeys(EncryptionKey, AuthenticationKey);
+    ASSERT_EQ(1u, replay.feedFrames({ frame }));
+    AmsData& s = replay.getState();
+    EXPECT_EQ(1484u, s.getActiveImportPower());
+    EXPECT_FLOAT_EQ(229.0, s.getL1Voltage());
+
+    // Without the keys nothing comes out of it
+    CaptureReplay noKeys;
+    EXPECT_EQ(0u, noKeys.feedFrames({ frame }));
+}
+
+TEST_F(GcmTest, RejectsAuthFailure) {
+    GCMParser parser(EncryptionKey, AuthenticationKey);
+    DataParserContext ctx;
+    std::vector<uint8_t> buf = frame;
+    buf[apdu + 40] ^= 0x01;
+    EXPECT_EQ(GCM_AUTH_FAILED, parse(parser, buf, ctx));
+
+    GCMParser wrongKey(EncryptionKey, OtherAuthenticationKey);
+    buf = frame;
+    EXPECT_EQ(GCM_AUTH_FAILED, parse(wrongKey, buf, ctx));
+}
+
+// The key schedule is expanded once, and again only when the keys change
+TEST_F(GcmTest, KeyChange) {
+    GCMParser parser(EncryptionKey, AuthenticationKey);
+    DataParserContext ctx;
+    std::vector<uint8_t> buf = frame;
+    ASSERT_GT(parse(parser, buf, ctx), 0);
+
+    hostHeapReset();
+    parser.setKeys(EncryptionKey, AuthenticationKey);
+    buf = frame;
+    ASSERT_GT(parse(parser, buf, ctx), 0);
+    EXPECT_EQ(0u, hostHeapStats().allocations);
+
+    std::vector<uint8_t> other = gcmEncryptFrame(plain, OtherEncryptionKey, OtherAuthenticationKey);
+    hostHeapReset();
+    parser.setKeys(OtherEncryptionKey, OtherAuthenticationKey);
+    buf = other;
+    int8_t res = parse(parser, buf, ctx);
+    ASSERT_GT(res, 0);
+    EXPECT_GT(hostHeapStats().allocations, 0u);
+    EXPECT_EQ(0, memcmp(&plain[apdu + res], &buf[apdu + res], ctx.length));
+
+    buf = frame;
+    EXPECT_EQ(GCM_AUTH_FAILED, parse(parser, buf, ctx));
+}
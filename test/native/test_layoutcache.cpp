@@ -0,0 +1,126 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "CaptureReplay.h"
+#include "DlmsFormat.h"
+#include "FrameCapture.h"
+#include "IEC6205675.h"
+
+// Payloads of the captures that are decoded as OBIS lists by IEC6205675
+static std::vector<std::vector<uint8_t>> obisPayloads(const std::string& path) {
+    CaptureReplay replay;
+    std::vector<std::vector<uint8_t>> payloads;
+    for(const std::vector<uint8_t>& payload : replay.unwrapFrames(splitFrames(loadCapture(path)))) {
+        int8_t format = dlmsFormatProbe((const char*) payload.data(), payload.size());
+        if(format >= 0 && strcmp(DLMS_FORMATS[format].name, "DLMS") == 0) payloads.push_back(payload);
+    }
+    return payloads;
+}
+
+class LayoutDecode {
+public:
+    LayoutDecode() {
+        memset(&config, 0, sizeof(config));
+    }
+
+    AmsData decode(std::vector<uint8_t>& payload, CosemLayoutCache* cache) {
+        DataParserContext ctx = {};
+        ctx.type = DATA_TAG_DLMS;
+        ctx.length = payload.size();
+        IEC6205675 decoded((const char*) payload.data(), AmsTypeAutodetect, &config, ctx, state, cache);
+        return decoded;
+    }
+
+private:
+    MeterConfig config;
+    AmsData state;
+};
+
+static void expectSameValues(AmsData& a, AmsData& b, const std::string& what) {
+    EXPECT_EQ(a.getListType(), b.getListType()) << what;
+    EXPECT_EQ(a.getMeterType(), b.getMeterType()) << what;
+    EXPECT_STREQ(a.getMeterId().c_str(), b.getMeterId().c_str()) << what;
+    EXPECT_STREQ(a.getMeterModel().c_str(), b.getMeterModel().c_str()) << what;
+    EXPECT_EQ(a.getActiveImportPower(), b.getActiveImportPower()) << what;
+    EXPECT_EQ(a.getActiveExportPower(), b.getActiveExportPower()) << what;
+    EXPECT_FLOAT_EQ(a.getL1Voltage(), b.getL1Voltage()) << what;
+    EXPECT_FLOAT_EQ(a.getL3Current(), b.getL3Current()) << what;
+    EXPECT_DOUBLE_EQ(a.getActiveImportCounter(), b.getActiveImportCounter()) << what;
+}
+
+TEST(LayoutCache, CachedDecodeMatchesFreshDecode) {
+    uint32_t checked = 0;
+    for(const std::string& path : listCaptures(capturesDir())) {
+        CosemLayoutCache cache;
+        LayoutDecode warm;
+        for(int round = 0; round < 3; round++) {
+            for(std::vector<uint8_t>& payload : obisPayloads(path)) {
+                CosemLayoutCache fresh;
+                LayoutDecode cold;
+                AmsData expected = cold.decode(payload, &fresh);
+                AmsData actual = warm.decode(payload, &cache);
+                expectSameValues(expected, actual, captureName(path));
+                checked++;
+            }
+        }
+    }
+    EXPECT_GE(checked, 15u);
+}
+
+TEST(LayoutCache, ValueChangeKeepsLayout) {
+    std::vector<std::vector<uint8_t>> payloads = obisPayloads(std::string(capturesDir()) + "/Kamstrup-Sweden.raw");
+    ASSERT_EQ(1u, payloads.size());
+    std::vector<uint8_t> payload = payloads[0];
+    CosemLayoutCache cache;
+    LayoutDecode decoder;
+    AmsData first = decoder.decode(payload, &cache);
+
+    // Active import power is the double long after 1.0.1.7.0.255, bump its lowest byte
+    static const uint8_t obis[] = { 0x09, 0x06, 0x01, 0x01, 0x01, 0x07, 0x00, 0xFF, 0x06 };
+    auto it = std::search(payload.begin(), payload.end(), obis, obis + sizeof(obis));
+    ASSERT_NE(payload.end(), it);
+    it[sizeof(obis) + 3] += 1;
+
+    AmsData second = decoder.decode(payload, &cache);
+    EXPECT_EQ(first.getActiveImportPower() + 1, second.getActiveImportPower());
+    EXPECT_EQ(1u, cache.getHits());
+    EXPECT_EQ(1u, cache.getMisses());
+}
+
+TEST(LayoutCache, KeepsEachListOfAMeter) {
+    // Kamstrup sends list 1 and list 3 with different layouts, both stay cached
+    std::vector<std::vector<uint8_t>> payloads = obisPayloads(std::string(capturesDir()) + "/Kamstrup-1p.raw");
+    ASSERT_EQ(3u, payloads.size());
+    CosemLayoutCache cache;
+    LayoutDecode decoder;
+    for(int round = 0; round < 10; round++) {
+        for(std::vector<uint8_t>& payload : payloads) decoder.decode(payload, &cache);
+    }
+    EXPECT_EQ(2u, cache.getMisses());
+    EXPECT_EQ(28u, cache.getHits());
+}
+
+TEST(LayoutCache, EvictsOldestLayout) {
+    std::vector<std::vector<uint8_t>> layouts;
+    for(uint8_t i = 0; i <= COSEM_LAYOUT_CACHE_SIZE; i++) {
+        // Lists with one more OBIS code each
+        std::vector<uint8_t> payload = { CosemTypeStructure, (uint8_t) ((i + 1) * 2) };
+        for(uint8_t j = 0; j <= i; j++) {
+            uint8_t item[] = { CosemTypeOctetString, 6, 1, 0, (uint8_t) (j + 1), 7, 0, 255, CosemTypeDLongUnsigned, 0, 0, 0, j };
+            payload.insert(payload.end(), item, item + sizeof(item));
+        }
+        layouts.push_back(payload);
+    }
+    CosemLayoutCache cache;
+    for(std::vector<uint8_t>& payload : layouts) cache.get((const char*) payload.data(), payload.size());
+    EXPECT_EQ((uint32_t) COSEM_LAYOUT_CACHE_SIZE + 1, cache.getMisses());
+    // The first one was pushed out by the last, the others are still there
+    cache.get((const char*) layouts[1].data(), layouts[1].size());
+    EXPECT_EQ(1u, cache.getHits());
+    cache.get((const char*) layouts[0].data(), layouts[0].size());
+    EXPECT_EQ((uint32_t) COSEM_LAYOUT_CACHE_SIZE + 2, cache.getMisses());
+}
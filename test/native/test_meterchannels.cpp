@@ -0,0 +1,112 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "CaptureReplay.h"
+#include "FrameCapture.h"
+#include "HostHeap.h"
+
+// Several meters read side by side, as the main meter and sub-meters are in the firmware loop
+class MeterChannels : public ::testing::Test {
+protected:
+    std::vector<std::vector<uint8_t>> aidon = captureFrames("Aidon-Sweden.raw");
+    std::vector<std::vector<uint8_t>> kamstrup = captureFrames("Kamstrup-Sweden.raw");
+    std::vector<std::vector<uint8_t>> kamstrup1p = captureFrames("Kamstrup-1p.raw");
+
+    void expectAidon(AmsData& s) {
+        EXPECT_EQ(2021u, s.getActiveImportPower());
+        EXPECT_FLOAT_EQ(227.5, s.getL1Voltage());
+        EXPECT_NEAR(63068.772, s.getActiveImportCounter(), 0.001);
+    }
+
+    void expectKamstrup(AmsData& s) {
+        EXPECT_STREQ("6841131BN245101092", s.getMeterModel().c_str());
+        EXPECT_EQ(2269u, s.getActiveImportPower());
+        EXPECT_FLOAT_EQ(241.0, s.getL1Voltage());
+    }
+
+    void expectKamstrup1p(AmsData& s) {
+        EXPECT_STREQ("6861111BN242101040", s.getMeterModel().c_str());
+        EXPECT_EQ(619u, s.getActiveImportPower());
+    }
+};
+
+TEST_F(MeterChannels, InterleavedFramesKeepTheirOwnState) {
+    CaptureReplay channels[3];
+    for(uint8_t i = 0; i < 3; i++) channels[i].getMeter().setChannel(i);
+
+    uint32_t decoded[3] = { 0, 0, 0 };
+    for(int round = 0; round < 10; round++) {
+        decoded[0] += channels[0].feedFrames(aidon);
+        decoded[1] += channels[1].feedFrames(kamstrup);
+        decoded[2] += channels[2].feedFrames(kamstrup1p);
+    }
+    EXPECT_EQ(10u, decoded[0]);
+    EXPECT_EQ(10u, decoded[1]);
+    EXPECT_EQ(30u, decoded[2]);
+    expectAidon(channels[0].getState());
+    expectKamstrup(channels[1].getState());
+    expectKamstrup1p(channels[2].getState());
+}
+
+// Half a frame on one channel must not be disturbed by whole frames on the others
+TEST_F(MeterChannels, PartialFramesDoNotMix) {
+    CaptureReplay main;
+    CaptureReplay sub;
+    sub.getMeter().setChannel(1);
+
+    const std::vector<uint8_t>& a = aidon.at(0);
+    size_t half = a.size() / 2;
+    EXPECT_EQ(0u, main.feed(a.data(), half));
+    EXPECT_EQ(1u, sub.feedFrames(kamstrup));
+    EXPECT_EQ(3u, sub.feedFrames(kamstrup1p));
+    EXPECT_EQ(1u, main.feed(a.data() + half, a.size() - half));
+    expectAidon(main.getState());
+    expectKamstrup1p(sub.getState());
+}
+
+// One layout cache serves all channels, so each meter only adds its own layouts to it
+TEST_F(MeterChannels, LayoutCacheIsShared) {
+    CaptureReplay main;
+    CaptureReplay sub;
+    sub.getMeter().setChannel(1);
+    CosemLayoutCache* cache = PassiveMeterCommunicator::getLayoutCache();
+    ASSERT_NE(nullptr, cache);
+
+    // The Kamstrup frames differ from each other, so each one is decoded and looked up
+    main.feedFrames(aidon);
+    sub.feedFrames(kamstrup1p);
+    uint32_t hits = cache->getHits();
+    uint32_t misses = cache->getMisses();
+    for(int round = 0; round < 5; round++) {
+        ASSERT_EQ(3u, sub.feedFrames(kamstrup1p));
+        ASSERT_EQ(1u, main.feedFrames(aidon));
+    }
+    EXPECT_EQ(misses, cache->getMisses());
+    EXPECT_GE(cache->getHits(), hits + 15);
+    EXPECT_EQ(cache, PassiveMeterCommunicator::getLayoutCache());
+}
+
+// A sub-meter that is removed gives back everything it allocated, parsers included
+TEST_F(MeterChannels, DeletedChannelFreesItsMemory) {
+    {
+        // Creates the shared layout cache, which stays
+        CaptureReplay warmup;
+        warmup.feedFrames(aidon);
+    }
+
+    hostHeapReset();
+    for(int i = 0; i < 5; i++) {
+        CaptureReplay sub;
+        sub.getMeter().setChannel(1);
+        ASSERT_EQ(1u, sub.feedFrames(aidon));
+        ASSERT_EQ(1u, sub.feedFrames(kamstrup));
+        ASSERT_EQ(3u, sub.feedFrames(kamstrup1p));
+    }
+    HostHeapStats heap = hostHeapStats();
+    EXPECT_EQ(heap.allocations, heap.frees);
+    EXPECT_EQ(0, heap.current);
+}
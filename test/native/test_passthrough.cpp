@@ -0,0 +1,215 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "PassthroughMqttHandler.h"
+#include "CaptureReplay.h"
+#include "FrameCapture.h"
+#include "SegmentedFrames.h"
+#include "DsmrTelegram.h"
+#include "hexutils.h"
+
+class HostPassthrough : public PassthroughMqttHandler {
+public:
+    HostPassthrough(MqttConfig& config, Stream* debugger, char* buf) : PassthroughMqttHandler(config, debugger, buf) {
+        mqtt.setConnected(true);
+    }
+    std::vector<MQTTMessage>& getPublished() { return mqtt.getPublished(); }
+};
+
+struct Record {
+    bool text;
+    std::string data;
+};
+
+// Splits a binary batch into its length prefixed records
+static std::vector<Record> records(const std::string& batch) {
+    std::vector<Record> ret;
+    size_t pos = 0;
+    while(pos + 2 <= batch.size()) {
+        uint16_t header = ((uint8_t) batch[pos] << 8) | (uint8_t) batch[pos+1];
+        uint16_t len = header & ~PASSTHROUGH_RECORD_TEXT;
+        EXPECT_LE(pos + 2 + len, batch.size());
+        ret.push_back({ (header & PASSTHROUGH_RECORD_TEXT) != 0, batch.substr(pos + 2, len) });
+        pos += 2 + len;
+    }
+    EXPECT_EQ(batch.size(), pos);
+    return ret;
+}
+
+class PassthroughTest : public ::testing::Test {
+protected:
+    HostDebug debug;
+    MqttConfig config;
+    char json[1024];
+
+    HostPassthrough* create(uint8_t format) {
+        memset(&config, 0, sizeof(config));
+        strcpy(config.publishTopic, "ams/raw");
+        config.payloadFormat = format;
+        return new HostPassthrough(config, &debug, json);
+    }
+};
+
+// One binary message per frame, holding the raw HDLC frame and the DLMS payload inside it
+TEST_F(PassthroughTest, BinaryBatchPerFrame) {
+    HostPassthrough* pt = create(PASSTHROUGH_FORMAT_BINARY);
+    CaptureReplay r;
+    r.getMeter().setPassthroughMqttHandler(pt);
+    std::vector<std::vector<uint8_t>> frames = captureFrames("Kamstrup-1p.raw");
+
+    for(const std::vector<uint8_t>& frame : frames) {
+        pt->getPublished().clear();
+        std::vector<std::vector<uint8_t>> payloads = r.unwrapFrames({ frame });
+        ASSERT_EQ(1u, payloads.size());
+        EXPECT_TRUE(pt->getPublished().empty()) << "Nothing is published while decoding";
+
+        pt->flush();
+        ASSERT_EQ(1u, pt->getPublished().size());
+        const MQTTMessage& msg = pt->getPublished()[0];
+        EXPECT_EQ("ams/raw", msg.topic);
+        EXPECT_EQ(2 + frame.size() + 2 + payloads[0].size(), msg.payload.size());
+
+        std::vector<Record> recs = records(msg.payload);
+        ASSERT_EQ(2u, recs.size());
+        EXPECT_EQ(std::string(frame.begin(), frame.end()), recs[0].data);
+        EXPECT_EQ(std::string(payloads[0].begin(), payloads[0].end()), recs[1].data);
+        EXPECT_FALSE(recs[0].text);
+        EXPECT_FALSE(recs[1].text);
+    }
+    EXPECT_EQ(0u, pt->getDropped());
+    delete pt;
+}
+
+// Hex keeps one message per record, as before batching
+TEST_F(PassthroughTest, HexMessagePerRecord) {
+    HostPassthrough* pt = create(PASSTHROUGH_FORMAT_HEX);
+    CaptureReplay r;
+    r.getMeter().setPassthroughMqttHandler(pt);
+    std::vector<uint8_t> frame = captureFrames("Kamstrup-1p.raw").at(0);
+
+    std::vector<std::vector<uint8_t>> payloads = r.unwrapFrames({ frame });
+    ASSERT_EQ(1u, payloads.size());
+    pt->flush();
+    ASSERT_EQ(2u, pt->getPublished().size());
+    EXPECT_EQ(std::string(toHex(frame.data(), frame.size()).c_str()), pt->getPublished()[0].payload);
+    EXPECT_EQ(frame.size() * 2, pt->getPublished()[0].payload.size());
+    EXPECT_EQ(std::string(toHex(payloads[0].data(), payloads[0].size()).c_str()), pt->getPublished()[1].payload);
+    EXPECT_EQ(0u, pt->getDropped());
+    delete pt;
+}
+
+// The payload does not have to fit the MQTT buffer, a long frame is not cut or dropped
+TEST_F(PassthroughTest, HexOfLongFrame) {
+    HostPassthrough* pt = create(PASSTHROUGH_FORMAT_HEX);
+    CaptureReplay r;
+    r.getMeter().setPassthroughMqttHandler(pt);
+    std::vector<uint8_t> frame = captureFrames("Aidon-Sweden.raw").at(0);
+    ASSERT_GT(frame.size() * 2, (size_t) PASSTHROUGH_MQTT_BUFFER_SIZE);
+
+    std::vector<std::vector<uint8_t>> payloads = r.unwrapFrames({ frame });
+    ASSERT_EQ(1u, payloads.size());
+    pt->flush();
+    ASSERT_EQ(2u, pt->getPublished().size());
+    EXPECT_EQ(std::string(toHex(frame.data(), frame.size()).c_str()), pt->getPublished()[0].payload);
+    EXPECT_EQ(0u, pt->getDropped());
+    delete pt;
+}
+
+TEST_F(PassthroughTest, DsmrTelegramIsOneTextRecord) {
+    HostPassthrough* pt = create(PASSTHROUGH_FORMAT_BINARY);
+    CaptureReplay r;
+    r.getMeter().setPassthroughMqttHandler(pt);
+    std::vector<uint8_t> telegram = dsmrTelegram();
+
+    ASSERT_EQ(1u, r.feed(telegram));
+    pt->flush();
+    ASSERT_EQ(1u, pt->getPublished().size());
+    std::vector<Record> recs = records(pt->getPublished()[0].payload);
+    ASSERT_EQ(1u, recs.size());
+    EXPECT_TRUE(recs[0].text);
+    EXPECT_EQ(std::string(telegram.begin(), telegram.end()), recs[0].data);
+    delete pt;
+}
+
+// Each segment frame is passed on as it arrives, the APDU follows with the last one
+TEST_F(PassthroughTest, SegmentedFrames) {
+    std::vector<uint8_t> frame = captureFrames("Aidon-Sweden.raw").at(0);
+    CaptureReplay whole;
+    std::vector<std::vector<uint8_t>> payloads = whole.unwrapFrames({ frame });
+    ASSERT_EQ(1u, payloads.size());
+
+    HostPassthrough* pt = create(PASSTHROUGH_FORMAT_BINARY);
+    CaptureReplay r;
+    r.getMeter().setPassthroughMqttHandler(pt);
+    std::vector<std::vector<uint8_t>> frames = hdlcSegments(hdlcPayload(frame), 200);
+    ASSERT_EQ(3u, frames.size());
+
+    uint32_t decoded = 0;
+    for(size_t i = 0; i < frames.size(); i++) {
+        pt->getPublished().clear();
+        decoded += r.feed(frames[i]);
+        pt->flush();
+        ASSERT_EQ(1u, pt->getPublished().size());
+        std::vector<Record> recs = records(pt->getPublished()[0].payload);
+        bool last = i == frames.size() - 1;
+        ASSERT_EQ(last ? 2u : 1u, recs.size());
+        EXPECT_EQ(std::string(frames[i].begin(), frames[i].end()), recs[0].data);
+        // The gathered payload is the same as from the frame in one piece
+        if(last) {
+            EXPECT_EQ(std::string(payloads[0].begin(), payloads[0].end()), recs[1].data);
+        }
+    }
+    EXPECT_EQ(1u, decoded);
+    EXPECT_EQ(0u, pt->getDropped());
+    delete pt;
+}
+
+// A frame and its payload can together be larger than the MQTT buffer, they still go out as one
+TEST_F(PassthroughTest, LongFrameIsOneMessage) {
+    HostPassthrough* pt = create(PASSTHROUGH_FORMAT_BINARY);
+    CaptureReplay r;
+    r.getMeter().setPassthroughMqttHandler(pt);
+    std::vector<uint8_t> frame = captureFrames("Aidon-Sweden.raw").at(0);
+
+    std::vector<std::vector<uint8_t>> payloads = r.unwrapFrames({ frame });
+    ASSERT_EQ(1u, payloads.size());
+    ASSERT_GT(2 + frame.size() + 2 + payloads[0].size(), (size_t) PASSTHROUGH_MQTT_BUFFER_SIZE);
+    pt->flush();
+    ASSERT_EQ(1u, pt->getPublished().size());
+    std::vector<Record> recs = records(pt->getPublished()[0].payload);
+    ASSERT_EQ(2u, recs.size());
+    EXPECT_EQ(std::string(frame.begin(), frame.end()), recs[0].data);
+    EXPECT_EQ(std::string(payloads[0].begin(), payloads[0].end()), recs[1].data);
+    EXPECT_EQ(0u, pt->getDropped());
+    delete pt;
+}
+
+// When flush() is not called in time, records that do not fit are dropped and counted
+TEST_F(PassthroughTest, FullQueueDropsRecords) {
+    HostPassthrough* pt = create(PASSTHROUGH_FORMAT_BINARY);
+    CaptureReplay r;
+    r.getMeter().setPassthroughMqttHandler(pt);
+    std::vector<uint8_t> frame = captureFrames("Kamstrup-1p.raw").at(0);
+
+    uint32_t fed = 0;
+    while(pt->getDropped() == 0 && fed < 20) fed += r.feed(frame);
+    ASSERT_GT(pt->getDropped(), 0u);
+    pt->flush();
+    ASSERT_EQ(1u, pt->getPublished().size());
+    const std::string& batch = pt->getPublished()[0].payload;
+    EXPECT_LE(batch.size(), (size_t) PASSTHROUGH_QUEUE_SIZE);
+    std::vector<Record> recs = records(batch);
+    // The frame and its payload from every decode are either published or counted as dropped
+    EXPECT_EQ(fed * 2, recs.size() + pt->getDropped());
+    EXPECT_EQ(std::string(frame.begin(), frame.end()), recs.at(0).data);
+
+    // Nothing left over for the next flush
+    pt->getPublished().clear();
+    pt->flush();
+    EXPECT_TRUE(pt->getPublished().empty());
+    delete pt;
+}
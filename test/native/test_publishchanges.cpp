@@ -0,0 +1,175 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "CaptureReplay.h"
+#include "FrameCapture.h"
+#include "JsonMqttHandler.h"
+#include "RawMqttHandler.h"
+#include "DomoticzMqttHandler.h"
+#include "HomeAssistantMqttHandler.h"
+
+// Gives the tests a connected client and what was published through it
+template<class T> class Host : public T {
+public:
+    template<class... Args> Host(Args&&... args) : T(std::forward<Args>(args)...) {
+        this->mqtt.setConnected(true);
+    }
+    std::vector<MQTTMessage>& getPublished() { return this->mqtt.getPublished(); }
+    void setConnected(bool connected) { this->mqtt.setConnected(connected); }
+
+    size_t count(const std::string& suffix) {
+        size_t n = 0;
+        for(const MQTTMessage& msg : getPublished()) {
+            if(msg.topic.size() >= suffix.size() && msg.topic.compare(msg.topic.size() - suffix.size(), suffix.size(), suffix) == 0) n++;
+        }
+        return n;
+    }
+};
+
+class PublishChanges : public ::testing::Test {
+protected:
+    HostDebug debug;
+    GpioConfig gpio;
+    HwTools hw;
+    EnergyAccountingConfig eaConfig;
+    EnergyAccountingRealtimeData rtd;
+    EnergyAccounting* ea;
+    MqttConfig config;
+    char json[2048];
+    AmsData state;
+    std::vector<AmsData> frames;
+
+    void SetUp() override {
+        memset(&gpio, 0, sizeof(gpio));
+        hw.setup(&gpio);
+        memset(&eaConfig, 0, sizeof(eaConfig));
+        memset(&rtd, 0, sizeof(rtd));
+        ea = new EnergyAccounting(&debug, &rtd);
+        memset(&config, 0, sizeof(config));
+        strcpy(config.publishTopic, "ams");
+        strcpy(config.clientId, "test");
+
+        CaptureReplay replay;
+        frames = replay.decodeFrames(captureFrames("Kamstrup-Sweden.raw"));
+        ASSERT_EQ(1u, frames.size());
+    }
+
+    void TearDown() override {
+        delete ea;
+    }
+
+    // As handleDataSuccess() does it, the frame is applied to the meter state once before publishing
+    bool publish(AmsMqttHandler* handler, AmsData& frame) {
+        hostAdvanceMillis(10000);
+        state.clearChanges();
+        state.apply(frame);
+        return handler->publish(&frame, &state, ea, NULL);
+    }
+};
+
+TEST_F(PublishChanges, JsonSkipsUnchangedFrames) {
+    Host<JsonMqttHandler> handler(config, &debug, json, &hw);
+    AmsData& frame = frames[0];
+
+    EXPECT_TRUE(publish(&handler, frame));
+    EXPECT_EQ(1u, handler.getPublished().size());
+
+    // The meter repeated itself, there is no new document
+    handler.getPublished().clear();
+    EXPECT_FALSE(publish(&handler, frame));
+    EXPECT_TRUE(handler.getPublished().empty());
+
+    // Until it is time for the full refresh
+    hostAdvanceMillis(MQTT_FULL_REFRESH_INTERVAL);
+    EXPECT_TRUE(publish(&handler, frame));
+    EXPECT_EQ(1u, handler.getPublished().size());
+}
+
+// With state updates the document comes from the meter state, which already holds the frame
+TEST_F(PublishChanges, StateUpdateUsesMeterState) {
+    config.stateUpdate = true;
+    config.stateUpdateInterval = 1;
+    Host<JsonMqttHandler> handler(config, &debug, json, &hw);
+    AmsData& frame = frames[0];
+
+    EXPECT_TRUE(publish(&handler, frame));
+    ASSERT_EQ(1u, handler.getPublished().size());
+    std::string doc = handler.getPublished()[0].payload;
+    char power[32];
+    snprintf(power, sizeof(power), "\"P\":%u", state.getActiveImportPower());
+    EXPECT_NE(std::string::npos, doc.find(power)) << doc;
+}
+
+TEST_F(PublishChanges, RawSendsChangedTopicsOnly) {
+    Host<RawMqttHandler> handler(config, &debug, json);
+    AmsData& frame = frames[0];
+
+    EXPECT_TRUE(publish(&handler, frame));
+    EXPECT_EQ(1u, handler.count("/meter/import/active"));
+    EXPECT_EQ(1u, handler.count("/meter/l1/voltage"));
+
+    handler.getPublished().clear();
+    EXPECT_TRUE(publish(&handler, frame));
+    EXPECT_EQ(0u, handler.count("/meter/import/active"));
+    EXPECT_EQ(0u, handler.count("/meter/l1/voltage"));
+
+    // Changes seen while disconnected are sent once connected again
+    AmsData other;
+    other.apply(frame);
+    other.apply(OBIS_ACTIVE_IMPORT, 1234);
+    handler.getPublished().clear();
+    handler.setConnected(false);
+    EXPECT_FALSE(publish(&handler, other));
+    handler.setConnected(true);
+    EXPECT_TRUE(publish(&handler, other));
+    EXPECT_EQ(1u, handler.count("/meter/import/active"));
+    EXPECT_EQ(0u, handler.count("/meter/l1/voltage"));
+}
+
+TEST_F(PublishChanges, DomoticzRefreshesDevices) {
+    DomoticzConfig dc;
+    memset(&dc, 0, sizeof(dc));
+    dc.vl1idx = 11;
+    Host<DomoticzMqttHandler> handler(config, &debug, json, dc);
+    AmsData& frame = frames[0];
+
+    EXPECT_TRUE(publish(&handler, frame));
+    EXPECT_EQ(1u, handler.getPublished().size());
+
+    handler.getPublished().clear();
+    publish(&handler, frame);
+    EXPECT_TRUE(handler.getPublished().empty());
+
+    // Every device is sent again now and then, in case Domoticz missed the last update
+    hostAdvanceMillis(MQTT_FULL_REFRESH_INTERVAL);
+    EXPECT_TRUE(publish(&handler, frame));
+    EXPECT_EQ(1u, handler.getPublished().size());
+}
+
+TEST_F(PublishChanges, HomeAssistantSkipsUnchangedTopics) {
+    HomeAssistantConfig hac;
+    memset(&hac, 0, sizeof(hac));
+    Host<HomeAssistantMqttHandler> handler(config, &debug, json, 0, hac, &hw);
+    AmsData& frame = frames[0];
+
+    EXPECT_TRUE(publish(&handler, frame));
+    EXPECT_EQ(1u, handler.count("/power"));
+    EXPECT_EQ(1u, handler.count("/energy"));
+
+    handler.getPublished().clear();
+    EXPECT_TRUE(publish(&handler, frame));
+    EXPECT_EQ(0u, handler.count("/power"));
+    EXPECT_EQ(0u, handler.count("/energy"));
+
+    // New power, same counters
+    AmsData other;
+    other.apply(frame);
+    other.apply(OBIS_ACTIVE_IMPORT, 1234);
+    EXPECT_TRUE(publish(&handler, other));
+    EXPECT_EQ(1u, handler.count("/power"));
+    EXPECT_EQ(0u, handler.count("/energy"));
+}
@@ -0,0 +1,150 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "AmsDataStorage.h"
+#include "EnergyAccounting.h"
+#include "HostDebug.h"
+#include "HostPrices.h"
+#include "LittleFS.h"
+
+// Local midnight in Norway on the days DST starts and ends in 2024
+static const time_t DstStartDay = 1711839600;
+static const time_t DstEndDay = 1729980000;
+
+// Power and price follow each other through the hour, so pricing by the hourly average
+// gives a different day cost than pricing each quarter
+static const uint32_t QuarterPower[4] = { 500, 1000, 1500, 2000 };
+static const float QuarterPrice[4] = { 0.5, 1.0, 1.5, 2.0 };
+
+class QuarterTest : public ::testing::Test {
+protected:
+    HostDebug debug;
+    Timezone* tz;
+    AmsDataStorage* ds;
+    AmsRollup rollup;
+    AmsData data;
+    EnergyAccountingConfig eaConfig;
+    EnergyAccountingRealtimeData rtd;
+    EnergyAccounting* ea;
+    PriceService* ps;
+    double counter = 1000.0;
+
+    void SetUp() override {
+        LittleFS.format();
+        TimeChangeRule CEST = {"CEST", Last, Sun, Mar, 2, 120};
+        TimeChangeRule CET = {"CET ", Last, Sun, Oct, 3, 60};
+        tz = new Timezone(CEST, CET);
+        rollup.setTimezone(tz);
+        ds = new AmsDataStorage(&debug);
+        ds->setTimezone(tz);
+        ps = new PriceService(&debug);
+
+        memset(&eaConfig, 0, sizeof(eaConfig));
+        for(uint8_t i = 0; i < 10; i++) eaConfig.thresholds[i] = 65535;
+        memset(&rtd, 0, sizeof(rtd));
+        ea = new EnergyAccounting(&debug, &rtd);
+        ea->setup(ds, &eaConfig);
+        ea->setPriceService(ps);
+        ea->setTimezone(tz);
+    }
+
+    void TearDown() override {
+        setTime(0);
+        hostClearPrices();
+        delete ea;
+        delete ps;
+        delete ds;
+        delete tz;
+    }
+
+    // Import prices in quarters from a quarter before dayStart until a quarter after the day
+    void setPrices(time_t dayStart, uint8_t quarters) {
+        std::vector<float> values;
+        for(uint8_t i = 0; i < quarters + 2; i++) {
+            values.push_back(QuarterPrice[(i + 3) % 4]);
+        }
+        hostSetPrices(PRICE_DIRECTION_IMPORT, dayStart - 900, 15, values);
+    }
+
+    // A frame every 10 seconds from a quarter before dayStart until a minute into the next day,
+    // fed as the firmware does: rollup, then storage, then accounting
+    void replayDay(time_t dayStart, uint8_t quarters) {
+        time_t start = dayStart - 900;
+        time_t end = dayStart + quarters * 900 + 60;
+        hostSetMicros(0);
+        setTime(start);
+        for(time_t now = start; now <= end; now += 10) {
+            uint32_t power = QuarterPower[(now / 900) % 4];
+            counter += power * 10.0 / 3600 / 1000;
+            data.apply(OBIS_ACTIVE_IMPORT, power);
+            data.apply(OBIS_ACTIVE_IMPORT_COUNT, counter);
+            data.setLastUpdateMillis(millis());
+            rollup.update(data, now);
+            ds->updateHour(rollup);
+            ds->updateDay(rollup);
+            ds->updateQuarter(rollup);
+            ea->update(&data);
+            hostAdvanceMillis(10000);
+        }
+    }
+
+    void expectDay(time_t dayStart, uint8_t quarters) {
+        setPrices(dayStart, quarters);
+        replayDay(dayStart, quarters);
+
+        ASSERT_EQ(dayStart, ds->getQuarterDayStart());
+        ASSERT_EQ(quarters, ds->getQuarterCount());
+        float expected = 0;
+        for(uint8_t slot = 0; slot < quarters; slot++) {
+            ASSERT_TRUE(ds->hasQuarter(slot)) << (int) slot;
+            EXPECT_EQ(QuarterPower[slot % 4] / 4, ds->getQuarterImport(slot)) << (int) slot;
+            expected += QuarterPrice[slot % 4] * ds->getQuarterImport(slot) / 1000.0;
+        }
+        EXPECT_FALSE(ds->hasQuarter(quarters));
+        EXPECT_NEAR(expected, ea->getCostYesterday(), 0.02);
+    }
+};
+
+TEST_F(QuarterTest, DstStartHas92Quarters) {
+    expectDay(DstStartDay, 92);
+}
+
+TEST_F(QuarterTest, DstEndHas100Quarters) {
+    expectDay(DstEndDay, 100);
+}
+
+// The day after DST started, 23 hours after the midnight before
+TEST_F(QuarterTest, NormalDayHas96Quarters) {
+    expectDay(DstStartDay + 23 * 3600, 96);
+}
+
+// The day and month plots are fed from the rollup as hours and days close
+TEST_F(QuarterTest, HoursAndDaysFromRollup) {
+    time_t dayStart = DstStartDay + 23 * 3600;
+    replayDay(dayStart, 96);
+
+    tmElements_t tm;
+    for(time_t hour = dayStart; hour < dayStart + 86400; hour += 3600) {
+        breakTime(hour, tm);
+        EXPECT_EQ(1250u, ds->getHourImport(tm.Hour)) << (int) tm.Hour;
+    }
+    breakTime(tz->toLocal(dayStart), tm);
+    EXPECT_EQ(24 * 1250u, ds->getDayImport(tm.Day));
+    EXPECT_EQ(0u, ds->getDayImport(tm.Day - 1));
+}
+
+// The replay starts a quarter before midnight, so that hour is incomplete in the rollup and
+// is left to the counter based update()
+TEST_F(QuarterTest, IncompleteHourIsNotFromRollup) {
+    time_t dayStart = DstStartDay + 23 * 3600;
+    replayDay(dayStart, 1);
+
+    tmElements_t tm;
+    breakTime(dayStart - 3600, tm);
+    EXPECT_EQ(0u, ds->getHourImport(tm.Hour));
+    EXPECT_EQ(0, ds->getDayData().lastMeterReadTime);
+}
@@ -0,0 +1,168 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "DataSegments.h"
+#include "CaptureReplay.h"
+#include "FrameCapture.h"
+#include "SegmentedFrames.h"
+#include "HostHeap.h"
+
+TEST(DataSegments, GathersViewsInOrder) {
+    uint8_t buf[32];
+    for(uint8_t i = 0; i < sizeof(buf); i++) buf[i] = i;
+    DataSegments segments;
+    segments.setBuffer(buf, sizeof(buf));
+    segments.begin();
+    ASSERT_TRUE(segments.add(buf + 4, 3));
+    ASSERT_TRUE(segments.add(buf + 10, 2));
+    ASSERT_TRUE(segments.add(buf + 20, 4));
+    EXPECT_EQ(3, segments.getCount());
+    EXPECT_EQ(9, segments.getLength());
+    ASSERT_EQ(9, segments.gather());
+    const uint8_t expected[] = { 4, 5, 6, 10, 11, 20, 21, 22, 23 };
+    EXPECT_EQ(0, memcmp(expected, buf, sizeof(expected)));
+    EXPECT_EQ(1, segments.getCount());
+}
+
+TEST(DataSegments, RejectsViewsOutsideOrBackwards) {
+    uint8_t buf[32];
+    uint8_t other[8];
+    DataSegments segments;
+    segments.setBuffer(buf, sizeof(buf));
+    segments.begin();
+    EXPECT_FALSE(segments.add(other, 4));
+    EXPECT_FALSE(segments.add(buf + 30, 4));
+    ASSERT_TRUE(segments.add(buf + 10, 4));
+    EXPECT_FALSE(segments.add(buf + 12, 4));
+    // A rejected view drops the whole sequence
+    EXPECT_EQ(0, segments.getCount());
+}
+
+TEST(DataSegments, ListIsBounded) {
+    uint8_t buf[DATA_SEGMENTS_MAX * 2 + 2];
+    DataSegments segments;
+    segments.setBuffer(buf, sizeof(buf));
+    segments.begin();
+    for(uint8_t i = 0; i < DATA_SEGMENTS_MAX; i++) ASSERT_TRUE(segments.add(buf + i * 2, 1));
+    EXPECT_FALSE(segments.add(buf + DATA_SEGMENTS_MAX * 2, 1));
+}
+
+static void expectAidon(AmsData& s) {
+    EXPECT_EQ(2021u, s.getActiveImportPower());
+    EXPECT_FLOAT_EQ(227.5, s.getL1Voltage());
+    EXPECT_NEAR(63068.772, s.getActiveImportCounter(), 0.001);
+}
+
+static std::vector<uint8_t> aidonPayload() {
+    return hdlcPayload(captureFrames("Aidon-Sweden.raw").at(0));
+}
+
+TEST(SegmentReplay, SegmentedHdlc) {
+    std::vector<uint8_t> payload = aidonPayload();
+    ASSERT_EQ(DATA_TAG_LLC, payload[0]);
+    for(size_t segmentSize : { 100, 200, 300 }) {
+        CaptureReplay r;
+        std::vector<std::vector<uint8_t>> frames = hdlcSegments(payload, segmentSize);
+        ASSERT_GT(frames.size(), 1u);
+        ASSERT_EQ(1u, r.feedFrames(frames)) << segmentSize;
+        expectAidon(r.getState());
+    }
+}
+
+TEST(SegmentReplay, GeneralBlockTransfer) {
+    std::vector<uint8_t> payload = aidonPayload();
+    std::vector<uint8_t> apdu(payload.begin() + 3, payload.end());
+    CaptureReplay r;
+    std::vector<std::vector<uint8_t>> frames = gbtSegments(apdu, 120);
+    ASSERT_EQ(5u, frames.size());
+    ASSERT_EQ(1u, r.feedFrames(frames));
+    expectAidon(r.getState());
+}
+
+TEST(SegmentReplay, MbusSegmentsOfAidonApdu) {
+    std::vector<uint8_t> payload = aidonPayload();
+    std::vector<uint8_t> apdu(payload.begin() + 3, payload.end());
+    CaptureReplay r;
+    std::vector<std::vector<uint8_t>> frames = mbusSegments(apdu, 250);
+    ASSERT_EQ(3u, frames.size());
+    ASSERT_EQ(1u, r.feedFrames(frames));
+    expectAidon(r.getState());
+}
+
+// austria.raw is a commented frame with the APDU shown decrypted. Sent in M-Bus segments like
+// the meter does, it has to decode the same as in one frame.
+TEST(SegmentReplay, AustrianMbusSegments) {
+    std::vector<uint8_t> raw = loadCapture(std::string(capturesDir()) + "/austria.raw");
+    const uint8_t start[] = { 0x0F, 0x80, 0x3E, 0x37, 0x71 };
+    std::vector<uint8_t>::iterator it = std::search(raw.begin(), raw.end(), start, start + sizeof(start));
+    ASSERT_NE(raw.end(), it);
+    // Up to the meter ID, the last item in the capture
+    std::vector<uint8_t> apdu(it, raw.end() - 2);
+
+    CaptureReplay whole;
+    ASSERT_EQ(1u, whole.feedFrames(mbusSegments(apdu, 250)));
+    EXPECT_NEAR(4406.538, whole.getState().getActiveImportCounter(), 0.001);
+    EXPECT_EQ(510u, whole.getState().getActiveImportPower());
+
+    for(size_t segmentSize : { 60, 100, 150 }) {
+        CaptureReplay r;
+        std::vector<std::vector<uint8_t>> frames = mbusSegments(apdu, segmentSize);
+        ASSERT_GT(frames.size(), 1u);
+        ASSERT_EQ(1u, r.feedFrames(frames)) << segmentSize;
+        AmsData& s = r.getState();
+        EXPECT_EQ(whole.getState().getActiveImportCounter(), s.getActiveImportCounter());
+        EXPECT_EQ(whole.getState().getActiveImportPower(), s.getActiveImportPower());
+        EXPECT_EQ(whole.getState().getL1Voltage(), s.getL1Voltage());
+        EXPECT_EQ(whole.getState().getL1Current(), s.getL1Current());
+        EXPECT_STREQ(whole.getState().getMeterId().c_str(), s.getMeterId().c_str());
+    }
+}
+
+// The frames of an APDU only just fit in the receive buffer together after the payloads so
+// far have been gathered to make room
+TEST(SegmentReplay, CompactsWhenFramesDoNotFit) {
+    std::vector<uint8_t> payload = aidonPayload();
+    CaptureReplay r(5);
+    ASSERT_EQ(640, r.getMeter().getBufferSize());
+    std::vector<std::vector<uint8_t>> frames = hdlcSegments(payload, 100);
+    size_t total = 0;
+    for(const std::vector<uint8_t>& f : frames) total += f.size();
+    ASSERT_GT(total, 640u);
+    ASSERT_EQ(1u, r.feedFrames(frames));
+    expectAidon(r.getState());
+}
+
+TEST(SegmentReplay, SequenceCanStartOver) {
+    std::vector<uint8_t> payload = aidonPayload();
+    std::vector<std::vector<uint8_t>> frames = hdlcSegments(payload, 200);
+    CaptureReplay r;
+    // The first segment again, as after a lost frame, restarts the sequence
+    ASSERT_EQ(0u, r.feed(frames[0]));
+    ASSERT_EQ(1u, r.feedFrames(frames));
+    expectAidon(r.getState());
+}
+
+// Reading the segments in place must not need more heap than a single frame does
+TEST(SegmentReplay, NoExtraAllocations) {
+    std::vector<uint8_t> frame = captureFrames("Aidon-Sweden.raw").at(0);
+    std::vector<std::vector<uint8_t>> frames = hdlcSegments(hdlcPayload(frame), 150);
+
+    CaptureReplay single;
+    single.feed(frame);
+    hostHeapReset();
+    ASSERT_EQ(1u, single.feed(frame));
+    HostHeapStats singleHeap = hostHeapStats();
+
+    CaptureReplay segmented;
+    segmented.feedFrames(frames);
+    hostHeapReset();
+    ASSERT_EQ(1u, segmented.feedFrames(frames));
+    HostHeapStats segmentedHeap = hostHeapStats();
+
+    EXPECT_EQ(singleHeap.allocations, segmentedHeap.allocations);
+    EXPECT_EQ(singleHeap.peak, segmentedHeap.peak);
+}
@@ -0,0 +1,162 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "SerialLineEncoder.h"
+#include "HostMeterCommunicator.h"
+#include "HostDebug.h"
+#include "FrameCapture.h"
+#include "DsmrTelegram.h"
+
+static SerialAutodetectScore score(const SerialLine& line, uint32_t baud, uint8_t parity, bool invert) {
+    uint8_t work[1024];
+    SerialAutodetectScore s;
+    s.baud = baud;
+    s.parity = parity;
+    s.invert = invert;
+    serialAutodetectScore(line.capture(AUTODETECT_CAPTURE_RUNS), s, work, sizeof(work));
+    return s;
+}
+
+struct LineSetup {
+    const char* capture; // NULL for a generated DSMR telegram
+    uint32_t baud;
+    uint8_t parity;
+    bool invert;
+};
+
+static std::vector<std::vector<uint8_t>> framesFor(const LineSetup& setup) {
+    if(setup.capture == NULL) return { dsmrTelegram() };
+    return captureFrames(setup.capture);
+}
+
+static const LineSetup SETUPS[] = {
+    { "Kamstrup-Sweden.raw", 2400, 3, false },
+    { "Aidon-Sweden.raw", 2400, 11, false },
+    { "Kamstrup-1p.raw", 2400, 3, true },
+    { "Kaifa-TN-3p.raw", 2400, 11, true },
+    { NULL, 115200, 3, false },
+    { NULL, 115200, 3, true },
+    // 7 data bits only carries the ASCII telegrams
+    { NULL, 115200, 10, false },
+    { NULL, 2400, 10, false },
+};
+
+TEST(SerialAutodetect, FindsTheSettingsCapturesWereSentWith) {
+    uint8_t work[1024];
+    for(const LineSetup& setup : SETUPS) {
+        SerialLine line = encodeSerialLine(framesFor(setup), setup.baud, setup.parity, setup.invert);
+        SerialAutodetectScore best;
+        ASSERT_TRUE(serialAutodetectBest(line.capture(AUTODETECT_CAPTURE_RUNS), AUTO_BAUD_RATES, sizeof(AUTO_BAUD_RATES) / sizeof(AUTO_BAUD_RATES[0]), best, work, sizeof(work)))
+            << (setup.capture ? setup.capture : "DSMR");
+        EXPECT_EQ(setup.baud, best.baud) << (setup.capture ? setup.capture : "DSMR");
+        EXPECT_EQ(setup.parity, best.parity) << (setup.capture ? setup.capture : "DSMR");
+        EXPECT_EQ(setup.invert, best.invert) << (setup.capture ? setup.capture : "DSMR");
+        EXPECT_GT(best.tagHits + best.checksumPasses, 0) << (setup.capture ? setup.capture : "DSMR");
+    }
+}
+
+// Every other baud rate, parity and inversion has to score below the one the line was sent with
+TEST(SerialAutodetect, WrongSettingsScoreLower) {
+    const uint32_t bauds[] = { 2400, 9600, 115200 };
+    for(const LineSetup& setup : SETUPS) {
+        SerialLine line = encodeSerialLine(framesFor(setup), setup.baud, setup.parity, setup.invert);
+        SerialAutodetectScore right = score(line, setup.baud, setup.parity, setup.invert);
+        EXPECT_EQ(0, right.framingErrors + right.parityErrors) << (setup.capture ? setup.capture : "DSMR");
+        for(uint32_t baud : bauds) {
+            for(uint8_t parity : AUTODETECT_PARITIES) {
+                for(bool invert : { false, true }) {
+                    if(baud == setup.baud && parity == setup.parity && invert == setup.invert) continue;
+                    SerialAutodetectScore wrong = score(line, baud, parity, invert);
+                    EXPECT_LT(wrong.score, right.score) << (setup.capture ? setup.capture : "DSMR") << " at " << baud << " " << (int) parity << (invert ? " inverted" : "");
+                }
+            }
+        }
+    }
+}
+
+TEST(SerialAutodetect, NoiseIsNotMeterData) {
+    uint8_t work[1024];
+    srand(1);
+    std::vector<uint16_t> runs;
+    for(int i = 0; i < AUTODETECT_CAPTURE_RUNS; i++) runs.push_back(20 + rand() % 3000);
+    SerialLineCapture line = { runs.data(), (uint16_t) runs.size(), true };
+    SerialAutodetectScore best;
+    EXPECT_FALSE(serialAutodetectBest(line, AUTO_BAUD_RATES, sizeof(AUTO_BAUD_RATES) / sizeof(AUTO_BAUD_RATES[0]), best, work, sizeof(work)));
+}
+
+class AutodetectMeter {
+public:
+    AutodetectMeter(uint8_t pin) : port(9) {
+        memset(&config, 0, sizeof(config));
+        config.bufferSize = 8;
+        config.rxPin = pin;
+        config.txPin = 0xFF;
+        config.rxPinPullup = true;
+        port.begin(2400);
+        mc = new HostMeterCommunicator(&debug);
+        mc->attach(&port, config, NULL);
+        mc->startAutodetect();
+    }
+
+    ~AutodetectMeter() {
+        delete mc;
+    }
+
+    HostDebug debug;
+    HardwareSerial port;
+    MeterConfig config;
+    HostMeterCommunicator* mc;
+};
+
+// A sub-meter going away in the middle of a capture must leave the main meter's capture alone
+TEST(SerialAutodetect, CapturesArePerMeter) {
+    hostSetMicros(1000000);
+    hostSetPinLevel(4, HIGH);
+    hostSetPinLevel(5, HIGH);
+    AutodetectMeter* main = new AutodetectMeter(4);
+    AutodetectMeter* sub = new AutodetectMeter(5);
+    main->mc->loop();
+    sub->mc->loop();
+    ASSERT_TRUE(main->mc->isCapturing());
+    ASSERT_TRUE(sub->mc->isCapturing());
+
+    SerialLine line = encodeSerialLine(captureFrames("Aidon-Sweden.raw"), 2400, 11, false);
+    ASSERT_GT(line.runs.size(), 200u);
+    playSerialLine(4, line, 0, 100);
+    playSerialLine(5, line, 0, 50);
+    EXPECT_EQ(100, main->mc->getCapturedRuns());
+    EXPECT_EQ(50, sub->mc->getCapturedRuns());
+
+    delete sub;
+    EXPECT_FALSE(hostHasInterrupt(5));
+    ASSERT_TRUE(hostHasInterrupt(4));
+
+    playSerialLine(4, line, 100);
+    EXPECT_EQ(min(line.runs.size(), (size_t) AUTODETECT_CAPTURE_RUNS), main->mc->getCapturedRuns());
+
+    hostAdvanceMillis(AUTODETECT_CAPTURE_MS);
+    main->mc->loop();
+    EXPECT_FALSE(main->mc->isCapturing());
+    EXPECT_FALSE(hostHasInterrupt(4));
+    EXPECT_EQ(2400u, main->mc->getAutodetectBaud());
+    EXPECT_EQ(11, main->mc->getAutodetectParity());
+    EXPECT_FALSE(main->mc->getAutodetectInvert());
+
+    delete main;
+}
+
+TEST(SerialAutodetect, DeletingAMeterDetachesItsCapture) {
+    hostSetPinLevel(6, HIGH);
+    AutodetectMeter* meter = new AutodetectMeter(6);
+    meter->mc->loop();
+    ASSERT_TRUE(hostHasInterrupt(6));
+    delete meter;
+    EXPECT_FALSE(hostHasInterrupt(6));
+    // Edges after that go nowhere
+    hostSetPinLevel(6, LOW);
+    hostSetPinLevel(6, HIGH);
+}
@@ -0,0 +1,83 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "AmsDataSnapshot.h"
+
+// A state where every field read below carries the same number, so a copy mixed from two
+// publishes shows up as a mismatch
+static void fill(AmsData& data, uint32_t n) {
+    data.apply(OBIS_METER_ID, n);
+    data.apply(OBIS_ACTIVE_IMPORT, n);
+    data.apply(OBIS_ACTIVE_EXPORT, n);
+    data.apply(OBIS_REACTIVE_IMPORT, n);
+    data.setLastUpdateMillis(n);
+}
+
+TEST(AmsDataSnapshot, NothingBeforeFirstPublish) {
+    AmsDataSnapshot snapshot;
+    AmsData target;
+    EXPECT_FALSE(snapshot.read(target));
+
+    AmsData state;
+    EXPECT_TRUE(snapshot.isBehind(state));
+    fill(state, 7);
+    EXPECT_TRUE(snapshot.publish(state));
+    EXPECT_FALSE(snapshot.isBehind(state));
+    ASSERT_TRUE(snapshot.read(target));
+    EXPECT_EQ(7u, target.getActiveImportPower());
+    EXPECT_EQ(1u, snapshot.getSequence());
+}
+
+// One writer publishing as fast as it can, against readers that check every copy they get
+TEST(AmsDataSnapshot, ReadersNeverSeeTornCopies) {
+    const uint32_t publishes = 200000;
+    AmsDataSnapshot snapshot;
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> torn(0);
+    std::atomic<uint32_t> reads(0);
+
+    std::vector<std::thread> readers;
+    for(int i = 0; i < 3; i++) {
+        readers.emplace_back([&]() {
+            AmsData target;
+            uint32_t last = 0;
+            while(!done.load()) {
+                if(!snapshot.read(target)) continue;
+                uint32_t n = target.getActiveImportPower();
+                if(target.getActiveExportPower() != n
+                    || target.getMeterId() != String(n)
+                    || target.getReactiveImportPower() != n
+                    || target.getLastUpdateMillis() != n
+                    || n < last) {
+                    torn++;
+                }
+                last = n;
+                reads++;
+            }
+        });
+    }
+
+    std::thread writer([&]() {
+        AmsData state;
+        for(uint32_t n = 1; n <= publishes; n++) {
+            fill(state, n);
+            while(snapshot.isBehind(state)) snapshot.publish(state);
+        }
+    });
+    writer.join();
+    done = true;
+    for(std::thread& t : readers) t.join();
+
+    EXPECT_EQ(0u, torn.load());
+    EXPECT_GT(reads.load(), 0u);
+    AmsData target;
+    ASSERT_TRUE(snapshot.read(target));
+    EXPECT_EQ(publishes, target.getActiveImportPower());
+    EXPECT_EQ(publishes, snapshot.getSequence());
+}
@@ -0,0 +1,130 @@
+/**
+ * @copyright Utilitech AS 2023
+ * License: Fair Source
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "AmsTimeSeries.h"
+#include "HostDebug.h"
+#include "LittleFS.h"
+#include "AmsStorage.h"
+
+// Start of a UTC day
+static const time_t DayStart = 1700006400;
+
+class TimeSeriesTest : public ::testing::Test {
+protected:
+    HostDebug debug;
+    AmsRollup rollup;
+    AmsData data;
+    time_t now = DayStart;
+    uint64_t millis = 0;
+    double counter = 1000.0;
+
+    void SetUp() override {
+        LittleFS.format();
+        LittleFS.failWritesAfter(-1);
+    }
+
+    void TearDown() override {
+        LittleFS.failWritesAfter(-1);
+    }
+
+    // A frame every 10 seconds at 1200 W, returns the number of records added
+    uint32_t feedMinutes(AmsTimeSeries& ts, uint32_t minutes) {
+        uint32_t added = 0;
+        for(uint32_t i = 0; i < minutes * 6; i++) {
+            data.apply(OBIS_ACTIVE_IMPORT, 1200);
+            data.apply(OBIS_ACTIVE_IMPORT_COUNT, counter);
+            data.setLastUpdateMillis(millis);
+            rollup.update(data, now);
+            if(ts.update(rollup)) added++;
+            now += 10;
+            millis += 10000;
+            counter += 1200.0 * 10 / 3600 / 1000;
+        }
+        return added;
+    }
+
+    std::vector<TimeSeriesRecord> queryAll(AmsTimeSeries& ts) {
+        std::vector<TimeSeriesRecord> records(1500);
+        records.resize(ts.query(DayStart, DayStart + 86400, records.data(), records.size()));
+        return records;
+    }
+
+    size_t segmentSize() {
+        char path[16];
+        snprintf_P(path, 16, PSTR(FILE_TIMESERIES), (int) ((DayStart / TIMESERIES_SEGMENT_SECONDS) % TIMESERIES_SEGMENTS));
+        File file = LittleFS.open(path, "r");
+        size_t size = file.size();
+        file.close();
+        return size;
+    }
+
+    void expectInOrder(const std::vector<TimeSeriesRecord>& records) {
+        for(size_t i = 1; i < records.size(); i++) {
+            EXPECT_EQ(records[i-1].timestamp + TIMESERIES_INTERVAL, records[i].timestamp) << i;
+        }
+    }
+};
+
+TEST_F(TimeSeriesTest, FlushWritesBufferedMinutes) {
+    AmsTimeSeries ts(&debug);
+    uint32_t added = feedMinutes(ts, 10);
+    ASSERT_GT(added, 5u);
+    ASSERT_TRUE(ts.flush());
+    std::vector<TimeSeriesRecord> records = queryAll(ts);
+    EXPECT_EQ(added, records.size());
+    EXPECT_EQ(sizeof(TimeSeriesSegmentHeader) + added * sizeof(TimeSeriesRecord), segmentSize());
+    EXPECT_EQ(1200, records.back().importPower);
+    expectInOrder(records);
+}
+
+// A short write keeps what did not make it, and the partial record it left is written over
+TEST_F(TimeSeriesTest, ShortWriteKeepsRecords) {
+    AmsTimeSeries ts(&debug);
+    uint32_t added = feedMinutes(ts, 12);
+    ASSERT_GT(added, 8u);
+    ASSERT_LT(added, (uint32_t) TIMESERIES_BUFFER);
+
+    LittleFS.failWritesAfter(sizeof(TimeSeriesSegmentHeader) + 5 * sizeof(TimeSeriesRecord) + sizeof(TimeSeriesRecord) / 2);
+    EXPECT_FALSE(ts.flush());
+    EXPECT_EQ(sizeof(TimeSeriesSegmentHeader) + 5 * sizeof(TimeSeriesRecord) + sizeof(TimeSeriesRecord) / 2, segmentSize());
+    // Five on flash and the rest still buffered, nothing lost or doubled
+    std::vector<TimeSeriesRecord> records = queryAll(ts);
+    EXPECT_EQ(added, records.size());
+    expectInOrder(records);
+
+    LittleFS.failWritesAfter(-1);
+    EXPECT_TRUE(ts.flush());
+    EXPECT_EQ(sizeof(TimeSeriesSegmentHeader) + added * sizeof(TimeSeriesRecord), segmentSize());
+    records = queryAll(ts);
+    EXPECT_EQ(added, records.size());
+    expectInOrder(records);
+
+    // After a reboot, appends carry on after the records on flash
+    AmsTimeSeries reloaded(&debug);
+    ASSERT_TRUE(reloaded.load());
+    uint32_t more = feedMinutes(reloaded, 3);
+    ASSERT_TRUE(reloaded.flush());
+    records = queryAll(reloaded);
+    EXPECT_EQ(added + more, records.size());
+    expectInOrder(records);
+}
+
+// While the flash fails the buffer stays bounded and keeps the newest minutes
+TEST_F(TimeSeriesTest, FailingFlashKeepsNewest) {
+    AmsTimeSeries ts(&debug);
+    LittleFS.failWritesAfter(0);
+    uint32_t added = feedMinutes(ts, 40);
+    ASSERT_GT(added, (uint32_t) TIMESERIES_BUFFER);
+    std::vector<TimeSeriesRecord> records = queryAll(ts);
+    ASSERT_EQ((size_t) TIMESERIES_BUFFER, records.size());
+    expectInOrder(records);
+    EXPECT_EQ(rollup.getLast(RollupTierMinute)->start, (time_t) records.back().timestamp);
+
+    LittleFS.failWritesAfter(-1);
+    EXPECT_TRUE(ts.flush());
+    EXPECT_EQ((size_t) TIMESERIES_BUFFER, queryAll(ts).size());
+}